@@ -0,0 +1,58 @@
+/**
+ * buffer_pool_manager_bench.cpp
+ *
+ * BufferPoolManager FetchPage + UnpinPage on the hit path (working set fits
+ * in the pool) and the miss path (working set is four times the pool, so
+ * most fetches evict a page and read from disk).
+ */
+
+#include <cstdio>
+#include <memory>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/micro_bench.h"
+
+int main(int argc, char **argv) {
+  using namespace cmudb;
+  MicroBench bench("buffer_pool_manager", argc, argv);
+  int pool_size = bench.Flags().GetInt("pool_size", 64);
+  const std::string db_file = "bpm_bench.db";
+  std::unique_ptr<DiskManager> disk_manager;
+  std::unique_ptr<BufferPoolManager> bpm;
+
+  // allocate num_pages pages on disk, then start from a cold pool
+  auto make_pool = [&](int num_pages) {
+    bpm.reset();
+    disk_manager.reset();
+    remove(db_file.c_str());
+    disk_manager.reset(new DiskManager(db_file));
+    bpm.reset(new BufferPoolManager(pool_size, disk_manager.get()));
+    page_id_t page_id;
+    for (int i = 0; i < num_pages; i++) {
+      bpm->NewPage(page_id);
+      bpm->UnpinPage(page_id, true);
+    }
+  };
+
+  auto fetch = [&](int num_pages) {
+    return [&, num_pages](int tid, int64_t n) {
+      uint64_t x = tid * 2654435761U + 1;
+      for (int64_t i = 0; i < n; i++) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        page_id_t page_id = (x >> 33) % num_pages;
+        if (bpm->FetchPage(page_id) != nullptr)
+          bpm->UnpinPage(page_id, false);
+      }
+    };
+  };
+
+  int hit_pages = pool_size / 2, miss_pages = pool_size * 4;
+  bench.Run("fetch_hit", [&](int) { make_pool(hit_pages); }, fetch(hit_pages));
+  bench.Run("fetch_miss", [&](int) { make_pool(miss_pages); },
+            fetch(miss_pages));
+
+  bpm.reset();
+  disk_manager.reset();
+  remove(db_file.c_str());
+  return 0;
+}
@@ -0,0 +1,59 @@
+/**
+ * lru_replacer_bench.cpp
+ *
+ * LRUReplacer Insert/Victim/Erase. The replacer is not thread safe, with
+ * more than one thread every call is serialised by a mutex the way
+ * BufferPoolManager does it under its latch.
+ */
+
+#include <memory>
+#include <mutex>
+
+#include "buffer/lru_replacer.h"
+#include "common/micro_bench.h"
+
+int main(int argc, char **argv) {
+  using namespace cmudb;
+  MicroBench bench("lru_replacer", argc, argv);
+  int64_t ops = bench.Ops();
+  std::unique_ptr<LRUReplacer<int>> replacer;
+  std::mutex latch;
+
+  auto empty_replacer = [&](int) { replacer.reset(new LRUReplacer<int>); };
+  auto full_replacer = [&](int threads) {
+    empty_replacer(threads);
+    for (int i = 0; i < ops * threads; i++)
+      replacer->Insert(i);
+  };
+
+  bench.Run("insert", empty_replacer, [&](int tid, int64_t n) {
+    int base = tid * n;
+    for (int i = 0; i < n; i++) {
+      std::lock_guard<std::mutex> guard(latch);
+      replacer->Insert(base + i);
+    }
+  });
+  // touching an existing entry moves it to the front
+  bench.Run("insert_existing", full_replacer, [&](int tid, int64_t n) {
+    int base = tid * n;
+    for (int i = 0; i < n; i++) {
+      std::lock_guard<std::mutex> guard(latch);
+      replacer->Insert(base + (i * 7919) % n);
+    }
+  });
+  bench.Run("victim", full_replacer, [&](int, int64_t n) {
+    int value;
+    for (int i = 0; i < n; i++) {
+      std::lock_guard<std::mutex> guard(latch);
+      replacer->Victim(value);
+    }
+  });
+  bench.Run("erase", full_replacer, [&](int tid, int64_t n) {
+    int base = tid * n;
+    for (int i = 0; i < n; i++) {
+      std::lock_guard<std::mutex> guard(latch);
+      replacer->Erase(base + i);
+    }
+  });
+  return 0;
+}
@@ -0,0 +1,120 @@
+/**
+ * rwmutex_bench.cpp
+ *
+ * Lock + unlock of the reader-writer latches, the counter workload of
+ * rwmutex_test: every thread reads a shared counter under the read latch and
+ * every write_ratio-th operation adds to it under the write latch.
+ * "condvar" is the previous std::mutex + condition variable RWMutex, kept as
+ * the baseline, "shared_timed" is std::shared_timed_mutex.
+ */
+
+#include <climits>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+#include "common/micro_bench.h"
+#include "common/rwmutex.h"
+
+namespace cmudb {
+
+// RWMutex before the atomic fast path
+class CondVarRWMutex {
+  static const uint32_t max_readers_ = UINT_MAX;
+
+public:
+  void WLock() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (writer_entered_)
+      reader_.wait(lock);
+    writer_entered_ = true;
+    while (reader_count_ > 0)
+      writer_.wait(lock);
+  }
+
+  void WUnlock() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    writer_entered_ = false;
+    reader_.notify_all();
+  }
+
+  void RLock() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (writer_entered_ || reader_count_ == max_readers_)
+      reader_.wait(lock);
+    reader_count_++;
+  }
+
+  void RUnlock() {
+    std::lock_guard<std::mutex> guard(mutex_);
+    reader_count_--;
+    if (writer_entered_) {
+      if (reader_count_ == 0)
+        writer_.notify_one();
+    } else {
+      if (reader_count_ == max_readers_ - 1)
+        reader_.notify_one();
+    }
+  }
+
+private:
+  std::mutex mutex_;
+  std::condition_variable writer_;
+  std::condition_variable reader_;
+  uint32_t reader_count_ = 0;
+  bool writer_entered_ = false;
+};
+
+class SharedTimedMutex {
+public:
+  void WLock() { mutex_.lock(); }
+  void WUnlock() { mutex_.unlock(); }
+  void RLock() { mutex_.lock_shared(); }
+  void RUnlock() { mutex_.unlock_shared(); }
+
+private:
+  std::shared_timed_mutex mutex_;
+};
+
+template <typename Latch>
+void RunLatch(MicroBench &bench, const std::string &name) {
+  std::unique_ptr<Latch> latch;
+  volatile int64_t counter = 0;
+  auto prepare = [&](int) {
+    latch.reset(new Latch());
+    counter = 0;
+  };
+  for (int write_ratio : {0, 10, 1}) {
+    std::string suffix =
+        write_ratio == 0 ? "read_only"
+                         : (write_ratio == 1 ? "write_only" : "read_90");
+    bench.Run(name + "_" + suffix, prepare, [&, write_ratio](int, int64_t n) {
+      int64_t sum = 0;
+      for (int64_t i = 0; i < n; i++) {
+        if (write_ratio != 0 && i % write_ratio == 0) {
+          latch->WLock();
+          counter = counter + 1;
+          latch->WUnlock();
+        } else {
+          latch->RLock();
+          sum += counter;
+          latch->RUnlock();
+        }
+      }
+      (void)sum;
+    });
+  }
+}
+
+} // namespace cmudb
+
+int main(int argc, char **argv) {
+  using namespace cmudb;
+  MicroBench bench("rwmutex", argc, argv, 1000000);
+  RunLatch<CondVarRWMutex>(bench, "condvar");
+  RunLatch<SharedTimedMutex>(bench, "shared_timed");
+  RunLatch<RWMutex>(bench, "rwmutex");
+  RunLatch<ShardedRWMutex>(bench, "sharded");
+  return 0;
+}
@@ -0,0 +1,39 @@
+/**
+ * lock_manager_bench.cpp
+ *
+ * LockManager acquire + release under 2PL. "private" cases lock a record
+ * no other thread touches, "shared_hot" has every thread share-lock the
+ * same record.
+ */
+
+#include <memory>
+
+#include "common/micro_bench.h"
+#include "concurrency/lock_manager.h"
+
+int main(int argc, char **argv) {
+  using namespace cmudb;
+  MicroBench bench("lock_manager", argc, argv);
+  LockManager lock_manager(false);
+
+  auto lock_unlock = [&](bool exclusive, bool hot) {
+    return [&, exclusive, hot](int tid, int64_t n) {
+      Transaction txn(tid);
+      RID rid(hot ? 0 : tid + 1, 0);
+      for (int64_t i = 0; i < n; i++) {
+        // 2PL moves the txn to shrinking on unlock, start it over
+        txn.SetState(TransactionState::GROWING);
+        if (exclusive)
+          lock_manager.LockExclusive(&txn, rid);
+        else
+          lock_manager.LockShared(&txn, rid);
+        lock_manager.Unlock(&txn, rid);
+      }
+    };
+  };
+
+  bench.Run("exclusive_private", lock_unlock(true, false));
+  bench.Run("shared_private", lock_unlock(false, false));
+  bench.Run("shared_hot", lock_unlock(false, true));
+  return 0;
+}
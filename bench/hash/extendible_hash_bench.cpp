@@ -0,0 +1,50 @@
+/**
+ * extendible_hash_bench.cpp
+ *
+ * ExtendibleHash Find/Insert/Remove, threads work on disjoint key ranges
+ * of one shared table.
+ */
+
+#include <memory>
+
+#include "common/micro_bench.h"
+#include "hash/extendible_hash.h"
+
+int main(int argc, char **argv) {
+  using namespace cmudb;
+  MicroBench bench("extendible_hash", argc, argv);
+  int64_t ops = bench.Ops();
+  int bucket_size = bench.Flags().GetInt("bucket_size", 64);
+  std::unique_ptr<ExtendibleHash<int, int>> table;
+
+  auto empty_table = [&](int) {
+    table.reset(new ExtendibleHash<int, int>(bucket_size));
+  };
+  auto full_table = [&](int threads) {
+    empty_table(threads);
+    for (int i = 0; i < ops * threads; i++)
+      table->Insert(i, i);
+  };
+
+  bench.Run("insert", empty_table, [&](int tid, int64_t n) {
+    int base = tid * n;
+    for (int i = 0; i < n; i++)
+      table->Insert(base + i, i);
+  });
+  bench.Run("find_hit", full_table, [&](int tid, int64_t n) {
+    int base = tid * n, value;
+    for (int i = 0; i < n; i++)
+      table->Find(base + i, value);
+  });
+  bench.Run("find_miss", full_table, [&](int tid, int64_t n) {
+    int base = -(tid + 1) * n, value;
+    for (int i = 0; i < n; i++)
+      table->Find(base + i, value);
+  });
+  bench.Run("remove", full_table, [&](int tid, int64_t n) {
+    int base = tid * n;
+    for (int i = 0; i < n; i++)
+      table->Remove(base + i);
+  });
+  return 0;
+}
@@ -0,0 +1,128 @@
+/**
+ * bench_util.h
+ *
+ * Helpers shared by the benchmark drivers: "--name=value" command line flags,
+ * a monotonic clock and a latency recorder reporting percentiles.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace cmudb {
+
+class BenchFlags {
+public:
+  BenchFlags(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+      std::string arg(argv[i]);
+      if (arg.compare(0, 2, "--") != 0)
+        continue;
+      arg = arg.substr(2);
+      std::string::size_type n = arg.find('=');
+      if (n == std::string::npos)
+        flags_[arg] = "true";
+      else
+        flags_[arg.substr(0, n)] = arg.substr(n + 1);
+    }
+  }
+
+  inline bool Has(const std::string &name) const {
+    return flags_.find(name) != flags_.end();
+  }
+
+  inline std::string GetString(const std::string &name,
+                               const std::string &default_value) const {
+    auto it = flags_.find(name);
+    return it == flags_.end() ? default_value : it->second;
+  }
+
+  inline int64_t GetInt(const std::string &name, int64_t default_value) const {
+    auto it = flags_.find(name);
+    return it == flags_.end() ? default_value : std::stoll(it->second);
+  }
+
+  inline double GetDouble(const std::string &name, double default_value) const {
+    auto it = flags_.find(name);
+    return it == flags_.end() ? default_value : std::stod(it->second);
+  }
+
+  // comma seperated list of integers, e.g. --threads=1,2,4
+  std::vector<int> GetIntList(const std::string &name,
+                              const std::vector<int> &default_value) const {
+    auto it = flags_.find(name);
+    if (it == flags_.end())
+      return default_value;
+    std::vector<int> result;
+    std::string::size_type start = 0;
+    while (start <= it->second.size()) {
+      std::string::size_type end = it->second.find(',', start);
+      if (end == std::string::npos)
+        end = it->second.size();
+      if (end > start)
+        result.push_back(std::stoi(it->second.substr(start, end - start)));
+      start = end + 1;
+    }
+    return result;
+  }
+
+private:
+  std::map<std::string, std::string> flags_;
+};
+
+// nanoseconds from a monotonic clock
+inline uint64_t NowNanos() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+/*
+ * Keeps every sample, each worker thread owns one recorder and the driver
+ * merges them once the run is over.
+ */
+class LatencyRecorder {
+public:
+  inline void Record(uint64_t nanos) {
+    samples_.push_back(nanos);
+    sorted_ = false;
+  }
+
+  void Merge(const LatencyRecorder &other) {
+    samples_.insert(samples_.end(), other.samples_.begin(),
+                    other.samples_.end());
+    sorted_ = false;
+  }
+
+  inline size_t Count() const { return samples_.size(); }
+
+  // p in [0, 100], returns nanoseconds
+  uint64_t Percentile(double p) {
+    if (samples_.empty())
+      return 0;
+    if (!sorted_) {
+      std::sort(samples_.begin(), samples_.end());
+      sorted_ = true;
+    }
+    size_t idx = static_cast<size_t>(p / 100.0 * (samples_.size() - 1) + 0.5);
+    return samples_[std::min(idx, samples_.size() - 1)];
+  }
+
+  void Clear() {
+    samples_.clear();
+    sorted_ = false;
+  }
+
+private:
+  std::vector<uint64_t> samples_;
+  bool sorted_ = false;
+};
+
+} // namespace cmudb
@@ -0,0 +1,159 @@
+/**
+ * micro_bench.h
+ *
+ * Harness for the micro benchmarks. A case is a body that runs a number of
+ * operations on one thread; the harness runs it for every thread count in
+ * --threads, and reports ns/op (wall time of a thread divided by its ops)
+ * and heap allocations/op, as a table or as JSON with --json.
+ *
+ * Allocations are counted by replacing the global operator new, so include
+ * this header from the benchmark's only translation unit.
+ *
+ * common flags: --threads=1,2,4 --ops=N --filter=substring --json
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/bench_util.h"
+
+namespace cmudb {
+// number of operator new calls made by the current thread
+static thread_local uint64_t thread_allocations = 0;
+} // namespace cmudb
+
+void *operator new(size_t size) {
+  cmudb::thread_allocations++;
+  void *ptr = std::malloc(size == 0 ? 1 : size);
+  if (ptr == nullptr)
+    throw std::bad_alloc();
+  return ptr;
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+
+namespace cmudb {
+
+class MicroBench {
+public:
+  MicroBench(const std::string &name, int argc, char **argv,
+             int64_t default_ops = 100000)
+      : name_(name), flags_(argc, argv) {
+    threads_ = flags_.GetIntList("threads", {1, 2, 4});
+    ops_ = flags_.GetInt("ops", default_ops);
+    filter_ = flags_.GetString("filter", "");
+    json_ = flags_.Has("json");
+    if (!json_)
+      std::printf("%-36s %8s %12s %12s %14s\n", name_.c_str(), "threads",
+                  "ops/thread", "ns/op", "allocs/op");
+  }
+
+  ~MicroBench() {
+    if (!json_)
+      return;
+    std::printf("{\"benchmark\": \"%s\", \"results\": [", name_.c_str());
+    for (size_t i = 0; i < results_.size(); i++) {
+      const Result &r = results_[i];
+      std::printf("%s\n  {\"case\": \"%s\", \"threads\": %d, \"ops\": %lld, "
+                  "\"ns_per_op\": %.2f, \"allocs_per_op\": %.3f}",
+                  i == 0 ? "" : ",", r.name.c_str(), r.threads,
+                  (long long)r.ops, r.ns_per_op, r.allocs_per_op);
+    }
+    std::printf("\n]}\n");
+  }
+
+  const BenchFlags &Flags() const { return flags_; }
+
+  // operations each thread runs per case
+  int64_t Ops() const { return ops_; }
+
+  /*
+   * prepare(threads) rebuilds the shared state before each thread count and
+   * is not timed, body(thread_id, ops) is timed
+   */
+  void Run(const std::string &name, const std::function<void(int)> &prepare,
+           const std::function<void(int, int64_t)> &body,
+           int max_threads = 0) {
+    if (!filter_.empty() && name.find(filter_) == std::string::npos)
+      return;
+    for (int threads : threads_) {
+      if (max_threads > 0 && threads > max_threads)
+        continue;
+      if (prepare)
+        prepare(threads);
+      RunThreads(name, threads, body);
+    }
+  }
+
+  void Run(const std::string &name,
+           const std::function<void(int, int64_t)> &body,
+           int max_threads = 0) {
+    Run(name, nullptr, body, max_threads);
+  }
+
+private:
+  struct Result {
+    std::string name;
+    int threads;
+    int64_t ops;
+    double ns_per_op;
+    double allocs_per_op;
+  };
+
+  void RunThreads(const std::string &name, int threads,
+                  const std::function<void(int, int64_t)> &body) {
+    std::vector<uint64_t> nanos(threads), allocs(threads);
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < threads; i++) {
+      workers.emplace_back([&, i] {
+        ready++;
+        while (!go.load())
+          std::this_thread::yield();
+        uint64_t alloc_start = thread_allocations;
+        uint64_t start = NowNanos();
+        body(i, ops_);
+        nanos[i] = NowNanos() - start;
+        allocs[i] = thread_allocations - alloc_start;
+      });
+    }
+    while (ready.load() != threads)
+      std::this_thread::yield();
+    go = true;
+    for (auto &t : workers)
+      t.join();
+
+    Result result{name, threads, ops_, 0, 0};
+    for (int i = 0; i < threads; i++) {
+      result.ns_per_op += static_cast<double>(nanos[i]) / ops_;
+      result.allocs_per_op += static_cast<double>(allocs[i]) / ops_;
+    }
+    result.ns_per_op /= threads;
+    result.allocs_per_op /= threads;
+    results_.push_back(result);
+    if (!json_)
+      std::printf("%-36s %8d %12lld %12.1f %14.3f\n", name.c_str(), threads,
+                  (long long)ops_, result.ns_per_op, result.allocs_per_op);
+  }
+
+  std::string name_;
+  BenchFlags flags_;
+  std::vector<int> threads_;
+  int64_t ops_;
+  std::string filter_;
+  bool json_;
+  std::vector<Result> results_;
+};
+
+} // namespace cmudb
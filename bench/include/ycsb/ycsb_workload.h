@@ -0,0 +1,197 @@
+/**
+ * ycsb_workload.h
+ *
+ * Core YCSB workloads A-F and the request distributions used to pick keys.
+ * Keys are integers in [0, record_count), workloads D and E append new keys
+ * at the end of the key space while they run.
+ *
+ * A: 50% read, 50% update             (zipfian)
+ * B: 95% read, 5% update              (zipfian)
+ * C: 100% read                        (zipfian)
+ * D: 95% read, 5% insert              (latest)
+ * E: 95% short scan, 5% insert        (zipfian)
+ * F: 50% read, 50% read-modify-write  (zipfian)
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+
+#include "common/exception.h"
+
+namespace cmudb {
+
+enum class YcsbOp { READ = 0, UPDATE, INSERT, SCAN, READ_MODIFY_WRITE };
+
+static const char *YcsbOpNames[] = {"read", "update", "insert", "scan",
+                                    "rmw"};
+
+struct YcsbWorkload {
+  char name;
+  double read_proportion;
+  double update_proportion;
+  double insert_proportion;
+  double scan_proportion;
+  double rmw_proportion;
+  // D reads the most recently inserted keys
+  bool latest;
+
+  static YcsbWorkload Get(char name) {
+    switch (name) {
+    case 'A':
+    case 'a':
+      return {'A', 0.50, 0.50, 0, 0, 0, false};
+    case 'B':
+    case 'b':
+      return {'B', 0.95, 0.05, 0, 0, 0, false};
+    case 'C':
+    case 'c':
+      return {'C', 1.00, 0, 0, 0, 0, false};
+    case 'D':
+    case 'd':
+      return {'D', 0.95, 0, 0.05, 0, 0, true};
+    case 'E':
+    case 'e':
+      return {'E', 0, 0, 0.05, 0.95, 0, false};
+    case 'F':
+    case 'f':
+      return {'F', 0.50, 0, 0, 0, 0.50, false};
+    default:
+      throw Exception(EXCEPTION_TYPE_MISMATCH_TYPE,
+                      std::string("unknown ycsb workload ") + name);
+    }
+  }
+
+  YcsbOp NextOp(double coin) const {
+    if ((coin -= read_proportion) < 0)
+      return YcsbOp::READ;
+    if ((coin -= update_proportion) < 0)
+      return YcsbOp::UPDATE;
+    if ((coin -= insert_proportion) < 0)
+      return YcsbOp::INSERT;
+    if ((coin -= scan_proportion) < 0)
+      return YcsbOp::SCAN;
+    return YcsbOp::READ_MODIFY_WRITE;
+  }
+};
+
+// FNV-1a over the 8 bytes of the value, used to scatter zipfian hot keys
+inline uint64_t FnvHash64(uint64_t val) {
+  uint64_t hash = 0xCBF29CE484222325ULL;
+  for (int i = 0; i < 8; i++) {
+    hash ^= val & 0xff;
+    hash *= 1099511628211ULL;
+    val >>= 8;
+  }
+  return hash;
+}
+
+/*
+ * Zipfian generator from Gray et al. "Quickly Generating Billion-Record
+ * Synthetic Databases", as used by YCSB. Item 0 is the most popular one.
+ * zeta(n) is only computed once, the generator is then shared read-only by
+ * every worker thread (each thread brings its own random engine).
+ */
+class ZipfianGenerator {
+public:
+  ZipfianGenerator(uint64_t items, double theta = 0.99)
+      : items_(items), theta_(theta) {
+    zetan_ = Zeta(items_, theta_);
+    double zeta2 = Zeta(2, theta_);
+    alpha_ = 1.0 / (1.0 - theta_);
+    eta_ = (1 - std::pow(2.0 / items_, 1 - theta_)) / (1 - zeta2 / zetan_);
+  }
+
+  uint64_t Next(std::mt19937_64 &rng) const {
+    double u = std::uniform_real_distribution<double>(0, 1)(rng);
+    double uz = u * zetan_;
+    if (uz < 1.0)
+      return 0;
+    if (uz < 1.0 + std::pow(0.5, theta_))
+      return 1;
+    uint64_t ret =
+        static_cast<uint64_t>(items_ * std::pow(eta_ * u - eta_ + 1, alpha_));
+    return ret >= items_ ? items_ - 1 : ret;
+  }
+
+private:
+  static double Zeta(uint64_t n, double theta) {
+    double sum = 0;
+    for (uint64_t i = 0; i < n; i++)
+      sum += 1 / std::pow(i + 1, theta);
+    return sum;
+  }
+
+  uint64_t items_;
+  double theta_;
+  double zetan_;
+  double alpha_;
+  double eta_;
+};
+
+/*
+ * Picks keys for the request distribution of a run. record_count grows as
+ * D/E insert new records, uniform and zipfian keys are drawn from the keys
+ * loaded up front (as YCSB does) while latest skews towards the newest key.
+ * Like YCSB's acknowledged counter, latest only sees keys below the first
+ * insert that has not completed yet, a key handed out by NextInsertKey is
+ * only readable once Acknowledge has been called for it and every key before.
+ */
+class KeyChooser {
+public:
+  KeyChooser(const std::string &distribution, uint64_t record_count)
+      : zipfian_(distribution == "zipfian"), record_count_(record_count),
+        acknowledged_(record_count), loaded_(record_count),
+        generator_(record_count) {
+    if (distribution != "zipfian" && distribution != "uniform")
+      throw Exception(EXCEPTION_TYPE_MISMATCH_TYPE,
+                      "distribution must be uniform or zipfian");
+  }
+
+  // key of an existing record
+  uint64_t Next(std::mt19937_64 &rng, bool latest) const {
+    if (latest) {
+      uint64_t max = acknowledged_.load();
+      uint64_t offset = generator_.Next(rng);
+      return offset >= max ? 0 : max - 1 - offset;
+    }
+    if (zipfian_)
+      return FnvHash64(generator_.Next(rng)) % loaded_;
+    return std::uniform_int_distribution<uint64_t>(0, loaded_ - 1)(rng);
+  }
+
+  // key for a new record, call Acknowledge once it has been inserted
+  inline uint64_t NextInsertKey() { return record_count_++; }
+
+  void Acknowledge(uint64_t key) {
+    std::lock_guard<std::mutex> guard(pending_latch_);
+    pending_.insert(key);
+    uint64_t next = acknowledged_.load();
+    while (!pending_.empty() && *pending_.begin() == next) {
+      pending_.erase(pending_.begin());
+      next++;
+    }
+    acknowledged_.store(next);
+  }
+
+  // number of records readers may pick from
+  inline uint64_t RecordCount() const { return acknowledged_.load(); }
+
+private:
+  bool zipfian_;
+  std::atomic<uint64_t> record_count_;
+  // every key below is inserted, pending_ holds completed keys above it
+  std::atomic<uint64_t> acknowledged_;
+  std::mutex pending_latch_;
+  std::set<uint64_t> pending_;
+  uint64_t loaded_;
+  ZipfianGenerator generator_;
+};
+
+} // namespace cmudb
@@ -0,0 +1,94 @@
+/**
+ * b_epsilon_tree_bench.cpp
+ *
+ * Random inserts and point lookups on a BEpsilonTree against a BPlusTree,
+ * with 8 byte keys on index sized pages and a buffer pool far smaller than
+ * the tree, so leaf writes go to disk. Threads own disjoint key ranges.
+ *
+ * extra flags: --pool_size=N (pages, default 64)
+ *              --page_size=N (bytes, default INDEX_PAGE_SIZE)
+ */
+
+#include <cstdio>
+#include <memory>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/micro_bench.h"
+#include "index/b_epsilon_tree.h"
+#include "index/b_plus_tree.h"
+
+namespace cmudb {
+
+// visits [0, n) once, in an order that defeats the buffer pool
+inline int64_t Scramble(int64_t i, int64_t n) { return (i * 7919) % n; }
+
+template <typename TreeType>
+void RunTree(MicroBench &bench, const std::string &tree_name, int pool_size,
+             size_t page_size) {
+  const std::string db_file = "b_epsilon_tree_bench.db";
+  Schema key_schema({Column(TypeId::BIGINT, 8, "k")});
+  GenericComparator<8> comparator(&key_schema);
+  std::unique_ptr<DiskManager> disk_manager;
+  std::unique_ptr<BufferPoolManager> bpm;
+  std::unique_ptr<TreeType> tree;
+  int64_t ops = bench.Ops();
+
+  auto insert = [&](int tid, int64_t n) {
+    Transaction txn(tid);
+    GenericKey<8> key;
+    for (int64_t i = 0; i < n; i++) {
+      int64_t k = tid * n + Scramble(i, n);
+      key.SetFromInteger(k);
+      tree->Insert(key, RID(k >> 32, k & 0xFFFFFFFF), &txn);
+    }
+  };
+  auto empty_tree = [&](int) {
+    tree.reset();
+    bpm.reset();
+    disk_manager.reset();
+    remove(db_file.c_str());
+    disk_manager.reset(new DiskManager(db_file, page_size));
+    bpm.reset(new BufferPoolManager(pool_size, disk_manager.get()));
+    // root page ids are recorded in the header page
+    page_id_t header_page_id;
+    bpm->NewPage(header_page_id);
+    bpm->UnpinPage(header_page_id, true);
+    tree.reset(new TreeType("bench", bpm.get(), comparator));
+  };
+  auto full_tree = [&](int threads) {
+    empty_tree(threads);
+    for (int i = 0; i < threads; i++)
+      insert(i, ops);
+  };
+
+  bench.Run("insert_" + tree_name, empty_tree, insert);
+  bench.Run("get_" + tree_name, full_tree, [&](int tid, int64_t n) {
+    Transaction txn(tid);
+    GenericKey<8> key;
+    std::vector<RID> result;
+    for (int64_t i = 0; i < n; i++) {
+      key.SetFromInteger(tid * n + Scramble(i, n));
+      result.clear();
+      tree->GetValue(key, result, &txn);
+    }
+  });
+
+  tree.reset();
+  bpm.reset();
+  disk_manager.reset();
+  remove(db_file.c_str());
+}
+
+} // namespace cmudb
+
+int main(int argc, char **argv) {
+  using namespace cmudb;
+  MicroBench bench("b_epsilon_tree", argc, argv, 200000);
+  int pool_size = bench.Flags().GetInt("pool_size", 64);
+  size_t page_size = bench.Flags().GetInt("page_size", INDEX_PAGE_SIZE);
+  RunTree<BPlusTree<GenericKey<8>, RID, GenericComparator<8>>>(
+      bench, "bplus", pool_size, page_size);
+  RunTree<BEpsilonTree<GenericKey<8>, RID, GenericComparator<8>>>(
+      bench, "bepsilon", pool_size, page_size);
+  return 0;
+}
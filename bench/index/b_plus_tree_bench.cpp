@@ -0,0 +1,156 @@
+/**
+ * b_plus_tree_bench.cpp
+ *
+ * BPlusTree Insert/GetValue/GetValues/iterator scan and delete/insert churn
+ * for every GenericKey size. Each thread owns a disjoint key range of one
+ * shared tree and visits it in a scrambled order.
+ *
+ * extra flags: --pool_size=N (pages, default 4096)
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/micro_bench.h"
+#include "index/b_plus_tree.h"
+
+namespace cmudb {
+
+// visits [0, n) once, in an order that defeats the leaf cache
+inline int64_t Scramble(int64_t i, int64_t n) { return (i * 7919) % n; }
+
+template <size_t KeySize>
+void RunTree(MicroBench &bench, int pool_size) {
+  typedef BPlusTree<GenericKey<KeySize>, RID, GenericComparator<KeySize>>
+      TreeType;
+  const std::string db_file = "b_plus_tree_bench.db";
+  const std::string suffix = "_key" + std::to_string(KeySize);
+  // the key is an integer, wider keys are zero padded
+  TypeId type = KeySize == 4 ? TypeId::INTEGER : TypeId::BIGINT;
+  Schema key_schema({Column(type, Type::GetTypeSize(type), "k")});
+  GenericComparator<KeySize> comparator(&key_schema);
+  std::unique_ptr<DiskManager> disk_manager;
+  std::unique_ptr<BufferPoolManager> bpm;
+  std::unique_ptr<TreeType> tree;
+  int64_t ops = bench.Ops();
+
+  auto insert = [&](int tid, int64_t n) {
+    Transaction txn(tid);
+    GenericKey<KeySize> key;
+    for (int64_t i = 0; i < n; i++) {
+      int64_t k = tid * n + Scramble(i, n);
+      key.SetFromInteger(k);
+      tree->Insert(key, RID(k >> 32, k & 0xFFFFFFFF), &txn);
+    }
+  };
+  auto empty_tree = [&](int) {
+    tree.reset();
+    bpm.reset();
+    disk_manager.reset();
+    remove(db_file.c_str());
+    disk_manager.reset(new DiskManager(db_file));
+    bpm.reset(new BufferPoolManager(pool_size, disk_manager.get()));
+    // root page ids are recorded in the header page
+    page_id_t header_page_id;
+    bpm->NewPage(header_page_id);
+    bpm->UnpinPage(header_page_id, true);
+    tree.reset(new TreeType("bench", bpm.get(), comparator));
+  };
+  auto full_tree = [&](int threads) {
+    empty_tree(threads);
+    for (int i = 0; i < threads; i++)
+      insert(i, ops);
+  };
+
+  bench.Run("insert" + suffix, empty_tree, insert);
+  bench.Run("get" + suffix, full_tree, [&](int tid, int64_t n) {
+    Transaction txn(tid);
+    GenericKey<KeySize> key;
+    std::vector<RID> result;
+    for (int64_t i = 0; i < n; i++) {
+      key.SetFromInteger(tid * n + Scramble(i, n));
+      result.clear();
+      tree->GetValue(key, result, &txn);
+    }
+  });
+  // delete/insert churn over ascending-built, half full leaves: eager
+  // merging against a 25% low water mark
+  for (int threshold : {50, 25}) {
+    auto sequential_tree = [&](int threads) {
+      empty_tree(threads);
+      tree->SetMergeThreshold(threshold);
+      Transaction txn(0);
+      GenericKey<KeySize> key;
+      for (int64_t k = 0; k < threads * ops; k++) {
+        key.SetFromInteger(k);
+        tree->Insert(key, RID(k >> 32, k & 0xFFFFFFFF), &txn);
+      }
+    };
+    bench.Run("churn_merge" + std::to_string(threshold) + suffix,
+              sequential_tree, [&](int tid, int64_t n) {
+                Transaction txn(tid);
+                GenericKey<KeySize> key;
+                for (int64_t i = 0; i < n; i++) {
+                  int64_t k = tid * n + Scramble(i, n);
+                  key.SetFromInteger(k);
+                  tree->Remove(key, &txn);
+                  tree->Insert(key, RID(k >> 32, k & 0xFFFFFFFF), &txn);
+                }
+              });
+  }
+  // an IN list: ascending keys, probed one by one or in one pass
+  const int64_t in_list = 256;
+  auto probe = [&](int tid, int64_t n, bool batched) {
+    Transaction txn(tid);
+    std::vector<GenericKey<KeySize>> keys(in_list);
+    std::vector<RID> result;
+    for (int64_t i = 0; i < n; i += in_list) {
+      for (int64_t j = 0; j < in_list; j++)
+        keys[j].SetFromInteger(tid * n + (i + j * 3) % n);
+      std::sort(keys.begin(), keys.end(),
+                [&](const GenericKey<KeySize> &a,
+                    const GenericKey<KeySize> &b) {
+                  return comparator(a, b) < 0;
+                });
+      result.clear();
+      if (batched) {
+        tree->GetValues(keys, result);
+      } else {
+        for (auto &key : keys)
+          tree->GetValue(key, result, &txn);
+      }
+    }
+  };
+  bench.Run("probe_each" + suffix, full_tree,
+            [&](int tid, int64_t n) { probe(tid, n, false); });
+  bench.Run("probe_batch" + suffix, full_tree,
+            [&](int tid, int64_t n) { probe(tid, n, true); });
+  bench.Run("scan" + suffix, full_tree, [&](int tid, int64_t n) {
+    GenericKey<KeySize> key;
+    key.SetFromInteger(tid * n);
+    int64_t i = 0;
+    for (auto it = tree->Begin(key); !it.isEnd() && i < n; ++it, ++i)
+      (*it).second.GetSlotNum();
+  });
+
+  tree.reset();
+  bpm.reset();
+  disk_manager.reset();
+  remove(db_file.c_str());
+}
+
+} // namespace cmudb
+
+int main(int argc, char **argv) {
+  using namespace cmudb;
+  MicroBench bench("b_plus_tree", argc, argv, 20000);
+  int pool_size = bench.Flags().GetInt("pool_size", 4096);
+  RunTree<4>(bench, pool_size);
+  RunTree<8>(bench, pool_size);
+  RunTree<16>(bench, pool_size);
+  RunTree<32>(bench, pool_size);
+  RunTree<64>(bench, pool_size);
+  return 0;
+}
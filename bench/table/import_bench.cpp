@@ -0,0 +1,103 @@
+/**
+ * import_bench.cpp
+ *
+ * Loading a CSV file of (int, varchar, double) rows into a table heap, row
+ * by row through TableHeap::InsertTuple and by BulkLoader with a range of
+ * worker counts. Reports rows/s and GB/min of CSV. InsertTuple walks the
+ * heap from its first page, the row by row load stops after insert_rows.
+ *
+ * usage: import_bench [--rows=N] [--insert_rows=N] [--workers=1,2,4]
+ *                     [--pool_size=N]
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/bench_util.h"
+#include "table/bulk_loader.h"
+#include "table/table_heap.h"
+
+namespace cmudb {
+
+static const char *kDbFile = "import_bench.db";
+static const char *kCsvFile = "import_bench.csv";
+
+static void Report(const char *name, int64_t rows, uint64_t bytes,
+                   uint64_t nanos) {
+  double seconds = nanos / 1e9;
+  std::printf("%-16s %10.0f rows/s %8.3f GB/min\n", name, rows / seconds,
+              bytes / 1e9 / seconds * 60);
+}
+
+} // namespace cmudb
+
+int main(int argc, char **argv) {
+  using namespace cmudb;
+  BenchFlags flags(argc, argv);
+  if (flags.Has("help")) {
+    std::printf("usage: %s [--rows=N] [--insert_rows=N] [--workers=1,2,4] "
+                "[--pool_size=N]\n",
+                argv[0]);
+    return 0;
+  }
+  int64_t rows = flags.GetInt("rows", 500000);
+  int64_t insert_rows = flags.GetInt("insert_rows", 2000);
+  int pool_size = flags.GetInt("pool_size", 64);
+  std::vector<int> workers = flags.GetIntList("workers", {1, 2, 4});
+
+  Schema schema({Column(TypeId::INTEGER, 4, "a"),
+                 Column(TypeId::VARCHAR, 32, "b"),
+                 Column(TypeId::DECIMAL, 8, "c")});
+  {
+    std::ofstream file(kCsvFile, std::ios::binary);
+    for (int64_t i = 0; i < rows; i++)
+      file << i << ",value " << i % 1000 << "," << i / 4.0 << "\n";
+  }
+  std::printf("import: %lld rows, page size %d\n", (long long)rows,
+              PAGE_SIZE);
+
+  auto run = [&](const char *name, int worker_count) {
+    remove(kDbFile);
+    DiskManager disk_manager(kDbFile);
+    BufferPoolManager buffer_pool_manager(pool_size, &disk_manager);
+    Transaction txn(0);
+    TableHeap table(&buffer_pool_manager, nullptr, nullptr, &txn);
+    int64_t loaded = 0;
+    uint64_t loaded_bytes = 0;
+    uint64_t start = NowNanos();
+    if (worker_count == 0) {
+      // what INSERT does per row, the file parsed on one thread
+      std::ifstream file(kCsvFile);
+      std::string a, b, c;
+      RID rid;
+      while (loaded < insert_rows && std::getline(file, a, ',') &&
+             std::getline(file, b, ',') && std::getline(file, c)) {
+        Tuple tuple({Value(TypeId::INTEGER, std::stoi(a)),
+                     Value(TypeId::VARCHAR, b),
+                     Value(TypeId::DECIMAL, std::stod(c))},
+                    &schema);
+        table.InsertTuple(tuple, rid, &txn);
+        loaded++;
+        loaded_bytes += a.size() + b.size() + c.size() + 3;
+      }
+    } else {
+      BulkLoader loader(&schema, &table, &buffer_pool_manager, &disk_manager);
+      loaded = loader.Load(kCsvFile, worker_count);
+      loaded_bytes = loader.GetBytes();
+    }
+    buffer_pool_manager.FlushAllPages();
+    Report(name, loaded, loaded_bytes, NowNanos() - start);
+  };
+
+  run("insert", 0);
+  for (int worker_count : workers) {
+    std::string name = "bulk_load/" + std::to_string(worker_count);
+    run(name.c_str(), worker_count);
+  }
+  remove(kDbFile);
+  remove(kCsvFile);
+  return 0;
+}
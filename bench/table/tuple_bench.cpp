@@ -0,0 +1,98 @@
+/**
+ * tuple_bench.cpp
+ *
+ * Tuple construction from values, SerializeTo/DeserializeFrom and column
+ * reads on a (int, bigint, decimal, varchar) row, through Value and typed in
+ * place. The filter runs compare a
+ * bigint predicate over a batch, through Values and through TupleFilter.
+ */
+
+#include <vector>
+
+#include "common/micro_bench.h"
+#include "table/tuple.h"
+#include "table/tuple_filter.h"
+
+int main(int argc, char **argv) {
+  using namespace cmudb;
+  MicroBench bench("tuple", argc, argv);
+  int varchar_len = bench.Flags().GetInt("varchar_len", 32);
+
+  Schema schema({Column(TypeId::INTEGER, 4, "a"), Column(TypeId::BIGINT, 8, "b"),
+                 Column(TypeId::DECIMAL, 8, "c"),
+                 Column(TypeId::VARCHAR, varchar_len, "d")});
+  std::vector<Value> values{Value(TypeId::INTEGER, (int32_t)1),
+                            Value(TypeId::BIGINT, (int64_t)2),
+                            Value(TypeId::DECIMAL, 3.0),
+                            Value(TypeId::VARCHAR, std::string(varchar_len, 'x'))};
+  const Tuple tuple(values, &schema);
+
+  bench.Run("construct", [&](int, int64_t n) {
+    for (int64_t i = 0; i < n; i++) {
+      Tuple t(values, &schema);
+      (void)t.GetLength();
+    }
+  });
+  bench.Run("serialize", [&](int, int64_t n) {
+    std::vector<char> buffer(tuple.GetLength() + sizeof(int32_t));
+    for (int64_t i = 0; i < n; i++)
+      tuple.SerializeTo(buffer.data());
+  });
+  bench.Run("deserialize", [&](int, int64_t n) {
+    std::vector<char> buffer(tuple.GetLength() + sizeof(int32_t));
+    tuple.SerializeTo(buffer.data());
+    Tuple t;
+    for (int64_t i = 0; i < n; i++)
+      t.DeserializeFrom(buffer.data());
+  });
+  bench.Run("get_value_fixed", [&](int, int64_t n) {
+    int64_t sum = 0;
+    for (int64_t i = 0; i < n; i++)
+      sum += tuple.GetValue(&schema, 1).GetAs<int64_t>();
+    (void)sum;
+  });
+  bench.Run("get_value_varchar", [&](int, int64_t n) {
+    size_t len = 0;
+    for (int64_t i = 0; i < n; i++)
+      len += tuple.GetValue(&schema, 3).GetLength();
+    (void)len;
+  });
+  bench.Run("get_typed_fixed", [&](int, int64_t n) {
+    int64_t sum = 0;
+    for (int64_t i = 0; i < n; i++)
+      sum += tuple.Get<int64_t>(&schema, 1);
+    (void)sum;
+  });
+  bench.Run("get_typed_varchar", [&](int, int64_t n) {
+    size_t first = 0;
+    for (int64_t i = 0; i < n; i++)
+      first += tuple.Get<const char *>(&schema, 3)[0];
+    (void)first;
+  });
+  // op is a batch of 128 rows, half of them selected
+  std::vector<Tuple> batch;
+  for (int i = 0; i < 128; i++) {
+    values[1] = Value(TypeId::BIGINT, (int64_t)i);
+    batch.emplace_back(values, &schema);
+  }
+  Value constant(TypeId::BIGINT, (int64_t)64);
+  bench.Run("filter_value", [&](int, int64_t n) {
+    std::vector<int> selection;
+    for (int64_t i = 0; i < n; i++) {
+      selection.clear();
+      for (size_t j = 0; j < batch.size(); j++) {
+        if (batch[j].GetValue(&schema, 1).CompareLessThan(constant) ==
+            CMP_TRUE)
+          selection.push_back(j);
+      }
+    }
+  });
+  bench.Run("filter_batch", [&](int, int64_t n) {
+    TupleFilter filter(&schema);
+    filter.AddPredicate(1, FilterOp::LT, constant);
+    std::vector<int> selection;
+    for (int64_t i = 0; i < n; i++)
+      filter.Select(batch, selection);
+  });
+  return 0;
+}
@@ -0,0 +1,78 @@
+/**
+ * value_bench.cpp
+ *
+ * Value comparisons through the type subsystem, for the types index keys
+ * are made of, against CompareRaw on the stored values.
+ */
+
+#include <string>
+#include <vector>
+
+#include "common/micro_bench.h"
+#include "type/type_traits.h"
+#include "type/value.h"
+
+namespace cmudb {
+
+void RunCompare(MicroBench &bench, const std::string &name,
+                const std::vector<Value> &values) {
+  size_t mask = values.size() - 1;
+  bench.Run("less_than_" + name, [&](int, int64_t n) {
+    int hits = 0;
+    for (int64_t i = 0; i < n; i++)
+      hits += values[i & mask].CompareLessThan(values[(i + 1) & mask]) ==
+              CMP_TRUE;
+    (void)hits;
+  });
+  bench.Run("equals_" + name, [&](int, int64_t n) {
+    int hits = 0;
+    for (int64_t i = 0; i < n; i++)
+      hits += values[i & mask].CompareEquals(values[(i + 1) & mask]) ==
+              CMP_TRUE;
+    (void)hits;
+  });
+
+  // the values as tuples and keys store them
+  const size_t stride = 64;
+  std::vector<char> storage(values.size() * stride);
+  for (size_t i = 0; i < values.size(); i++)
+    values[i].SerializeTo(&storage[i * stride]);
+  TypeId type = values[0].GetTypeId();
+  bench.Run("raw_less_than_" + name, [&](int, int64_t n) {
+    int hits = 0;
+    for (int64_t i = 0; i < n; i++)
+      hits += CompareRaw(type, &storage[(i & mask) * stride],
+                         &storage[((i + 1) & mask) * stride]) < 0;
+    (void)hits;
+  });
+}
+
+} // namespace cmudb
+
+int main(int argc, char **argv) {
+  using namespace cmudb;
+  MicroBench bench("value", argc, argv, 1000000);
+  // power of two so the index can be masked
+  const int count = 1024;
+  std::vector<Value> integers, bigints, decimals, varchars;
+  for (int i = 0; i < count; i++) {
+    int32_t v = (i * 7919) % count;
+    integers.emplace_back(TypeId::INTEGER, v);
+    bigints.emplace_back(TypeId::BIGINT, (int64_t)v);
+    decimals.emplace_back(TypeId::DECIMAL, (double)v);
+    varchars.emplace_back(TypeId::VARCHAR, "key" + std::to_string(v));
+  }
+  RunCompare(bench, "integer", integers);
+  RunCompare(bench, "bigint", bigints);
+  RunCompare(bench, "decimal", decimals);
+  RunCompare(bench, "varchar", varchars);
+
+  bench.Run("construct_varchar", [&](int, int64_t n) {
+    const std::string s(16, 'x');
+    for (int64_t i = 0; i < n; i++) {
+      Value v(TypeId::VARCHAR, s);
+      (void)v.GetLength();
+    }
+  });
+  return 0;
+}
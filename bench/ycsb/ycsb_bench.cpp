@@ -0,0 +1,458 @@
+/**
+ * ycsb_bench.cpp
+ *
+ * YCSB core workloads A-F, either against the storage engine directly
+ * (BufferPoolManager + TableHeap + BPlusTreeIndex + TransactionManager) or
+ * through sqlite and the vtable extension.
+ *
+ * usage: ycsb_bench [--mode=engine|sqlite] [--workload=A..F|all]
+ *                   [--records=N] [--ops=N] [--dist=zipfian|uniform]
+ *                   [--threads=N] [--pool_size=N] [--value_len=N]
+ *                   [--scan_len=N] [--seed=N] [--vtable_lib=libvtable]
+ *
+ * PAGE_SIZE (and the pool size used by the vtable) are compile time
+ * constants, configure with cmake -DPAGE_SIZE=4096 -DBUFFER_POOL_SIZE=1024
+ * to change them.
+ */
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/bench_util.h"
+#include "concurrency/transaction_manager.h"
+#include "index/b_plus_tree_index.h"
+#include "sqlite/sqlite3.h"
+#include "table/table_heap.h"
+#include "ycsb/ycsb_workload.h"
+
+namespace cmudb {
+
+static const int kOpTypes = 5;
+
+struct YcsbOptions {
+  std::string mode;
+  std::string dist;
+  std::string vtable_lib;
+  int64_t records;
+  int64_t ops;
+  int threads;
+  int pool_size;
+  int value_len;
+  int scan_len;
+  uint64_t seed;
+};
+
+struct YcsbThreadStats {
+  LatencyRecorder latency[kOpTypes];
+  int64_t not_found = 0;
+};
+
+static std::string MakeValue(std::mt19937_64 &rng, int len) {
+  std::string value(len, 'a');
+  for (auto &c : value)
+    c = static_cast<char>('a' + rng() % 26);
+  return value;
+}
+
+/*
+ * The storage engine without sqlite on top, every operation runs in a
+ * transaction of its own.
+ */
+class EngineDatabase {
+  typedef GenericKey<8> KeyType;
+  typedef BPlusTreeIndex<KeyType, RID, GenericComparator<8>> IndexType;
+
+public:
+  EngineDatabase(const YcsbOptions &options) : value_len_(options.value_len) {
+    remove(db_file_.c_str());
+    ENABLE_LOGGING = false;
+    disk_manager_.reset(new DiskManager(db_file_));
+    buffer_pool_manager_.reset(
+        new BufferPoolManager(options.pool_size, disk_manager_.get()));
+    // index root ids are recorded in the header page
+    page_id_t header_page_id;
+    buffer_pool_manager_->NewPage(header_page_id);
+    buffer_pool_manager_->UnpinPage(header_page_id, true);
+    lock_manager_.reset(new LockManager(true));
+    transaction_manager_.reset(new TransactionManager(lock_manager_.get()));
+
+    std::vector<Column> columns;
+    columns.emplace_back(TypeId::BIGINT, Type::GetTypeSize(TypeId::BIGINT),
+                         "ycsb_key");
+    columns.emplace_back(TypeId::VARCHAR, value_len_, "field0");
+    schema_.reset(new Schema(columns));
+    key_schema_.reset(Schema::CopySchema(schema_.get(), {0}));
+
+    Transaction *txn = transaction_manager_->Begin();
+    table_heap_.reset(new TableHeap(buffer_pool_manager_.get(),
+                                    lock_manager_.get(), nullptr, txn));
+    transaction_manager_->Commit(txn);
+    delete txn;
+    index_.reset(new IndexType(
+        new IndexMetadata("usertable_pk", "usertable", schema_.get(), {0}),
+        buffer_pool_manager_.get()));
+  }
+
+  ~EngineDatabase() {
+    index_.reset();
+    table_heap_.reset();
+    buffer_pool_manager_.reset();
+    disk_manager_.reset();
+    remove(db_file_.c_str());
+  }
+
+  bool Insert(int64_t key, const std::string &value) {
+    Transaction *txn = transaction_manager_->Begin();
+    Tuple tuple = MakeTuple(key, value);
+    RID rid;
+    bool res = table_heap_->InsertTuple(tuple, rid, txn);
+    if (res)
+      index_->InsertEntry(MakeKey(key), rid, txn);
+    Finish(txn);
+    return res;
+  }
+
+  bool Read(int64_t key) {
+    Transaction *txn = transaction_manager_->Begin();
+    bool res = ReadTuple(key, txn);
+    Finish(txn);
+    return res;
+  }
+
+  bool Update(int64_t key, const std::string &value) {
+    Transaction *txn = transaction_manager_->Begin();
+    bool res = UpdateTuple(key, value, txn);
+    Finish(txn);
+    return res;
+  }
+
+  bool ReadModifyWrite(int64_t key, const std::string &value) {
+    Transaction *txn = transaction_manager_->Begin();
+    bool res = ReadTuple(key, txn) && UpdateTuple(key, value, txn);
+    Finish(txn);
+    return res;
+  }
+
+  bool Scan(int64_t key, int len) {
+    Transaction *txn = transaction_manager_->Begin();
+    KeyType index_key;
+    index_key.SetFromKey(MakeKey(key));
+    // collect the rids first, the iterator keeps a leaf latched
+    std::vector<RID> rids;
+    for (auto it = index_->GetBeginIterator(index_key);
+         !it.isEnd() && (int)rids.size() < len; ++it)
+      rids.push_back((*it).second);
+    for (auto &rid : rids) {
+      Tuple tuple;
+      table_heap_->GetTuple(rid, tuple, txn);
+    }
+    Finish(txn);
+    return !rids.empty();
+  }
+
+private:
+  inline Tuple MakeTuple(int64_t key, const std::string &value) {
+    std::vector<Value> values{Value(TypeId::BIGINT, key),
+                              Value(TypeId::VARCHAR, value)};
+    return Tuple(values, schema_.get());
+  }
+
+  inline Tuple MakeKey(int64_t key) {
+    std::vector<Value> values{Value(TypeId::BIGINT, key)};
+    return Tuple(values, key_schema_.get());
+  }
+
+  bool ReadTuple(int64_t key, Transaction *txn) {
+    std::vector<RID> result;
+    index_->ScanKey(MakeKey(key), result, txn);
+    if (result.empty())
+      return false;
+    Tuple tuple;
+    return table_heap_->GetTuple(result[0], tuple, txn);
+  }
+
+  bool UpdateTuple(int64_t key, const std::string &value, Transaction *txn) {
+    std::vector<RID> result;
+    index_->ScanKey(MakeKey(key), result, txn);
+    if (result.empty())
+      return false;
+    return table_heap_->UpdateTuple(MakeTuple(key, value), result[0], txn);
+  }
+
+  inline void Finish(Transaction *txn) {
+    transaction_manager_->Commit(txn);
+    delete txn;
+  }
+
+  std::string db_file_ = "ycsb_bench.db";
+  int value_len_;
+  std::unique_ptr<DiskManager> disk_manager_;
+  std::unique_ptr<BufferPoolManager> buffer_pool_manager_;
+  std::unique_ptr<LockManager> lock_manager_;
+  std::unique_ptr<TransactionManager> transaction_manager_;
+  std::unique_ptr<Schema> schema_;
+  std::unique_ptr<Schema> key_schema_;
+  std::unique_ptr<TableHeap> table_heap_;
+  std::unique_ptr<IndexType> index_;
+};
+
+/*
+ * The same workload through sqlite. sqlite does not run concurrent
+ * transactions against the vtable, so this mode is single threaded.
+ */
+class SqliteDatabase {
+public:
+  SqliteDatabase(const YcsbOptions &options) {
+    remove(db_file_.c_str());
+    remove("vtable.db");
+    Check(sqlite3_open(db_file_.c_str(), &db_), "open");
+    Check(sqlite3_enable_load_extension(db_, 1), "enable extension");
+    char *err = nullptr;
+    if (sqlite3_load_extension(db_, options.vtable_lib.c_str(), nullptr,
+                               &err) != SQLITE_OK) {
+      std::string msg = err ? err : "unknown error";
+      sqlite3_free(err);
+      throw Exception(EXCEPTION_TYPE_CONNECTION, "load extension: " + msg);
+    }
+    Exec("CREATE VIRTUAL TABLE usertable USING vtable('ycsb_key bigint, "
+         "field0 varchar(" +
+         std::to_string(options.value_len) + ")', 'usertable_pk ycsb_key')");
+    read_ = Prepare("SELECT field0 FROM usertable WHERE ycsb_key = ?");
+    update_ = Prepare("UPDATE usertable SET field0 = ? WHERE ycsb_key = ?");
+    insert_ = Prepare("INSERT INTO usertable VALUES(?, ?)");
+    scan_ = Prepare("SELECT field0 FROM usertable WHERE ycsb_key >= ? "
+                    "ORDER BY ycsb_key LIMIT ?");
+  }
+
+  ~SqliteDatabase() {
+    for (auto stmt : {read_, update_, insert_, scan_})
+      sqlite3_finalize(stmt);
+    sqlite3_close(db_);
+    remove(db_file_.c_str());
+    remove("vtable.db");
+  }
+
+  bool Insert(int64_t key, const std::string &value) {
+    sqlite3_bind_int64(insert_, 1, key);
+    sqlite3_bind_text(insert_, 2, value.c_str(), value.size(),
+                      SQLITE_TRANSIENT);
+    return Step(insert_) >= 0;
+  }
+
+  bool Read(int64_t key) {
+    sqlite3_bind_int64(read_, 1, key);
+    return Step(read_) > 0;
+  }
+
+  bool Update(int64_t key, const std::string &value) {
+    sqlite3_bind_text(update_, 1, value.c_str(), value.size(),
+                      SQLITE_TRANSIENT);
+    sqlite3_bind_int64(update_, 2, key);
+    return Step(update_) >= 0 && sqlite3_changes(db_) > 0;
+  }
+
+  bool ReadModifyWrite(int64_t key, const std::string &value) {
+    return Read(key) && Update(key, value);
+  }
+
+  bool Scan(int64_t key, int len) {
+    sqlite3_bind_int64(scan_, 1, key);
+    sqlite3_bind_int(scan_, 2, len);
+    return Step(scan_) > 0;
+  }
+
+private:
+  void Check(int rc, const std::string &what) {
+    if (rc != SQLITE_OK)
+      throw Exception(EXCEPTION_TYPE_CONNECTION,
+                      what + ": " + sqlite3_errmsg(db_));
+  }
+
+  void Exec(const std::string &sql) {
+    Check(sqlite3_exec(db_, sql.c_str(), nullptr, nullptr, nullptr), sql);
+  }
+
+  sqlite3_stmt *Prepare(const std::string &sql) {
+    sqlite3_stmt *stmt;
+    Check(sqlite3_prepare_v2(db_, sql.c_str(), -1, &stmt, nullptr), sql);
+    return stmt;
+  }
+
+  // returns the number of rows produced, -1 on error
+  int Step(sqlite3_stmt *stmt) {
+    int rows = 0, rc;
+    while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+      rows++;
+    sqlite3_reset(stmt);
+    sqlite3_clear_bindings(stmt);
+    return rc == SQLITE_DONE ? rows : -1;
+  }
+
+  std::string db_file_ = "ycsb_sqlite.db";
+  sqlite3 *db_ = nullptr;
+  sqlite3_stmt *read_ = nullptr;
+  sqlite3_stmt *update_ = nullptr;
+  sqlite3_stmt *insert_ = nullptr;
+  sqlite3_stmt *scan_ = nullptr;
+};
+
+template <typename Database>
+void RunWorker(Database *db, const YcsbWorkload &workload, KeyChooser *chooser,
+               const YcsbOptions &options, int64_t ops, uint64_t seed,
+               YcsbThreadStats *stats) {
+  std::mt19937_64 rng(seed);
+  std::uniform_real_distribution<double> coin(0, 1);
+  for (int64_t i = 0; i < ops; i++) {
+    YcsbOp op = workload.NextOp(coin(rng));
+    bool found = true;
+    uint64_t start = NowNanos();
+    switch (op) {
+    case YcsbOp::READ:
+      found = db->Read(chooser->Next(rng, workload.latest));
+      break;
+    case YcsbOp::UPDATE:
+      found = db->Update(chooser->Next(rng, workload.latest),
+                         MakeValue(rng, options.value_len));
+      break;
+    case YcsbOp::INSERT: {
+      uint64_t key = chooser->NextInsertKey();
+      db->Insert(key, MakeValue(rng, options.value_len));
+      chooser->Acknowledge(key);
+      break;
+    }
+    case YcsbOp::SCAN:
+      found = db->Scan(chooser->Next(rng, workload.latest),
+                       1 + rng() % options.scan_len);
+      break;
+    case YcsbOp::READ_MODIFY_WRITE:
+      found = db->ReadModifyWrite(chooser->Next(rng, workload.latest),
+                                  MakeValue(rng, options.value_len));
+      break;
+    }
+    stats->latency[static_cast<int>(op)].Record(NowNanos() - start);
+    if (!found)
+      stats->not_found++;
+  }
+}
+
+template <typename Database>
+void RunWorkload(const YcsbOptions &options, char name) {
+  YcsbWorkload workload = YcsbWorkload::Get(name);
+  Database db(options);
+
+  // load phase, keys are inserted in random order
+  std::mt19937_64 rng(options.seed);
+  std::vector<int64_t> keys(options.records);
+  for (int64_t i = 0; i < options.records; i++)
+    keys[i] = i;
+  std::shuffle(keys.begin(), keys.end(), rng);
+  uint64_t start = NowNanos();
+  for (auto key : keys)
+    db.Insert(key, MakeValue(rng, options.value_len));
+  double load_secs = (NowNanos() - start) / 1e9;
+
+  // run phase
+  KeyChooser chooser(options.dist, options.records);
+  std::vector<YcsbThreadStats> stats(options.threads);
+  std::vector<std::thread> threads;
+  start = NowNanos();
+  for (int i = 0; i < options.threads; i++) {
+    int64_t ops = options.ops / options.threads +
+                  (i < options.ops % options.threads ? 1 : 0);
+    threads.emplace_back(RunWorker<Database>, &db, std::cref(workload),
+                         &chooser, std::cref(options), ops,
+                         options.seed + i + 1, &stats[i]);
+  }
+  for (auto &t : threads)
+    t.join();
+  double run_secs = (NowNanos() - start) / 1e9;
+
+  LatencyRecorder merged[kOpTypes];
+  int64_t not_found = 0;
+  for (auto &s : stats) {
+    for (int i = 0; i < kOpTypes; i++)
+      merged[i].Merge(s.latency[i]);
+    not_found += s.not_found;
+  }
+
+  std::printf("workload %c: load %lld records %.2f s (%.0f ops/sec), run "
+              "%lld ops %.2f s (%.0f ops/sec), %lld not found\n",
+              workload.name, (long long)options.records, load_secs,
+              options.records / load_secs, (long long)options.ops, run_secs,
+              options.ops / run_secs, (long long)not_found);
+  for (int i = 0; i < kOpTypes; i++) {
+    if (merged[i].Count() == 0)
+      continue;
+    std::printf("  %-7s count %-9zu p50 %9.1f us  p99 %9.1f us  p999 %9.1f "
+                "us\n",
+                YcsbOpNames[i], merged[i].Count(),
+                merged[i].Percentile(50) / 1e3, merged[i].Percentile(99) / 1e3,
+                merged[i].Percentile(99.9) / 1e3);
+  }
+}
+
+} // namespace cmudb
+
+int main(int argc, char **argv) {
+  using namespace cmudb;
+  BenchFlags flags(argc, argv);
+  if (flags.Has("help")) {
+    std::printf("usage: %s [--mode=engine|sqlite] [--workload=A..F|all] "
+                "[--records=N] [--ops=N] [--dist=zipfian|uniform] "
+                "[--threads=N] [--pool_size=N] [--value_len=N] "
+                "[--scan_len=N] [--seed=N] [--vtable_lib=libvtable]\n",
+                argv[0]);
+    return 0;
+  }
+
+  YcsbOptions options;
+  options.mode = flags.GetString("mode", "engine");
+  options.dist = flags.GetString("dist", "zipfian");
+  options.vtable_lib = flags.GetString("vtable_lib", "libvtable");
+  options.records = flags.GetInt("records", 10000);
+  options.ops = flags.GetInt("ops", 10000);
+  options.threads = flags.GetInt("threads", 1);
+  options.pool_size = flags.GetInt("pool_size", 1024);
+  options.value_len = flags.GetInt("value_len", 100);
+  options.scan_len = flags.GetInt("scan_len", 100);
+  options.seed = flags.GetInt("seed", 42);
+  std::string workloads = flags.GetString("workload", "all");
+  if (workloads == "all")
+    workloads = "ABCDEF";
+
+  if (options.mode == "sqlite") {
+    // sqlite runs one transaction at a time against the vtable and the
+    // buffer pool size is fixed at compile time
+    options.threads = 1;
+    options.pool_size = BUFFER_POOL_SIZE;
+  } else if (options.mode != "engine") {
+    std::fprintf(stderr, "unknown mode %s\n", options.mode.c_str());
+    return 1;
+  }
+  if (options.records <= 0 || options.threads <= 0 || options.scan_len <= 0) {
+    std::fprintf(stderr, "records, threads and scan_len must be positive\n");
+    return 1;
+  }
+
+  std::printf("ycsb: mode %s, %lld records, %lld ops, %s, %d threads, page "
+              "size %d, pool size %d pages, value length %d\n",
+              options.mode.c_str(), (long long)options.records,
+              (long long)options.ops, options.dist.c_str(), options.threads,
+              PAGE_SIZE, options.pool_size, options.value_len);
+  try {
+    for (char name : workloads) {
+      if (options.mode == "sqlite")
+        RunWorkload<SqliteDatabase>(options, name);
+      else
+        RunWorkload<EngineDatabase>(options, name);
+    }
+  } catch (Exception &e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
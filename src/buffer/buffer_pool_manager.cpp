@@ -1,4 +1,6 @@
 #include "buffer/buffer_pool_manager.h"
+#include "common/metrics.h"
+#include "common/trace.h"
 
 namespace cmudb {
 
@@ -10,10 +12,16 @@ namespace cmudb {
 BufferPoolManager::BufferPoolManager(size_t pool_size,
                                                  DiskManager *disk_manager,
                                                  LogManager *log_manager)
-        : pool_size_(pool_size), disk_manager_(disk_manager),
-          log_manager_(log_manager) {
+        : pool_size_(pool_size), page_size_(disk_manager->GetPageSize()),
+          disk_manager_(disk_manager), log_manager_(log_manager) {
     // a consecutive memory space for buffer pool
     pages_ = new Page[pool_size_];
+    frames_ = new char[pool_size_ * page_size_];
+    for (size_t i = 0; i < pool_size_; ++ i) {
+        pages_[i].data_ = frames_ + i * page_size_;
+        pages_[i].page_size_ = page_size_;
+        pages_[i].ResetMemory();
+    }
     page_table_ = new ExtendibleHash<page_id_t, Page *>(BUCKET_SIZE);
     replacer_ = new LRUReplacer<Page *>;
     free_list_ = new std::list<Page *>;
@@ -33,6 +41,7 @@ BufferPoolManager::BufferPoolManager(size_t pool_size,
  */
 BufferPoolManager::~BufferPoolManager() {
     delete[] pages_;
+    delete[] frames_;
     delete page_table_;
     delete replacer_;
     delete free_list_;
@@ -52,21 +61,26 @@ BufferPoolManager::~BufferPoolManager() {
  * pointer
  */
 Page *BufferPoolManager::FetchPage(page_id_t page_id) {
-    std::unique_lock<std::mutex> lock(latch_);
+    std::unique_lock<ProfiledMutex> lock(latch_);
 #ifdef DBG
     LOG_DEBUG("Fetch Page - %d\n", page_id);
 #endif
     Page *page = nullptr;
     if (page_table_->Find(page_id, page)) {
+        Metrics::Add(MetricCounter::BUFFER_HIT);
         ++ page->pin_count_;
         replacer_->Erase(page); // because the page is pinned
         return page;
     }
+    Metrics::Add(MetricCounter::BUFFER_MISS);
+    TRACE_SCOPE("buffer", "FetchPage miss", page_id);
     page = GetFreePage();
     if (page == nullptr)
         return nullptr;
-    if (page->is_dirty_)
+    if (page->is_dirty_) {
+        Metrics::Add(MetricCounter::BUFFER_DIRTY_WRITEBACK);
         FlushPage(page->page_id_);   // flush old page
+    }
     page_table_->Remove(page->page_id_);
     page_table_->Insert(page_id, page);
     disk_manager_->ReadPage(page_id, page->data_);
@@ -89,6 +103,8 @@ Page *BufferPoolManager::GetFreePage() {
     }
     else if (!replacer_->Victim(page)){
         return nullptr;
+    } else {
+        Metrics::Add(MetricCounter::BUFFER_EVICTION);
     }
     return page;
 }
@@ -100,7 +116,7 @@ Page *BufferPoolManager::GetFreePage() {
  * dirty flag of this page
  */
 bool BufferPoolManager::UnpinPage(page_id_t page_id, bool is_dirty) {
-    std::unique_lock<std::mutex> lock(latch_);
+    std::unique_lock<ProfiledMutex> lock(latch_);
 #ifdef DBG
     LOG_DEBUG("Unpin Page - %d\n", page_id);
 #endif
@@ -133,7 +149,7 @@ bool BufferPoolManager::FlushPage(page_id_t page_id) {
 }
 
 void BufferPoolManager::FlushAllPages() {
-    std::unique_lock<std::mutex> lock(latch_);
+    std::unique_lock<ProfiledMutex> lock(latch_);
     for (uint16_t i = 0; i < pool_size_; ++ i) {
         if (pages_[i].pin_count_ == 0 && pages_[i].is_dirty_) {
             disk_manager_->WritePage(pages_[i].page_id_, pages_[i].data_);
@@ -151,7 +167,7 @@ void BufferPoolManager::FlushAllPages() {
  * the page is found within page table, but pin_count != 0, return false
  */
 bool BufferPoolManager::DeletePage(page_id_t page_id) {
-    std::unique_lock<std::mutex> lock(latch_);
+    std::unique_lock<ProfiledMutex> lock(latch_);
     Page *page = nullptr;
     page_table_->Find(page_id, page);
     if (page != nullptr) {
@@ -177,7 +193,7 @@ bool BufferPoolManager::DeletePage(page_id_t page_id) {
  * into page table. return nullptr if all the pages in pool are pinned
  */
 Page *BufferPoolManager::NewPage(page_id_t &page_id) {
-    std::unique_lock<std::mutex> lock(latch_);
+    std::unique_lock<ProfiledMutex> lock(latch_);
     Page *page = nullptr;
     page = GetFreePage();
     if (page == nullptr)
@@ -188,8 +204,10 @@ Page *BufferPoolManager::NewPage(page_id_t &page_id) {
     LOG_DEBUG("New Page - %d\n", page_id);
 #endif
 
-    if (page->is_dirty_)
+    if (page->is_dirty_) {
+        Metrics::Add(MetricCounter::BUFFER_DIRTY_WRITEBACK);
         FlushPage(page->page_id_);
+    }
     page_table_->Remove(page->page_id_);
     page_table_->Insert(page_id, page);
 
@@ -0,0 +1,212 @@
+/**
+ * catalog.cpp
+ */
+
+#include <cstring>
+#include <vector>
+
+#include "catalog/catalog.h"
+#include "common/exception.h"
+#include "hash/city.h"
+#include "page/catalog_page.h"
+#include "page/header_page.h"
+
+namespace cmudb {
+
+namespace {
+// header page record of the directory page
+const char *DIRECTORY_RECORD = "__catalog";
+} // namespace
+
+/*
+ * Read every bucket into the cache, or create the directory when the header
+ * page has no record of it
+ */
+Catalog::Catalog(BufferPoolManager *buffer_pool_manager)
+    : buffer_pool_manager_(buffer_pool_manager) {
+  HeaderPage *header_page =
+      static_cast<HeaderPage *>(FetchPage(HEADER_PAGE_ID));
+  if (!header_page->GetRootId(DIRECTORY_RECORD, directory_page_id_)) {
+    Page *page = buffer_pool_manager_->NewPage(directory_page_id_);
+    if (page == nullptr) {
+      buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, false);
+      throw Exception(EXCEPTION_TYPE_CATALOG, "out of memory");
+    }
+    static_cast<CatalogDirectoryPage *>(page)->Init();
+    buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+    header_page->InsertRecord(DIRECTORY_RECORD, directory_page_id_);
+    buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+    return;
+  }
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, false);
+
+  CatalogDirectoryPage *directory =
+      static_cast<CatalogDirectoryPage *>(FetchPage(directory_page_id_));
+  std::vector<std::pair<std::string, std::string>> records;
+  for (int bucket = 0; bucket < directory->GetBucketCount(); bucket++) {
+    page_id_t page_id = directory->GetBucketPageId(bucket);
+    while (page_id != INVALID_PAGE_ID) {
+      CatalogPage *page = static_cast<CatalogPage *>(FetchPage(page_id));
+      records.clear();
+      page->GetRecords(records);
+      for (auto &record : records)
+        cache_[record.first] =
+            std::make_pair(Deserialize(record.first, record.second), page_id);
+      page_id_t next_page_id = page->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+  }
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+}
+
+bool Catalog::CreateEntry(const CatalogEntry &entry) {
+  std::lock_guard<std::mutex> guard(latch_);
+  if (cache_.count(entry.name) != 0)
+    return false;
+  page_id_t page_id = WriteRecord(entry.name, Serialize(entry));
+  cache_[entry.name] = std::make_pair(entry, page_id);
+  return true;
+}
+
+bool Catalog::GetEntry(const std::string &name, CatalogEntry &entry) {
+  std::lock_guard<std::mutex> guard(latch_);
+  auto it = cache_.find(name);
+  if (it == cache_.end())
+    return false;
+  entry = it->second.first;
+  return true;
+}
+
+/*
+ * The record stays on its page when it still fits, else it moves to another
+ * page of its bucket. The old record is only deleted once the new one is
+ * written, an update that throws leaves the entry as it was.
+ */
+bool Catalog::UpdateEntry(const CatalogEntry &entry) {
+  std::lock_guard<std::mutex> guard(latch_);
+  auto it = cache_.find(entry.name);
+  if (it == cache_.end())
+    return false;
+  std::string payload = Serialize(entry);
+  page_id_t page_id = it->second.second;
+  CatalogPage *page = static_cast<CatalogPage *>(FetchPage(page_id));
+  bool fits = page->ReplaceRecord(entry.name, payload);
+  buffer_pool_manager_->UnpinPage(page_id, fits);
+  if (!fits) {
+    page_id_t new_page_id = WriteRecord(entry.name, payload);
+    page = static_cast<CatalogPage *>(FetchPage(page_id));
+    page->DeleteRecord(entry.name);
+    buffer_pool_manager_->UnpinPage(page_id, true);
+    page_id = new_page_id;
+  }
+  it->second = std::make_pair(entry, page_id);
+  return true;
+}
+
+bool Catalog::DropEntry(const std::string &name) {
+  std::lock_guard<std::mutex> guard(latch_);
+  auto it = cache_.find(name);
+  if (it == cache_.end())
+    return false;
+  page_id_t page_id = it->second.second;
+  CatalogPage *page = static_cast<CatalogPage *>(FetchPage(page_id));
+  page->DeleteRecord(name);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  cache_.erase(it);
+  return true;
+}
+
+size_t Catalog::GetEntryCount() {
+  std::lock_guard<std::mutex> guard(latch_);
+  return cache_.size();
+}
+
+/*
+ * First page of the bucket with room for the record, a new page goes in
+ * front of the chain. Emptied pages stay in their chain for later records.
+ */
+page_id_t Catalog::WriteRecord(const std::string &name,
+                               const std::string &payload) {
+  if (name.size() + payload.size() >
+      CatalogPage::MaxRecordSize(buffer_pool_manager_->GetPageSize()))
+    throw Exception(EXCEPTION_TYPE_CATALOG,
+                    "catalog entry of " + name + " does not fit in a page");
+  CatalogDirectoryPage *directory =
+      static_cast<CatalogDirectoryPage *>(FetchPage(directory_page_id_));
+  int bucket = CityHash64(name.data(), name.size()) %
+               directory->GetBucketCount();
+  page_id_t head_page_id = directory->GetBucketPageId(bucket);
+  page_id_t page_id = head_page_id;
+  while (page_id != INVALID_PAGE_ID) {
+    CatalogPage *page = static_cast<CatalogPage *>(FetchPage(page_id));
+    if (page->InsertRecord(name, payload)) {
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+      return page_id;
+    }
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_page_id;
+  }
+
+  CatalogPage *page =
+      static_cast<CatalogPage *>(buffer_pool_manager_->NewPage(page_id));
+  if (page == nullptr) {
+    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+    throw Exception(EXCEPTION_TYPE_CATALOG, "out of memory");
+  }
+  page->Init();
+  page->SetNextPageId(head_page_id);
+  page->InsertRecord(name, payload);
+  buffer_pool_manager_->UnpinPage(page_id, true);
+  directory->SetBucketPageId(bucket, page_id);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+  return page_id;
+}
+
+/*
+ * Payload format (size in byte):
+ *  ----------------------------------------------------------------------
+ * | FirstPageId (4) | RowCount (8) | DictionaryPageId (4) | LayoutVersion (4)
+ *  ----------------------------------------------------------------------
+ *  ------------------------------------
+ * | SchemaLength (4) | Schema | Index |
+ *  ------------------------------------
+ */
+std::string Catalog::Serialize(const CatalogEntry &entry) {
+  std::string payload(24, '\0');
+  int schema_length = entry.schema.size();
+  memcpy(&payload[0], &entry.first_page_id, 4);
+  memcpy(&payload[4], &entry.row_count, 8);
+  memcpy(&payload[12], &entry.dictionary_page_id, 4);
+  memcpy(&payload[16], &entry.layout_version, 4);
+  memcpy(&payload[20], &schema_length, 4);
+  payload += entry.schema;
+  payload += entry.index;
+  return payload;
+}
+
+CatalogEntry Catalog::Deserialize(const std::string &name,
+                                  const std::string &payload) {
+  CatalogEntry entry;
+  int schema_length;
+  entry.name = name;
+  memcpy(&entry.first_page_id, &payload[0], 4);
+  memcpy(&entry.row_count, &payload[4], 8);
+  memcpy(&entry.dictionary_page_id, &payload[12], 4);
+  memcpy(&entry.layout_version, &payload[16], 4);
+  memcpy(&schema_length, &payload[20], 4);
+  entry.schema = payload.substr(24, schema_length);
+  entry.index = payload.substr(24 + schema_length);
+  return entry;
+}
+
+Page *Catalog::FetchPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr)
+    throw Exception(EXCEPTION_TYPE_CATALOG, "all pages are pinned");
+  return page;
+}
+
+} // namespace cmudb
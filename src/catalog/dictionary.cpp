@@ -0,0 +1,124 @@
+/**
+ * dictionary.cpp
+ */
+
+#include <cstring>
+#include <utility>
+#include <vector>
+
+#include "catalog/dictionary.h"
+#include "common/exception.h"
+#include "page/catalog_page.h"
+
+namespace cmudb {
+
+Dictionary::Dictionary(BufferPoolManager *buffer_pool_manager,
+                       page_id_t first_page_id)
+    : buffer_pool_manager_(buffer_pool_manager),
+      first_page_id_(first_page_id), last_page_id_(first_page_id) {
+  if (first_page_id_ == INVALID_PAGE_ID) {
+    Page *page = buffer_pool_manager_->NewPage(first_page_id_);
+    if (page == nullptr)
+      throw Exception(EXCEPTION_TYPE_CATALOG, "out of memory");
+    static_cast<CatalogPage *>(page)->Init();
+    buffer_pool_manager_->UnpinPage(first_page_id_, true);
+    last_page_id_ = first_page_id_;
+    return;
+  }
+
+  std::vector<std::pair<std::string, std::string>> records;
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    CatalogPage *page = static_cast<CatalogPage *>(FetchPage(page_id));
+    records.clear();
+    page->GetRecords(records);
+    // codes were appended in order, each one lands at its position
+    for (auto &record : records) {
+      int32_t code;
+      memcpy(&code, record.second.data(), sizeof(int32_t));
+      ColumnDictionary &column = columns_[record.second.substr(4)];
+      column.codes[record.first] = code;
+      column.values.push_back(record.first);
+    }
+    last_page_id_ = page_id;
+    page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(last_page_id_, false);
+  }
+}
+
+int32_t Dictionary::Encode(const std::string &column,
+                           const std::string &value) {
+  std::lock_guard<std::mutex> guard(latch_);
+  ColumnDictionary &dictionary = columns_[column];
+  auto it = dictionary.codes.find(value);
+  if (it != dictionary.codes.end())
+    return it->second;
+
+  int32_t code = dictionary.values.size();
+  std::string payload(4, '\0');
+  memcpy(&payload[0], &code, sizeof(int32_t));
+  payload += column;
+  if (value.size() + payload.size() >
+      CatalogPage::MaxRecordSize(buffer_pool_manager_->GetPageSize()))
+    throw Exception(EXCEPTION_TYPE_OBJECT_SIZE,
+                    "dictionary value of " + column + " does not fit in a page");
+  CatalogPage *page = static_cast<CatalogPage *>(FetchPage(last_page_id_));
+  if (!page->InsertRecord(value, payload)) {
+    page_id_t new_page_id;
+    CatalogPage *new_page =
+        static_cast<CatalogPage *>(buffer_pool_manager_->NewPage(new_page_id));
+    if (new_page == nullptr) {
+      buffer_pool_manager_->UnpinPage(last_page_id_, false);
+      throw Exception(EXCEPTION_TYPE_CATALOG, "out of memory");
+    }
+    new_page->Init();
+    new_page->InsertRecord(value, payload);
+    page->SetNextPageId(new_page_id);
+    buffer_pool_manager_->UnpinPage(last_page_id_, true);
+    last_page_id_ = new_page_id;
+  }
+  buffer_pool_manager_->UnpinPage(last_page_id_, true);
+
+  dictionary.codes[value] = code;
+  dictionary.values.push_back(value);
+  return code;
+}
+
+bool Dictionary::Lookup(const std::string &column, const std::string &value,
+                        int32_t &code) {
+  std::lock_guard<std::mutex> guard(latch_);
+  auto dictionary = columns_.find(column);
+  if (dictionary == columns_.end())
+    return false;
+  auto it = dictionary->second.codes.find(value);
+  if (it == dictionary->second.codes.end())
+    return false;
+  code = it->second;
+  return true;
+}
+
+const std::string &Dictionary::Decode(const std::string &column,
+                                      int32_t code) {
+  std::lock_guard<std::mutex> guard(latch_);
+  ColumnDictionary &dictionary = columns_[column];
+  if (code < 0 || code >= (int32_t)dictionary.values.size())
+    throw Exception(EXCEPTION_TYPE_CATALOG,
+                    "no dictionary value of " + column + " for code " +
+                        std::to_string(code));
+  return dictionary.values[code];
+}
+
+size_t Dictionary::GetSize(const std::string &column) {
+  std::lock_guard<std::mutex> guard(latch_);
+  auto dictionary = columns_.find(column);
+  return dictionary == columns_.end() ? 0 : dictionary->second.values.size();
+}
+
+Page *Dictionary::FetchPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr)
+    throw Exception(EXCEPTION_TYPE_CATALOG, "all pages are pinned");
+  return page;
+}
+
+} // namespace cmudb
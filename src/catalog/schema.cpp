@@ -11,22 +11,40 @@
 namespace cmudb {
 
 // Construct schema from vector of Column
-Schema::Schema(const std::vector<Column> &columns) : tuple_is_inlined(true) {
-  int32_t column_offset = 0;
+Schema::Schema(const std::vector<Column> &columns, bool null_bitmap)
+    : columns(columns), offsets(columns.size()), has_null_bitmap(null_bitmap),
+      tuple_is_inlined(true) {
+  // fixed length columns by decreasing length, so none needs padding to be
+  // aligned. The sort is stable, equal lengths keep the column order
+  std::vector<int> order;
   for (size_t index = 0; index < columns.size(); index++) {
-    Column column = columns[index];
     // handle uninlined column
-    if (column.IsInlined() == false) {
+    if (columns[index].IsInlined() == false) {
       tuple_is_inlined = false;
       uninlined_columns.push_back(index);
     }
-    // set column offset
-    column.column_offset = column_offset;
-    column_offset += column.GetFixedLength();
+    if (columns[index].IsVarint())
+      varint_columns.push_back(index);
+    else
+      order.push_back(index);
+  }
+  std::stable_sort(order.begin(), order.end(), [&columns](int lhs, int rhs) {
+    return columns[lhs].GetFixedLength() > columns[rhs].GetFixedLength();
+  });
 
-    // add column
-    this->columns.push_back(std::move(column));
+  int32_t column_offset = 0;
+  for (int index : order) {
+    // set column offset
+    this->columns[index].column_offset = column_offset;
+    offsets[index] = column_offset;
+    column_offset += this->columns[index].GetFixedLength();
+  }
+  if (has_null_bitmap) {
+    null_bitmap_offset = column_offset;
+    column_offset += (columns.size() + 7) / 8;
   }
+  for (size_t ordinal = 0; ordinal < varint_columns.size(); ordinal++)
+    offsets[varint_columns[ordinal]] = ordinal;
   // set tuple length
   length = column_offset;
 }
@@ -46,6 +64,7 @@ Schema *Schema::CopySchema(const Schema *schema, const std::vector<int> &ids) {
     // Make sure the index does not refer to invalid element
     assert(id < schema->GetColumnCount());
     column_list.push_back(schema->columns[id]);
+    column_list.back().SetVarint(false);
   }
 
   Schema *ret_schema = new Schema(column_list);
@@ -58,6 +77,7 @@ std::string Schema::ToString() const {
   os << "Schema["
      << "NumColumns:" << GetColumnCount() << ", "
      << "IsInlined:" << tuple_is_inlined << ", "
+     << "NullBitmap:" << has_null_bitmap << ", "
      << "Length:" << length << "]";
 
   bool first = true;
@@ -0,0 +1,48 @@
+/**
+ * latch_profiler.cpp
+ */
+
+#include <cstdio>
+
+#include "common/latch_profiler.h"
+
+namespace cmudb {
+
+const char *LatchProfiler::Name(LatchClass latch_class) {
+  static const char *names[NUM_LATCH_CLASSES] = {
+      "bpm_latch", "root_latch", "page_latch", "lock_table_mutex",
+      "log_latch"};
+  if (latch_class == LatchClass::UNPROFILED)
+    return "none";
+  return names[static_cast<int>(latch_class)];
+}
+
+std::string LatchProfiler::Dump() {
+  MetricsSnapshot snapshot = Metrics::Snapshot();
+  std::string result;
+  char line[256];
+  if (!Enabled())
+    result += "latch profiling is disabled, build with -DLATCH_PROFILING=ON\n";
+  snprintf(line, sizeof(line), "%-18s %12s %12s %12s %12s %12s %12s\n",
+           "latch", "acquire", "contended", "wait_p50", "wait_p99",
+           "hold_p50", "hold_p99");
+  result += line;
+  for (int c = 0; c < NUM_LATCH_CLASSES; c++) {
+    LatchClass latch_class = static_cast<LatchClass>(c);
+    const HistogramSnapshot &wait = snapshot.Get(Histogram(latch_class, 0));
+    const HistogramSnapshot &hold = snapshot.Get(Histogram(latch_class, 1));
+    snprintf(line, sizeof(line),
+             "%-18s %12llu %12llu %12llu %12llu %12llu %12llu\n",
+             Name(latch_class),
+             (unsigned long long)snapshot.Get(Counter(latch_class, 0)),
+             (unsigned long long)snapshot.Get(Counter(latch_class, 1)),
+             (unsigned long long)wait.Percentile(50),
+             (unsigned long long)wait.Percentile(99),
+             (unsigned long long)hold.Percentile(50),
+             (unsigned long long)hold.Percentile(99));
+    result += line;
+  }
+  return result;
+}
+
+} // namespace cmudb
@@ -0,0 +1,163 @@
+/**
+ * metrics.cpp
+ */
+
+#include <algorithm>
+#include <mutex>
+
+#include "common/metrics.h"
+
+namespace cmudb {
+
+namespace {
+// never destroyed, threads may still exit after static destructors ran
+struct Registry {
+  std::mutex mutex;
+  std::vector<Metrics::Slot *> slots;
+  // counts of threads that exited
+  Metrics::Slot retired;
+};
+
+Registry *GetRegistry() {
+  static Registry *registry = new Registry;
+  return registry;
+}
+
+void Accumulate(MetricsSnapshot &snapshot, const Metrics::Slot &slot) {
+  for (int i = 0; i < NUM_COUNTERS; i++)
+    snapshot.counters[i] += slot.counters[i].load(std::memory_order_relaxed);
+  for (int h = 0; h < NUM_HISTOGRAMS; h++) {
+    HistogramSnapshot &histogram = snapshot.histograms[h];
+    histogram.sum += slot.histogram_sum[h].load(std::memory_order_relaxed);
+    for (int b = 0; b < HISTOGRAM_BUCKETS; b++) {
+      uint64_t n = slot.histogram_buckets[h][b].load(std::memory_order_relaxed);
+      histogram.buckets[b] += n;
+      histogram.count += n;
+    }
+  }
+}
+
+void Fold(Metrics::Slot &into, Metrics::Slot &from) {
+  for (int i = 0; i < NUM_COUNTERS; i++)
+    Metrics::Slot::Bump(into.counters[i], from.counters[i].load());
+  for (int h = 0; h < NUM_HISTOGRAMS; h++) {
+    Metrics::Slot::Bump(into.histogram_sum[h], from.histogram_sum[h].load());
+    for (int b = 0; b < HISTOGRAM_BUCKETS; b++)
+      Metrics::Slot::Bump(into.histogram_buckets[h][b],
+                          from.histogram_buckets[h][b].load());
+  }
+}
+
+void Clear(Metrics::Slot &slot) {
+  for (auto &cell : slot.counters)
+    cell.store(0, std::memory_order_relaxed);
+  for (int h = 0; h < NUM_HISTOGRAMS; h++) {
+    slot.histogram_sum[h].store(0, std::memory_order_relaxed);
+    for (auto &cell : slot.histogram_buckets[h])
+      cell.store(0, std::memory_order_relaxed);
+  }
+}
+
+// unregisters the slot of a thread when the thread exits
+struct SlotOwner {
+  Metrics::Slot *slot = nullptr;
+  ~SlotOwner() {
+    if (slot == nullptr)
+      return;
+    Registry *registry = GetRegistry();
+    std::lock_guard<std::mutex> guard(registry->mutex);
+    Fold(registry->retired, *slot);
+    registry->slots.erase(
+        std::find(registry->slots.begin(), registry->slots.end(), slot));
+    delete slot;
+  }
+};
+
+thread_local SlotOwner slot_owner;
+} // namespace
+
+thread_local Metrics::Slot *Metrics::local_slot_ = nullptr;
+
+Metrics::Slot::Slot() { Clear(*this); }
+
+uint64_t HistogramSnapshot::Percentile(double p) const {
+  if (count == 0)
+    return 0;
+  uint64_t rank = static_cast<uint64_t>(p / 100.0 * count);
+  if (rank >= count)
+    rank = count - 1;
+  uint64_t seen = 0;
+  for (int b = 0; b < HISTOGRAM_BUCKETS; b++) {
+    seen += buckets[b];
+    if (seen > rank) {
+      if (b == 0)
+        return 0;
+      return b == HISTOGRAM_BUCKETS - 1 ? UINT64_MAX : (1ULL << b) - 1;
+    }
+  }
+  return UINT64_MAX;
+}
+
+Metrics::Slot *Metrics::RegisterThread() {
+  Slot *slot = new Slot;
+  Registry *registry = GetRegistry();
+  {
+    std::lock_guard<std::mutex> guard(registry->mutex);
+    registry->slots.push_back(slot);
+  }
+  slot_owner.slot = slot;
+  return slot;
+}
+
+MetricsSnapshot Metrics::Snapshot() {
+  MetricsSnapshot snapshot;
+  Registry *registry = GetRegistry();
+  std::lock_guard<std::mutex> guard(registry->mutex);
+  Accumulate(snapshot, registry->retired);
+  for (Slot *slot : registry->slots)
+    Accumulate(snapshot, *slot);
+  return snapshot;
+}
+
+void Metrics::Reset() {
+  Registry *registry = GetRegistry();
+  std::lock_guard<std::mutex> guard(registry->mutex);
+  Clear(registry->retired);
+  for (Slot *slot : registry->slots)
+    Clear(*slot);
+}
+
+const char *Metrics::Name(MetricCounter id) {
+  static const char *names[NUM_COUNTERS] = {
+      "buffer_hit",       "buffer_miss",        "buffer_eviction",
+      "buffer_writeback", "disk_read",          "disk_write",
+      "btree_split",      "btree_merge",        "btree_redistribute",
+      "btree_latch_wait", "btree_hash_hit",     "btree_hash_miss",
+      "btree_leaf_reuse",
+      "bloom_filter_skip", "bloom_filter_false_positive",
+      "blink_move_right", "bepsilon_flush",   "index_only_row",
+      "index_scan_row",   "filter_skip_row",    "import_row",
+      "import_byte",
+      "lock_wait",        "lock_abort",         "log_bytes",
+      "log_flush",
+      "bpm_latch_acquire",        "bpm_latch_contended",
+      "root_latch_acquire",       "root_latch_contended",
+      "page_latch_acquire",       "page_latch_contended",
+      "lock_table_mutex_acquire", "lock_table_mutex_contended",
+      "log_latch_acquire",        "log_latch_contended"};
+  return names[static_cast<int>(id)];
+}
+
+const char *Metrics::Name(MetricHistogram id) {
+  static const char *names[NUM_HISTOGRAMS] = {
+      "disk_read_latency_ns",     "disk_write_latency_ns",
+      "lock_wait_latency_ns",     "bpm_latch_wait_ns",
+      "bpm_latch_hold_ns",        "root_latch_wait_ns",
+      "root_latch_hold_ns",       "page_latch_wait_ns",
+      "page_latch_hold_ns",       "lock_table_mutex_wait_ns",
+      "lock_table_mutex_hold_ns", "log_latch_wait_ns",
+      "log_latch_hold_ns"};
+  return names[static_cast<int>(id)];
+}
+
+} // namespace cmudb
@@ -0,0 +1,151 @@
+/**
+ * trace.cpp
+ */
+
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "common/trace.h"
+
+namespace cmudb {
+
+namespace {
+struct Ring {
+  TraceEvent events[Trace::RING_CAPACITY];
+  // number of events ever recorded, the slot of event i is i % capacity
+  std::atomic<uint64_t> head{0};
+  int thread_id;
+};
+
+// never destroyed, threads may still exit after static destructors ran
+struct Registry {
+  std::mutex mutex;
+  // rings of exited threads stay until the next Start()
+  std::vector<std::unique_ptr<Ring>> rings;
+  std::vector<Ring *> retired;
+  int next_thread_id = 1;
+};
+
+Registry *GetRegistry() {
+  static Registry *registry = new Registry;
+  return registry;
+}
+
+// marks the ring of a thread retired when the thread exits
+struct RingOwner {
+  Ring *ring = nullptr;
+  ~RingOwner() {
+    if (ring == nullptr)
+      return;
+    Registry *registry = GetRegistry();
+    std::lock_guard<std::mutex> guard(registry->mutex);
+    registry->retired.push_back(ring);
+  }
+};
+
+thread_local RingOwner ring_owner;
+
+// rings are only allocated once a thread records an event
+Ring *LocalRing() {
+  if (ring_owner.ring == nullptr) {
+    Registry *registry = GetRegistry();
+    std::lock_guard<std::mutex> guard(registry->mutex);
+    Ring *ring = new Ring;
+    ring->thread_id = registry->next_thread_id++;
+    registry->rings.emplace_back(ring);
+    ring_owner.ring = ring;
+  }
+  return ring_owner.ring;
+}
+
+void AppendJsonEvent(std::string &json, const TraceEvent &event,
+                     int thread_id) {
+  char buffer[384];
+  int n = snprintf(buffer, sizeof(buffer),
+                   "{\"cat\":\"%s\",\"name\":\"%s\",\"ph\":\"%c\","
+                   "\"ts\":%.3f,\"pid\":1,\"tid\":%d",
+                   event.category, event.name, event.phase,
+                   event.start_ns / 1000.0, thread_id);
+  if (event.phase == 'X')
+    n += snprintf(buffer + n, sizeof(buffer) - n, ",\"dur\":%.3f",
+                  event.duration_ns / 1000.0);
+  else
+    n += snprintf(buffer + n, sizeof(buffer) - n, ",\"s\":\"t\"");
+  if (event.arg >= 0)
+    n += snprintf(buffer + n, sizeof(buffer) - n,
+                  ",\"args\":{\"arg\":%" PRId64 "}", event.arg);
+  snprintf(buffer + n, sizeof(buffer) - n, "}");
+  json += buffer;
+}
+} // namespace
+
+std::atomic<bool> Trace::enabled_(false);
+
+void Trace::Start() {
+  Registry *registry = GetRegistry();
+  {
+    std::lock_guard<std::mutex> guard(registry->mutex);
+    // free the rings of exited threads, empty the others
+    for (Ring *ring : registry->retired) {
+      for (auto it = registry->rings.begin(); it != registry->rings.end();
+           ++it) {
+        if (it->get() == ring) {
+          registry->rings.erase(it);
+          break;
+        }
+      }
+    }
+    registry->retired.clear();
+    for (auto &ring : registry->rings)
+      ring->head.store(0);
+  }
+  enabled_.store(true);
+}
+
+void Trace::Stop() { enabled_.store(false); }
+
+void Trace::Record(const TraceEvent &event) {
+  Ring *ring = LocalRing();
+  uint64_t head = ring->head.load(std::memory_order_relaxed);
+  ring->events[head % RING_CAPACITY] = event;
+  ring->head.store(head + 1, std::memory_order_release);
+}
+
+std::string Trace::ToChromeJson(int64_t *events) {
+  std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+  bool first = true;
+  int64_t count = 0;
+  Registry *registry = GetRegistry();
+  std::lock_guard<std::mutex> guard(registry->mutex);
+  for (auto &ring : registry->rings) {
+    uint64_t head = ring->head.load(std::memory_order_acquire);
+    uint64_t begin = head > RING_CAPACITY ? head - RING_CAPACITY : 0;
+    for (uint64_t i = begin; i < head; i++) {
+      if (!first)
+        json += ",\n";
+      first = false;
+      AppendJsonEvent(json, ring->events[i % RING_CAPACITY], ring->thread_id);
+      count++;
+    }
+  }
+  json += "]}\n";
+  if (events != nullptr)
+    *events = count;
+  return json;
+}
+
+int64_t Trace::WriteChromeJson(const std::string &path) {
+  int64_t events = 0;
+  std::string json = ToChromeJson(&events);
+  std::ofstream out(path, std::ios::out | std::ios::trunc);
+  if (!out.is_open())
+    return -1;
+  out << json;
+  return out.bad() ? -1 : events;
+}
+
+} // namespace cmudb
@@ -2,6 +2,8 @@
  * lock_manager.cpp
  */
 
+#include "common/metrics.h"
+#include "common/trace.h"
 #include "concurrency/lock_manager.h"
 
 namespace cmudb {
@@ -9,11 +11,12 @@ namespace cmudb {
 bool LockManager::LockShared(Transaction *txn, const RID &rid) {
   // 1. if txn is not in growing phase, betray the rule of 2PL
   if (txn->GetState() != TransactionState::GROWING) {
+    Metrics::Add(MetricCounter::LOCK_ABORT);
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
   // 2. get list of the record
-  std::unique_lock<std::mutex> table_latch(mutex_);
+  std::unique_lock<ProfiledMutex> table_latch(mutex_);
   TxListForRecord &tx_list_for_record = lock_table_[rid];
   std::unique_lock<std::mutex> list_latch(tx_list_for_record.mutex_);
   table_latch.unlock();
@@ -28,6 +31,7 @@ bool LockManager::LockShared(Transaction *txn, const RID &rid) {
   }
   // 4. if txn has lower priority, abort; otherwise wait
   if (!can_granted && txn->GetTransactionId() > tx_list_for_record.locks_.back().txn_id_) {
+    Metrics::Add(MetricCounter::LOCK_ABORT);
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
@@ -36,6 +40,9 @@ bool LockManager::LockShared(Transaction *txn, const RID &rid) {
   TxLockForRecord &last_lock = tx_list_for_record.locks_.back();
   if (!can_granted) {
     list_latch.unlock();
+    Metrics::Add(MetricCounter::LOCK_WAIT);
+    ScopedLatency latency(MetricHistogram::LOCK_WAIT_LATENCY);
+    TRACE_SCOPE("lock", "LockWait", txn->GetTransactionId());
     last_lock.Wait();
   }
   txn->GetSharedLockSet()->insert(rid);
@@ -45,11 +52,12 @@ bool LockManager::LockShared(Transaction *txn, const RID &rid) {
 bool LockManager::LockExclusive(Transaction *txn, const RID &rid) {
   // 1. if txn is not in growing phase, betray the rule of 2PL
   if (txn->GetState() != TransactionState::GROWING) {
+    Metrics::Add(MetricCounter::LOCK_ABORT);
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
   // 2. get list of the record
-  std::unique_lock<std::mutex> table_latch(mutex_);
+  std::unique_lock<ProfiledMutex> table_latch(mutex_);
   TxListForRecord &tx_list_for_record = lock_table_[rid];
   std::unique_lock<std::mutex> list_latch(tx_list_for_record.mutex_);
   table_latch.unlock();
@@ -57,6 +65,7 @@ bool LockManager::LockExclusive(Transaction *txn, const RID &rid) {
   bool can_granted = tx_list_for_record.locks_.empty();
   // 4. if txn has lower priority, abort; otherwise wait
   if (!can_granted && txn->GetTransactionId() > tx_list_for_record.locks_.back().txn_id_) {
+    Metrics::Add(MetricCounter::LOCK_ABORT);
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
@@ -65,6 +74,9 @@ bool LockManager::LockExclusive(Transaction *txn, const RID &rid) {
   TxLockForRecord &last_lock = tx_list_for_record.locks_.back();
   if (!can_granted) {
     list_latch.unlock();
+    Metrics::Add(MetricCounter::LOCK_WAIT);
+    ScopedLatency latency(MetricHistogram::LOCK_WAIT_LATENCY);
+    TRACE_SCOPE("lock", "LockWait", txn->GetTransactionId());
     last_lock.Wait();
   }
   txn->GetExclusiveLockSet()->insert(rid);
@@ -74,16 +86,18 @@ bool LockManager::LockExclusive(Transaction *txn, const RID &rid) {
 bool LockManager::LockUpgrade(Transaction *txn, const RID &rid) {
   // 1. if txn is not in growing phase, betray the rule of 2PL
   if (txn->GetState() != TransactionState::GROWING) {
+    Metrics::Add(MetricCounter::LOCK_ABORT);
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
   // 2. get list of the record
-  std::unique_lock<std::mutex> table_latch(mutex_);
+  std::unique_lock<ProfiledMutex> table_latch(mutex_);
   TxListForRecord &tx_list_for_record = lock_table_[rid];
   std::unique_lock<std::mutex> list_latch(tx_list_for_record.mutex_);
   table_latch.unlock();
   // 3. whether the upgrage could be executed
   if (tx_list_for_record.has_upgrated_) {
+    Metrics::Add(MetricCounter::LOCK_ABORT);
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
@@ -92,6 +106,7 @@ bool LockManager::LockUpgrade(Transaction *txn, const RID &rid) {
                       return tx_lock.txn_id_ == txn->GetTransactionId();
                     });
   if (it == tx_list_for_record.locks_.end() || it->lock_type_ != LockType::SHARED || !it->granted_) {
+    Metrics::Add(MetricCounter::LOCK_ABORT);
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
@@ -101,6 +116,7 @@ bool LockManager::LockUpgrade(Transaction *txn, const RID &rid) {
   bool can_granted = tx_list_for_record.locks_.empty();
   // 5. if txn has lower priority, abort; otherwise wait
   if (!can_granted && txn->GetTransactionId() > tx_list_for_record.locks_.back().txn_id_) {
+    Metrics::Add(MetricCounter::LOCK_ABORT);
     txn->SetState(TransactionState::ABORTED);
     return false;
   }
@@ -113,6 +129,9 @@ bool LockManager::LockUpgrade(Transaction *txn, const RID &rid) {
   if (!can_granted) {
     tx_list_for_record.has_upgrated_ = true;
     list_latch.unlock();
+    Metrics::Add(MetricCounter::LOCK_WAIT);
+    ScopedLatency latency(MetricHistogram::LOCK_WAIT_LATENCY);
+    TRACE_SCOPE("lock", "LockWait", txn->GetTransactionId());
     last_lock.Wait();
   }
   txn->GetExclusiveLockSet()->insert(rid);
@@ -124,6 +143,7 @@ bool LockManager::Unlock(Transaction *txn, const RID &rid) {
   if (strict_2PL_) {
     if (txn->GetState() != TransactionState::COMMITTED && txn->GetState() != TransactionState::ABORTED) {
       // otherwise, abort it
+      Metrics::Add(MetricCounter::LOCK_ABORT);
       txn->SetState(TransactionState::ABORTED);
       return false;
     } 
@@ -132,7 +152,7 @@ bool LockManager::Unlock(Transaction *txn, const RID &rid) {
     txn->SetState(TransactionState::SHRINKING);
   }
   // 3. get lock list of the record
-  std::unique_lock<std::mutex> table_latch(mutex_);
+  std::unique_lock<ProfiledMutex> table_latch(mutex_);
   TxListForRecord &tx_list_for_record = lock_table_[rid];
   std::unique_lock<std::mutex> list_latch(tx_list_for_record.mutex_);
   // 4. find the lock in the list
@@ -140,6 +160,14 @@ bool LockManager::Unlock(Transaction *txn, const RID &rid) {
                     [txn](const TxLockForRecord &tx_lock) {
                       return tx_lock.txn_id_ == txn->GetTransactionId();
                     });
+  // the txn does not hold a lock on this record (e.g. logging is disabled)
+  if (it == tx_list_for_record.locks_.end()) {
+    if (tx_list_for_record.locks_.empty()) {
+      list_latch.unlock();
+      lock_table_.erase(rid);
+    }
+    return false;
+  }
   // 5. remove the lock
   if (it->lock_type_ == LockType::SHARED)
     txn->GetSharedLockSet()->erase(rid);
@@ -147,6 +175,7 @@ bool LockManager::Unlock(Transaction *txn, const RID &rid) {
     txn->GetExclusiveLockSet()->erase(rid);
   tx_list_for_record.locks_.erase(it);
   if (tx_list_for_record.locks_.empty()) {
+    list_latch.unlock();
     lock_table_.erase(rid);
     return true;
   }
@@ -2,6 +2,7 @@
  * transaction_manager.cpp
  *
  */
+#include "common/trace.h"
 #include "concurrency/transaction_manager.h"
 #include "table/table_heap.h"
 
@@ -10,6 +11,7 @@ namespace cmudb {
 
 Transaction *TransactionManager::Begin() {
   Transaction *txn = new Transaction(next_txn_id_++);
+  TRACE_INSTANT("txn", "Begin", txn->GetTransactionId());
 
   if (ENABLE_LOGGING) {
     // TODO: write log and update transaction's prev_lsn here
@@ -19,6 +21,7 @@ Transaction *TransactionManager::Begin() {
 }
 
 void TransactionManager::Commit(Transaction *txn) {
+  TRACE_SCOPE("txn", "Commit", txn->GetTransactionId());
   txn->SetState(TransactionState::COMMITTED);
   // truly delete before commit
   auto write_set = txn->GetWriteSet();
@@ -50,6 +53,7 @@ void TransactionManager::Commit(Transaction *txn) {
 }
 
 void TransactionManager::Abort(Transaction *txn) {
+  TRACE_SCOPE("txn", "Abort", txn->GetTransactionId());
   txn->SetState(TransactionState::ABORTED);
   // rollback before releasing lock
   auto write_set = txn->GetWriteSet();
@@ -8,6 +8,8 @@
 #include <thread>
 
 #include "common/logger.h"
+#include "common/metrics.h"
+#include "common/trace.h"
 #include "disk/disk_manager.h"
 
 namespace cmudb {
@@ -18,8 +20,8 @@ static char *buffer_used = nullptr;
  * Constructor: open/create a single database file & log file
  * @input db_file: database file name
  */
-DiskManager::DiskManager(const std::string &db_file)
-    : file_name_(db_file), next_page_id_(0), num_flushes_(0), flush_log_(false),
+DiskManager::DiskManager(const std::string &db_file, size_t page_size)
+    : file_name_(db_file), page_size_(page_size), next_page_id_(0), num_flushes_(0), flush_log_(false),
       flush_log_f_(nullptr) {
   std::string::size_type n = file_name_.find(".");
   if (n == std::string::npos) {
@@ -53,6 +55,10 @@ DiskManager::DiskManager(const std::string &db_file)
     // reopen with original mode
     db_io_.open(db_file, std::ios::binary | std::ios::in | std::ios::out);
   }
+  // new pages of a reopened file go after the existing ones
+  int file_size = GetFileSize(db_file);
+  if (file_size > 0)
+    next_page_id_ = (file_size + page_size_ - 1) / page_size_;
 }
 
 DiskManager::~DiskManager() {
@@ -64,10 +70,14 @@ DiskManager::~DiskManager() {
  * Write the contents of the specified page into disk file
  */
 void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
-  size_t offset = page_id * PAGE_SIZE;
+  Metrics::Add(MetricCounter::DISK_WRITE);
+  ScopedLatency latency(MetricHistogram::DISK_WRITE_LATENCY);
+  TRACE_SCOPE("disk", "WritePage", page_id);
+  size_t offset = static_cast<size_t>(page_id) * page_size_;
+  std::lock_guard<std::mutex> lock(db_io_latch_);
   // set write cursor to offset
   db_io_.seekp(offset);
-  db_io_.write(page_data, PAGE_SIZE);
+  db_io_.write(page_data, page_size_);
   // check for I/O error
   if (db_io_.bad()) {
     LOG_DEBUG("I/O error while writing");
@@ -77,25 +87,47 @@ void DiskManager::WritePage(page_id_t page_id, const char *page_data) {
   db_io_.flush();
 }
 
+/**
+ * Write count pages starting at page_id, data holds them back to back
+ */
+void DiskManager::WritePages(page_id_t page_id, const char *data, int count) {
+  Metrics::Add(MetricCounter::DISK_WRITE, count);
+  ScopedLatency latency(MetricHistogram::DISK_WRITE_LATENCY);
+  TRACE_SCOPE("disk", "WritePages", page_id);
+  size_t offset = static_cast<size_t>(page_id) * page_size_;
+  std::lock_guard<std::mutex> lock(db_io_latch_);
+  db_io_.seekp(offset);
+  db_io_.write(data, page_size_ * count);
+  if (db_io_.bad()) {
+    LOG_DEBUG("I/O error while writing");
+    return;
+  }
+  db_io_.flush();
+}
+
 /**
  * Read the contents of the specified page into the given memory area
  */
 void DiskManager::ReadPage(page_id_t page_id, char *page_data) {
-  int offset = page_id * PAGE_SIZE;
+  Metrics::Add(MetricCounter::DISK_READ);
+  ScopedLatency latency(MetricHistogram::DISK_READ_LATENCY);
+  TRACE_SCOPE("disk", "ReadPage", page_id);
+  size_t offset = static_cast<size_t>(page_id) * page_size_;
+  std::lock_guard<std::mutex> lock(db_io_latch_);
   // check if read beyond file length
-  if (offset > GetFileSize(file_name_)) {
+  if (offset > static_cast<size_t>(GetFileSize(file_name_))) {
     LOG_DEBUG("I/O error while reading");
     // std::cerr << "I/O error while reading" << std::endl;
   } else {
     // set read cursor to offset
     db_io_.seekp(offset);
-    db_io_.read(page_data, PAGE_SIZE);
-    // if file ends before reading PAGE_SIZE
-    int read_count = db_io_.gcount();
-    if (read_count < PAGE_SIZE) {
+    db_io_.read(page_data, page_size_);
+    // if file ends before reading a whole page
+    size_t read_count = db_io_.gcount();
+    if (read_count < page_size_) {
       LOG_DEBUG("Read less than a page");
       // std::cerr << "Read less than a page" << std::endl;
-      memset(page_data + read_count, 0, PAGE_SIZE - read_count);
+      memset(page_data + read_count, 0, page_size_ - read_count);
     }
   }
 }
@@ -120,6 +152,8 @@ void DiskManager::WriteLog(char *log_data, int size) {
            std::future_status::ready);
 
   num_flushes_ += 1;
+  Metrics::Add(MetricCounter::LOG_BYTES, size);
+  TRACE_SCOPE("log", "WriteLog", size);
   // sequence write
   log_io_.write(log_data, size);
 
@@ -130,6 +164,7 @@ void DiskManager::WriteLog(char *log_data, int size) {
   }
   // needs to flush to keep disk file in sync
   log_io_.flush();
+  Metrics::Add(MetricCounter::LOG_FLUSH);
   flush_log_ = false;
 }
 
@@ -162,6 +197,10 @@ bool DiskManager::ReadLog(char *log_data, int size, int offset) {
  */
 page_id_t DiskManager::AllocatePage() { return next_page_id_++; }
 
+page_id_t DiskManager::AllocatePages(int count) {
+  return next_page_id_.fetch_add(count);
+}
+
 /**
  * Deallocate page (operations like drop index/table)
  * Need bitmap in header page for tracking pages
@@ -0,0 +1,359 @@
+/**
+ * disk_extendible_hash.cpp
+ */
+
+#include <set>
+#include <sstream>
+
+#include "common/exception.h"
+#include "common/rid.h"
+#include "hash/city.h"
+#include "hash/disk_extendible_hash.h"
+#include "page/header_page.h"
+
+namespace cmudb {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+DISK_EXTENDIBLE_HASH_TYPE::DiskExtendibleHash(
+    const std::string &name, BufferPoolManager *buffer_pool_manager,
+    const KeyComparator &comparator, page_id_t directory_page_id)
+    : name_(name), directory_page_id_(directory_page_id),
+      buffer_pool_manager_(buffer_pool_manager), comparator_(comparator) {
+  if (directory_page_id_ != INVALID_PAGE_ID)
+    return;
+  // 1. a directory with a single empty bucket
+  page_id_t bucket_page_id;
+  Page *directory_page = buffer_pool_manager_->NewPage(directory_page_id_);
+  Page *bucket_page = buffer_pool_manager_->NewPage(bucket_page_id);
+  if (directory_page == nullptr || bucket_page == nullptr)
+    throw Exception(EXCEPTION_TYPE_INDEX, "out of memory");
+  reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData())
+      ->Init(directory_page_id_, bucket_page_id,
+             buffer_pool_manager_->GetPageSize());
+  reinterpret_cast<BucketPage *>(bucket_page->GetData())
+      ->Init(bucket_page_id, buffer_pool_manager_->GetPageSize());
+  buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+
+  // 2. record the directory in the header page
+  HeaderPage *header_page = static_cast<HeaderPage *>(
+      buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  if (!header_page->InsertRecord(name_, directory_page_id_))
+    header_page->UpdateRecord(name_, directory_page_id_);
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+/*
+ * Return the only value that associated with input key
+ * This method is used for point query
+ * @return : true means key exists
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool DISK_EXTENDIBLE_HASH_TYPE::GetValue(const KeyType &key,
+                                         std::vector<ValueType> &result,
+                                         Transaction *transaction) {
+  // 1. find the bucket, splits wait for the bucket latch
+  Page *directory_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  directory_page->RLatch();
+  auto directory =
+      reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData());
+  page_id_t page_id = directory->GetBucketPageId(directory->SlotOf(Hash(key)));
+  Page *head_page = buffer_pool_manager_->FetchPage(page_id);
+  head_page->RLatch();
+  directory_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+
+  // 2. look through the bucket and its overflow pages
+  bool found = false;
+  while (page_id != INVALID_PAGE_ID && !found) {
+    Page *page = page_id == head_page->GetPageId()
+                     ? head_page
+                     : buffer_pool_manager_->FetchPage(page_id);
+    auto bucket = reinterpret_cast<BucketPage *>(page->GetData());
+    ValueType value;
+    if (bucket->Lookup(key, value, comparator_)) {
+      result.push_back(value);
+      found = true;
+    }
+    page_id = bucket->GetNextPageId();
+    if (page != head_page)
+      buffer_pool_manager_->UnpinPage(page->GetPageId(), false);
+  }
+  head_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(head_page->GetPageId(), false);
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+/*
+ * Insert constant key & value pair into the hash table
+ * @return: since we only support unique key, if user try to insert duplicate
+ * keys return false, otherwise return true.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool DISK_EXTENDIBLE_HASH_TYPE::Insert(const KeyType &key,
+                                       const ValueType &value,
+                                       Transaction *transaction) {
+  // 1. optimistic: the bucket has room, or can only overflow anyway
+  Page *directory_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  directory_page->RLatch();
+  auto directory =
+      reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData());
+  uint32_t slot = directory->SlotOf(Hash(key));
+  page_id_t bucket_page_id = directory->GetBucketPageId(slot);
+  bool allow_overflow =
+      directory->GetLocalDepth(slot) == directory->GetMaxDepth();
+  Page *bucket_page = buffer_pool_manager_->FetchPage(bucket_page_id);
+  bucket_page->WLatch();
+  directory_page->RUnlatch();
+  bool inserted;
+  bool done =
+      InsertIntoChain(bucket_page, key, value, allow_overflow, inserted);
+  bucket_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+  if (done) {
+    buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+    return inserted;
+  }
+
+  // 2. pessimistic: split with the directory latched exclusively
+  directory_page->WLatch();
+  inserted = SplitInsert(directory, key, value);
+  directory_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, true);
+  return inserted;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool DISK_EXTENDIBLE_HASH_TYPE::InsertIntoChain(Page *head_page,
+                                                const KeyType &key,
+                                                const ValueType &value,
+                                                bool allow_overflow,
+                                                bool &inserted) {
+  inserted = false;
+  // 1. look for the key and for a page with room
+  page_id_t room_page_id = INVALID_PAGE_ID;
+  page_id_t last_page_id = INVALID_PAGE_ID;
+  page_id_t page_id = head_page->GetPageId();
+  while (page_id != INVALID_PAGE_ID) {
+    Page *page = page_id == head_page->GetPageId()
+                     ? head_page
+                     : buffer_pool_manager_->FetchPage(page_id);
+    auto bucket = reinterpret_cast<BucketPage *>(page->GetData());
+    bool found = bucket->KeyIndex(key, comparator_) != -1;
+    if (room_page_id == INVALID_PAGE_ID && !bucket->IsFull())
+      room_page_id = page_id;
+    last_page_id = page_id;
+    page_id = bucket->GetNextPageId();
+    if (page != head_page)
+      buffer_pool_manager_->UnpinPage(last_page_id, false);
+    if (found)
+      return true;
+  }
+  // 2. chain an overflow page if the bucket can not split
+  if (room_page_id == INVALID_PAGE_ID) {
+    if (!allow_overflow)
+      return false;
+    Page *overflow_page = buffer_pool_manager_->NewPage(room_page_id);
+    if (overflow_page == nullptr)
+      throw Exception(EXCEPTION_TYPE_INDEX, "out of memory");
+    reinterpret_cast<BucketPage *>(overflow_page->GetData())
+        ->Init(room_page_id, buffer_pool_manager_->GetPageSize());
+    buffer_pool_manager_->UnpinPage(room_page_id, true);
+    Page *last_page = last_page_id == head_page->GetPageId()
+                          ? head_page
+                          : buffer_pool_manager_->FetchPage(last_page_id);
+    reinterpret_cast<BucketPage *>(last_page->GetData())
+        ->SetNextPageId(room_page_id);
+    if (last_page != head_page)
+      buffer_pool_manager_->UnpinPage(last_page_id, true);
+  }
+  // 3. insert
+  Page *page = room_page_id == head_page->GetPageId()
+                   ? head_page
+                   : buffer_pool_manager_->FetchPage(room_page_id);
+  reinterpret_cast<BucketPage *>(page->GetData())->Insert(key, value);
+  if (page != head_page)
+    buffer_pool_manager_->UnpinPage(room_page_id, true);
+  inserted = true;
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool DISK_EXTENDIBLE_HASH_TYPE::SplitInsert(HashTableDirectoryPage *directory,
+                                            const KeyType &key,
+                                            const ValueType &value) {
+  uint32_t hash = Hash(key);
+  while (true) {
+    // 1. the bucket may have changed since the optimistic attempt
+    uint32_t slot = directory->SlotOf(hash);
+    page_id_t bucket_page_id = directory->GetBucketPageId(slot);
+    uint32_t local_depth = directory->GetLocalDepth(slot);
+    Page *bucket_page = buffer_pool_manager_->FetchPage(bucket_page_id);
+    bucket_page->WLatch();
+    bool inserted;
+    if (InsertIntoChain(bucket_page, key, value,
+                        local_depth == directory->GetMaxDepth(),
+                        inserted)) {
+      bucket_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(bucket_page_id, inserted);
+      return inserted;
+    }
+
+    // 2. split the bucket on hash bit local_depth
+    if (local_depth == directory->GetGlobalDepth())
+      directory->Grow();
+    page_id_t image_page_id;
+    Page *image_page = buffer_pool_manager_->NewPage(image_page_id);
+    if (image_page == nullptr) {
+      bucket_page->WUnlatch();
+      buffer_pool_manager_->UnpinPage(bucket_page_id, false);
+      throw Exception(EXCEPTION_TYPE_INDEX, "out of memory");
+    }
+    auto bucket = reinterpret_cast<BucketPage *>(bucket_page->GetData());
+    auto image = reinterpret_cast<BucketPage *>(image_page->GetData());
+    image->Init(image_page_id, buffer_pool_manager_->GetPageSize());
+    uint32_t split_bit = 1U << local_depth;
+    for (int i = 0; i < bucket->GetSize();) {
+      auto item = bucket->GetItem(i);
+      if (Hash(item.first) & split_bit) {
+        image->Insert(item.first, item.second);
+        bucket->RemoveAt(i);
+      } else {
+        i++;
+      }
+    }
+    // 3. point the slots with the bit set at the new bucket
+    for (uint32_t i = 0; i < directory->Size(); i++) {
+      if (directory->GetBucketPageId(i) != bucket_page_id)
+        continue;
+      directory->SetLocalDepth(i, local_depth + 1);
+      if (i & split_bit)
+        directory->SetBucketPageId(i, image_page_id);
+    }
+    buffer_pool_manager_->UnpinPage(image_page_id, true);
+    bucket_page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(bucket_page_id, true);
+  }
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+/*
+ * Delete key & value pair associated with input key. An overflow page that
+ * becomes empty is unlinked and deleted.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool DISK_EXTENDIBLE_HASH_TYPE::Remove(const KeyType &key,
+                                       Transaction *transaction) {
+  Page *directory_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  directory_page->RLatch();
+  auto directory =
+      reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData());
+  page_id_t page_id = directory->GetBucketPageId(directory->SlotOf(Hash(key)));
+  Page *head_page = buffer_pool_manager_->FetchPage(page_id);
+  head_page->WLatch();
+  directory_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+
+  bool removed = false;
+  page_id_t prev_page_id = INVALID_PAGE_ID;
+  while (page_id != INVALID_PAGE_ID && !removed) {
+    Page *page = page_id == head_page->GetPageId()
+                     ? head_page
+                     : buffer_pool_manager_->FetchPage(page_id);
+    auto bucket = reinterpret_cast<BucketPage *>(page->GetData());
+    int index = bucket->KeyIndex(key, comparator_);
+    page_id_t next_page_id = bucket->GetNextPageId();
+    if (index != -1) {
+      bucket->RemoveAt(index);
+      removed = true;
+    }
+    if (page == head_page) {
+      prev_page_id = page_id;
+      page_id = next_page_id;
+      continue;
+    }
+    if (removed && bucket->GetSize() == 0) {
+      // unlink the empty overflow page
+      Page *prev_page = prev_page_id == head_page->GetPageId()
+                            ? head_page
+                            : buffer_pool_manager_->FetchPage(prev_page_id);
+      reinterpret_cast<BucketPage *>(prev_page->GetData())
+          ->SetNextPageId(next_page_id);
+      if (prev_page != head_page)
+        buffer_pool_manager_->UnpinPage(prev_page_id, true);
+      buffer_pool_manager_->UnpinPage(page_id, true);
+      buffer_pool_manager_->DeletePage(page_id);
+      break;
+    }
+    buffer_pool_manager_->UnpinPage(page_id, removed);
+    prev_page_id = page_id;
+    page_id = next_page_id;
+  }
+  head_page->WUnlatch();
+  buffer_pool_manager_->UnpinPage(head_page->GetPageId(), removed);
+  return removed;
+}
+
+/*****************************************************************************
+ * UTILITIES AND DEBUG
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t DISK_EXTENDIBLE_HASH_TYPE::Hash(const KeyType &key) const {
+  return static_cast<uint32_t>(
+      CityHash64(reinterpret_cast<const char *>(&key), sizeof(KeyType)));
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+uint32_t DISK_EXTENDIBLE_HASH_TYPE::GetGlobalDepth() {
+  Page *directory_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  directory_page->RLatch();
+  uint32_t global_depth =
+      reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData())
+          ->GetGlobalDepth();
+  directory_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  return global_depth;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::string DISK_EXTENDIBLE_HASH_TYPE::ToString() {
+  std::stringstream os;
+  Page *directory_page = buffer_pool_manager_->FetchPage(directory_page_id_);
+  directory_page->RLatch();
+  auto directory =
+      reinterpret_cast<HashTableDirectoryPage *>(directory_page->GetData());
+  os << directory->ToString() << std::endl;
+  std::set<page_id_t> printed;
+  for (uint32_t i = 0; i < directory->Size(); i++) {
+    page_id_t page_id = directory->GetBucketPageId(i);
+    if (!printed.insert(page_id).second)
+      continue;
+    while (page_id != INVALID_PAGE_ID) {
+      Page *page = buffer_pool_manager_->FetchPage(page_id);
+      auto bucket = reinterpret_cast<BucketPage *>(page->GetData());
+      os << bucket->ToString() << std::endl;
+      page_id_t next_page_id = bucket->GetNextPageId();
+      buffer_pool_manager_->UnpinPage(page_id, false);
+      page_id = next_page_id;
+    }
+  }
+  directory_page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(directory_page_id_, false);
+  return os.str();
+}
+
+template class DiskExtendibleHash<GenericKey<4>, RID, GenericComparator<4>>;
+template class DiskExtendibleHash<GenericKey<8>, RID, GenericComparator<8>>;
+template class DiskExtendibleHash<GenericKey<16>, RID, GenericComparator<16>>;
+template class DiskExtendibleHash<GenericKey<32>, RID, GenericComparator<32>>;
+template class DiskExtendibleHash<GenericKey<64>, RID, GenericComparator<64>>;
+
+} // namespace cmudb
@@ -11,6 +11,7 @@
 #include <mutex>
 
 #include "buffer/lru_replacer.h"
+#include "common/latch_profiler.h"
 #include "disk/disk_manager.h"
 #include "hash/extendible_hash.h"
 #include "logging/log_manager.h"
@@ -39,15 +40,20 @@ public:
 
   void FlushAllPages();
 
+  // the page size of the disk manager
+  inline size_t GetPageSize() const { return page_size_; }
+
 private:
   size_t pool_size_; // number of pages in buffer pool
+  size_t page_size_; // size of a page in byte
   Page *pages_;      // array of pages
+  char *frames_;     // content of the pages
   DiskManager *disk_manager_;
   LogManager *log_manager_;
   HashTable<page_id_t, Page *> *page_table_; // to keep track of pages
   Replacer<Page *> *replacer_;   // to find an unpinned page for replacement
   std::list<Page *> *free_list_; // to find a free page for replacement
-  std::mutex latch_;             // to protect shared data structure
+  ProfiledMutex latch_{LatchClass::BPM_LATCH}; // to protect shared data structure
 
   Page *GetFreePage();
 };
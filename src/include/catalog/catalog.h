@@ -0,0 +1,81 @@
+/**
+ * catalog.h
+ *
+ * Catalog of the tables of a database, keyed by table name: the first page
+ * of the table heap, the CREATE VIRTUAL TABLE arguments, the dictionary of
+ * encoded columns and stats.
+ *
+ * Entries are records in buckets of chained catalog pages, the bucket is
+ * picked by a hash of the name (see page/catalog_page.h). The directory of
+ * buckets is found through the header page record "__catalog". Every entry
+ * is read into a cache when the catalog is opened, so lookups never touch a
+ * page, and changes write through to the page of the entry.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace cmudb {
+
+// layout of the tuples in the table heap: 1 is the packed layout with a
+// null bitmap, 0 stands for tables written before it
+static const int32_t TUPLE_LAYOUT_VERSION = 1;
+
+struct CatalogEntry {
+  std::string name;
+  page_id_t first_page_id = INVALID_PAGE_ID;
+  // column definitions, as given to CREATE VIRTUAL TABLE
+  std::string schema;
+  // index definition, empty for a table without index
+  std::string index;
+  // rows at the last disconnect
+  int64_t row_count = 0;
+  // dictionary of the encoded columns, INVALID_PAGE_ID for a table without
+  // them
+  page_id_t dictionary_page_id = INVALID_PAGE_ID;
+  // tuple layout the rows were written with
+  int32_t layout_version = TUPLE_LAYOUT_VERSION;
+};
+
+class Catalog {
+public:
+  // open the catalog of the database, create it on first use. The header
+  // page must exist
+  explicit Catalog(BufferPoolManager *buffer_pool_manager);
+
+  // false if an entry of that name exists
+  bool CreateEntry(const CatalogEntry &entry);
+
+  // copy the entry of that name, false if there is none
+  bool GetEntry(const std::string &name, CatalogEntry &entry);
+
+  // replace the entry of the same name, false if there is none
+  bool UpdateEntry(const CatalogEntry &entry);
+
+  bool DropEntry(const std::string &name);
+
+  size_t GetEntryCount();
+
+private:
+  // store the record in the bucket of name, returns its page
+  page_id_t WriteRecord(const std::string &name, const std::string &payload);
+
+  static std::string Serialize(const CatalogEntry &entry);
+  static CatalogEntry Deserialize(const std::string &name,
+                                  const std::string &payload);
+
+  Page *FetchPage(page_id_t page_id);
+
+  BufferPoolManager *buffer_pool_manager_;
+  page_id_t directory_page_id_;
+  // entry and the page holding its record
+  std::unordered_map<std::string, std::pair<CatalogEntry, page_id_t>> cache_;
+  std::mutex latch_;
+};
+
+} // namespace cmudb
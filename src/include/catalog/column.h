@@ -60,6 +60,18 @@ public:
 
   inline bool IsInlined() const { return is_inlined; }
 
+  // a VARCHAR column stored as the INTEGER code of its value in the table
+  // dictionary (see catalog/dictionary.h)
+  inline bool IsDictionary() const { return is_dictionary; }
+
+  inline void SetDictionary(bool dictionary) { is_dictionary = dictionary; }
+
+  // an integer column stored as a zigzag varint after the fixed length
+  // columns, in 1 byte for values in [-64, 64) (see table/tuple.h)
+  inline bool IsVarint() const { return is_varint; }
+
+  inline void SetVarint(bool varint) { is_varint = varint; }
+
   // Compare two column objects
   bool operator==(const Column &other) const {
     if (other.column_type != column_type || other.is_inlined != is_inlined) {
@@ -97,6 +109,12 @@ private:
 
   // offset of column in tuple
   int32_t column_offset = -1;
+
+  // is the column dictionary encoded ?
+  bool is_dictionary = false;
+
+  // is the column varint encoded ?
+  bool is_varint = false;
 };
 
 } // namespace cmudb
\ No newline at end of file
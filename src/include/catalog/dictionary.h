@@ -0,0 +1,70 @@
+/**
+ * dictionary.h
+ *
+ * Dictionary of the encoded VARCHAR columns of a table. A value is stored in
+ * its tuples as an INTEGER code, assigned in order of first insert from 0
+ * per column, and decoded only when sqlite reads the column.
+ *
+ * Every (value, column, code) is a record of a chain of catalog pages (see
+ * page/catalog_page.h), the head page is kept in the catalog entry of the
+ * table. Records are only appended, the whole dictionary is read into memory
+ * when the table is opened.
+ *
+ * Record payload format (size in byte):
+ *  -------------------------
+ * | Code (4) | ColumnName |
+ *  -------------------------
+ */
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "buffer/buffer_pool_manager.h"
+
+namespace cmudb {
+
+class Dictionary {
+public:
+  // open the dictionary starting at first_page_id, a new one is created
+  // when it is INVALID_PAGE_ID
+  Dictionary(BufferPoolManager *buffer_pool_manager,
+             page_id_t first_page_id = INVALID_PAGE_ID);
+
+  inline page_id_t GetFirstPageId() const { return first_page_id_; }
+
+  // code of the value in the column, a value seen for the first time gets
+  // the next code and is written to the dictionary pages
+  int32_t Encode(const std::string &column, const std::string &value);
+
+  // code of the value in the column, false if it has none
+  bool Lookup(const std::string &column, const std::string &value,
+              int32_t &code);
+
+  // value of a code of the column
+  const std::string &Decode(const std::string &column, int32_t code);
+
+  // distinct values of the column
+  size_t GetSize(const std::string &column);
+
+private:
+  struct ColumnDictionary {
+    std::unordered_map<std::string, int32_t> codes;
+    // by code, a deque so decoded values stay put while codes are added
+    std::deque<std::string> values;
+  };
+
+  Page *FetchPage(page_id_t page_id);
+
+  BufferPoolManager *buffer_pool_manager_;
+  page_id_t first_page_id_;
+  // new records are appended here
+  page_id_t last_page_id_;
+  std::unordered_map<std::string, ColumnDictionary> columns_;
+  std::mutex latch_;
+};
+
+} // namespace cmudb
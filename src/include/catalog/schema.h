@@ -1,5 +1,11 @@
 /**
  * schema.h
+ *
+ * Layout of the columns in a tuple. The fixed length columns (and the offsets
+ * of the VARCHAR columns) are ordered by their length, 8 byte columns first,
+ * so each is aligned to its size whenever the tuple is, and their offsets are
+ * computed once here. A schema with a null bitmap keeps one bit per column
+ * after them, the varint columns follow in column order (see table/tuple.h).
  */
 
 #pragma once
@@ -17,10 +23,12 @@ public:
   //===--------------------------------------------------------------------===//
   // Static factory methods to construct schema objects
   //===--------------------------------------------------------------------===//
-  // Construct schema from vector of Column
-  Schema(const std::vector<Column> &columns);
+  // Construct schema from vector of Column, null_bitmap keeps a bit per
+  // column telling whether it is NULL in every tuple
+  Schema(const std::vector<Column> &columns, bool null_bitmap = false);
 
-  // Copy Schema, use to construct indexed tuple
+  // Copy Schema, use to construct indexed tuple. Keys are fixed length: the
+  // copy has no null bitmap and no varint column
   static Schema *CopySchema(const Schema *schema, const std::vector<int> &ids);
 
   // Compare two schemas
@@ -33,7 +41,7 @@ public:
   //===--------------------------------------------------------------------===//
 
   inline int32_t GetOffset(const int column_id) const {
-    return columns[column_id].GetOffset();
+    return offsets[column_id];
   }
 
   inline TypeId GetType(const int column_id) const {
@@ -67,6 +75,27 @@ public:
     return columns[column_id].IsInlined();
   }
 
+  inline bool IsDictionary(const int column_id) const {
+    return columns[column_id].IsDictionary();
+  }
+
+  inline bool IsVarint(const int column_id) const {
+    return columns[column_id].IsVarint();
+  }
+
+  // number of varint columns stored before the column
+  inline int GetVarintOrdinal(const int column_id) const {
+    return offsets[column_id];
+  }
+
+  inline bool HasNullBitmap() const { return has_null_bitmap; }
+
+  inline int32_t GetNullBitmapOffset() const { return null_bitmap_offset; }
+
+  inline const std::string &GetColumnName(const int column_id) const {
+    return columns[column_id].column_name;
+  }
+
   inline const Column GetColumn(const int column_id) const {
     return columns[column_id];
   }
@@ -86,6 +115,11 @@ public:
     return uninlined_columns;
   }
 
+  // varint columns, in the order they are stored
+  inline const std::vector<int> &GetVarintColumns() const {
+    return varint_columns;
+  }
+
   inline const std::vector<Column> &GetColumns() const { return columns; }
 
   // Return the number of columns in the schema for the tuple.
@@ -95,7 +129,8 @@ public:
     return static_cast<int>(uninlined_columns.size());
   }
 
-  // Return the number of bytes used by one tuple.
+  // Return the number of bytes used by one tuple, the varint columns and the
+  // VARCHAR payloads follow.
   inline int32_t GetLength() const { return length; }
 
   // Returns a flag indicating whether all columns are inlined
@@ -105,12 +140,23 @@ public:
   std::string ToString() const;
 
 private:
-  // size of fixed length columns
+  // size of fixed length columns and the null bitmap
   int32_t length;
 
   // all inlined and uninlined columns in the tuple
   std::vector<Column> columns;
 
+  // by column id, the offset of a fixed length column or the varint ordinal
+  // of a varint column. Apart from columns to keep them in a cache line
+  std::vector<int32_t> offsets;
+
+  bool has_null_bitmap;
+
+  int32_t null_bitmap_offset = -1;
+
+  // keeps track of varint columns, using logical position(start with 0)
+  std::vector<int> varint_columns;
+
   // are all columns inlined
   bool tuple_is_inlined;
 
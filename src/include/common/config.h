@@ -20,11 +20,18 @@ extern std::atomic<bool> ENABLE_LOGGING;
 #define INVALID_TXN_ID -1  // representing an invalid txn id
 #define INVALID_LSN -1     // representing an invalid lsn
 #define HEADER_PAGE_ID 0   // the header page id
+#ifndef PAGE_SIZE
 #define PAGE_SIZE 512     // size of a data page in byte
+#endif
+#ifndef INDEX_PAGE_SIZE
+#define INDEX_PAGE_SIZE 16384 // size of an index node in byte, see DiskManager
+#endif
 #define LOG_BUFFER_SIZE                                                            \
   ((BUFFER_POOL_SIZE + 1) * PAGE_SIZE) // size of a log buffer in byte
 #define BUCKET_SIZE 50                 // size of extendible hash bucket
+#ifndef BUFFER_POOL_SIZE
 #define BUFFER_POOL_SIZE 10            // size of buffer pool
+#endif
 
 typedef int32_t page_id_t; // page id type
 typedef int32_t txn_id_t;  // transaction id type
@@ -0,0 +1,143 @@
+/**
+ * latch_profiler.h
+ *
+ * Latch contention profiling, compiled in with -DLATCH_PROFILING=ON. For
+ * every latch class it records acquisitions, how many of them had to block,
+ * a histogram of the time spent blocking and a histogram of the time the
+ * latch was held exclusively (shared holders are not timed, several of them
+ * may hold a latch at once). The numbers land in the engine metrics, so they
+ * are merged on read and show up in vtable_stats; Dump() formats them.
+ *
+ * Without LATCH_PROFILING the latches are plain std::mutex / RWMutex calls.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+
+#include "common/metrics.h"
+
+namespace cmudb {
+
+enum class LatchClass : int {
+  BPM_LATCH = 0,
+  ROOT_LATCH,
+  PAGE_LATCH,
+  LOCK_TABLE_MUTEX,
+  LOG_LATCH,
+  NUM_LATCH_CLASSES,
+  // latches that are not profiled
+  UNPROFILED = NUM_LATCH_CLASSES
+};
+
+static const int NUM_LATCH_CLASSES =
+    static_cast<int>(LatchClass::NUM_LATCH_CLASSES);
+
+class LatchProfiler {
+public:
+  inline static bool Enabled() {
+#ifdef LATCH_PROFILING
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  inline static uint64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  // contended: the latch could not be taken without blocking
+  inline static void Acquired(LatchClass latch_class, bool contended,
+                              uint64_t wait_ns) {
+    if (latch_class == LatchClass::UNPROFILED)
+      return;
+    Metrics::Add(Counter(latch_class, 0));
+    if (contended) {
+      Metrics::Add(Counter(latch_class, 1));
+      Metrics::Record(Histogram(latch_class, 0), wait_ns);
+    }
+  }
+
+  inline static void Released(LatchClass latch_class, uint64_t hold_ns) {
+    if (latch_class == LatchClass::UNPROFILED)
+      return;
+    Metrics::Record(Histogram(latch_class, 1), hold_ns);
+  }
+
+  // one line per latch class
+  static std::string Dump();
+
+  static const char *Name(LatchClass latch_class);
+
+  // metrics are laid out as (acquire, contended) and (wait, hold) pairs
+  inline static MetricCounter Counter(LatchClass latch_class, int which) {
+    return static_cast<MetricCounter>(
+        static_cast<int>(MetricCounter::BPM_LATCH_ACQUIRE) +
+        2 * static_cast<int>(latch_class) + which);
+  }
+
+  inline static MetricHistogram Histogram(LatchClass latch_class, int which) {
+    return static_cast<MetricHistogram>(
+        static_cast<int>(MetricHistogram::BPM_LATCH_WAIT) +
+        2 * static_cast<int>(latch_class) + which);
+  }
+};
+
+/*
+ * std::mutex that reports to the latch profiler, usable with
+ * std::unique_lock / std::lock_guard (and std::condition_variable_any)
+ */
+class ProfiledMutex {
+public:
+  explicit ProfiledMutex(LatchClass latch_class) : latch_class_(latch_class) {}
+
+  ProfiledMutex(const ProfiledMutex &) = delete;
+  ProfiledMutex &operator=(const ProfiledMutex &) = delete;
+
+  inline void lock() {
+#ifdef LATCH_PROFILING
+    if (mutex_.try_lock()) {
+      LatchProfiler::Acquired(latch_class_, false, 0);
+    } else {
+      uint64_t start = LatchProfiler::Now();
+      mutex_.lock();
+      LatchProfiler::Acquired(latch_class_, true, LatchProfiler::Now() - start);
+    }
+    acquired_at_ = LatchProfiler::Now();
+#else
+    mutex_.lock();
+#endif
+  }
+
+  inline bool try_lock() {
+    if (!mutex_.try_lock())
+      return false;
+#ifdef LATCH_PROFILING
+    LatchProfiler::Acquired(latch_class_, false, 0);
+    acquired_at_ = LatchProfiler::Now();
+#endif
+    return true;
+  }
+
+  inline void unlock() {
+#ifdef LATCH_PROFILING
+    LatchProfiler::Released(latch_class_, LatchProfiler::Now() - acquired_at_);
+#endif
+    mutex_.unlock();
+  }
+
+private:
+  std::mutex mutex_;
+  LatchClass latch_class_;
+#ifdef LATCH_PROFILING
+  uint64_t acquired_at_ = 0;
+#endif
+};
+
+} // namespace cmudb
@@ -0,0 +1,179 @@
+/**
+ * metrics.h
+ *
+ * Engine wide counters and histograms. Every thread updates a slot of its
+ * own (a relaxed load + store, no shared cache line), readers merge all the
+ * slots on demand. Slots of exited threads are folded into a retired slot so
+ * their counts are not lost.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace cmudb {
+
+enum class MetricCounter : int {
+  BUFFER_HIT = 0,
+  BUFFER_MISS,
+  BUFFER_EVICTION,
+  BUFFER_DIRTY_WRITEBACK,
+  DISK_READ,
+  DISK_WRITE,
+  BTREE_SPLIT,
+  BTREE_MERGE,
+  BTREE_REDISTRIBUTE,
+  BTREE_LATCH_WAIT,
+  BTREE_HASH_HIT,
+  BTREE_HASH_MISS,
+  BTREE_LEAF_REUSE,
+  BLOOM_FILTER_SKIP,
+  BLOOM_FILTER_FALSE_POSITIVE,
+  BLINK_MOVE_RIGHT,
+  BEPSILON_FLUSH,
+  INDEX_ONLY_ROW,
+  INDEX_SCAN_ROW,
+  FILTER_SKIP_ROW,
+  IMPORT_ROW,
+  IMPORT_BYTE,
+  LOCK_WAIT,
+  LOCK_ABORT,
+  LOG_BYTES,
+  LOG_FLUSH,
+  // latch profiling (LATCH_PROFILING), two counters per LatchClass
+  BPM_LATCH_ACQUIRE,
+  BPM_LATCH_CONTENDED,
+  ROOT_LATCH_ACQUIRE,
+  ROOT_LATCH_CONTENDED,
+  PAGE_LATCH_ACQUIRE,
+  PAGE_LATCH_CONTENDED,
+  LOCK_TABLE_MUTEX_ACQUIRE,
+  LOCK_TABLE_MUTEX_CONTENDED,
+  LOG_LATCH_ACQUIRE,
+  LOG_LATCH_CONTENDED,
+  NUM_COUNTERS
+};
+
+// histograms of nanoseconds
+enum class MetricHistogram : int {
+  DISK_READ_LATENCY = 0,
+  DISK_WRITE_LATENCY,
+  LOCK_WAIT_LATENCY,
+  // latch profiling (LATCH_PROFILING), two histograms per LatchClass
+  BPM_LATCH_WAIT,
+  BPM_LATCH_HOLD,
+  ROOT_LATCH_WAIT,
+  ROOT_LATCH_HOLD,
+  PAGE_LATCH_WAIT,
+  PAGE_LATCH_HOLD,
+  LOCK_TABLE_MUTEX_WAIT,
+  LOCK_TABLE_MUTEX_HOLD,
+  LOG_LATCH_WAIT,
+  LOG_LATCH_HOLD,
+  NUM_HISTOGRAMS
+};
+
+static const int NUM_COUNTERS =
+    static_cast<int>(MetricCounter::NUM_COUNTERS);
+static const int NUM_HISTOGRAMS =
+    static_cast<int>(MetricHistogram::NUM_HISTOGRAMS);
+// bucket i holds values in [2^(i-1), 2^i), bucket 0 holds 0
+static const int HISTOGRAM_BUCKETS = 64;
+
+struct HistogramSnapshot {
+  uint64_t count = 0;
+  uint64_t sum = 0;
+  uint64_t buckets[HISTOGRAM_BUCKETS] = {0};
+
+  // upper bound of the bucket holding the p-th percentile, p in [0, 100]
+  uint64_t Percentile(double p) const;
+};
+
+struct MetricsSnapshot {
+  uint64_t counters[NUM_COUNTERS] = {0};
+  HistogramSnapshot histograms[NUM_HISTOGRAMS];
+
+  inline uint64_t Get(MetricCounter id) const {
+    return counters[static_cast<int>(id)];
+  }
+  inline const HistogramSnapshot &Get(MetricHistogram id) const {
+    return histograms[static_cast<int>(id)];
+  }
+};
+
+class Metrics {
+public:
+  struct Slot {
+    std::atomic<uint64_t> counters[NUM_COUNTERS];
+    std::atomic<uint64_t> histogram_sum[NUM_HISTOGRAMS];
+    std::atomic<uint64_t> histogram_buckets[NUM_HISTOGRAMS][HISTOGRAM_BUCKETS];
+
+    Slot();
+    // only the owning thread writes, so no read-modify-write is needed
+    inline static void Bump(std::atomic<uint64_t> &cell, uint64_t n) {
+      cell.store(cell.load(std::memory_order_relaxed) + n,
+                 std::memory_order_relaxed);
+    }
+  };
+
+  inline static void Add(MetricCounter id, uint64_t n = 1) {
+    Slot::Bump(LocalSlot()->counters[static_cast<int>(id)], n);
+  }
+
+  inline static void Record(MetricHistogram id, uint64_t value) {
+    Slot *slot = LocalSlot();
+    int h = static_cast<int>(id);
+    Slot::Bump(slot->histogram_sum[h], value);
+    Slot::Bump(slot->histogram_buckets[h][BucketOf(value)], 1);
+  }
+
+  // merge the slots of every thread
+  static MetricsSnapshot Snapshot();
+
+  // zero every slot, counts racing with the reset may survive it
+  static void Reset();
+
+  static const char *Name(MetricCounter id);
+
+  static const char *Name(MetricHistogram id);
+
+  // values of 2^63 and above share the last bucket
+  inline static int BucketOf(uint64_t value) {
+    int bucket = value == 0 ? 0 : 64 - __builtin_clzll(value);
+    return bucket < HISTOGRAM_BUCKETS ? bucket : HISTOGRAM_BUCKETS - 1;
+  }
+
+private:
+  inline static Slot *LocalSlot() {
+    if (local_slot_ == nullptr)
+      local_slot_ = RegisterThread();
+    return local_slot_;
+  }
+
+  static Slot *RegisterThread();
+
+  static thread_local Slot *local_slot_;
+};
+
+// records the lifetime of the object into a histogram
+class ScopedLatency {
+public:
+  ScopedLatency(MetricHistogram id)
+      : id_(id), start_(std::chrono::steady_clock::now()) {}
+
+  ~ScopedLatency() {
+    Metrics::Record(id_, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - start_)
+                             .count());
+  }
+
+private:
+  MetricHistogram id_;
+  std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace cmudb
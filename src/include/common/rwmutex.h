@@ -1,69 +1,320 @@
 /**
  * rwmutex.h
  *
- * Reader-Writer lock
+ * Reader-Writer latches, both report to the latch profiler when built with
+ * LATCH_PROFILING (see common/latch_profiler.h)
+ *
+ * RWMutex keeps its whole state in one atomic word: an uncontended RLock or
+ * WLock is a single compare-and-swap. A blocked thread spins for a while and
+ * then parks on a futex. Writers are preferred, once a writer waits no new
+ * reader gets in, so readers can not starve writers (a thread must therefore
+ * not take a read latch it already holds).
+ *
+ * ShardedRWMutex gives every reader thread a counter on a cache line of its
+ * own, so read-mostly latches (the B+ tree root latch) do not bounce a cache
+ * line between cores; writers pay for it by checking every counter.
  */
 
 #pragma once
 
+#include <atomic>
 #include <climits>
-#include <condition_variable>
-#include <mutex>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "common/latch_profiler.h"
 
 namespace cmudb {
-class RWMutex {
 
-  typedef std::mutex mutex_t;
-  typedef std::condition_variable cond_t;
-  static const uint32_t max_readers_ = UINT_MAX;
+/*
+ * Blocked threads wait here: they spin on their condition first and then
+ * sleep until the epoch moves. Every state change that may unblock a waiter
+ * is followed by Notify().
+ */
+class LatchWaitQueue {
+  // spins before parking, enough to cover a short critical section
+  static const int spin_limit_ = 128;
 
 public:
-  RWMutex() : reader_count_(0), writer_entered_(false) {}
+  template <typename Ready> void Wait(Ready ready) {
+    for (int i = 0; i < spin_limit_; i++) {
+      if (ready())
+        return;
+      Pause();
+    }
+    while (true) {
+      uint32_t epoch = epoch_.load();
+      sleepers_.fetch_add(1);
+      if (ready()) {
+        sleepers_.fetch_sub(1);
+        return;
+      }
+      Park(epoch);
+      sleepers_.fetch_sub(1);
+      if (ready())
+        return;
+    }
+  }
+
+  inline void Notify() {
+    epoch_.fetch_add(1);
+    if (sleepers_.load() != 0)
+      WakeAll();
+  }
 
-  ~RWMutex() { std::lock_guard<mutex_t> guard(mutex_); }
+private:
+  inline static void Pause() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+  }
+
+  void Park(uint32_t epoch) {
+#ifdef __linux__
+    // returns at once when the epoch already moved
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&epoch_),
+            FUTEX_WAIT_PRIVATE, epoch, nullptr, nullptr, 0);
+#else
+    if (epoch_.load() == epoch)
+      std::this_thread::yield();
+#endif
+  }
+
+  void WakeAll() {
+#ifdef __linux__
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&epoch_),
+            FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+#endif
+  }
+
+  std::atomic<uint32_t> epoch_{0};
+  std::atomic<uint32_t> sleepers_{0};
+};
 
-  RWMutex(const RWMutex &) = delete;
-  RWMutex &operator=(const RWMutex &) = delete;
+/*
+ * Public interface of the latches, Latch implements
+ * {W,R}LockInternal, Try{W,R}LockInternal and {W,R}UnlockInternal
+ */
+template <typename Latch> class RWLatch {
+public:
+  explicit RWLatch(LatchClass latch_class) : latch_class_(latch_class) {}
+
+  RWLatch(const RWLatch &) = delete;
+  RWLatch &operator=(const RWLatch &) = delete;
 
   void WLock() {
-    std::unique_lock<mutex_t> lock(mutex_);
-    while (writer_entered_)
-      reader_.wait(lock);
-    writer_entered_ = true;
-    while (reader_count_ > 0)
-      writer_.wait(lock);
+#ifdef LATCH_PROFILING
+    if (Self()->TryWLockInternal()) {
+      LatchProfiler::Acquired(latch_class_, false, 0);
+    } else {
+      uint64_t start = LatchProfiler::Now();
+      Self()->WLockInternal();
+      LatchProfiler::Acquired(latch_class_, true, LatchProfiler::Now() - start);
+    }
+    acquired_at_ = LatchProfiler::Now();
+#else
+    Self()->WLockInternal();
+#endif
+  }
+
+  bool TryWLock() {
+    if (!Self()->TryWLockInternal())
+      return false;
+#ifdef LATCH_PROFILING
+    LatchProfiler::Acquired(latch_class_, false, 0);
+    acquired_at_ = LatchProfiler::Now();
+#endif
+    return true;
   }
 
   void WUnlock() {
-    std::lock_guard<mutex_t> guard(mutex_);
-    writer_entered_ = false;
-    reader_.notify_all();
+#ifdef LATCH_PROFILING
+    LatchProfiler::Released(latch_class_, LatchProfiler::Now() - acquired_at_);
+#endif
+    Self()->WUnlockInternal();
   }
 
   void RLock() {
-    std::unique_lock<mutex_t> lock(mutex_);
-    while (writer_entered_ || reader_count_ == max_readers_)
-      reader_.wait(lock);
-    reader_count_++;
-  }
-
-  void RUnlock() {
-    std::lock_guard<mutex_t> guard(mutex_);
-    reader_count_--;
-    if (writer_entered_) {
-      if (reader_count_ == 0)
-        writer_.notify_one();
+#ifdef LATCH_PROFILING
+    if (Self()->TryRLockInternal()) {
+      LatchProfiler::Acquired(latch_class_, false, 0);
     } else {
-      if (reader_count_ == max_readers_ - 1)
-        reader_.notify_one();
+      uint64_t start = LatchProfiler::Now();
+      Self()->RLockInternal();
+      LatchProfiler::Acquired(latch_class_, true, LatchProfiler::Now() - start);
     }
+#else
+    Self()->RLockInternal();
+#endif
   }
 
+  bool TryRLock() {
+    if (!Self()->TryRLockInternal())
+      return false;
+#ifdef LATCH_PROFILING
+    LatchProfiler::Acquired(latch_class_, false, 0);
+#endif
+    return true;
+  }
+
+  void RUnlock() { Self()->RUnlockInternal(); }
+
 private:
-  mutex_t mutex_;
-  cond_t writer_;
-  cond_t reader_;
-  uint32_t reader_count_;
-  bool writer_entered_;
+  inline Latch *Self() { return static_cast<Latch *>(this); }
+
+  LatchClass latch_class_;
+#ifdef LATCH_PROFILING
+  // when the current writer got the latch
+  uint64_t acquired_at_ = 0;
+#endif
+};
+
+class RWMutex : public RWLatch<RWMutex> {
+  friend class RWLatch<RWMutex>;
+
+  static const uint32_t writer_bit_ = 1U << 31;
+  static const uint32_t max_readers_ = writer_bit_ - 1;
+
+public:
+  RWMutex(LatchClass latch_class = LatchClass::UNPROFILED)
+      : RWLatch<RWMutex>(latch_class) {}
+
+private:
+  void WLockInternal() {
+    writers_waiting_.fetch_add(1);
+    while (!TryWLockInternal())
+      queue_.Wait([this] { return state_.load() == 0; });
+    writers_waiting_.fetch_sub(1);
+  }
+
+  inline bool TryWLockInternal() {
+    uint32_t expected = 0;
+    return state_.compare_exchange_strong(expected, writer_bit_);
+  }
+
+  inline void WUnlockInternal() {
+    state_.store(0);
+    queue_.Notify();
+  }
+
+  void RLockInternal() {
+    while (!TryRLockInternal())
+      queue_.Wait([this] { return ReaderMayEnter(state_.load()); });
+  }
+
+  inline bool TryRLockInternal() {
+    uint32_t state = state_.load();
+    while (ReaderMayEnter(state)) {
+      if (state_.compare_exchange_weak(state, state + 1))
+        return true;
+    }
+    return false;
+  }
+
+  inline void RUnlockInternal() {
+    // the last reader lets a waiting writer in
+    uint32_t state = state_.fetch_sub(1);
+    if ((state == 1 && writers_waiting_.load() != 0) || state == max_readers_)
+      queue_.Notify();
+  }
+
+  inline bool ReaderMayEnter(uint32_t state) {
+    return (state & writer_bit_) == 0 && state != max_readers_ &&
+           writers_waiting_.load() == 0;
+  }
+
+  // writer_bit_ | number of readers
+  std::atomic<uint32_t> state_{0};
+  std::atomic<uint32_t> writers_waiting_{0};
+  LatchWaitQueue queue_;
+};
+
+class ShardedRWMutex : public RWLatch<ShardedRWMutex> {
+  friend class RWLatch<ShardedRWMutex>;
+
+  static const int num_shards_ = 16;
+
+  // one cache line each
+  struct alignas(64) Shard {
+    std::atomic<uint32_t> readers{0};
+  };
+
+public:
+  ShardedRWMutex(LatchClass latch_class = LatchClass::UNPROFILED)
+      : RWLatch<ShardedRWMutex>(latch_class) {}
+
+private:
+  void WLockInternal() {
+    uint32_t expected = 0;
+    while (!writer_.compare_exchange_strong(expected, 1)) {
+      queue_.Wait([this] { return writer_.load() == 0; });
+      expected = 0;
+    }
+    // no new reader gets in, wait for the current ones to leave
+    queue_.Wait([this] { return NoReaders(); });
+  }
+
+  bool TryWLockInternal() {
+    uint32_t expected = 0;
+    if (!writer_.compare_exchange_strong(expected, 1))
+      return false;
+    if (NoReaders())
+      return true;
+    writer_.store(0);
+    queue_.Notify();
+    return false;
+  }
+
+  inline void WUnlockInternal() {
+    writer_.store(0);
+    queue_.Notify();
+  }
+
+  void RLockInternal() {
+    while (!TryRLockInternal())
+      queue_.Wait([this] { return writer_.load() == 0; });
+  }
+
+  inline bool TryRLockInternal() {
+    std::atomic<uint32_t> &readers = LocalShard().readers;
+    readers.fetch_add(1);
+    if (writer_.load() == 0)
+      return true;
+    // a writer holds or wants the latch, back off
+    RUnlockInternal();
+    return false;
+  }
+
+  inline void RUnlockInternal() {
+    if (LocalShard().readers.fetch_sub(1) == 1 && writer_.load() != 0)
+      queue_.Notify();
+  }
+
+  bool NoReaders() {
+    for (const Shard &shard : shards_) {
+      if (shard.readers.load() != 0)
+        return false;
+    }
+    return true;
+  }
+
+  // a thread always uses the same shard, so RUnlock finds its RLock
+  inline Shard &LocalShard() {
+    static thread_local size_t shard =
+        std::hash<std::thread::id>()(std::this_thread::get_id()) % num_shards_;
+    return shards_[shard];
+  }
+
+  Shard shards_[num_shards_];
+  // 1 when a writer holds or waits for the latch
+  std::atomic<uint32_t> writer_{0};
+  LatchWaitQueue queue_;
 };
 } // namespace cmudb
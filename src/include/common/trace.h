@@ -0,0 +1,120 @@
+/**
+ * trace.h
+ *
+ * Timeline of what the engine was doing, for latency spikes the metrics can
+ * only count. Every thread appends timestamped events to a ring buffer of its
+ * own (the newest RING_CAPACITY events survive), Trace::ToChromeJson() merges
+ * the rings into the Chrome trace format (chrome://tracing, Perfetto).
+ *
+ * Tracing is off until Trace::Start(); while off a trace point costs one
+ * relaxed load and a branch. Configure with -DTRACING=OFF to compile the
+ * trace points out.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace cmudb {
+
+struct TraceEvent {
+  // string literals, never freed
+  const char *category;
+  const char *name;
+  // 'X' complete event with a duration, 'i' instant event
+  char phase;
+  uint64_t start_ns;
+  uint64_t duration_ns;
+  // page id, txn id, ..., -1 when the event has none
+  int64_t arg;
+};
+
+class Trace {
+public:
+  static const size_t RING_CAPACITY = 8192;
+
+  inline static bool Enabled() {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  // drop the recorded events and start recording
+  static void Start();
+
+  static void Stop();
+
+  inline static uint64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  static void Record(const TraceEvent &event);
+
+  inline static void Instant(const char *category, const char *name,
+                             int64_t arg = -1) {
+    Record(TraceEvent{category, name, 'i', Now(), 0, arg});
+  }
+
+  /*
+   * the events of every thread, oldest first per thread. Events recorded
+   * while the dump runs may be torn, Stop() first for an exact timeline.
+   * events, when given, receives the number of events in the dump
+   */
+  static std::string ToChromeJson(int64_t *events = nullptr);
+
+  // returns the number of events written, -1 when the file can't be written
+  static int64_t WriteChromeJson(const std::string &path);
+
+private:
+  static std::atomic<bool> enabled_;
+};
+
+// records its lifetime as a complete event
+class TraceScope {
+public:
+  TraceScope(const char *category, const char *name, int64_t arg = -1)
+      : start_ns_(Trace::Enabled() ? Trace::Now() : 0), category_(category),
+        name_(name), arg_(arg) {}
+
+  ~TraceScope() {
+    if (start_ns_ != 0 && Trace::Enabled())
+      Trace::Record(TraceEvent{category_, name_, 'X', start_ns_,
+                               Trace::Now() - start_ns_, arg_});
+  }
+
+  TraceScope(const TraceScope &) = delete;
+  TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+  // 0 when tracing was off at construction
+  uint64_t start_ns_;
+  const char *category_;
+  const char *name_;
+  int64_t arg_;
+};
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+
+#ifdef TRACING
+// trace the rest of the enclosing scope
+#define TRACE_SCOPE(category, name, ...)                                       \
+  TraceScope TRACE_CONCAT(trace_scope_, __LINE__)(category, name, ##__VA_ARGS__)
+#define TRACE_INSTANT(category, name, ...)                                     \
+  do {                                                                         \
+    if (Trace::Enabled())                                                      \
+      Trace::Instant(category, name, ##__VA_ARGS__);                           \
+  } while (0)
+#else
+#define TRACE_SCOPE(category, name, ...)                                       \
+  do {                                                                         \
+  } while (0)
+#define TRACE_INSTANT(category, name, ...)                                     \
+  do {                                                                         \
+  } while (0)
+#endif
+
+} // namespace cmudb
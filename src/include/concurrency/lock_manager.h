@@ -12,6 +12,7 @@
 #include <mutex>
 #include <unordered_map>
 
+#include "common/latch_profiler.h"
 #include "common/rid.h"
 #include "concurrency/transaction.h"
 #include "index/b_plus_tree.h"
@@ -76,7 +77,7 @@ private:
 
   bool strict_2PL_;
   std::unordered_map<RID, TxListForRecord> lock_table_;
-  std::mutex mutex_;    // for lock_table
+  ProfiledMutex mutex_{LatchClass::LOCK_TABLE_MUTEX};    // for lock_table
 };
 
 } // namespace cmudb
@@ -11,6 +11,7 @@
 #include <atomic>
 #include <fstream>
 #include <future>
+#include <mutex>
 #include <string>
 
 #include "common/config.h"
@@ -19,18 +20,27 @@ namespace cmudb {
 
 class DiskManager {
 public:
-  DiskManager(const std::string &db_file);
+  // every page of the file is page_size bytes, index segments use larger
+  // pages than tables
+  DiskManager(const std::string &db_file, size_t page_size = PAGE_SIZE);
   ~DiskManager();
 
   void WritePage(page_id_t page_id, const char *page_data);
+  // write count pages from page_id on, data holds them back to back. One
+  // write and one flush, e.g. for the pages of a bulk load
+  void WritePages(page_id_t page_id, const char *data, int count);
   void ReadPage(page_id_t page_id, char *page_data);
 
   void WriteLog(char *log_data, int size);
   bool ReadLog(char *log_data, int size, int offset);
 
   page_id_t AllocatePage();
+  // count pages with consecutive ids, returns the first one
+  page_id_t AllocatePages(int count);
   void DeallocatePage(page_id_t page_id);
 
+  inline size_t GetPageSize() const { return page_size_; }
+
   int GetNumFlushes() const;
   bool GetFlushState() const;
   inline void SetFlushLogFuture(std::future<void> *f) { flush_log_f_ = f; }
@@ -43,7 +53,11 @@ private:
   std::string log_name_;
   // stream to write db file
   std::fstream db_io_;
+  // the stream has one position, reads and writes of pages take turns. Pages
+  // are written outside the buffer pool latch by bulk loads
+  std::mutex db_io_latch_;
   std::string file_name_;
+  size_t page_size_;
   std::atomic<page_id_t> next_page_id_;
   int num_flushes_;
   bool flush_log_;
@@ -0,0 +1,82 @@
+/**
+ * disk_extendible_hash.h
+ *
+ * Extendible hash table made of buffer pool pages: a directory page and
+ * bucket pages (see page/hash_table_directory_page.h and
+ * page/hash_table_bucket_page.h). A point lookup reads the directory and one
+ * bucket, whatever the number of keys.
+ * (1) We only support unique key
+ * (2) Buckets split when full and are not merged when they empty out
+ *
+ * Latching: readers latch the directory shared, latch the bucket and release
+ * the directory. Writers latch the directory shared and the bucket
+ * exclusively; an insert that has to split retries with the directory latched
+ * exclusively.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "page/hash_table_bucket_page.h"
+#include "page/hash_table_directory_page.h"
+
+namespace cmudb {
+
+#define DISK_EXTENDIBLE_HASH_TYPE                                              \
+  DiskExtendibleHash<KeyType, ValueType, KeyComparator>
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class DiskExtendibleHash {
+  typedef HASH_TABLE_BUCKET_PAGE_TYPE BucketPage;
+
+public:
+  // creates the directory when directory_page_id is INVALID_PAGE_ID and
+  // records it in the header page under name
+  DiskExtendibleHash(const std::string &name,
+                     BufferPoolManager *buffer_pool_manager,
+                     const KeyComparator &comparator,
+                     page_id_t directory_page_id = INVALID_PAGE_ID);
+
+  // Insert a key-value pair, false if the key is already present
+  bool Insert(const KeyType &key, const ValueType &value,
+              Transaction *transaction = nullptr);
+
+  // Remove a key and its value, false if the key is not present
+  bool Remove(const KeyType &key, Transaction *transaction = nullptr);
+
+  // return the value associated with a given key
+  bool GetValue(const KeyType &key, std::vector<ValueType> &result,
+                Transaction *transaction = nullptr);
+
+  page_id_t GetDirectoryPageId() const { return directory_page_id_; }
+
+  uint32_t GetGlobalDepth();
+
+  // Debug
+  std::string ToString();
+
+private:
+  uint32_t Hash(const KeyType &key) const;
+
+  // insert into the chain of a latched bucket if the key is absent and there
+  // is room (or allow_overflow), sets inserted accordingly
+  bool InsertIntoChain(Page *bucket_page, const KeyType &key,
+                       const ValueType &value, bool allow_overflow,
+                       bool &inserted);
+
+  // split the key's bucket until it has room and insert, the directory is
+  // latched exclusively. false if the key is already present
+  bool SplitInsert(HashTableDirectoryPage *directory, const KeyType &key,
+                   const ValueType &value);
+
+  std::string name_;
+  page_id_t directory_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+};
+
+} // namespace cmudb
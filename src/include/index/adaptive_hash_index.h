@@ -0,0 +1,104 @@
+/**
+ * adaptive_hash_index.h
+ *
+ * In-memory overlay of a B+ tree for hot point lookups, in the spirit of
+ * InnoDB's adaptive hash index: maps a key to the leaf page and slot it was
+ * last found in, so a repeated lookup goes straight to the leaf instead of
+ * descending from the root. A key is cached once it has been looked up
+ * PROMOTE_THRESHOLD times.
+ *
+ * An entry is only a hint. The tree drops the keys a split, merge,
+ * redistribute or delete moves, and every hit is validated against the
+ * latched leaf. The tree bumps the epoch before it frees a page, so an entry
+ * cached in an older epoch may point at a reused page and is never trusted.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <unordered_map>
+
+#include "common/config.h"
+#include "hash/city.h"
+
+namespace cmudb {
+
+template <typename KeyType> class AdaptiveHashIndex {
+public:
+  struct Entry {
+    page_id_t page_id;
+    int slot;
+    uint64_t epoch;
+  };
+
+  // lookups of a key before it is cached
+  static const int PROMOTE_THRESHOLD = 2;
+  // cached keys (and candidates) per shard
+  static const size_t SHARD_CAPACITY = 1024;
+  static const int NUM_SHARDS = 16;
+
+  AdaptiveHashIndex() = default;
+  AdaptiveHashIndex(const AdaptiveHashIndex &) = delete;
+  AdaptiveHashIndex &operator=(const AdaptiveHashIndex &) = delete;
+
+  // false when the key is not cached or the overlay is disabled
+  bool Lookup(const KeyType &key, Entry &entry);
+
+  // count a lookup that found key at entry, caches it once it is hot and
+  // refreshes it when it already is
+  void Record(const KeyType &key, const Entry &entry);
+
+  void Invalidate(const KeyType &key);
+
+  void Clear();
+
+  // number of cached keys
+  size_t Size() const { return size_.load(std::memory_order_relaxed); }
+
+  inline uint64_t GetEpoch() const {
+    return epoch_.load(std::memory_order_acquire);
+  }
+
+  // call before a page of the tree is freed, with the page latched
+  inline void BumpEpoch() { epoch_.fetch_add(1, std::memory_order_acq_rel); }
+
+  inline bool IsEnabled() const {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  // disabling drops every cached key
+  void SetEnabled(bool enabled);
+
+private:
+  struct KeyHash {
+    size_t operator()(const KeyType &key) const {
+      return CityHash64(key.data, sizeof(key.data));
+    }
+  };
+
+  struct KeyEqual {
+    bool operator()(const KeyType &lhs, const KeyType &rhs) const {
+      return memcmp(lhs.data, rhs.data, sizeof(lhs.data)) == 0;
+    }
+  };
+
+  struct Shard {
+    std::mutex latch;
+    std::unordered_map<KeyType, Entry, KeyHash, KeyEqual> entries;
+    // lookup counts of keys not cached yet
+    std::unordered_map<KeyType, int, KeyHash, KeyEqual> candidates;
+  };
+
+  inline Shard &ShardOf(const KeyType &key) {
+    return shards_[KeyHash()(key) % NUM_SHARDS];
+  }
+
+  Shard shards_[NUM_SHARDS];
+  std::atomic<size_t> size_{0};
+  std::atomic<uint64_t> epoch_{0};
+  std::atomic<bool> enabled_{true};
+};
+
+} // namespace cmudb
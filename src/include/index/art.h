@@ -0,0 +1,78 @@
+/**
+ * art.h
+ *
+ * Adaptive radix tree (Leis et al., ICDE 2013) over binary comparable keys,
+ * kept entirely in memory. Inner nodes grow from 4 to 16, 48 and 256
+ * children and compress common prefixes (up to MAX_STORED_PREFIX bytes are
+ * stored, longer prefixes are checked against a leaf).
+ * (1) We only support unique key
+ * (2) No key may be a prefix of another one, see ArtIndex::NormalizeKey
+ *
+ * Concurrency is optimistic lock coupling (Leis et al., DaMoN 2016): every
+ * inner node carries a version, readers latch nothing and restart when a
+ * version they read changed, writers lock only the one or two nodes they
+ * modify. Replaced nodes and removed leaves are retired, an optimistic reader
+ * may still be looking at them. Every operation pins the global epoch it
+ * started in, a retired node is freed once no operation that started before
+ * it was unlinked is still running.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "common/rid.h"
+
+namespace cmudb {
+
+struct ArtNode;
+
+class AdaptiveRadixTree {
+public:
+  AdaptiveRadixTree();
+  ~AdaptiveRadixTree();
+  AdaptiveRadixTree(const AdaptiveRadixTree &) = delete;
+  AdaptiveRadixTree &operator=(const AdaptiveRadixTree &) = delete;
+
+  // false if the key is already present
+  bool Insert(const std::string &key, const RID &value);
+
+  // false if the key is not present
+  bool Remove(const std::string &key);
+
+  bool GetValue(const std::string &key, RID &value) const;
+
+  // visit every entry in key order, the tree must not change meanwhile
+  void ForEach(
+      const std::function<void(const std::string &, const RID &)> &visit) const;
+
+  size_t Size() const { return size_.load(std::memory_order_relaxed); }
+
+  // retired nodes not freed yet
+  size_t RetiredCount();
+
+private:
+  // one optimistic attempt, sets restart when a version changed under it
+  bool TryInsert(const std::string &key, const RID &value, bool &restart);
+  bool TryRemove(const std::string &key, bool &restart);
+  bool TryGetValue(const std::string &key, RID &value, bool &restart) const;
+
+  // defer freeing a node optimistic readers may still hold, every
+  // RECLAIM_BATCH retirements the epoch advances and old nodes are freed
+  void Retire(ArtNode *node);
+
+  // a 256 way node with no prefix, never replaced
+  ArtNode *root_;
+  std::atomic<size_t> size_{0};
+  std::mutex retired_latch_;
+  // (epoch the node was retired in, node)
+  std::vector<std::pair<uint64_t, ArtNode *>> retired_;
+};
+
+} // namespace cmudb
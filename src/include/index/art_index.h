@@ -0,0 +1,54 @@
+/**
+ * art_index.h
+ *
+ * Memory resident index over an adaptive radix tree, for small and hot
+ * lookup tables: a probe touches no buffer pool page and takes no latch.
+ * Nothing is logged, the index is rebuilt from the table heap when the table
+ * is connected, or loaded from the snapshot written on the last clean
+ * disconnect.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "index/art.h"
+#include "index/index.h"
+
+namespace cmudb {
+
+class ArtIndex : public Index {
+public:
+  explicit ArtIndex(IndexMetadata *metadata);
+
+  ~ArtIndex() {}
+
+  void InsertEntry(const Tuple &key, RID rid,
+                   Transaction *transaction = nullptr) override;
+
+  void DeleteEntry(const Tuple &key,
+                   Transaction *transaction = nullptr) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> &result,
+               Transaction *transaction = nullptr) override;
+
+  size_t Size() const { return container_.Size(); }
+
+  // write every entry to file_name, the index must not change meanwhile
+  void Checkpoint(const std::string &file_name) const;
+
+  // load a snapshot written by Checkpoint into an empty index, false if the
+  // file does not exist or does not match the key schema
+  bool LoadSnapshot(const std::string &file_name);
+
+  // binary comparable form of a key: integers big endian with the sign bit
+  // flipped, doubles ordered by their bits, strings 1 prefixed and 0
+  // terminated and NULL strings a single 0. No key is a prefix of another one
+  static std::string NormalizeKey(const Tuple &key, Schema *key_schema);
+
+private:
+  AdaptiveRadixTree container_;
+};
+
+} // namespace cmudb
@@ -0,0 +1,96 @@
+/**
+ * b_epsilon_tree.h
+ *
+ * Write-optimized B-epsilon tree: internal pages carry a buffer of pending
+ * puts and erases (see page/b_epsilon_page.h). A write only touches the
+ * root, when its buffer fills up the messages for the child with the most
+ * of them are flushed one level down in one batch, recursively, and they
+ * are applied to a leaf only when they reach it. A random insert costs a
+ * fraction of a page write instead of a leaf read and write.
+ * (1) We only support unique key, a put overwrites the value of its key and
+ *     never reads a leaf to check it
+ * (2) Pages never merge, erases empty leaves but keep them
+ *
+ * A lookup stops at the first buffered message for its key on the way down,
+ * messages higher up are newer.
+ *
+ * Latching: writers latch the whole tree exclusively since a flush
+ * restructures pages at every level, readers latch it shared.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/rwmutex.h"
+#include "concurrency/transaction.h"
+#include "page/b_epsilon_page.h"
+
+namespace cmudb {
+
+#define B_EPSILON_TREE_TYPE BEpsilonTree<KeyType, ValueType, KeyComparator>
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class BEpsilonTree {
+  typedef BEpsilonLeafPage<KeyType, ValueType, KeyComparator> LeafPage;
+  typedef BEpsilonInternalPage<KeyType, ValueType, KeyComparator>
+      InternalPage;
+  typedef BEpsilonMessage<KeyType, ValueType> MessageType;
+
+public:
+  explicit BEpsilonTree(const std::string &name,
+                        BufferPoolManager *buffer_pool_manager,
+                        const KeyComparator &comparator,
+                        page_id_t root_page_id = INVALID_PAGE_ID);
+
+  bool IsEmpty() const { return root_page_id_ == INVALID_PAGE_ID; }
+
+  // Insert a key-value pair, overwriting the value of a present key
+  void Insert(const KeyType &key, const ValueType &value,
+              Transaction *transaction = nullptr);
+
+  // Remove a key and its value if present
+  void Remove(const KeyType &key, Transaction *transaction = nullptr);
+
+  // return the value associated with a given key
+  bool GetValue(const KeyType &key, std::vector<ValueType> &result,
+                Transaction *transaction = nullptr);
+
+  page_id_t GetRootPageId() const { return root_page_id_; }
+
+  // walk every page and check pivots and messages are ordered and within
+  // the range of their parent pivot, for tests
+  bool Check();
+
+private:
+  BEpsilonPage *FetchNode(page_id_t page_id);
+
+  // add message at the root, flushing while its buffer is full
+  void Upsert(const MessageType &message);
+
+  // move the buffered messages for the child with the most of them into it.
+  // A split of the child adds a pivot to node, the caller splits node when
+  // it overflows
+  void Flush(InternalPage *node);
+
+  // split the overflowing child at index, posting the new sibling to node
+  void SplitChild(InternalPage *node, int index, BEpsilonPage *child);
+
+  // the root overflows, grow a new root above it
+  void SplitRoot(BEpsilonPage *root);
+
+  bool CheckNode(page_id_t page_id, const KeyType *low, const KeyType *high);
+
+  void UpdateRootPageId(bool insert_record);
+
+  std::string index_name_;
+  page_id_t root_page_id_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+  // writers exclusive, readers shared
+  RWMutex latch_{LatchClass::ROOT_LATCH};
+};
+
+} // namespace cmudb
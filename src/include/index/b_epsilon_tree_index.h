@@ -0,0 +1,46 @@
+/**
+ * b_epsilon_tree_index.h
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "index/b_epsilon_tree.h"
+#include "index/index.h"
+
+namespace cmudb {
+
+#define B_EPSILON_TREE_INDEX_TYPE                                              \
+  BEpsilonTreeIndex<KeyType, ValueType, KeyComparator>
+
+// index whose writes are buffered in internal pages and reach the leaves in
+// batches, for tables written far more than read, see index/b_epsilon_tree.h
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class BEpsilonTreeIndex : public Index {
+
+public:
+  BEpsilonTreeIndex(IndexMetadata *metadata,
+                    BufferPoolManager *buffer_pool_manager,
+                    page_id_t root_page_id = INVALID_PAGE_ID);
+
+  ~BEpsilonTreeIndex() {}
+
+  void InsertEntry(const Tuple &key, RID rid,
+                   Transaction *transaction = nullptr) override;
+
+  void DeleteEntry(const Tuple &key,
+                   Transaction *transaction = nullptr) override;
+
+  void ScanKey(const Tuple &key, std::vector<RID> &result,
+               Transaction *transaction = nullptr) override;
+
+protected:
+  // comparator for key
+  KeyComparator comparator_;
+  // container
+  BEpsilonTree<KeyType, ValueType, KeyComparator> container_;
+};
+
+} // namespace cmudb
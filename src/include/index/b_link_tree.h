@@ -0,0 +1,97 @@
+/**
+ * b_link_tree.h
+ *
+ * Lehman-Yao B-link tree: a B+ tree whose pages carry a high key and a link
+ * to their right sibling (see page/b_link_page.h). A split first moves the
+ * upper half into a new right sibling, then posts the separator into the
+ * parent, and a search that reaches a page before the parent knows about the
+ * split follows the right link.
+ * (1) We only support unique key
+ * (2) Pages never merge, emptied pages stay linked in
+ *
+ * Latching: a search latches one page at a time, it releases a page before
+ * latching the next one. Writers latch the leaf exclusively, and a split
+ * holds the page being split while it latches the parent, so at most two
+ * latches are held and the root is never latched for the whole descent.
+ * Latches are taken bottom up and left to right, which can not deadlock.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "concurrency/transaction.h"
+#include "page/b_link_page.h"
+
+namespace cmudb {
+
+#define B_LINK_TREE_TYPE BLinkTree<KeyType, ValueType, KeyComparator>
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class BLinkTree {
+  typedef BLinkPage<KeyType, ValueType, KeyComparator> LeafPage;
+  typedef BLinkPage<KeyType, page_id_t, KeyComparator> InternalPage;
+
+public:
+  explicit BLinkTree(const std::string &name,
+                     BufferPoolManager *buffer_pool_manager,
+                     const KeyComparator &comparator,
+                     page_id_t root_page_id = INVALID_PAGE_ID);
+
+  bool IsEmpty() const { return root_page_id_ == INVALID_PAGE_ID; }
+
+  // Insert a key-value pair, false if the key is already present
+  bool Insert(const KeyType &key, const ValueType &value,
+              Transaction *transaction = nullptr);
+
+  // Remove a key and its value, false if the key is not present
+  bool Remove(const KeyType &key, Transaction *transaction = nullptr);
+
+  // return the value associated with a given key
+  bool GetValue(const KeyType &key, std::vector<ValueType> &result,
+                Transaction *transaction = nullptr);
+
+  page_id_t GetRootPageId() const { return root_page_id_; }
+
+  // walk every level left to right and check keys are ordered within and
+  // across pages and below the high keys, for tests
+  bool Check();
+
+private:
+  Page *FetchPage(page_id_t page_id);
+
+  inline void Release(Page *page, bool exclusive, bool is_dirty) {
+    if (exclusive)
+      page->WUnlatch();
+    else
+      page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page->GetPageId(), is_dirty);
+  }
+
+  // latch the page of the given level covering key, from the root down.
+  // Internal pages passed on the way down are appended to path
+  Page *FindPage(const KeyType &key, int level, bool exclusive,
+                 std::vector<page_id_t> *path);
+
+  // follow right links from a latched page until it covers key
+  Page *MoveRight(Page *page, const KeyType &key, bool exclusive);
+
+  // split the latched, overflowing page and post the separator up, the page
+  // is released once its parent is latched
+  void Split(Page *page, std::vector<page_id_t> &path);
+
+  void UpdateRootPageId(bool insert_record);
+
+  std::string index_name_;
+  std::atomic<page_id_t> root_page_id_;
+  // serialises creating the first page and growing a new root
+  std::mutex root_mutex_;
+  BufferPoolManager *buffer_pool_manager_;
+  KeyComparator comparator_;
+};
+
+} // namespace cmudb
@@ -10,10 +10,13 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <queue>
 #include <vector>
 
+#include "common/metrics.h"
 #include "concurrency/transaction.h"
+#include "index/adaptive_hash_index.h"
 #include "index/index_iterator.h"
 #include "page/b_plus_tree_internal_page.h"
 #include "page/b_plus_tree_leaf_page.h"
@@ -25,6 +28,12 @@ namespace cmudb {
 #define BPLUSTREE_TYPE BPlusTree<KeyType, ValueType, KeyComparator>
 enum class LockType { EXCLUSIVE = 0, SHARED, UPGRADING };
 
+// the leaf a batch of ascending probes ended at, see BPlusTree::GetValues
+struct LeafHint {
+  page_id_t page_id = INVALID_PAGE_ID;
+  uint64_t epoch = 0;
+};
+
 // Main class providing the API for the Interactive B+ Tree.
 INDEX_TEMPLATE_ARGUMENTS
 class BPlusTree {
@@ -48,9 +57,18 @@ public:
   bool GetValue(const KeyType &key, std::vector<ValueType> &result,
                 Transaction *transaction = nullptr);
 
+  // look up ascending keys in one left to right pass, appending the values
+  // found. hint carries the last leaf over to the next call
+  void GetValues(const std::vector<KeyType> &keys,
+                 std::vector<ValueType> &result, LeafHint *hint = nullptr);
+
   // index iterator
   INDEXITERATOR_TYPE Begin();
   INDEXITERATOR_TYPE Begin(const KeyType &key);
+  // reverse index iterator, walked with operator--: from the last key, or
+  // from the last key not greater than key
+  INDEXITERATOR_TYPE RBegin();
+  INDEXITERATOR_TYPE RBegin(const KeyType &key);
 
   // Print this B+ tree to stdout using a simple command-line
   std::string ToString(bool verbose = false);
@@ -64,12 +82,55 @@ public:
                       Transaction *transaction = nullptr);
   // expose for test purpose
   B_PLUS_TREE_LEAF_PAGE_TYPE *FindLeafPage(const KeyType &key, bool leftMost = false, 
-                                            OpType op = OpType::READ, Transaction *transaction = nullptr);
+                                            OpType op = OpType::READ, Transaction *transaction = nullptr,
+                                            bool rightMost = false);
 
   bool Check(bool force = false);
   bool openCheck = true;
 
+  // in-memory overlay of hot point lookups, on by default
+  AdaptiveHashIndex<KeyType> &GetAdaptiveHash() { return adaptive_hash_; }
+
+  // lazy deletion: a leaf is merged or redistributed only once it falls
+  // below percent of its max size, instead of below half. 50 (the default)
+  // is eager, 0 keeps leaves until they are empty. Set before the tree is
+  // shared
+  void SetMergeThreshold(int percent) {
+    merge_threshold_ = std::max(0, std::min(50, percent));
+  }
+  int GetMergeThreshold() const { return merge_threshold_; }
+
 private:
+  // iterators search the tree again when they can not latch a previous leaf
+  friend class IndexIterator<KeyType, ValueType, KeyComparator>;
+
+  // the latched leaf for the next of ascending probes, leaf is the latched
+  // leaf of the previous one or nullptr
+  B_PLUS_TREE_LEAF_PAGE_TYPE *ProbeLeaf(B_PLUS_TREE_LEAF_PAGE_TYPE *leaf,
+                                        const KeyType &key);
+  // the hinted leaf latched shared, nullptr when the hint is stale
+  B_PLUS_TREE_LEAF_PAGE_TYPE *LatchHintedLeaf(const LeafHint &hint);
+
+  // smallest size a page keeps without being merged or redistributed
+  int LowWater(BPlusTreePage *page) const;
+  // BPlusTreePage::IsSafe with the leaf low water
+  bool IsSafe(BPlusTreePage *page, OpType op) const;
+
+  // latch the leaf after leaf for a split or merge without waiting, false
+  // when another thread holds it
+  bool LatchNextLeaf(B_PLUS_TREE_LEAF_PAGE_TYPE *leaf,
+                     Transaction *transaction);
+  // after a split or merge, point the leaf after leaf back at it. That leaf
+  // was latched by LatchNextLeaf
+  void RelinkNextLeaf(B_PLUS_TREE_LEAF_PAGE_TYPE *leaf,
+                      Transaction *transaction);
+
+  // point lookup through the adaptive hash index, false on a miss
+  bool AdaptiveHashLookup(const KeyType &key, std::vector<ValueType> &result);
+
+  // drop the keys of a leaf about to move out of it
+  template <typename N> void InvalidateAdaptiveHash(N *node);
+
   void StartNewTree(const KeyType &key, const ValueType &value);
 
   bool InsertIntoLeaf(const KeyType &key, const ValueType &value,
@@ -85,7 +146,8 @@ private:
   bool CoalesceOrRedistribute(N *node, Transaction *transaction = nullptr);
 
   template <typename N>
-  bool FindSibling(N *node, N * &sibling, Transaction *transaction = nullptr);
+  bool FindSibling(N *node, B_PLUS_TREE_INTERNAL_PAGE *parent, N * &sibling,
+                   Transaction *transaction = nullptr);
 
   template <typename N>
   bool Coalesce(
@@ -93,7 +155,9 @@ private:
       BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *&parent,
       int index, Transaction *transaction = nullptr);
 
-  template <typename N> void Redistribute(N *neighbor_node, N *node, int index);
+  template <typename N>
+  void Redistribute(N *neighbor_node, N *node,
+                    B_PLUS_TREE_INTERNAL_PAGE *parent, int index);
 
   bool AdjustRoot(BPlusTreePage *node);
 
@@ -101,13 +165,25 @@ private:
 
   void RemovePagesInTransaction(LockType lock_type, Transaction *transaction, page_id_t cur_id = INVALID_PAGE_ID);
 
+  // the page latched right before node on the way down
+  B_PLUS_TREE_INTERNAL_PAGE *GetParentPage(BPlusTreePage *node,
+                                           Transaction *transaction);
+
   BPlusTreePage *ConcurrentFetchPage(page_id_t page_id, OpType op, page_id_t previous_id, Transaction *transaction);
 
+  // count the latch as a wait when it can not be taken right away
   inline void LockPage(LockType lock_type, Page *page) {
-    if (lock_type == LockType::EXCLUSIVE)
-      page->WLatch();
-    else if (lock_type == LockType::SHARED)
-      page->RLatch();
+    if (lock_type == LockType::EXCLUSIVE) {
+      if (!page->TryWLatch()) {
+        Metrics::Add(MetricCounter::BTREE_LATCH_WAIT);
+        page->WLatch();
+      }
+    } else if (lock_type == LockType::SHARED) {
+      if (!page->TryRLatch()) {
+        Metrics::Add(MetricCounter::BTREE_LATCH_WAIT);
+        page->RLatch();
+      }
+    }
   }
 
   inline void UnlockPage(LockType lock_type, Page *page) {
@@ -118,10 +194,17 @@ private:
   }
 
   inline void LockRootPage(LockType lock_type) {
-    if (lock_type == LockType::EXCLUSIVE)
-      rw_mutex_.WLock();
-    else if (lock_type == LockType::SHARED)
-      rw_mutex_.RLock();
+    if (lock_type == LockType::EXCLUSIVE) {
+      if (!rw_mutex_.TryWLock()) {
+        Metrics::Add(MetricCounter::BTREE_LATCH_WAIT);
+        rw_mutex_.WLock();
+      }
+    } else if (lock_type == LockType::SHARED) {
+      if (!rw_mutex_.TryRLock()) {
+        Metrics::Add(MetricCounter::BTREE_LATCH_WAIT);
+        rw_mutex_.RLock();
+      }
+    }
     ++ root_locked_cnt;
   }
 
@@ -146,7 +229,10 @@ private:
   page_id_t root_page_id_;
   BufferPoolManager *buffer_pool_manager_;
   KeyComparator comparator_;
-  RWMutex rw_mutex_;  // protect root_page_id_
+  ShardedRWMutex rw_mutex_{LatchClass::ROOT_LATCH};  // protect root_page_id_
+  AdaptiveHashIndex<KeyType> adaptive_hash_;
+  // leaf low water in percent of the max size, see SetMergeThreshold
+  int merge_threshold_ = 50;
   static thread_local int root_locked_cnt;
 };
 
@@ -4,11 +4,15 @@
 
 #pragma once
 
+#include <atomic>
 #include <map>
+#include <memory>
 #include <string>
 #include <vector>
 
+#include "common/rwmutex.h"
 #include "index/b_plus_tree.h"
+#include "index/bloom_filter.h"
 #include "index/index.h"
 
 namespace cmudb {
@@ -34,11 +38,39 @@ public:
   void ScanKey(const Tuple &key, std::vector<RID> &result,
                Transaction *transaction = nullptr) override;
 
+  // the position is the leaf the last probe ended at
+  void ScanKeys(const std::vector<Tuple> &keys, std::vector<RID> &result,
+                std::string &position) override;
+
+  // the position is the last key returned, no latch is held between batches
+  void ScanBatch(std::string &position, bool reverse, size_t batch_size,
+                 std::vector<RID> &result,
+                 std::vector<Tuple> *keys = nullptr) override;
+
+  // range scan, the iterator holds a read latch on the current leaf
+  INDEXITERATOR_TYPE GetBeginIterator();
+
+  INDEXITERATOR_TYPE GetBeginIterator(const KeyType &key);
+
+  // keys the filter was sized for before it is rebuilt larger
+  size_t GetFilterCapacity() const { return filter_capacity_; }
+
 protected:
+  // fill a new filter from the tree, sized for twice its keys
+  void RebuildFilter();
+
   // comparator for key
   KeyComparator comparator_;
   // container
   BPlusTree<KeyType, ValueType, KeyComparator> container_;
+  // keys of the tree, lets lookups of absent keys skip the tree. Deleted
+  // keys stay in it until the next rebuild
+  std::unique_ptr<BlockedBloomFilter> filter_;
+  // readers of filter_ latch it shared, a rebuild exclusive
+  RWMutex filter_latch_;
+  size_t filter_capacity_;
+  // keys added to filter_ since it was built
+  std::atomic<size_t> filter_count_{0};
 };
 
 } // namespace cmudb
@@ -0,0 +1,61 @@
+/**
+ * bloom_filter.h
+ *
+ * Blocked Bloom filter (Putze et al.): every key sets one bit in each of the
+ * eight 64 bit words of a single cache line sized block, so a probe touches
+ * one cache line and the eight bit positions come from independent
+ * multiplications the compiler can vectorise. Keys are given by a 64 bit
+ * hash, the high half picks the block and the low half the bits.
+ *
+ * Bits are only ever set, concurrent inserts and probes need no latch. A
+ * probe racing with the insert of the same key may miss it, as if it ran
+ * first.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace cmudb {
+
+class BlockedBloomFilter {
+public:
+  // bits per expected key, ~0.1% false positives for a blocked filter
+  static const int BITS_PER_KEY = 16;
+
+  explicit BlockedBloomFilter(size_t expected_keys);
+  ~BlockedBloomFilter();
+  BlockedBloomFilter(const BlockedBloomFilter &) = delete;
+  BlockedBloomFilter &operator=(const BlockedBloomFilter &) = delete;
+
+  void Insert(uint64_t hash);
+
+  // false means the key was never inserted
+  bool MayContain(uint64_t hash) const;
+
+  size_t GetNumBlocks() const { return num_blocks_; }
+
+private:
+  static const int WORDS_PER_BLOCK = 8;
+
+  inline size_t BlockOf(uint64_t hash) const {
+    return static_cast<size_t>(((hash >> 32) * num_blocks_) >> 32);
+  }
+
+  // the bit of every word of the block
+  static inline void MakeMask(uint32_t key, uint64_t mask[WORDS_PER_BLOCK]) {
+    static const uint32_t SALT[WORDS_PER_BLOCK] = {
+        0x47b6137bU, 0x44974d91U, 0x8824ad5bU, 0xa2b7289dU,
+        0x705495c7U, 0x2df1424bU, 0x9efc4947U, 0x5c6bfb31U};
+    for (int i = 0; i < WORDS_PER_BLOCK; i++)
+      mask[i] = 1ULL << ((key * SALT[i]) >> 26);
+  }
+
+  size_t num_blocks_;
+  // num_blocks_ * WORDS_PER_BLOCK words, aligned on a cache line
+  std::atomic<uint64_t> *words_;
+};
+
+} // namespace cmudb
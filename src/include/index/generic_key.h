@@ -9,9 +9,11 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <cstring>
 
 #include "table/tuple.h"
+#include "type/type_traits.h"
 #include "type/value.h"
 
 namespace cmudb {
@@ -26,21 +28,21 @@ public:
   // NOTE: for test purpose only
   inline void SetFromInteger(int64_t key) {
     memset(data, 0, KeySize);
-    memcpy(data, &key, sizeof(int64_t));
+    memcpy(data, &key, std::min(KeySize, sizeof(int64_t)));
   }
 
   inline Value ToValue(Schema *schema, int column_id) const {
-    const char *data_ptr;
-    const TypeId column_type = schema->GetType(column_id);
-    const bool is_inlined = schema->IsInlined(column_id);
-    if (is_inlined) {
-      data_ptr = (data + schema->GetOffset(column_id));
-    } else {
-      int32_t offset = *reinterpret_cast<int32_t *>(
-          const_cast<char *>(data + schema->GetOffset(column_id)));
-      data_ptr = (data + offset);
-    }
-    return Value::DeserializeFrom(data_ptr, column_type);
+    return Value::DeserializeFrom(GetDataPtr(schema, column_id),
+                                  schema->GetType(column_id));
+  }
+
+  // stored form of the column, as CompareRaw takes it
+  inline const char *GetDataPtr(Schema *schema, int column_id) const {
+    if (schema->IsInlined(column_id))
+      return data + schema->GetOffset(column_id);
+    int32_t offset;
+    memcpy(&offset, data + schema->GetOffset(column_id), sizeof(int32_t));
+    return data + offset;
   }
 
   // NOTE: for test purpose only
@@ -69,15 +71,13 @@ public:
                         const GenericKey<KeySize> &rhs) const {
     int column_count = key_schema_->GetColumnCount();
 
+    // the columns compare in place by their type, no Value is built
     for (int i = 0; i < column_count; i++) {
-      Value lhs_value = (lhs.ToValue(key_schema_, i));
-      Value rhs_value = (rhs.ToValue(key_schema_, i));
-
-      if (lhs_value.CompareLessThan(rhs_value) == CMP_TRUE)
-        return -1;
-
-      if (lhs_value.CompareGreaterThan(rhs_value) == CMP_TRUE)
-        return 1;
+      int cmp = CompareRaw(key_schema_->GetType(i),
+                           lhs.GetDataPtr(key_schema_, i),
+                           rhs.GetDataPtr(key_schema_, i));
+      if (cmp != 0)
+        return cmp < 0 ? -1 : 1;
     }
     // equals
     return 0;
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "catalog/schema.h"
+#include "common/exception.h"
 #include "table/tuple.h"
 #include "type/value.h"
 
@@ -23,13 +24,25 @@ namespace cmudb {
  * mapping relation and does the conversion between tuple key and index key
  */
 class Transaction;
+
+// structure behind an index, chosen at CREATE VIRTUAL TABLE time
+enum class IndexType {
+  BPLUS_TREE = 0,
+  HASH,
+  ART,
+  BLINK_TREE,
+  BEPSILON_TREE
+};
+
 class IndexMetadata {
   IndexMetadata() = delete;
 
 public:
   IndexMetadata(std::string index_name, std::string table_name,
-                const Schema *tuple_schema, const std::vector<int> &key_attrs)
-      : name_(index_name), table_name_(table_name), key_attrs_(key_attrs) {
+                const Schema *tuple_schema, const std::vector<int> &key_attrs,
+                IndexType index_type = IndexType::BPLUS_TREE)
+      : name_(index_name), table_name_(table_name), key_attrs_(key_attrs),
+        index_type_(index_type) {
     key_schema_ = Schema::CopySchema(tuple_schema, key_attrs_);
   }
 
@@ -39,6 +52,8 @@ public:
 
   inline const std::string &GetTableName() { return table_name_; }
 
+  inline IndexType GetIndexType() const { return index_type_; }
+
   // Returns a schema object pointer that represents the indexed key
   inline Schema *GetKeySchema() const { return key_schema_; }
 
@@ -57,7 +72,7 @@ public:
 
     os << "IndexMetadata["
        << "Name = " << name_ << ", "
-       << "Type = B+Tree, "
+       << "Type = " << GetIndexTypeName() << ", "
        << "Table name = " << table_name_ << "] :: ";
     os << key_schema_->ToString();
 
@@ -65,10 +80,26 @@ public:
   }
 
 private:
+  const char *GetIndexTypeName() const {
+    switch (index_type_) {
+    case IndexType::HASH:
+      return "Hash";
+    case IndexType::ART:
+      return "ART";
+    case IndexType::BLINK_TREE:
+      return "B-link tree";
+    case IndexType::BEPSILON_TREE:
+      return "B-epsilon tree";
+    default:
+      return "B+Tree";
+    }
+  }
+
   std::string name_;
   std::string table_name_;
   // The mapping relation between key schema and tuple schema
   const std::vector<int> key_attrs_;
+  IndexType index_type_;
   // schema of the indexed key
   Schema *key_schema_;
 };
@@ -110,6 +141,8 @@ public:
     return metadata_->GetKeyAttrs();
   }
 
+  IndexType GetIndexType() const { return metadata_->GetIndexType(); }
+
   // Get a string representation for debugging
   const std::string ToString() const {
     std::stringstream os;
@@ -133,6 +166,33 @@ public:
   virtual void ScanKey(const Tuple &key, std::vector<RID> &result,
                        Transaction *transaction = nullptr) = 0;
 
+  // point queries for many keys, rids come in key order. position is opaque
+  // to the caller like in ScanBatch and kept between calls: an ordered index
+  // remembers where the probes ended, so ascending keys over several calls
+  // are found in one pass
+  virtual void ScanKeys(const std::vector<Tuple> &keys,
+                        std::vector<RID> &result, std::string &position) {
+    (void)position;
+    for (auto &key : keys)
+      ScanKey(key, result);
+  }
+
+  // ordered scan in batches of up to batch_size rids, ascending or
+  // descending by key. position is opaque to the caller: empty to start at
+  // either end, then kept between calls. An empty batch ends the scan. With
+  // keys, the key tuple of every rid is returned too, for scans that never
+  // read the table heap. Only ordered indexes support it
+  virtual void ScanBatch(std::string &position, bool reverse,
+                         size_t batch_size, std::vector<RID> &result,
+                         std::vector<Tuple> *keys = nullptr) {
+    (void)position;
+    (void)reverse;
+    (void)batch_size;
+    (void)result;
+    (void)keys;
+    throw Exception(EXCEPTION_TYPE_INDEX, "index is not ordered");
+  }
+
 private:
   //===--------------------------------------------------------------------===//
   //  Data members
@@ -1,6 +1,9 @@
 /**
  * index_iterator.h
- * For range scan of b+ tree
+ * For range scan of b+ tree, in both directions. Only the current leaf is
+ * latched (shared). Walking back latches the previous leaf without waiting,
+ * writers latch leaves left to right; when it is taken the iterator releases
+ * its leaf and searches the tree again for the keys before it.
  */
 #pragma once
 #include "page/b_plus_tree_leaf_page.h"
@@ -10,10 +13,17 @@ namespace cmudb {
 #define INDEXITERATOR_TYPE                                                     \
   IndexIterator<KeyType, ValueType, KeyComparator>
 
+INDEX_TEMPLATE_ARGUMENTS class BPlusTree;
+
 INDEX_TEMPLATE_ARGUMENTS
 class IndexIterator {
 public:
-  IndexIterator(int index, B_PLUS_TREE_LEAF_PAGE_TYPE *leaf, BufferPoolManager *buffer_pool_manager);
+  // index past either end of the leaf moves to the neighbouring leaf
+  IndexIterator(int index, B_PLUS_TREE_LEAF_PAGE_TYPE *leaf,
+                BufferPoolManager *buffer_pool_manager,
+                BPlusTree<KeyType, ValueType, KeyComparator> *tree);
+  IndexIterator(IndexIterator &&other);
+  IndexIterator(const IndexIterator &) = delete;
   ~IndexIterator();
 
   bool isEnd();
@@ -22,15 +32,21 @@ public:
 
   IndexIterator &operator++();
 
+  IndexIterator &operator--();
+
 private:
   void UnlockAndUnPin() {
     buffer_pool_manager_->FetchPage(leaf_->GetPageId())->RUnlatch();
     buffer_pool_manager_->UnpinPage(leaf_->GetPageId(), false);
     buffer_pool_manager_->UnpinPage(leaf_->GetPageId(), false); // fetch two times
   }
+  // move to the previous leaf while index_ is before the first key
+  void SkipBackward();
+
   int index_;
   B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_;
   BufferPoolManager *buffer_pool_manager_;
+  BPlusTree<KeyType, ValueType, KeyComparator> *tree_;
 };
 
 } // namespace cmudb
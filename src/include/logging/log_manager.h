@@ -11,6 +11,7 @@
 #include <future>
 #include <mutex>
 
+#include "common/latch_profiler.h"
 #include "disk/disk_manager.h"
 #include "logging/log_record.h"
 
@@ -56,11 +57,11 @@ private:
   char *log_buffer_;
   char *flush_buffer_;
   // latch to protect shared member variables
-  std::mutex latch_;
+  ProfiledMutex latch_{LatchClass::LOG_LATCH};
   // flush thread
   std::thread *flush_thread_;
   // for notifying flush thread
-  std::condition_variable cv_;
+  std::condition_variable_any cv_;
   // disk manager
   DiskManager *disk_manager_;
 };
@@ -0,0 +1,154 @@
+/**
+ * b_epsilon_page.h
+ *
+ * Pages of a B-epsilon tree (see index/b_epsilon_tree.h). Leaves hold sorted
+ * key/value pairs like a B+ tree leaf. Internal pages hold sorted pivots,
+ * whose first key is invalid like in BPlusTreeInternalPage, and a buffer of
+ * messages sorted by key, at most one per key, on their way down.
+ *
+ * With epsilon = 1/2 an internal page gives about the square root of its
+ * slots to pivots and the rest to the buffer, so a flush moves many messages
+ * into one child at once.
+ *
+ * Header format (size in byte):
+ * ----------------------------------------------------------------------------
+ * | Level (4) | CurrentSize (4) | MaxSize (4) | PageId (4) |
+ * ----------------------------------------------------------------------------
+ * Internal pages go on with:
+ * ----------------------------------------------------------------------------
+ * | BufferSize (4) | BufferMaxSize (4) | Pivots | Messages |
+ * ----------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "index/generic_key.h"
+
+namespace cmudb {
+
+#define B_EPSILON_LEAF_PAGE_TYPE                                               \
+  BEpsilonLeafPage<KeyType, ValueType, KeyComparator>
+#define B_EPSILON_INTERNAL_PAGE_TYPE                                           \
+  BEpsilonInternalPage<KeyType, ValueType, KeyComparator>
+
+// a put of a value or an erase of a key, applied once it reaches the leaf
+template <typename KeyType, typename ValueType> struct BEpsilonMessage {
+  KeyType key;
+  ValueType value;
+  int32_t erase;
+};
+
+// header shared by leaf and internal pages, level 0 is a leaf
+class BEpsilonPage {
+public:
+  bool IsLeafPage() const { return level_ == 0; }
+  int GetLevel() const { return level_; }
+  int GetSize() const { return size_; }
+  int GetMaxSize() const { return max_size_; }
+  page_id_t GetPageId() const { return page_id_; }
+
+protected:
+  int level_;
+  int size_;
+  int max_size_;
+  page_id_t page_id_;
+};
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class BEpsilonLeafPage : public BEpsilonPage {
+  typedef std::pair<KeyType, ValueType> ItemType;
+  typedef BEpsilonMessage<KeyType, ValueType> MessageType;
+
+public:
+  // After creating a new page from buffer pool, must call initialize method
+  // to set default values
+  void Init(page_id_t page_id, size_t page_size = PAGE_SIZE);
+
+  KeyType KeyAt(int index) const { return array_[index].first; }
+  ValueType ValueAt(int index) const { return array_[index].second; }
+
+  // first index whose key is not less than key
+  int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
+  bool Lookup(const KeyType &key, ValueType &value,
+              const KeyComparator &comparator) const;
+
+  // a put inserts or overwrites, an erase removes the key if present. The
+  // page may overflow by one item until split
+  void Apply(const MessageType &message, const KeyComparator &comparator);
+
+  // move the upper half into the empty recipient, the separator is
+  // recipient->KeyAt(0)
+  void MoveHalfTo(BEpsilonLeafPage *recipient);
+
+private:
+  ItemType array_[0];
+};
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class BEpsilonInternalPage : public BEpsilonPage {
+  typedef std::pair<KeyType, page_id_t> PivotType;
+  typedef BEpsilonMessage<KeyType, ValueType> MessageType;
+
+public:
+  // After creating a new page from buffer pool, must call initialize method
+  // to set default values
+  void Init(page_id_t page_id, int level, size_t page_size = PAGE_SIZE);
+
+  KeyType KeyAt(int index) const { return pivots_[index].first; }
+  page_id_t ValueAt(int index) const { return pivots_[index].second; }
+
+  // index of the pivot whose child covers key
+  int ChildIndex(const KeyType &key, const KeyComparator &comparator) const;
+
+  // a new root over old_page_id alone, the split that grows it adds the
+  // second pivot
+  void PopulateNewRoot(page_id_t old_page_id);
+  // add the pivot of a new right sibling of the child at index, the page may
+  // overflow by one pivot until split
+  void InsertPivotAfter(int index, const KeyType &key, page_id_t page_id);
+
+  int GetBufferSize() const { return buffer_size_; }
+  int GetBufferMaxSize() const { return buffer_max_size_; }
+  bool IsBufferFull() const { return buffer_size_ >= buffer_max_size_; }
+  const MessageType &MessageAt(int index) const { return Messages()[index]; }
+
+  // the buffered message for key, nullptr when there is none
+  const MessageType *FindMessage(const KeyType &key,
+                                 const KeyComparator &comparator) const;
+  // buffer message keeping keys sorted, it replaces an older message for the
+  // same key. The caller checks the buffer is not full
+  void PutMessage(const MessageType &message, const KeyComparator &comparator);
+  // the buffered messages for the child at index are [begin, end)
+  void ChildMessages(int index, const KeyComparator &comparator, int &begin,
+                     int &end) const;
+  void RemoveMessages(int begin, int end);
+
+  // move the upper half of the pivots, and the messages for their children,
+  // into the empty recipient. Returns the separator, the key of the first
+  // moved pivot
+  KeyType MoveHalfTo(BEpsilonInternalPage *recipient,
+                     const KeyComparator &comparator);
+
+  // Debug
+  std::string ToString() const;
+
+private:
+  // the buffer starts after the pivots and their spare slot
+  MessageType *Messages() {
+    return reinterpret_cast<MessageType *>(pivots_ + max_size_ + 1);
+  }
+  const MessageType *Messages() const {
+    return reinterpret_cast<const MessageType *>(pivots_ + max_size_ + 1);
+  }
+  // first buffered message whose key is not less than key
+  int MessageIndex(const KeyType &key, const KeyComparator &comparator) const;
+
+  int buffer_size_;
+  int buffer_max_size_;
+  PivotType pivots_[0];
+};
+
+} // namespace cmudb
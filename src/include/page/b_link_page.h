@@ -0,0 +1,92 @@
+/**
+ * b_link_page.h
+ *
+ * Page of a Lehman-Yao B-link tree (see index/b_link_tree.h). Leaf and
+ * internal pages share the format, leaves hold RIDs (level 0) and internal
+ * pages hold child page ids. Like BPlusTreeInternalPage, the first key of an
+ * internal page is invalid for lookups.
+ *
+ * Every page covers the keys in [low key, high key). The low key is the high
+ * key of the left sibling; the rightmost page of a level has no high key. A
+ * split moves the upper half into a new right sibling and lowers the high
+ * key, a key at or above the high key is found by following RightPageId.
+ *
+ * Header format (size in byte):
+ * ----------------------------------------------------------------------------
+ * | Level (4) | CurrentSize (4) | MaxSize (4) | PageId (4) | RightPageId (4) |
+ * ----------------------------------------------------------------------------
+ * | HasHighKey (4) | HighKey |
+ * ----------------------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "index/generic_key.h"
+
+namespace cmudb {
+
+#define B_LINK_PAGE_TYPE BLinkPage<KeyType, ValueType, KeyComparator>
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class BLinkPage {
+  typedef std::pair<KeyType, ValueType> ItemType;
+
+public:
+  // After creating a new page from buffer pool, must call initialize method
+  // to set default values, the page holds as many items as fit in page_size
+  void Init(page_id_t page_id, int level, size_t page_size = PAGE_SIZE);
+
+  bool IsLeafPage() const { return level_ == 0; }
+  int GetLevel() const { return level_; }
+  int GetSize() const { return size_; }
+  int GetMaxSize() const { return max_size_; }
+  page_id_t GetPageId() const { return page_id_; }
+  page_id_t GetRightPageId() const { return right_page_id_; }
+  bool HasHighKey() const { return has_high_key_ != 0; }
+  KeyType GetHighKey() const { return high_key_; }
+
+  // true when key is at or above the high key, it lives further right
+  bool IsBeyondHighKey(const KeyType &key,
+                       const KeyComparator &comparator) const;
+
+  KeyType KeyAt(int index) const { return array_[index].first; }
+  ValueType ValueAt(int index) const { return array_[index].second; }
+
+  // leaf: first index whose key is not less than key
+  int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
+  bool Lookup(const KeyType &key, ValueType &value,
+              const KeyComparator &comparator) const;
+  // internal: the child covering key
+  ValueType LookupChild(const KeyType &key,
+                        const KeyComparator &comparator) const;
+
+  // insert keeping keys ordered, the page may overflow by one item until
+  // split. The caller checks unique keys.
+  void Insert(const KeyType &key, const ValueType &value,
+              const KeyComparator &comparator);
+  void RemoveAt(int index);
+  void PopulateNewRoot(const ValueType &old_value, const KeyType &new_key,
+                       const ValueType &new_value);
+
+  // move the upper half into the empty right sibling "recipient" and link it
+  // in, the separator is recipient->KeyAt(0)
+  void MoveHalfTo(BLinkPage *recipient);
+
+  // Debug
+  std::string ToString() const;
+
+private:
+  int level_;
+  int size_;
+  int max_size_;
+  page_id_t page_id_;
+  page_id_t right_page_id_;
+  int has_high_key_;
+  KeyType high_key_;
+  ItemType array_[0];
+};
+
+} // namespace cmudb
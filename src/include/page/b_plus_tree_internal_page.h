@@ -32,7 +32,9 @@ INDEX_TEMPLATE_ARGUMENTS
 class BPlusTreeInternalPage : public BPlusTreePage {
 public:
   // must call initialize method after "create" a new node
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID);
+  // the page holds as many items as fit in page_size bytes
+  void Init(page_id_t page_id, bool is_root = false,
+            size_t page_size = PAGE_SIZE);
 
   KeyType KeyAt(int index) const;
   void SetKeyAt(int index, const KeyType &key);
@@ -47,29 +49,22 @@ public:
   void Remove(int index);
   ValueType RemoveAndReturnOnlyChild();
 
-  void MoveHalfTo(BPlusTreeInternalPage *recipient,
-                  BufferPoolManager *buffer_pool_manager);
-  void MoveAllTo(BPlusTreeInternalPage *recipient, int index_in_parent,
-                 BufferPoolManager *buffer_pool_manager);
+  void MoveHalfTo(BPlusTreeInternalPage *recipient);
+  void MoveAllTo(BPlusTreeInternalPage *recipient, const KeyType &middle_key);
   void MoveFirstToEndOf(BPlusTreeInternalPage *recipient,
-                        BufferPoolManager *buffer_pool_manager);
+                        const KeyType &middle_key);
   void MoveLastToFrontOf(BPlusTreeInternalPage *recipient,
-                         int parent_index,
-                         BufferPoolManager *buffer_pool_manager);
+                         const KeyType &middle_key);
   // DEUBG and PRINT
   std::string ToString(bool verbose) const;
   void QueueUpChildren(std::queue<BPlusTreePage *> *queue,
                        BufferPoolManager *buffer_pool_manager);
 
 private:
-  void CopyHalfFrom(MappingType *items, int size,
-                    BufferPoolManager *buffer_pool_manager);
-  void CopyAllFrom(MappingType *items, int size,
-                   BufferPoolManager *buffer_pool_manager);
-  void CopyLastFrom(const MappingType &pair,
-                    BufferPoolManager *buffer_pool_manager);
-  void CopyFirstFrom(const MappingType &pair, int parent_index,
-                     BufferPoolManager *buffer_pool_manager);
+  void CopyHalfFrom(MappingType *items, int size);
+  void CopyAllFrom(MappingType *items, int size);
+  void CopyLastFrom(const MappingType &pair);
+  void CopyFirstFrom(const MappingType &pair, const KeyType &middle_key);
   MappingType array[0];
 };
 } // namespace cmudb
@@ -10,13 +10,16 @@
  * | HEADER | KEY(1) + RID(1) | KEY(2) + RID(2) | ... | KEY(n) + RID(n)
  *  ----------------------------------------------------------------------
  *
- *  Header format (size in byte, 24 bytes in total):
+ *  Header format (size in byte, 28 bytes in total):
  *  ---------------------------------------------------------------------
- * | PageType (4) | CurrentSize (4) | MaxSize (4) | ParentPageId (4) |
+ * | PageType (4) | CurrentSize (4) | MaxSize (4) | IsRoot (4) |
  *  ---------------------------------------------------------------------
- *  ------------------------------
- * | PageId (4) | NextPageId (4)
- *  ------------------------------
+ *  ---------------------------------------------
+ * | PageId (4) | NextPageId (4) | PrevPageId (4)
+ *  ---------------------------------------------
+ *
+ * Leaves form a doubly linked list. Split and merge update the neighbour on
+ * the right while latching it, left to right like every writer.
  */
 #pragma once
 #include <utility>
@@ -34,10 +37,14 @@ class BPlusTreeLeafPage : public BPlusTreePage {
 public:
   // After creating a new leaf page from buffer pool, must call initialize
   // method to set default values
-  void Init(page_id_t page_id, page_id_t parent_id = INVALID_PAGE_ID);
+  // the page holds as many items as fit in page_size bytes
+  void Init(page_id_t page_id, bool is_root = false,
+            size_t page_size = PAGE_SIZE);
   // helper methods
   page_id_t GetNextPageId() const;
   void SetNextPageId(page_id_t next_page_id);
+  page_id_t GetPrevPageId() const;
+  void SetPrevPageId(page_id_t prev_page_id);
   KeyType KeyAt(int index) const;
   int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
   const MappingType &GetItem(int index);
@@ -50,14 +57,14 @@ public:
   int RemoveAndDeleteRecord(const KeyType &key,
                             const KeyComparator &comparator);
   // Split and Merge utility methods
-  void MoveHalfTo(BPlusTreeLeafPage *recipient,
-                  BufferPoolManager *buffer_pool_manager /* Unused */);
-  void MoveAllTo(BPlusTreeLeafPage *recipient, int /* Unused */,
-                 BufferPoolManager * /* Unused */);
+  // middle_key is the separator in the parent, unused by leaves
+  void MoveHalfTo(BPlusTreeLeafPage *recipient);
+  void MoveAllTo(BPlusTreeLeafPage *recipient,
+                 const KeyType &middle_key /* Unused */);
   void MoveFirstToEndOf(BPlusTreeLeafPage *recipient,
-                        BufferPoolManager *buffer_pool_manager);
-  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient, int parent_index,
-                         BufferPoolManager *buffer_pool_manager);
+                        const KeyType &middle_key /* Unused */);
+  void MoveLastToFrontOf(BPlusTreeLeafPage *recipient,
+                         const KeyType &middle_key /* Unused */);
   // Debug
   std::string ToString(bool verbose = false) const;
 
@@ -65,9 +72,9 @@ private:
   void CopyHalfFrom(MappingType *items, int size);
   void CopyAllFrom(MappingType *items, int size);
   void CopyLastFrom(const MappingType &item);
-  void CopyFirstFrom(const MappingType &item, int parent_index,
-                     BufferPoolManager *buffer_pool_manager);
+  void CopyFirstFrom(const MappingType &item);
   page_id_t next_page_id_;
+  page_id_t prev_page_id_;
   MappingType array[0];
 };
 } // namespace cmudb
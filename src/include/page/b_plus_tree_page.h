@@ -6,12 +6,16 @@
  * It actually serves as a header part for each B+ tree page and
  * contains information shared by both leaf page and internal page.
  *
- * Header format (size in byte, 20 bytes in total):
+ * Header format (size in byte, 24 bytes in total):
  * ----------------------------------------------------------------------------
  * | PageType (4) | LSN (4) | CurrentSize (4) | MaxSize (4) |
  * ----------------------------------------------------------------------------
- * | ParentPageId (4) | PageId(4) |
+ * | IsRoot (4) | PageId(4) |
  * ----------------------------------------------------------------------------
+ *
+ * Pages do not know their parent. Writers keep the pages latched on the way
+ * down in the transaction's page set, the parent of a page is the one
+ * latched before it, so splits and merges never touch the moved children.
  */
 
 #pragma once
@@ -50,8 +54,7 @@ public:
   void SetMaxSize(int max_size);
   int GetMinSize() const;
 
-  page_id_t GetParentPageId() const;
-  void SetParentPageId(page_id_t parent_page_id);
+  void SetRootPage(bool is_root);
 
   page_id_t GetPageId() const;
   void SetPageId(page_id_t page_id);
@@ -66,7 +69,7 @@ private:
   lsn_t lsn_;                 // log sequence number
   int size_;                  // Number of Key & Value pairs in page
   int max_size_;              // Max number of Key & Value pairs in page
-  page_id_t parent_page_id_;  // Parent page id
+  int is_root_;               // Whether the page is the root
   page_id_t page_id_;         // Self page id
 };
 
@@ -0,0 +1,72 @@
+/**
+ * catalog_page.h
+ *
+ * Pages of the catalog (see catalog/catalog.h). The directory page holds the
+ * first page of every hash bucket, a bucket is a chain of catalog pages of
+ * variable length records keyed by name.
+ *
+ * Directory format (size in byte):
+ *  -----------------------------------------------------------------
+ * | BucketCount (4) | Bucket_1 page_id (4) | Bucket_2 page_id (4) | ... |
+ *  -----------------------------------------------------------------
+ *
+ * Catalog page format (size in byte):
+ *  -----------------------------------------------------------------
+ * | NextPageId (4) | RecordCount (4) | UsedBytes (4) | Record_1 | ... |
+ *  -----------------------------------------------------------------
+ * Record format:
+ *  -----------------------------------------------------------------
+ * | NameLength (4) | PayloadLength (4) | Name | Payload |
+ *  -----------------------------------------------------------------
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "page/page.h"
+
+namespace cmudb {
+
+class CatalogDirectoryPage : public Page {
+public:
+  // every bucket starts empty
+  void Init();
+
+  int GetBucketCount();
+  page_id_t GetBucketPageId(int bucket);
+  void SetBucketPageId(int bucket, page_id_t page_id);
+};
+
+class CatalogPage : public Page {
+public:
+  void Init();
+
+  page_id_t GetNextPageId();
+  void SetNextPageId(page_id_t next_page_id);
+  int GetRecordCount();
+
+  // false when the page has no room for the record
+  bool InsertRecord(const std::string &name, const std::string &payload);
+  bool DeleteRecord(const std::string &name);
+  // false when the page has no room for the new payload, the old record
+  // stays then
+  bool ReplaceRecord(const std::string &name, const std::string &payload);
+  bool GetRecord(const std::string &name, std::string &payload);
+  // every (name, payload) of the page
+  void GetRecords(std::vector<std::pair<std::string, std::string>> &records);
+
+  // largest name plus payload a record of an empty page can hold
+  static size_t MaxRecordSize(size_t page_size);
+
+private:
+  // byte offset of the record, -1 if there is none
+  int FindRecord(const std::string &name);
+  int GetUsedBytes();
+  void SetRecordCount(int record_count);
+  void SetUsedBytes(int used_bytes);
+};
+
+} // namespace cmudb
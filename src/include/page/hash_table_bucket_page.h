@@ -0,0 +1,72 @@
+/**
+ * hash_table_bucket_page.h
+ *
+ * Bucket of a disk resident extendible hash index, an unordered array of
+ * key & value pairs. A bucket that can not split any more (its local depth is
+ * the maximum global depth) chains overflow pages through NextPageId; the
+ * latch of the first page of the chain protects the whole chain.
+ * Only support unique key.
+ *
+ * Format (size in byte):
+ *  ----------------------------------------------------------------------
+ * | PageId (4) | LSN (4) | CurrentSize (4) | MaxSize (4) | NextPageId (4) |
+ *  ----------------------------------------------------------------------
+ *  --------------------------------------------------
+ * | KEY(1) + RID(1) | ... | KEY(n) + RID(n)
+ *  --------------------------------------------------
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+
+#include "index/generic_key.h"
+
+namespace cmudb {
+
+#define HASH_TABLE_BUCKET_PAGE_TYPE                                            \
+  HashTableBucketPage<KeyType, ValueType, KeyComparator>
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+class HashTableBucketPage {
+  typedef std::pair<KeyType, ValueType> ItemType;
+
+public:
+  // After creating a new bucket page from buffer pool, must call initialize
+  // method to set default values. The page holds as many items as page_size
+  // bytes have room for
+  void Init(page_id_t page_id, size_t page_size);
+
+  page_id_t GetPageId() const;
+  int GetSize() const;
+  int GetMaxSize() const;
+  bool IsFull() const;
+  page_id_t GetNextPageId() const;
+  void SetNextPageId(page_id_t next_page_id);
+
+  KeyType KeyAt(int index) const;
+  const ItemType &GetItem(int index) const;
+  // index of key, -1 if not present
+  int KeyIndex(const KeyType &key, const KeyComparator &comparator) const;
+
+  bool Lookup(const KeyType &key, ValueType &value,
+              const KeyComparator &comparator) const;
+  // append, the caller checks the bucket is not full and key not present
+  void Insert(const KeyType &key, const ValueType &value);
+  // remove the item at index, the last item takes its place
+  void RemoveAt(int index);
+
+  // Debug
+  std::string ToString() const;
+
+private:
+  page_id_t page_id_;
+  lsn_t lsn_;
+  int size_;
+  int max_size_;
+  page_id_t next_page_id_;
+  ItemType array_[0];
+};
+
+} // namespace cmudb
@@ -0,0 +1,87 @@
+/**
+ * hash_table_directory_page.h
+ *
+ * Directory of a disk resident extendible hash index. Slot i of the directory
+ * holds the bucket page for the keys whose low GlobalDepth hash bits equal i,
+ * together with the local depth of that bucket. The directory fits in a page,
+ * so its size (and the global depth) is capped by the page size of its buffer
+ * pool, recorded as MaxDepth; buckets at the maximum depth grow overflow
+ * pages instead of splitting.
+ *
+ * Format (size in byte), N = 2^MaxDepth:
+ *  --------------------------------------------------------------------------
+ * | PageId (4) | LSN (4) | GlobalDepth (4) | MaxDepth (4) | LocalDepth (1) x N
+ *  --------------------------------------------------------------------------
+ *  ------------------------
+ * | BucketPageId (4) x N |
+ *  ------------------------
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include "common/config.h"
+
+namespace cmudb {
+
+// largest power of two number of slots a directory page of page_size bytes
+// can hold
+constexpr uint32_t DirectorySlots(size_t page_size, uint32_t slots = 1) {
+  return 16 + 5 * 2 * slots <= page_size ? DirectorySlots(page_size, 2 * slots)
+                                         : slots;
+}
+
+class HashTableDirectoryPage {
+public:
+  // After creating a new directory page from buffer pool, must call
+  // initialize method to set default values
+  void Init(page_id_t page_id, page_id_t bucket_page_id, size_t page_size);
+
+  page_id_t GetPageId() const;
+
+  uint32_t GetGlobalDepth() const;
+  // number of slots in use, 2^GlobalDepth
+  uint32_t Size() const;
+  // global depth the page has room for
+  uint32_t GetMaxDepth() const;
+  // global depth a directory page of page_size bytes has room for
+  static uint32_t MaxDepthOf(size_t page_size);
+  // slot of a hash value
+  uint32_t SlotOf(uint32_t hash) const;
+
+  page_id_t GetBucketPageId(uint32_t slot) const;
+  void SetBucketPageId(uint32_t slot, page_id_t bucket_page_id);
+  uint32_t GetLocalDepth(uint32_t slot) const;
+  void SetLocalDepth(uint32_t slot, uint32_t local_depth);
+
+  // double the directory, the new upper half mirrors the lower half
+  void Grow();
+
+  // Debug
+  std::string ToString() const;
+
+private:
+  uint8_t *LocalDepths() { return array_; }
+  const uint8_t *LocalDepths() const { return array_; }
+  // behind the local depths of every slot the page has room for
+  page_id_t *BucketPageIds() {
+    return reinterpret_cast<page_id_t *>(array_ + (1U << max_depth_));
+  }
+  const page_id_t *BucketPageIds() const {
+    return reinterpret_cast<const page_id_t *>(array_ + (1U << max_depth_));
+  }
+
+  page_id_t page_id_;
+  lsn_t lsn_;
+  uint32_t global_depth_;
+  uint32_t max_depth_;
+  uint8_t array_[0];
+};
+
+// the smallest page holds a directory, with the bucket page ids aligned
+static_assert(DirectorySlots(PAGE_SIZE) >= sizeof(page_id_t),
+              "hash directory does not fit in a page");
+
+} // namespace cmudb
@@ -20,10 +20,15 @@ class Page {
   friend class BufferPoolManager;
 
 public:
-  Page() { ResetMemory(); }
+  Page() {}
+  // a page over memory of the caller, outside the buffer pool, e.g. a page
+  // image built by a bulk load before it is written
+  Page(char *data, size_t page_size) : data_(data), page_size_(page_size) {}
   ~Page(){};
   // get actual data page content
   inline char *GetData() { return data_; }
+  // size of the content in byte, the page size of the buffer pool
+  inline size_t GetPageSize() { return page_size_; }
   // get page id
   inline page_id_t GetPageId() { return page_id_; }
   // get page pin count
@@ -33,19 +38,22 @@ public:
   inline void WLatch() { rwlatch_.WLock(); }
   inline void RUnlatch() { rwlatch_.RUnlock(); }
   inline void RLatch() { rwlatch_.RLock(); }
+  inline bool TryWLatch() { return rwlatch_.TryWLock(); }
+  inline bool TryRLatch() { return rwlatch_.TryRLock(); }
 
   inline lsn_t GetLSN() { return *reinterpret_cast<lsn_t *>(GetData() + 4); }
   inline void SetLSN(lsn_t lsn) { memcpy(GetData() + 4, &lsn, 4); }
 
 private:
   // method used by buffer pool manager
-  inline void ResetMemory() { memset(data_, 0, PAGE_SIZE); }
+  inline void ResetMemory() { memset(data_, 0, page_size_); }
   // members
-  char data_[PAGE_SIZE]; // actual data
+  char *data_ = nullptr; // actual data, owned by the buffer pool manager
+  size_t page_size_ = 0;
   page_id_t page_id_ = INVALID_PAGE_ID;
   int pin_count_ = 0;
   bool is_dirty_ = false;
-  RWMutex rwlatch_;
+  RWMutex rwlatch_{LatchClass::PAGE_LATCH};
 };
 
 } // namespace cmudb
@@ -21,6 +21,7 @@
 #pragma once
 
 #include <cstring>
+#include <vector>
 
 #include "common/rid.h"
 #include "concurrency/lock_manager.h"
@@ -38,6 +39,8 @@ public:
   void Init(page_id_t page_id, size_t page_size, page_id_t prev_page_id,
             LogManager *log_manager, Transaction *txn);
   page_id_t GetPageId();
+  // a page image built before its id was known, e.g. by a bulk load
+  void SetPageId(page_id_t page_id);
   page_id_t GetPrevPageId();
   page_id_t GetNextPageId();
   void SetPrevPageId(page_id_t prev_page_id);
@@ -70,6 +73,9 @@ public:
    */
   bool GetFirstTupleRid(RID &first_rid);
   bool GetNextTupleRid(const RID &cur_rid, RID &next_rid);
+  // append a copy of every tuple of the page, in slot order
+  void GetTuples(std::vector<Tuple> &tuples, Transaction *txn,
+                 LockManager *lock_manager);
 
 private:
   /**
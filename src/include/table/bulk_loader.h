@@ -0,0 +1,95 @@
+/**
+ * bulk_loader.h
+ *
+ * Appends the rows of a CSV file to a table heap without TableHeap's per row
+ * insert. The file is read in chunks cut at a record boundary, worker threads
+ * parse each chunk into tuples and pack them into table page images. The
+ * images of a chunk get consecutive page ids and are written straight to the
+ * disk manager in one write, in file order. Only when every page is on disk
+ * is the first one linked after the last page of the heap, through the
+ * buffer pool, so a failed load leaves the table as it was.
+ *
+ * CSV format: one record per line, fields separated by commas, no header
+ * line. A field in double quotes may hold commas, newlines and "" for a
+ * quote. An empty unquoted field is NULL.
+ */
+
+#pragma once
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/dictionary.h"
+#include "catalog/schema.h"
+#include "disk/disk_manager.h"
+#include "table/table_heap.h"
+#include "table/tuple.h"
+
+namespace cmudb {
+
+class BulkLoader {
+public:
+  // encoded columns take their code from dictionary
+  BulkLoader(Schema *schema, TableHeap *table_heap,
+             BufferPoolManager *buffer_pool_manager, DiskManager *disk_manager,
+             Dictionary *dictionary = nullptr)
+      : schema_(schema), table_heap_(table_heap),
+        buffer_pool_manager_(buffer_pool_manager), disk_manager_(disk_manager),
+        dictionary_(dictionary) {}
+
+  // keep the key of every row loaded, to build an index on them at the end
+  inline void SetKeyAttrs(const std::vector<int> &key_attrs,
+                          Schema *key_schema) {
+    key_attrs_ = key_attrs;
+    key_schema_ = key_schema;
+  }
+
+  // append the rows of the file, parsed by worker_count threads. Returns the
+  // number of rows. Throws on a record that does not fit the schema, no row
+  // is appended then
+  size_t Load(const std::string &file_name, int worker_count);
+
+  // bytes of the file read by the last Load
+  inline uint64_t GetBytes() const { return bytes_; }
+
+  // key and rid of every row loaded, in key order so they go into an
+  // ordered index one leaf after the other
+  inline std::vector<std::pair<Tuple, RID>> &GetKeys() { return keys_; }
+
+private:
+  // what a worker makes of a chunk
+  struct Chunk {
+    // page images back to back, with the page index in the chunk as their
+    // page id until they are written
+    std::vector<char> pages;
+    int page_count = 0;
+    size_t row_count = 0;
+    // page of the rid is the page index in the chunk too
+    std::vector<std::pair<Tuple, RID>> keys;
+  };
+
+  Chunk ParseChunk(const std::string &text);
+  // one column of a record
+  Value ParseField(int column, const std::string &field, bool quoted);
+  // give the pages their ids, write them after the last one written
+  void WriteChunk(Chunk &chunk);
+
+  Schema *schema_;
+  TableHeap *table_heap_;
+  BufferPoolManager *buffer_pool_manager_;
+  DiskManager *disk_manager_;
+  Dictionary *dictionary_;
+  std::vector<int> key_attrs_;
+  Schema *key_schema_ = nullptr;
+
+  uint64_t bytes_ = 0;
+  std::vector<std::pair<Tuple, RID>> keys_;
+  // last page of the chunks written, its image kept to link the next chunk
+  page_id_t first_page_id_ = INVALID_PAGE_ID;
+  page_id_t last_page_id_ = INVALID_PAGE_ID;
+  std::vector<char> last_page_;
+};
+
+} // namespace cmudb
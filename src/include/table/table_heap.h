@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "buffer/buffer_pool_manager.h"
 #include "logging/log_manager.h"
 #include "page/table_page.h"
@@ -44,6 +46,11 @@ public:
 
   bool GetTuple(const RID &rid, Tuple &tuple, Transaction *txn);
 
+  // append a copy of every tuple of the page, returns the next page of the
+  // heap. A scan reads a page under one latch instead of one per tuple
+  page_id_t GetPageTuples(page_id_t page_id, std::vector<Tuple> &tuples,
+                          Transaction *txn);
+
   bool DeleteTableHeap();
 
   TableIterator begin(Transaction *txn);
@@ -2,13 +2,21 @@
  * tuple.h
  *
  * Tuple format:
- *  ------------------------------------------------------------------
- * | FIXED-SIZE or VARIED-SIZED OFFSET | PAYLOAD OF VARIED-SIZED FIELD|
- *  ------------------------------------------------------------------
+ *  ---------------------------------------------------------------------
+ * | FIXED-SIZE or VARIED-SIZED OFFSET | NULL BITMAP | VARINT | PAYLOAD |
+ *  ---------------------------------------------------------------------
+ * The fixed size columns are laid out by the schema (see catalog/schema.h).
+ * The null bitmap, only when the schema has one, has bit (i % 8) of byte
+ * (i / 8) set when column i is NULL. A NULL column keeps its slot, holding
+ * the sentinel of its type (0 for a varint column). A varint column is its
+ * zigzag value in 7 bit groups, low group first, the high bit of a byte set
+ * when another follows. PAYLOAD holds the VARCHAR columns.
  */
 
 #pragma once
 
+#include <cstring>
+
 #include "catalog/schema.h"
 #include "common/rid.h"
 #include "type/value.h"
@@ -63,18 +71,48 @@ public:
   // checks the schema to see how to return the Value.
   Value GetValue(Schema *schema, const int column_id) const;
 
-  // Is the column value null ?
+  // read the column in place as T, the C++ type it is stored as (see
+  // type/type_traits.h): no Value is built and no Type is dispatched to.
+  // Get<const char *> gives the characters of a VARCHAR
+  template <typename T> inline T Get(Schema *schema, const int column_id) const {
+    if (schema->IsVarint(column_id))
+      return static_cast<T>(GetVarint(schema, column_id));
+    T value;
+    memcpy(&value, data_ + schema->GetOffset(column_id), sizeof(T));
+    return value;
+  }
+
+  // Is the column value null ? Read from the null bitmap when the schema has
+  // one, from the sentinel of the type otherwise
   inline bool IsNull(Schema *schema, const int column_id) const {
-    Value value = GetValue(schema, column_id);
-    return value.IsNull();
+    if (schema->HasNullBitmap())
+      return (data_[schema->GetNullBitmapOffset() + column_id / 8] >>
+              (column_id % 8)) &
+             1;
+    return IsNullSentinel(schema, column_id);
   }
   inline bool IsAllocated() { return allocated_; }
 
   std::string ToString(Schema *schema) const;
 
+  // Get the starting storage address of specific column, not of a varint
+  // one. The stored form of the column, as CompareRaw takes it
+  inline const char *GetDataPtr(Schema *schema, const int column_id) const {
+    const char *data_ptr = data_ + schema->GetOffset(column_id);
+    if (schema->IsInlined(column_id))
+      return data_ptr;
+    // the real data of a VARCHAR is at the relative offset stored
+    int32_t offset;
+    memcpy(&offset, data_ptr, sizeof(int32_t));
+    return data_ + offset;
+  }
+
 private:
-  // Get the starting storage address of specific column
-  const char *GetDataPtr(Schema *schema, const int column_id) const;
+  // is the stored value the NULL sentinel of the column type ?
+  bool IsNullSentinel(Schema *schema, const int column_id) const;
+
+  // decode the value of a varint column
+  int64_t GetVarint(Schema *schema, const int column_id) const;
 
   bool allocated_; // is allocated?
   RID rid_;        // if pointing to the table heap, the rid is valid
@@ -82,4 +120,12 @@ private:
   char *data_;
 };
 
+template <>
+inline const char *Tuple::Get<const char *>(Schema *schema,
+                                            const int column_id) const {
+  int32_t offset;
+  memcpy(&offset, data_ + schema->GetOffset(column_id), sizeof(int32_t));
+  return data_ + offset + sizeof(uint32_t);
+}
+
 } // namespace cmudb
@@ -0,0 +1,71 @@
+/**
+ * tuple_filter.h
+ *
+ * Conjunction of column <op> constant predicates, evaluated over a batch of
+ * tuples at a time. Every predicate gathers its column into a typed array
+ * (int64_t, double or string) and a branch free loop over the array narrows
+ * a byte per row match vector, the rows left make the selection vector.
+ *
+ * Integer columns compare as int64_t, decimal columns and integer columns
+ * against a decimal constant as double, varchar columns against a varchar
+ * constant byte by byte (the BINARY collation of sqlite). A NULL matches
+ * no predicate.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "catalog/schema.h"
+#include "table/tuple.h"
+#include "type/value.h"
+
+namespace cmudb {
+
+enum class FilterOp { EQ, LT, LE, GT, GE };
+
+class TupleFilter {
+public:
+  explicit TupleFilter(Schema *schema) : schema_(schema) {}
+
+  // rows must satisfy column op constant. False when the column can not be
+  // compared with the constant in place (e.g. varchar against a number), the
+  // predicate is left out
+  bool AddPredicate(int column, FilterOp op, const Value &constant);
+
+  // no row can match, e.g. a comparison with NULL
+  inline void SetEmpty() { empty_ = true; }
+  inline bool IsEmpty() const { return empty_; }
+
+  inline size_t GetPredicateCount() const { return predicates_.size(); }
+
+  // positions in tuples of the rows that satisfy every predicate, ascending
+  void Select(const std::vector<Tuple> &tuples, std::vector<int> &selection);
+
+private:
+  struct Predicate {
+    int column;
+    FilterOp op;
+    // BIGINT, DECIMAL or VARCHAR, the type the column is compared as
+    TypeId compare_type;
+    int64_t bigint_constant;
+    double decimal_constant;
+    std::string varchar_constant;
+  };
+
+  void MatchNotNull(const std::vector<Tuple> &tuples, int column);
+
+  void MatchVarchar(const std::vector<Tuple> &tuples,
+                    const Predicate &predicate);
+
+  Schema *schema_;
+  std::vector<Predicate> predicates_;
+  bool empty_ = false;
+  // per batch scratch, kept to reuse their memory
+  std::vector<uint8_t> match_;
+  std::vector<int64_t> bigints_;
+  std::vector<double> decimals_;
+};
+
+} // namespace cmudb
@@ -30,6 +30,8 @@ public:
 
   static Value GetMinValue(TypeId type_id);
   static Value GetMaxValue(TypeId type_id);
+  // the NULL of the type, stored as its sentinel value
+  static Value GetNullValue(TypeId type_id);
 
   inline static Type *GetInstance(TypeId type_id) { return kTypes[type_id]; }
 
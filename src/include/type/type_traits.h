@@ -0,0 +1,82 @@
+/**
+ * type_traits.h
+ *
+ * Compile time view of the stored form of each TypeId, for the hot paths
+ * that read or compare column data in place instead of through Value and
+ * the virtual Type instances.
+ *
+ * Fixed width types are stored as their C++ type, a VARCHAR as its length
+ * (uint32_t, counting the terminating null) and the characters.
+ */
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+
+#include "type/limits.h"
+#include "type/type_id.h"
+#include "type/type_util.h"
+
+namespace cmudb {
+
+// C++ type a column of the TypeId is read as
+template <TypeId type> struct TypeTraits;
+template <> struct TypeTraits<TypeId::BOOLEAN> { using CppType = int8_t; };
+template <> struct TypeTraits<TypeId::TINYINT> { using CppType = int8_t; };
+template <> struct TypeTraits<TypeId::SMALLINT> { using CppType = int16_t; };
+template <> struct TypeTraits<TypeId::INTEGER> { using CppType = int32_t; };
+template <> struct TypeTraits<TypeId::BIGINT> { using CppType = int64_t; };
+template <> struct TypeTraits<TypeId::DECIMAL> { using CppType = double; };
+// the characters, null terminated
+template <> struct TypeTraits<TypeId::VARCHAR> {
+  using CppType = const char *;
+};
+
+// <0, 0 or >0 as the stored value at lhs is less, equal or greater than the
+// one at rhs. NULLs compare by their stored sentinel
+template <TypeId type>
+inline int CompareRaw(const char *lhs, const char *rhs) {
+  using T = typename TypeTraits<type>::CppType;
+  T lhs_value, rhs_value;
+  memcpy(&lhs_value, lhs, sizeof(T));
+  memcpy(&rhs_value, rhs, sizeof(T));
+  return (lhs_value > rhs_value) - (lhs_value < rhs_value);
+}
+
+template <>
+inline int CompareRaw<TypeId::VARCHAR>(const char *lhs, const char *rhs) {
+  uint32_t lhs_length, rhs_length;
+  memcpy(&lhs_length, lhs, sizeof(uint32_t));
+  memcpy(&rhs_length, rhs, sizeof(uint32_t));
+  // a NULL is its length alone, before every other value
+  if (lhs_length == PELOTON_VALUE_NULL || rhs_length == PELOTON_VALUE_NULL)
+    return (rhs_length == PELOTON_VALUE_NULL) -
+           (lhs_length == PELOTON_VALUE_NULL);
+  return TypeUtil::CompareStrings(lhs + sizeof(uint32_t), lhs_length,
+                                  rhs + sizeof(uint32_t), rhs_length);
+}
+
+// CompareRaw of the type chosen at run time, the instances inline into the
+// switch. Types without a stored form compare equal
+inline int CompareRaw(TypeId type, const char *lhs, const char *rhs) {
+  switch (type) {
+  case TypeId::BOOLEAN:
+    return CompareRaw<TypeId::BOOLEAN>(lhs, rhs);
+  case TypeId::TINYINT:
+    return CompareRaw<TypeId::TINYINT>(lhs, rhs);
+  case TypeId::SMALLINT:
+    return CompareRaw<TypeId::SMALLINT>(lhs, rhs);
+  case TypeId::INTEGER:
+    return CompareRaw<TypeId::INTEGER>(lhs, rhs);
+  case TypeId::BIGINT:
+    return CompareRaw<TypeId::BIGINT>(lhs, rhs);
+  case TypeId::DECIMAL:
+    return CompareRaw<TypeId::DECIMAL>(lhs, rhs);
+  case TypeId::VARCHAR:
+    return CompareRaw<TypeId::VARCHAR>(lhs, rhs);
+  default:
+    return 0;
+  }
+}
+
+} // namespace cmudb
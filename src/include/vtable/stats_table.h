@@ -0,0 +1,21 @@
+/**
+ * stats_table.h
+ *
+ * Eponymous read-only virtual table exposing the engine metrics:
+ *   SELECT * FROM vtable_stats;
+ * one row per counter (value) and per histogram (value = number of samples,
+ * sum and percentiles in nanoseconds).
+ * SELECT vtable_latch_profile() returns the latch contention report,
+ * vtable_trace('start' | 'stop' | 'dump', path) drives the tracer.
+ */
+
+#pragma once
+
+#include "sqlite/sqlite3ext.h"
+
+namespace cmudb {
+
+// register the vtable_stats module and the diagnostics functions, called from sqlite3_vtable_init
+int RegisterStatsModule(sqlite3 *db);
+
+} // namespace cmudb
@@ -4,14 +4,27 @@
 
 #pragma once
 
+#include <algorithm>
+#include <memory>
+#include <unordered_map>
+
 #include "buffer/lru_replacer.h"
+#include "catalog/catalog.h"
+#include "catalog/dictionary.h"
 #include "catalog/schema.h"
+#include "common/metrics.h"
 #include "concurrency/transaction_manager.h"
+#include "index/art_index.h"
+#include "index/b_epsilon_tree_index.h"
+#include "index/b_link_tree_index.h"
 #include "index/b_plus_tree_index.h"
+#include "index/extendible_hash_index.h"
 #include "logging/log_manager.h"
 #include "sqlite/sqlite3ext.h"
+#include "table/bulk_loader.h"
 #include "table/table_heap.h"
 #include "table/tuple.h"
+#include "table/tuple_filter.h"
 #include "type/value.h"
 
 namespace cmudb {
@@ -22,7 +35,10 @@ IndexMetadata *ParseIndexStatement(std::string &sql,
                                    const std::string &table_name,
                                    Schema *schema);
 
-Tuple ConstructTuple(Schema *schema, sqlite3_value **argv);
+// encoded columns take their code from dictionary. A value without one gets
+// the next code, or with add_values false the code -1 no row has
+Tuple ConstructTuple(Schema *schema, sqlite3_value **argv,
+                     Dictionary *dictionary = nullptr, bool add_values = true);
 
 Index *ConstructIndex(IndexMetadata *metadata,
                       BufferPoolManager *buffer_pool_manager,
@@ -40,6 +56,8 @@ int VtabBestIndex(sqlite3_vtab *tab, sqlite3_index_info *pIdxInfo);
 
 int VtabDisconnect(sqlite3_vtab *pVtab);
 
+int VtabDestroy(sqlite3_vtab *pVtab);
+
 int VtabOpen(sqlite3_vtab *pVtab, sqlite3_vtab_cursor **ppCursor);
 
 int VtabClose(sqlite3_vtab_cursor *cur);
@@ -59,10 +77,12 @@ int VtabCommit(sqlite3_vtab *pVTab);
 
 int VtabBegin(sqlite3_vtab *pVTab);
 
+class VirtualTable;
+
 // storage engine
 class StorageEngine {
 public:
-  StorageEngine(std::string db_file_name) {
+  StorageEngine(std::string db_file_name) : db_file_name_(db_file_name) {
     ENABLE_LOGGING = false;
 
     // storage related
@@ -74,26 +94,53 @@ public:
     buffer_pool_manager_ =
         new BufferPoolManager(BUFFER_POOL_SIZE, disk_manager_, log_manager_);
 
+    // indexes live in their own file, with nodes of INDEX_PAGE_SIZE. The
+    // same number of frames covers far more keys, since large nodes keep
+    // trees shallow
+    index_disk_manager_ =
+        new DiskManager(IndexFileName(db_file_name), INDEX_PAGE_SIZE);
+    index_buffer_pool_manager_ =
+        new BufferPoolManager(BUFFER_POOL_SIZE, index_disk_manager_);
+
     // txn related
     lock_manager_ = new LockManager(true); // S2PL
     transaction_manager_ = new TransactionManager(lock_manager_, log_manager_);
   }
 
+  // pages still dirty when the connection closes are written back
   ~StorageEngine() {
     if (ENABLE_LOGGING)
       log_manager_->StopFlushThread();
+    delete catalog_;
+    buffer_pool_manager_->FlushAllPages();
+    index_buffer_pool_manager_->FlushAllPages();
     delete disk_manager_;
     delete buffer_pool_manager_;
+    delete index_disk_manager_;
+    delete index_buffer_pool_manager_;
     delete log_manager_;
     delete lock_manager_;
     delete transaction_manager_;
   }
 
+  // the index segment of a database file
+  static std::string IndexFileName(const std::string &db_file_name) {
+    return db_file_name + ".idx";
+  }
+
+  std::string db_file_name_;
   DiskManager *disk_manager_;
   BufferPoolManager *buffer_pool_manager_;
+  // index segment, its header page holds the index root page ids
+  DiskManager *index_disk_manager_;
+  BufferPoolManager *index_buffer_pool_manager_;
+  // tables of the database, opened once the header page exists
+  Catalog *catalog_ = nullptr;
   LockManager *lock_manager_;
   TransactionManager *transaction_manager_;
   LogManager *log_manager_;
+  // connected tables by name, for the functions that name a table
+  std::unordered_map<std::string, VirtualTable *> tables_;
 };
 
 StorageEngine *storage_engine_;
@@ -125,11 +172,15 @@ public:
     delete schema_;
     delete table_heap_;
     delete index_;
+    delete dictionary_;
   }
 
   // insert into table heap
   inline bool InsertTuple(const Tuple &tuple, RID &rid) {
-    return table_heap_->InsertTuple(tuple, rid, GetTransaction());
+    bool inserted = table_heap_->InsertTuple(tuple, rid, GetTransaction());
+    if (inserted)
+      catalog_entry_.row_count++;
+    return inserted;
   }
 
   // insert into index
@@ -148,7 +199,10 @@ public:
   // delete from table heap
   // TODO: call makrdelete method from heaptable
   inline bool DeleteTuple(const RID &rid) {
-    return table_heap_->MarkDelete(rid, GetTransaction());
+    bool deleted = table_heap_->MarkDelete(rid, GetTransaction());
+    if (deleted)
+      catalog_entry_.row_count--;
+    return deleted;
   }
 
   // delete from index
@@ -180,18 +234,113 @@ public:
 
   inline Index *GetIndex() { return index_; }
 
+  // nullptr when no column is dictionary encoded
+  inline Dictionary *GetDictionary() { return dictionary_; }
+
   inline TableHeap *GetTableHeap() { return table_heap_; }
 
   inline page_id_t GetFirstPageId() { return table_heap_->GetFirstPageId(); }
 
+  // the catalog entry of the table, its row count is kept up to date and
+  // written back by SaveStats. Rows of aborted transactions are counted too
+  inline CatalogEntry &GetCatalogEntry() { return catalog_entry_; }
+
+  void SaveStats() { storage_engine_->catalog_->UpdateEntry(catalog_entry_); }
+
+  // open the dictionary of the catalog entry, a table that has encoded
+  // columns but no dictionary yet gets one recorded in its entry
+  void OpenDictionary() {
+    bool encoded = false;
+    for (int i = 0; i < schema_->GetColumnCount(); i++)
+      encoded |= schema_->IsDictionary(i);
+    if (!encoded)
+      return;
+    page_id_t page_id = catalog_entry_.dictionary_page_id;
+    dictionary_ =
+        new Dictionary(storage_engine_->buffer_pool_manager_, page_id);
+    if (page_id == INVALID_PAGE_ID) {
+      catalog_entry_.dictionary_page_id = dictionary_->GetFirstPageId();
+      storage_engine_->catalog_->UpdateEntry(catalog_entry_);
+    }
+  }
+
+  // memory resident indexes are not persisted with the table
+  inline bool IsIndexInMemory() {
+    return index_ != nullptr && index_->GetIndexType() == IndexType::ART;
+  }
+
+  // where the memory resident index is saved between connections
+  inline std::string GetIndexSnapshotName() {
+    return storage_engine_->db_file_name_ + "." + index_->GetName() + ".art";
+  }
+
+  // fill the memory resident index from its snapshot, or from the table heap
+  // when there is none. The snapshot is consumed, it is stale as soon as the
+  // table changes
+  void LoadIndex() {
+    if (!IsIndexInMemory())
+      return;
+    ArtIndex *index = static_cast<ArtIndex *>(index_);
+    std::string snapshot = GetIndexSnapshotName();
+    if (!index->LoadSnapshot(snapshot)) {
+      Transaction *txn = storage_engine_->transaction_manager_->Begin();
+      for (auto it = table_heap_->begin(txn); it != table_heap_->end(); ++it) {
+        std::vector<Value> key_values;
+        for (auto &i : index_->GetKeyAttrs())
+          key_values.push_back(it->GetValue(schema_, i));
+        Tuple key(key_values, index_->GetKeySchema());
+        index_->InsertEntry(key, it->GetRid(), txn);
+      }
+      storage_engine_->transaction_manager_->Commit(txn);
+    }
+    remove(snapshot.c_str());
+  }
+
+  // append the rows of a CSV file (see table/bulk_loader.h), parsed by
+  // worker_count threads, then insert their keys into the index in key
+  // order. Returns the number of rows, bytes is set to the size of the file
+  size_t Import(const std::string &file_name, int worker_count,
+                uint64_t &bytes) {
+    BulkLoader loader(schema_, table_heap_,
+                      storage_engine_->buffer_pool_manager_,
+                      storage_engine_->disk_manager_, dictionary_);
+    if (index_ != nullptr)
+      loader.SetKeyAttrs(index_->GetKeyAttrs(), index_->GetKeySchema());
+    size_t row_count = loader.Load(file_name, worker_count);
+    bytes = loader.GetBytes();
+    if (index_ != nullptr) {
+      Transaction *txn = storage_engine_->transaction_manager_->Begin();
+      for (auto &key : loader.GetKeys())
+        index_->InsertEntry(key.first, key.second, txn);
+      storage_engine_->transaction_manager_->Commit(txn);
+      delete txn;
+    }
+    catalog_entry_.row_count += row_count;
+    SaveStats();
+    Metrics::Add(MetricCounter::IMPORT_ROW, row_count);
+    Metrics::Add(MetricCounter::IMPORT_BYTE, bytes);
+    return row_count;
+  }
+
+  // snapshot the memory resident index, after the table heap is flushed
+  void SaveIndex() {
+    if (!IsIndexInMemory())
+      return;
+    storage_engine_->buffer_pool_manager_->FlushAllPages();
+    static_cast<ArtIndex *>(index_)->Checkpoint(GetIndexSnapshotName());
+  }
+
 private:
   sqlite3_vtab base_;
   // virtual table schema
   Schema *schema_;
   // to read/write actual data in table
   TableHeap *table_heap_;
+  // values of the encoded columns
+  Dictionary *dictionary_ = nullptr;
   // to insert/delete index entry
   Index *index_ = nullptr;
+  CatalogEntry catalog_entry_;
 };
 
 class Cursor {
@@ -204,6 +353,12 @@ public:
     is_index_scan_ = is_index_scan;
   }
 
+  // every column read is part of the index key, it is decoded from the key
+  // and the table heap is never read
+  inline void SetIndexOnly(bool is_index_only) {
+    is_index_only_ = is_index_only;
+  }
+
   inline bool IsIndexScan() { return is_index_scan_; }
 
   inline VirtualTable *GetVirtualTable() { return virtual_table_; }
@@ -213,50 +368,169 @@ public:
   }
   // return rid at which cursor is currently pointed
   inline int64_t GetCurrentRid() {
+    if (is_filter_scan_)
+      return batch_[selection_[offset_]].GetRid().Get();
     if (is_index_scan_)
       return results[offset_].Get();
     else
       return (*table_iterator_).GetRid().Get();
   }
 
-  // return tuple at which cursor is currently pointed
-  inline Value GetCurrentValue(Schema *schema, int column) {
+  // tuple at which cursor is currently pointed. For a key column of an
+  // index-only scan it is the key tuple, schema and column are changed to
+  // the key schema and the position in the key
+  inline const Tuple &GetCurrentTuple(Schema *&schema, int &column) {
+    if (is_index_only_) {
+      auto &key_attrs = virtual_table_->index_->GetKeyAttrs();
+      auto pos = std::find(key_attrs.begin(), key_attrs.end(), column);
+      if (pos != key_attrs.end()) {
+        schema = GetKeySchema();
+        column = pos - key_attrs.begin();
+        return keys_[offset_];
+      }
+    }
+    if (is_filter_scan_)
+      return batch_[selection_[offset_]];
     if (is_index_scan_) {
-      RID rid = results[offset_];
-      Tuple tuple(rid);
-      virtual_table_->table_heap_->GetTuple(rid, tuple, GetTransaction());
-      return tuple.GetValue(schema, column);
-    } else {
-      return table_iterator_->GetValue(schema, column);
+      // read once for all the columns of the row
+      if (!is_current_tuple_read_) {
+        virtual_table_->table_heap_->GetTuple(results[offset_], current_tuple_,
+                                              GetTransaction());
+        is_current_tuple_read_ = true;
+      }
+      return current_tuple_;
     }
+    return *table_iterator_;
+  }
+
+  // return value at which cursor is currently pointed
+  inline Value GetCurrentValue(Schema *schema, int column) {
+    const Tuple &tuple = GetCurrentTuple(schema, column);
+    return tuple.GetValue(schema, column);
   }
 
   // move cursor up to next
   Cursor &operator++() {
-    if (is_index_scan_)
+    is_current_tuple_read_ = false;
+    if (is_filter_scan_) {
       ++offset_;
-    else
+      if (offset_ == static_cast<int>(selection_.size()))
+        NextFilteredBatch();
+    } else if (is_index_scan_) {
+      if (is_index_only_)
+        Metrics::Add(MetricCounter::INDEX_ONLY_ROW);
+      ++offset_;
+      if (is_ordered_scan_ && offset_ == static_cast<int>(results.size()))
+        NextBatch();
+    } else {
       ++table_iterator_;
+    }
     return *this;
   }
   // is end of cursor(no more tuple)
   inline bool isEof() {
+    if (is_filter_scan_)
+      return offset_ == static_cast<int>(selection_.size());
     if (is_index_scan_)
       return offset_ == static_cast<int>(results.size());
     else
       return table_iterator_ == virtual_table_->end();
   }
 
-  // wrapper around poit scan methods
+  // wrapper around poit scan methods. sqlite runs an IN list as one filter
+  // per key in ascending order, the probes go on from where the last ended
   inline void ScanKey(const Tuple &key) {
-    virtual_table_->index_->ScanKey(key, results);
+    is_current_tuple_read_ = false;
+    results.clear();
+    offset_ = 0;
+    virtual_table_->index_->ScanKeys({key}, results, probe_position_);
+    // a match has the key it was looked up with
+    if (is_index_only_)
+      keys_.assign(results.size(), key);
+  }
+
+  // walk the whole index in key order, a batch of rids at a time
+  inline void ScanOrdered(bool reverse) {
+    is_ordered_scan_ = true;
+    reverse_ = reverse;
+    position_.clear();
+    batch_size_ = MIN_SCAN_BATCH;
+    NextBatch();
+  }
+
+  // sequential scan that hands out only the rows filter selects, a batch
+  // of table pages at a time
+  inline void ScanFiltered(TupleFilter *filter) {
+    is_filter_scan_ = true;
+    filter_.reset(filter);
+    next_page_id_ = filter->IsEmpty() ? INVALID_PAGE_ID
+                                      : virtual_table_->GetFirstPageId();
+    NextFilteredBatch();
   }
 
 private:
+  // sqlite does not tell a LIMIT, the first batch is small and each one
+  // doubles while rows are still wanted
+  static const size_t MIN_SCAN_BATCH = 8;
+  static const size_t MAX_SCAN_BATCH = 256;
+
+  inline void NextBatch() {
+    is_current_tuple_read_ = false;
+    results.clear();
+    keys_.clear();
+    offset_ = 0;
+    virtual_table_->index_->ScanBatch(position_, reverse_, batch_size_,
+                                      results,
+                                      is_index_only_ ? &keys_ : nullptr);
+    batch_size_ = batch_size_ < MAX_SCAN_BATCH / 2 ? 2 * batch_size_
+                                                  : MAX_SCAN_BATCH;
+  }
+
+  // table pages are small, a batch takes whole pages until it holds this
+  // many rows
+  static const size_t MIN_FILTER_BATCH = 128;
+
+  // the next batch with a selected row, or an empty one at the end of the
+  // table
+  inline void NextFilteredBatch() {
+    offset_ = 0;
+    selection_.clear();
+    while (selection_.empty() && next_page_id_ != INVALID_PAGE_ID) {
+      batch_.clear();
+      while (next_page_id_ != INVALID_PAGE_ID &&
+             batch_.size() < MIN_FILTER_BATCH)
+        next_page_id_ = virtual_table_->table_heap_->GetPageTuples(
+            next_page_id_, batch_, GetTransaction());
+      filter_->Select(batch_, selection_);
+      Metrics::Add(MetricCounter::FILTER_SKIP_ROW,
+                   batch_.size() - selection_.size());
+    }
+  }
+
   sqlite3_vtab_cursor base_; /* Base class - must be first */
   // for index scan
   std::vector<RID> results;
   int offset_ = 0;
+  // for index scan, where the last probe ended
+  std::string probe_position_;
+  // for ordered index scan, where the next batch starts
+  bool is_ordered_scan_ = false;
+  bool reverse_ = false;
+  std::string position_;
+  size_t batch_size_ = MIN_SCAN_BATCH;
+  // for index-only scan, the key tuple of every rid in results
+  bool is_index_only_ = false;
+  std::vector<Tuple> keys_;
+  // for index scan, the table heap tuple of the current rid
+  bool is_current_tuple_read_ = false;
+  Tuple current_tuple_;
+  // for filtered sequential scan, the rows of a batch and the positions of
+  // those selected
+  bool is_filter_scan_ = false;
+  std::unique_ptr<TupleFilter> filter_;
+  page_id_t next_page_id_ = INVALID_PAGE_ID;
+  std::vector<Tuple> batch_;
+  std::vector<int> selection_;
   // for sequential scan
   TableIterator table_iterator_;
   // flag to indicate which scan method is currently used
@@ -0,0 +1,83 @@
+/**
+ * adaptive_hash_index.cpp
+ */
+
+#include "index/adaptive_hash_index.h"
+#include "index/generic_key.h"
+
+namespace cmudb {
+
+template <typename KeyType>
+bool AdaptiveHashIndex<KeyType>::Lookup(const KeyType &key, Entry &entry) {
+  if (Size() == 0 || !IsEnabled())
+    return false;
+  Shard &shard = ShardOf(key);
+  std::lock_guard<std::mutex> guard(shard.latch);
+  auto it = shard.entries.find(key);
+  if (it == shard.entries.end())
+    return false;
+  entry = it->second;
+  return true;
+}
+
+template <typename KeyType>
+void AdaptiveHashIndex<KeyType>::Record(const KeyType &key,
+                                        const Entry &entry) {
+  if (!IsEnabled())
+    return;
+  Shard &shard = ShardOf(key);
+  std::lock_guard<std::mutex> guard(shard.latch);
+  auto it = shard.entries.find(key);
+  if (it != shard.entries.end()) {
+    it->second = entry;
+    return;
+  }
+  // 1. not hot yet
+  if (shard.candidates.size() >= SHARD_CAPACITY)
+    shard.candidates.clear();
+  int &count = shard.candidates[key];
+  if (++count < PROMOTE_THRESHOLD)
+    return;
+  shard.candidates.erase(key);
+  // 2. cache it, evicting an arbitrary key when the shard is full
+  if (shard.entries.size() >= SHARD_CAPACITY) {
+    shard.entries.erase(shard.entries.begin());
+    size_.fetch_sub(1, std::memory_order_relaxed);
+  }
+  shard.entries.emplace(key, entry);
+  size_.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename KeyType>
+void AdaptiveHashIndex<KeyType>::Invalidate(const KeyType &key) {
+  if (Size() == 0)
+    return;
+  Shard &shard = ShardOf(key);
+  std::lock_guard<std::mutex> guard(shard.latch);
+  if (shard.entries.erase(key) > 0)
+    size_.fetch_sub(1, std::memory_order_relaxed);
+}
+
+template <typename KeyType> void AdaptiveHashIndex<KeyType>::Clear() {
+  for (Shard &shard : shards_) {
+    std::lock_guard<std::mutex> guard(shard.latch);
+    size_.fetch_sub(shard.entries.size(), std::memory_order_relaxed);
+    shard.entries.clear();
+    shard.candidates.clear();
+  }
+}
+
+template <typename KeyType>
+void AdaptiveHashIndex<KeyType>::SetEnabled(bool enabled) {
+  enabled_.store(enabled, std::memory_order_relaxed);
+  if (!enabled)
+    Clear();
+}
+
+template class AdaptiveHashIndex<GenericKey<4>>;
+template class AdaptiveHashIndex<GenericKey<8>>;
+template class AdaptiveHashIndex<GenericKey<16>>;
+template class AdaptiveHashIndex<GenericKey<32>>;
+template class AdaptiveHashIndex<GenericKey<64>>;
+
+} // namespace cmudb
@@ -0,0 +1,832 @@
+/**
+ * art.cpp
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "common/exception.h"
+#include "index/art.h"
+
+namespace cmudb {
+
+namespace {
+// prefix bytes stored in a node, longer prefixes are checked at the leaf
+const uint32_t MAX_STORED_PREFIX = 8;
+
+// retirements between two attempts to free retired nodes
+const size_t RECLAIM_BATCH = 64;
+
+// bytes past the end of a key read as 0
+inline uint8_t KeyByte(const std::string &key, uint32_t i) {
+  return i < key.size() ? static_cast<uint8_t>(key[i]) : 0;
+}
+
+/*
+ * Epoch based reclamation, shared by every tree. While a thread runs a tree
+ * operation its slot holds the global epoch it read on entry, 0 otherwise. A
+ * node is retired with the epoch current after it was unlinked, an
+ * operation that entered in a later epoch can not reach it anymore.
+ */
+struct EpochSlot {
+  std::atomic<uint64_t> epoch{0};
+};
+
+struct EpochRegistry {
+  std::atomic<uint64_t> global_epoch{1};
+  std::mutex mutex;
+  std::vector<EpochSlot *> slots;
+};
+
+EpochRegistry *GetEpochRegistry() {
+  static EpochRegistry *registry = new EpochRegistry;
+  return registry;
+}
+
+// unregisters the slot of a thread when the thread exits
+struct EpochSlotOwner {
+  EpochSlot *slot = nullptr;
+  ~EpochSlotOwner() {
+    if (slot == nullptr)
+      return;
+    EpochRegistry *registry = GetEpochRegistry();
+    std::lock_guard<std::mutex> guard(registry->mutex);
+    registry->slots.erase(
+        std::find(registry->slots.begin(), registry->slots.end(), slot));
+    delete slot;
+  }
+};
+
+thread_local EpochSlotOwner epoch_slot_owner;
+
+EpochSlot *LocalEpochSlot() {
+  if (epoch_slot_owner.slot == nullptr) {
+    EpochSlot *slot = new EpochSlot;
+    EpochRegistry *registry = GetEpochRegistry();
+    std::lock_guard<std::mutex> guard(registry->mutex);
+    registry->slots.push_back(slot);
+    epoch_slot_owner.slot = slot;
+  }
+  return epoch_slot_owner.slot;
+}
+
+// pins the current epoch for one tree operation, operations do not nest
+class EpochGuard {
+public:
+  EpochGuard() : slot_(LocalEpochSlot()) {
+    slot_->epoch.store(GetEpochRegistry()->global_epoch.load());
+  }
+  ~EpochGuard() { slot_->epoch.store(0); }
+
+private:
+  EpochSlot *slot_;
+};
+
+// oldest epoch pinned by a running operation, UINT64_MAX if there is none
+uint64_t OldestPinnedEpoch() {
+  EpochRegistry *registry = GetEpochRegistry();
+  std::lock_guard<std::mutex> guard(registry->mutex);
+  uint64_t oldest = UINT64_MAX;
+  for (EpochSlot *slot : registry->slots) {
+    uint64_t epoch = slot->epoch.load();
+    if (epoch != 0 && epoch < oldest)
+      oldest = epoch;
+  }
+  return oldest;
+}
+} // namespace
+
+enum class ArtNodeType : uint8_t { LEAF, NODE4, NODE16, NODE48, NODE256 };
+
+struct ArtNode {
+  explicit ArtNode(ArtNodeType type) : type(type) {}
+  virtual ~ArtNode() {}
+  inline bool IsLeaf() const { return type == ArtNodeType::LEAF; }
+
+  const ArtNodeType type;
+};
+
+// leaves are immutable, a removed leaf is retired
+struct ArtLeaf : public ArtNode {
+  ArtLeaf(const std::string &key, const RID &value)
+      : ArtNode(ArtNodeType::LEAF), key(key), value(value) {}
+
+  const std::string key;
+  const RID value;
+};
+
+typedef std::vector<std::pair<uint8_t, ArtNode *>> ArtChildren;
+
+struct ArtInner : public ArtNode {
+  explicit ArtInner(ArtNodeType type) : ArtNode(type) {}
+
+  virtual ArtNode *GetChild(uint8_t byte) const = 0;
+  // the caller checks the node is not full
+  virtual void Insert(uint8_t byte, ArtNode *child) = 0;
+  virtual void Change(uint8_t byte, ArtNode *child) = 0;
+  virtual void Remove(uint8_t byte) = 0;
+  virtual bool IsFull() const = 0;
+  // a child other than the one under byte, nullptr if there is none
+  virtual ArtNode *GetSecondChild(uint8_t byte, uint8_t &second_byte) const = 0;
+  virtual ArtNode *AnyChild() const = 0;
+  // children in byte order
+  virtual void GetChildren(ArtChildren &children) const = 0;
+  // empty node of the next larger type
+  virtual ArtInner *NewLarger() const = 0;
+
+  // a copy of the node with room for one more child
+  ArtInner *Grow() const {
+    ArtInner *larger = NewLarger();
+    larger->SetPrefix(prefix, prefix_len);
+    ArtChildren children;
+    GetChildren(children);
+    for (auto &child : children)
+      larger->Insert(child.first, child.second);
+    return larger;
+  }
+
+  void SetPrefix(const uint8_t *bytes, uint32_t len) {
+    memcpy(prefix, bytes, std::min(len, MAX_STORED_PREFIX));
+    prefix_len = len;
+  }
+
+  // node, the parent being removed, reached this one through byte
+  void AddPrefixBefore(const ArtInner *node, uint8_t byte) {
+    uint32_t copy_count = std::min(MAX_STORED_PREFIX, node->prefix_len + 1);
+    memmove(prefix + copy_count, prefix,
+            std::min(prefix_len, MAX_STORED_PREFIX - copy_count));
+    memcpy(prefix, node->prefix, std::min(copy_count, node->prefix_len));
+    if (node->prefix_len < MAX_STORED_PREFIX)
+      prefix[copy_count - 1] = byte;
+    prefix_len += node->prefix_len + 1;
+  }
+
+  /*
+   * Optimistic lock coupling. Bit 1 of the version is the write lock, bit 0
+   * marks a node replaced in the tree, the rest counts modifications.
+   */
+  inline uint64_t ReadLockOrRestart(bool &restart) const {
+    uint64_t v = version.load(std::memory_order_acquire);
+    if ((v & 0b11) != 0)
+      restart = true;
+    return v;
+  }
+
+  inline void ReadUnlockOrRestart(uint64_t v, bool &restart) const {
+    if (version.load(std::memory_order_acquire) != v)
+      restart = true;
+  }
+
+  inline void UpgradeToWriteLockOrRestart(uint64_t &v, bool &restart) {
+    if (version.compare_exchange_strong(v, v + 0b10))
+      v += 0b10;
+    else
+      restart = true;
+  }
+
+  inline void WriteLockOrRestart(bool &restart) {
+    uint64_t v = ReadLockOrRestart(restart);
+    if (!restart)
+      UpgradeToWriteLockOrRestart(v, restart);
+  }
+
+  inline void WriteUnlock() { version.fetch_add(0b10); }
+
+  inline void WriteUnlockObsolete() { version.fetch_add(0b11); }
+
+  std::atomic<uint64_t> version{0};
+  uint16_t count = 0;
+  uint32_t prefix_len = 0;
+  uint8_t prefix[MAX_STORED_PREFIX];
+};
+
+// up to N children in insertion order, for the 4 and 16 way nodes
+template <int N, ArtNodeType TYPE> struct ArtNodeN : public ArtInner {
+  ArtNodeN() : ArtInner(TYPE) {}
+
+  ArtNode *GetChild(uint8_t byte) const override {
+    int n = std::min<int>(count, N);
+    for (int i = 0; i < n; i++) {
+      if (keys[i] == byte)
+        return children[i];
+    }
+    return nullptr;
+  }
+
+  void Insert(uint8_t byte, ArtNode *child) override {
+    keys[count] = byte;
+    children[count] = child;
+    count++;
+  }
+
+  void Change(uint8_t byte, ArtNode *child) override {
+    for (int i = 0; i < count; i++) {
+      if (keys[i] == byte)
+        children[i] = child;
+    }
+  }
+
+  void Remove(uint8_t byte) override {
+    for (int i = 0; i < count; i++) {
+      if (keys[i] == byte) {
+        keys[i] = keys[count - 1];
+        children[i] = children[count - 1];
+        count--;
+        return;
+      }
+    }
+  }
+
+  bool IsFull() const override { return count == N; }
+
+  ArtNode *GetSecondChild(uint8_t byte, uint8_t &second_byte) const override {
+    for (int i = 0; i < count; i++) {
+      if (keys[i] != byte) {
+        second_byte = keys[i];
+        return children[i];
+      }
+    }
+    return nullptr;
+  }
+
+  ArtNode *AnyChild() const override {
+    return count > 0 ? children[0] : nullptr;
+  }
+
+  void GetChildren(ArtChildren &out) const override {
+    for (int i = 0; i < count; i++)
+      out.emplace_back(keys[i], children[i]);
+    std::sort(out.begin(), out.end());
+  }
+
+  ArtInner *NewLarger() const override;
+
+  uint8_t keys[N];
+  ArtNode *children[N];
+};
+
+typedef ArtNodeN<4, ArtNodeType::NODE4> ArtNode4;
+typedef ArtNodeN<16, ArtNodeType::NODE16> ArtNode16;
+
+struct ArtNode48 : public ArtInner {
+  static const uint8_t EMPTY = 48;
+
+  ArtNode48() : ArtInner(ArtNodeType::NODE48) {
+    memset(child_index, EMPTY, sizeof(child_index));
+    memset(children, 0, sizeof(children));
+  }
+
+  ArtNode *GetChild(uint8_t byte) const override {
+    uint8_t index = child_index[byte];
+    return index == EMPTY ? nullptr : children[index];
+  }
+
+  void Insert(uint8_t byte, ArtNode *child) override {
+    uint8_t index = 0;
+    while (children[index] != nullptr)
+      index++;
+    children[index] = child;
+    child_index[byte] = index;
+    count++;
+  }
+
+  void Change(uint8_t byte, ArtNode *child) override {
+    children[child_index[byte]] = child;
+  }
+
+  void Remove(uint8_t byte) override {
+    children[child_index[byte]] = nullptr;
+    child_index[byte] = EMPTY;
+    count--;
+  }
+
+  bool IsFull() const override { return count == 48; }
+
+  ArtNode *GetSecondChild(uint8_t byte, uint8_t &second_byte) const override {
+    for (int b = 0; b < 256; b++) {
+      if (b != byte && child_index[b] != EMPTY) {
+        second_byte = b;
+        return children[child_index[b]];
+      }
+    }
+    return nullptr;
+  }
+
+  ArtNode *AnyChild() const override {
+    for (ArtNode *child : children) {
+      if (child != nullptr)
+        return child;
+    }
+    return nullptr;
+  }
+
+  void GetChildren(ArtChildren &out) const override {
+    for (int b = 0; b < 256; b++) {
+      if (child_index[b] != EMPTY)
+        out.emplace_back(b, children[child_index[b]]);
+    }
+  }
+
+  ArtInner *NewLarger() const override;
+
+  uint8_t child_index[256];
+  ArtNode *children[48];
+};
+
+struct ArtNode256 : public ArtInner {
+  ArtNode256() : ArtInner(ArtNodeType::NODE256) {
+    memset(children, 0, sizeof(children));
+  }
+
+  ArtNode *GetChild(uint8_t byte) const override { return children[byte]; }
+
+  void Insert(uint8_t byte, ArtNode *child) override {
+    children[byte] = child;
+    count++;
+  }
+
+  void Change(uint8_t byte, ArtNode *child) override {
+    children[byte] = child;
+  }
+
+  void Remove(uint8_t byte) override {
+    children[byte] = nullptr;
+    count--;
+  }
+
+  bool IsFull() const override { return false; }
+
+  ArtNode *GetSecondChild(uint8_t byte, uint8_t &second_byte) const override {
+    for (int b = 0; b < 256; b++) {
+      if (b != byte && children[b] != nullptr) {
+        second_byte = b;
+        return children[b];
+      }
+    }
+    return nullptr;
+  }
+
+  ArtNode *AnyChild() const override {
+    for (ArtNode *child : children) {
+      if (child != nullptr)
+        return child;
+    }
+    return nullptr;
+  }
+
+  void GetChildren(ArtChildren &out) const override {
+    for (int b = 0; b < 256; b++) {
+      if (children[b] != nullptr)
+        out.emplace_back(b, children[b]);
+    }
+  }
+
+  ArtInner *NewLarger() const override { return nullptr; }
+
+  ArtNode *children[256];
+};
+
+template <int N, ArtNodeType TYPE>
+ArtInner *ArtNodeN<N, TYPE>::NewLarger() const {
+  if (N == 4)
+    return new ArtNode16;
+  return new ArtNode48;
+}
+
+ArtInner *ArtNode48::NewLarger() const { return new ArtNode256; }
+
+namespace {
+inline ArtInner *AsInner(ArtNode *node) {
+  return static_cast<ArtInner *>(node);
+}
+
+// any leaf below node, they all share the prefix of node. nullptr when a
+// concurrent writer emptied a node on the way
+const ArtLeaf *AnyLeaf(const ArtNode *node) {
+  while (node != nullptr && !node->IsLeaf())
+    node = static_cast<const ArtInner *>(node)->AnyChild();
+  return static_cast<const ArtLeaf *>(node);
+}
+
+enum class PrefixMatch { NO_MATCH, MATCH, OPTIMISTIC_MATCH };
+
+// compare the stored prefix bytes, a longer prefix is skipped and left to
+// the full key comparison at the leaf
+PrefixMatch CheckPrefix(const ArtInner *node, const std::string &key,
+                        uint32_t &level) {
+  if (node->prefix_len == 0)
+    return PrefixMatch::MATCH;
+  uint32_t stored = std::min(node->prefix_len, MAX_STORED_PREFIX);
+  for (uint32_t i = 0; i < stored; i++, level++) {
+    if (node->prefix[i] != KeyByte(key, level))
+      return PrefixMatch::NO_MATCH;
+  }
+  if (node->prefix_len > MAX_STORED_PREFIX) {
+    level += node->prefix_len - MAX_STORED_PREFIX;
+    return PrefixMatch::OPTIMISTIC_MATCH;
+  }
+  return PrefixMatch::MATCH;
+}
+
+/*
+ * Compare the whole prefix, reading the bytes not stored from a leaf. On a
+ * mismatch return the prefix byte that differs and the prefix node keeps
+ * below the mismatch.
+ */
+bool CheckPrefixPessimistic(const ArtInner *node, const std::string &key,
+                            uint32_t &level, uint8_t &non_matching_byte,
+                            uint8_t *remaining_prefix, bool &restart) {
+  if (node->prefix_len == 0)
+    return true;
+  const ArtLeaf *leaf = nullptr;
+  uint32_t prev_level = level;
+  for (uint32_t i = 0; i < node->prefix_len; i++, level++) {
+    if (i == MAX_STORED_PREFIX && (leaf = AnyLeaf(node)) == nullptr) {
+      restart = true;
+      return true;
+    }
+    uint8_t cur = i >= MAX_STORED_PREFIX ? KeyByte(leaf->key, level)
+                                         : node->prefix[i];
+    if (cur == KeyByte(key, level))
+      continue;
+    non_matching_byte = cur;
+    uint32_t left = node->prefix_len - (level - prev_level) - 1;
+    if (node->prefix_len > MAX_STORED_PREFIX) {
+      if (leaf == nullptr && (leaf = AnyLeaf(node)) == nullptr) {
+        restart = true;
+        return true;
+      }
+      for (uint32_t j = 0; j < std::min(left, MAX_STORED_PREFIX); j++)
+        remaining_prefix[j] = KeyByte(leaf->key, level + j + 1);
+    } else {
+      for (uint32_t j = 0; j < std::min(left, MAX_STORED_PREFIX); j++)
+        remaining_prefix[j] = node->prefix[i + j + 1];
+    }
+    return false;
+  }
+  return true;
+}
+
+void FreeSubtree(ArtNode *node) {
+  if (node == nullptr)
+    return;
+  if (!node->IsLeaf()) {
+    ArtChildren children;
+    AsInner(node)->GetChildren(children);
+    for (auto &child : children)
+      FreeSubtree(child.second);
+  }
+  delete node;
+}
+
+void Visit(const ArtNode *node,
+           const std::function<void(const std::string &, const RID &)> &visit) {
+  if (node->IsLeaf()) {
+    const ArtLeaf *leaf = static_cast<const ArtLeaf *>(node);
+    visit(leaf->key, leaf->value);
+    return;
+  }
+  ArtChildren children;
+  static_cast<const ArtInner *>(node)->GetChildren(children);
+  for (auto &child : children)
+    Visit(child.second, visit);
+}
+} // namespace
+
+AdaptiveRadixTree::AdaptiveRadixTree() : root_(new ArtNode256) {}
+
+AdaptiveRadixTree::~AdaptiveRadixTree() {
+  FreeSubtree(root_);
+  for (auto &retired : retired_)
+    delete retired.second;
+}
+
+void AdaptiveRadixTree::Retire(ArtNode *node) {
+  EpochRegistry *registry = GetEpochRegistry();
+  std::lock_guard<std::mutex> guard(retired_latch_);
+  retired_.emplace_back(registry->global_epoch.load(), node);
+  if (retired_.size() % RECLAIM_BATCH != 0)
+    return;
+  // operations entering from now on can't see any node retired so far
+  registry->global_epoch.fetch_add(1);
+  uint64_t oldest = OldestPinnedEpoch();
+  auto reclaimable = std::stable_partition(
+      retired_.begin(), retired_.end(),
+      [oldest](const std::pair<uint64_t, ArtNode *> &retired) {
+        return retired.first >= oldest;
+      });
+  for (auto it = reclaimable; it != retired_.end(); ++it)
+    delete it->second;
+  retired_.erase(reclaimable, retired_.end());
+}
+
+size_t AdaptiveRadixTree::RetiredCount() {
+  std::lock_guard<std::mutex> guard(retired_latch_);
+  return retired_.size();
+}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+bool AdaptiveRadixTree::GetValue(const std::string &key, RID &value) const {
+  EpochGuard epoch_guard;
+  while (true) {
+    bool restart = false;
+    bool found = TryGetValue(key, value, restart);
+    if (!restart)
+      return found;
+    std::this_thread::yield();
+  }
+}
+
+bool AdaptiveRadixTree::TryGetValue(const std::string &key, RID &value,
+                                    bool &restart) const {
+  ArtInner *node = AsInner(root_);
+  uint64_t v = node->ReadLockOrRestart(restart);
+  if (restart)
+    return false;
+  uint32_t level = 0;
+  while (true) {
+    if (CheckPrefix(node, key, level) == PrefixMatch::NO_MATCH) {
+      node->ReadUnlockOrRestart(v, restart);
+      return false;
+    }
+    ArtNode *next = node->GetChild(KeyByte(key, level));
+    node->ReadUnlockOrRestart(v, restart);
+    if (restart || next == nullptr)
+      return false;
+    if (next->IsLeaf()) {
+      const ArtLeaf *leaf = static_cast<const ArtLeaf *>(next);
+      bool found = leaf->key == key;
+      if (found)
+        value = leaf->value;
+      // the leaf was still linked when the version was read
+      node->ReadUnlockOrRestart(v, restart);
+      return found && !restart;
+    }
+    level++;
+    ArtInner *child = AsInner(next);
+    uint64_t child_v = child->ReadLockOrRestart(restart);
+    if (restart)
+      return false;
+    node->ReadUnlockOrRestart(v, restart);
+    if (restart)
+      return false;
+    node = child;
+    v = child_v;
+  }
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+bool AdaptiveRadixTree::Insert(const std::string &key, const RID &value) {
+  EpochGuard epoch_guard;
+  while (true) {
+    bool restart = false;
+    bool inserted = TryInsert(key, value, restart);
+    if (!restart) {
+      if (inserted)
+        size_.fetch_add(1, std::memory_order_relaxed);
+      return inserted;
+    }
+    std::this_thread::yield();
+  }
+}
+
+bool AdaptiveRadixTree::TryInsert(const std::string &key, const RID &value,
+                                  bool &restart) {
+  ArtInner *node = nullptr;
+  ArtInner *next = AsInner(root_);
+  ArtInner *parent = nullptr;
+  uint8_t parent_byte = 0, node_byte = 0;
+  uint64_t parent_v = 0;
+  uint32_t level = 0;
+
+  while (true) {
+    parent = node;
+    parent_byte = node_byte;
+    node = next;
+    uint64_t v = node->ReadLockOrRestart(restart);
+    if (restart)
+      return false;
+
+    // 1. the key leaves the prefix of node: a new node takes the common part
+    uint32_t next_level = level;
+    uint8_t non_matching_byte = 0;
+    uint8_t remaining_prefix[MAX_STORED_PREFIX];
+    bool match =
+        CheckPrefixPessimistic(node, key, next_level, non_matching_byte,
+                               remaining_prefix, restart);
+    if (restart)
+      return false;
+    if (!match) {
+      parent->UpgradeToWriteLockOrRestart(parent_v, restart);
+      if (restart)
+        return false;
+      node->UpgradeToWriteLockOrRestart(v, restart);
+      if (restart) {
+        parent->WriteUnlock();
+        return false;
+      }
+      ArtNode4 *branch = new ArtNode4;
+      branch->SetPrefix(reinterpret_cast<const uint8_t *>(key.data()) + level,
+                        next_level - level);
+      branch->Insert(KeyByte(key, next_level), new ArtLeaf(key, value));
+      branch->Insert(non_matching_byte, node);
+      parent->Change(parent_byte, branch);
+      parent->WriteUnlock();
+      node->SetPrefix(remaining_prefix,
+                      node->prefix_len - (next_level - level + 1));
+      node->WriteUnlock();
+      return true;
+    }
+    level = next_level;
+    node_byte = KeyByte(key, level);
+    ArtNode *child = node->GetChild(node_byte);
+    node->ReadUnlockOrRestart(v, restart);
+    if (restart)
+      return false;
+
+    // 2. free slot in node, grow it first when it is full
+    if (child == nullptr) {
+      if (!node->IsFull()) {
+        if (parent != nullptr) {
+          parent->ReadUnlockOrRestart(parent_v, restart);
+          if (restart)
+            return false;
+        }
+        node->UpgradeToWriteLockOrRestart(v, restart);
+        if (restart)
+          return false;
+        node->Insert(node_byte, new ArtLeaf(key, value));
+        node->WriteUnlock();
+        return true;
+      }
+      parent->UpgradeToWriteLockOrRestart(parent_v, restart);
+      if (restart)
+        return false;
+      node->UpgradeToWriteLockOrRestart(v, restart);
+      if (restart) {
+        parent->WriteUnlock();
+        return false;
+      }
+      ArtInner *larger = node->Grow();
+      larger->Insert(node_byte, new ArtLeaf(key, value));
+      parent->Change(parent_byte, larger);
+      parent->WriteUnlock();
+      node->WriteUnlockObsolete();
+      Retire(node);
+      return true;
+    }
+    if (parent != nullptr) {
+      parent->ReadUnlockOrRestart(parent_v, restart);
+      if (restart)
+        return false;
+    }
+
+    // 3. a leaf in the way: a new node takes the bytes both keys share
+    if (child->IsLeaf()) {
+      node->UpgradeToWriteLockOrRestart(v, restart);
+      if (restart)
+        return false;
+      const ArtLeaf *leaf = static_cast<const ArtLeaf *>(child);
+      if (leaf->key == key) {
+        node->WriteUnlock();
+        return false;
+      }
+      uint32_t common = 0;
+      uint32_t limit = std::max(key.size(), leaf->key.size());
+      while (level + 1 + common < limit &&
+             KeyByte(key, level + 1 + common) ==
+                 KeyByte(leaf->key, level + 1 + common))
+        common++;
+      if (level + 1 + common >= limit) {
+        node->WriteUnlock();
+        throw Exception(EXCEPTION_TYPE_INDEX,
+                        "art key is a prefix of another key");
+      }
+      ArtNode4 *branch = new ArtNode4;
+      branch->SetPrefix(reinterpret_cast<const uint8_t *>(key.data()) + level +
+                            1,
+                        common);
+      branch->Insert(KeyByte(key, level + 1 + common),
+                     new ArtLeaf(key, value));
+      branch->Insert(KeyByte(leaf->key, level + 1 + common),
+                     const_cast<ArtLeaf *>(leaf));
+      node->Change(node_byte, branch);
+      node->WriteUnlock();
+      return true;
+    }
+    level++;
+    parent_v = v;
+    next = AsInner(child);
+  }
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+bool AdaptiveRadixTree::Remove(const std::string &key) {
+  EpochGuard epoch_guard;
+  while (true) {
+    bool restart = false;
+    bool removed = TryRemove(key, restart);
+    if (!restart) {
+      if (removed)
+        size_.fetch_sub(1, std::memory_order_relaxed);
+      return removed;
+    }
+    std::this_thread::yield();
+  }
+}
+
+bool AdaptiveRadixTree::TryRemove(const std::string &key, bool &restart) {
+  ArtInner *node = nullptr;
+  ArtInner *next = AsInner(root_);
+  ArtInner *parent = nullptr;
+  uint8_t parent_byte = 0, node_byte = 0;
+  uint64_t parent_v = 0;
+  uint32_t level = 0;
+
+  while (true) {
+    parent = node;
+    parent_byte = node_byte;
+    node = next;
+    uint64_t v = node->ReadLockOrRestart(restart);
+    if (restart)
+      return false;
+    if (CheckPrefix(node, key, level) == PrefixMatch::NO_MATCH) {
+      node->ReadUnlockOrRestart(v, restart);
+      return false;
+    }
+    node_byte = KeyByte(key, level);
+    ArtNode *child = node->GetChild(node_byte);
+    node->ReadUnlockOrRestart(v, restart);
+    if (restart || child == nullptr)
+      return false;
+
+    if (child->IsLeaf()) {
+      const ArtLeaf *leaf = static_cast<const ArtLeaf *>(child);
+      if (leaf->key != key) {
+        node->ReadUnlockOrRestart(v, restart);
+        return false;
+      }
+      // 1. node is left with one child: the child takes its place
+      if (node->count == 2 && parent != nullptr) {
+        parent->UpgradeToWriteLockOrRestart(parent_v, restart);
+        if (restart)
+          return false;
+        node->UpgradeToWriteLockOrRestart(v, restart);
+        if (restart) {
+          parent->WriteUnlock();
+          return false;
+        }
+        uint8_t second_byte = 0;
+        ArtNode *second = node->GetSecondChild(node_byte, second_byte);
+        if (!second->IsLeaf()) {
+          AsInner(second)->WriteLockOrRestart(restart);
+          if (restart) {
+            node->WriteUnlock();
+            parent->WriteUnlock();
+            return false;
+          }
+          AsInner(second)->AddPrefixBefore(node, second_byte);
+        }
+        parent->Change(parent_byte, second);
+        parent->WriteUnlock();
+        if (!second->IsLeaf())
+          AsInner(second)->WriteUnlock();
+        node->WriteUnlockObsolete();
+        Retire(node);
+      } else {
+        // 2. just unlink the leaf
+        if (parent != nullptr) {
+          parent->ReadUnlockOrRestart(parent_v, restart);
+          if (restart)
+            return false;
+        }
+        node->UpgradeToWriteLockOrRestart(v, restart);
+        if (restart)
+          return false;
+        node->Remove(node_byte);
+        node->WriteUnlock();
+      }
+      Retire(const_cast<ArtLeaf *>(leaf));
+      return true;
+    }
+    level++;
+    parent_v = v;
+    next = AsInner(child);
+  }
+}
+
+void AdaptiveRadixTree::ForEach(
+    const std::function<void(const std::string &, const RID &)> &visit) const {
+  Visit(root_, visit);
+}
+
+} // namespace cmudb
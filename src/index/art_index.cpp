@@ -0,0 +1,156 @@
+/**
+ * art_index.cpp
+ */
+
+#include <cstring>
+#include <fstream>
+#include <utility>
+
+#include "common/exception.h"
+#include "index/art_index.h"
+
+namespace cmudb {
+
+namespace {
+const uint32_t SNAPSHOT_MAGIC = 0x41525432; // "ART2"
+
+template <typename T> void AppendBigEndian(std::string &out, T bits) {
+  for (int shift = (sizeof(T) - 1) * 8; shift >= 0; shift -= 8)
+    out.push_back(static_cast<char>(bits >> shift));
+}
+
+template <typename T> void WriteRaw(std::ofstream &out, const T &value) {
+  out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+template <typename T> bool ReadRaw(std::ifstream &in, T &value) {
+  return static_cast<bool>(
+      in.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+} // namespace
+
+ArtIndex::ArtIndex(IndexMetadata *metadata) : Index(metadata) {}
+
+void ArtIndex::InsertEntry(const Tuple &key, RID rid, Transaction *) {
+  container_.Insert(NormalizeKey(key, GetKeySchema()), rid);
+}
+
+void ArtIndex::DeleteEntry(const Tuple &key, Transaction *) {
+  container_.Remove(NormalizeKey(key, GetKeySchema()));
+}
+
+void ArtIndex::ScanKey(const Tuple &key, std::vector<RID> &result,
+                       Transaction *) {
+  RID rid;
+  if (container_.GetValue(NormalizeKey(key, GetKeySchema()), rid))
+    result.push_back(rid);
+}
+
+std::string ArtIndex::NormalizeKey(const Tuple &key, Schema *key_schema) {
+  std::string normalized;
+  for (int i = 0; i < key_schema->GetColumnCount(); i++) {
+    Value value = key.GetValue(key_schema, i);
+    switch (key_schema->GetType(i)) {
+    case TypeId::BOOLEAN:
+    case TypeId::TINYINT:
+      AppendBigEndian<uint8_t>(normalized,
+                               static_cast<uint8_t>(value.GetAs<int8_t>()) ^
+                                   0x80);
+      break;
+    case TypeId::SMALLINT:
+      AppendBigEndian<uint16_t>(normalized,
+                                static_cast<uint16_t>(value.GetAs<int16_t>()) ^
+                                    0x8000);
+      break;
+    case TypeId::INTEGER:
+      AppendBigEndian<uint32_t>(normalized,
+                                static_cast<uint32_t>(value.GetAs<int32_t>()) ^
+                                    0x80000000u);
+      break;
+    case TypeId::BIGINT:
+      AppendBigEndian<uint64_t>(normalized,
+                                static_cast<uint64_t>(value.GetAs<int64_t>()) ^
+                                    (1ULL << 63));
+      break;
+    case TypeId::DECIMAL: {
+      double d = value.GetAs<double>();
+      uint64_t bits;
+      memcpy(&bits, &d, sizeof(bits));
+      // negative numbers order backwards, flip all their bits
+      bits = (bits >> 63) ? ~bits : bits | (1ULL << 63);
+      AppendBigEndian<uint64_t>(normalized, bits);
+      break;
+    }
+    case TypeId::VARCHAR:
+      // NULL sorts before every string, '' included
+      if (value.IsNull()) {
+        normalized.push_back('\0');
+        break;
+      }
+      normalized.push_back('\1');
+      normalized.append(value.GetData(), value.GetLength() - 1);
+      normalized.push_back('\0');
+      break;
+    default:
+      throw Exception(EXCEPTION_TYPE_INDEX, "art index, unsupported key type");
+    }
+  }
+  return normalized;
+}
+
+/*
+ * Snapshot format:
+ *  | Magic (4) | SchemaLength (4) | Schema | EntryCount (8) |
+ *  | KeyLength (4) | Key | RID (8) | ...
+ * The schema string guards against loading the snapshot of another index.
+ */
+void ArtIndex::Checkpoint(const std::string &file_name) const {
+  std::ofstream out(file_name, std::ios::binary | std::ios::trunc);
+  if (!out)
+    throw Exception(EXCEPTION_TYPE_INDEX, "can't write " + file_name);
+  std::string schema = GetKeySchema()->ToString();
+  WriteRaw(out, SNAPSHOT_MAGIC);
+  WriteRaw(out, static_cast<uint32_t>(schema.size()));
+  out.write(schema.data(), schema.size());
+  WriteRaw(out, static_cast<uint64_t>(container_.Size()));
+  container_.ForEach([&out](const std::string &key, const RID &rid) {
+    WriteRaw(out, static_cast<uint32_t>(key.size()));
+    out.write(key.data(), key.size());
+    WriteRaw(out, rid.Get());
+  });
+  if (!out.flush())
+    throw Exception(EXCEPTION_TYPE_INDEX, "can't write " + file_name);
+}
+
+bool ArtIndex::LoadSnapshot(const std::string &file_name) {
+  std::ifstream in(file_name, std::ios::binary);
+  if (!in)
+    return false;
+  uint32_t magic, schema_size;
+  if (!ReadRaw(in, magic) || magic != SNAPSHOT_MAGIC ||
+      !ReadRaw(in, schema_size))
+    return false;
+  std::string schema(schema_size, '\0');
+  in.read(&schema[0], schema_size);
+  uint64_t count;
+  if (!in || schema != GetKeySchema()->ToString() || !ReadRaw(in, count))
+    return false;
+  // read it all first, a truncated snapshot leaves the index empty
+  std::vector<std::pair<std::string, int64_t>> entries;
+  for (uint64_t i = 0; i < count; i++) {
+    uint32_t key_size;
+    int64_t rid;
+    if (!ReadRaw(in, key_size))
+      return false;
+    std::string key(key_size, '\0');
+    in.read(&key[0], key_size);
+    if (!ReadRaw(in, rid))
+      return false;
+    entries.emplace_back(std::move(key), rid);
+  }
+  for (auto &entry : entries)
+    container_.Insert(entry.first, RID(entry.second));
+  return true;
+}
+
+} // namespace cmudb
@@ -0,0 +1,296 @@
+/**
+ * b_epsilon_tree.cpp
+ */
+
+#include "common/exception.h"
+#include "common/metrics.h"
+#include "common/rid.h"
+#include "index/b_epsilon_tree.h"
+#include "page/header_page.h"
+
+namespace cmudb {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+B_EPSILON_TREE_TYPE::BEpsilonTree(const std::string &name,
+                                  BufferPoolManager *buffer_pool_manager,
+                                  const KeyComparator &comparator,
+                                  page_id_t root_page_id)
+    : index_name_(name), root_page_id_(root_page_id),
+      buffer_pool_manager_(buffer_pool_manager), comparator_(comparator) {}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+/*
+ * Return the only value that associated with input key, the first message
+ * for key on the way down decides, else the leaf.
+ * @return : true means key exists
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool B_EPSILON_TREE_TYPE::GetValue(const KeyType &key,
+                                   std::vector<ValueType> &result,
+                                   Transaction *) {
+  latch_.RLock();
+  page_id_t page_id = root_page_id_;
+  bool found = false;
+  while (page_id != INVALID_PAGE_ID) {
+    BEpsilonPage *node = FetchNode(page_id);
+    page_id_t next_id = INVALID_PAGE_ID;
+    if (node->IsLeafPage()) {
+      ValueType value;
+      found = reinterpret_cast<LeafPage *>(node)->Lookup(key, value,
+                                                         comparator_);
+      if (found)
+        result.push_back(value);
+    } else {
+      InternalPage *inner = reinterpret_cast<InternalPage *>(node);
+      const MessageType *message = inner->FindMessage(key, comparator_);
+      if (message != nullptr) {
+        found = !message->erase;
+        if (found)
+          result.push_back(message->value);
+      } else {
+        next_id = inner->ValueAt(inner->ChildIndex(key, comparator_));
+      }
+    }
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = next_id;
+  }
+  latch_.RUnlock();
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION AND REMOVE
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_EPSILON_TREE_TYPE::Insert(const KeyType &key, const ValueType &value,
+                                 Transaction *) {
+  MessageType message;
+  message.key = key;
+  message.value = value;
+  message.erase = 0;
+  Upsert(message);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_EPSILON_TREE_TYPE::Remove(const KeyType &key, Transaction *) {
+  if (IsEmpty())
+    return;
+  MessageType message;
+  message.key = key;
+  message.value = ValueType();
+  message.erase = 1;
+  Upsert(message);
+}
+
+/*
+ * A root leaf takes the message right away. A root internal page buffers it
+ * and flushes until its buffer has room again; when a flush overflows the
+ * root with pivots a new root grows above it, with an empty buffer.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_EPSILON_TREE_TYPE::Upsert(const MessageType &message) {
+  latch_.WLock();
+  if (IsEmpty()) {
+    page_id_t root_page_id;
+    Page *page = buffer_pool_manager_->NewPage(root_page_id);
+    if (page == nullptr)
+      throw Exception(EXCEPTION_TYPE_INDEX, "out of memory");
+    reinterpret_cast<LeafPage *>(page->GetData())
+        ->Init(root_page_id, buffer_pool_manager_->GetPageSize());
+    buffer_pool_manager_->UnpinPage(root_page_id, true);
+    root_page_id_ = root_page_id;
+    UpdateRootPageId(true);
+  }
+
+  page_id_t root_page_id = root_page_id_;
+  BEpsilonPage *root = FetchNode(root_page_id);
+  if (root->IsLeafPage()) {
+    reinterpret_cast<LeafPage *>(root)->Apply(message, comparator_);
+  } else {
+    InternalPage *inner = reinterpret_cast<InternalPage *>(root);
+    inner->PutMessage(message, comparator_);
+    while (inner->IsBufferFull() && inner->GetSize() <= inner->GetMaxSize())
+      Flush(inner);
+  }
+  if (root->GetSize() > root->GetMaxSize())
+    SplitRoot(root);
+  buffer_pool_manager_->UnpinPage(root_page_id, true);
+  latch_.WUnlock();
+}
+
+/*
+ * Messages go to a leaf one by one until it splits, the rest wait for the
+ * next flush since they may belong to the new sibling. An internal child
+ * without room for them is flushed first, and split if that overflows it.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_EPSILON_TREE_TYPE::Flush(InternalPage *node) {
+  Metrics::Add(MetricCounter::BEPSILON_FLUSH);
+  // the child with the most buffered messages
+  int index = 0, begin = 0, end = 0;
+  for (int i = 0; i < node->GetSize(); i++) {
+    int child_begin, child_end;
+    node->ChildMessages(i, comparator_, child_begin, child_end);
+    if (child_end - child_begin > end - begin) {
+      index = i;
+      begin = child_begin;
+      end = child_end;
+    }
+  }
+
+  page_id_t child_id = node->ValueAt(index);
+  BEpsilonPage *child = FetchNode(child_id);
+  int moved = 0;
+  if (child->IsLeafPage()) {
+    LeafPage *leaf = reinterpret_cast<LeafPage *>(child);
+    while (begin + moved < end) {
+      leaf->Apply(node->MessageAt(begin + moved), comparator_);
+      moved++;
+      if (leaf->GetSize() > leaf->GetMaxSize()) {
+        SplitChild(node, index, leaf);
+        break;
+      }
+    }
+  } else {
+    InternalPage *inner = reinterpret_cast<InternalPage *>(child);
+    bool split = false;
+    if (inner->GetBufferMaxSize() - inner->GetBufferSize() < end - begin) {
+      Flush(inner);
+      split = inner->GetSize() > inner->GetMaxSize();
+      if (split)
+        SplitChild(node, index, inner);
+    }
+    // after a split the messages may be for either half, the next flush
+    // sorts them out
+    if (!split) {
+      while (begin + moved < end && !inner->IsBufferFull()) {
+        inner->PutMessage(node->MessageAt(begin + moved), comparator_);
+        moved++;
+      }
+    }
+  }
+  node->RemoveMessages(begin, begin + moved);
+  buffer_pool_manager_->UnpinPage(child_id, true);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_EPSILON_TREE_TYPE::SplitChild(InternalPage *node, int index,
+                                     BEpsilonPage *child) {
+  page_id_t new_page_id;
+  Page *new_page = buffer_pool_manager_->NewPage(new_page_id);
+  if (new_page == nullptr)
+    throw Exception(EXCEPTION_TYPE_INDEX, "out of memory");
+  Metrics::Add(MetricCounter::BTREE_SPLIT);
+  KeyType separator;
+  if (child->IsLeafPage()) {
+    LeafPage *recipient = reinterpret_cast<LeafPage *>(new_page->GetData());
+    recipient->Init(new_page_id, buffer_pool_manager_->GetPageSize());
+    reinterpret_cast<LeafPage *>(child)->MoveHalfTo(recipient);
+    separator = recipient->KeyAt(0);
+  } else {
+    InternalPage *recipient =
+        reinterpret_cast<InternalPage *>(new_page->GetData());
+    recipient->Init(new_page_id, child->GetLevel(),
+                    buffer_pool_manager_->GetPageSize());
+    separator = reinterpret_cast<InternalPage *>(child)->MoveHalfTo(
+        recipient, comparator_);
+  }
+  node->InsertPivotAfter(index, separator, new_page_id);
+  buffer_pool_manager_->UnpinPage(new_page_id, true);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_EPSILON_TREE_TYPE::SplitRoot(BEpsilonPage *root) {
+  page_id_t new_root_id;
+  Page *page = buffer_pool_manager_->NewPage(new_root_id);
+  if (page == nullptr)
+    throw Exception(EXCEPTION_TYPE_INDEX, "out of memory");
+  InternalPage *new_root = reinterpret_cast<InternalPage *>(page->GetData());
+  new_root->Init(new_root_id, root->GetLevel() + 1,
+                 buffer_pool_manager_->GetPageSize());
+  new_root->PopulateNewRoot(root->GetPageId());
+  SplitChild(new_root, 0, root);
+  buffer_pool_manager_->UnpinPage(new_root_id, true);
+  root_page_id_ = new_root_id;
+  UpdateRootPageId(false);
+}
+
+/*****************************************************************************
+ * UTILITIES AND DEBUG
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+BEpsilonPage *B_EPSILON_TREE_TYPE::FetchNode(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr)
+    throw Exception(EXCEPTION_TYPE_INDEX, "all pages are pinned");
+  return reinterpret_cast<BEpsilonPage *>(page->GetData());
+}
+
+/*
+ * Update/Insert root page id in header page, the record is named after the
+ * index
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_EPSILON_TREE_TYPE::UpdateRootPageId(bool insert_record) {
+  HeaderPage *header_page = static_cast<HeaderPage *>(
+      buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  if (!insert_record || !header_page->InsertRecord(index_name_, root_page_id_))
+    header_page->UpdateRecord(index_name_, root_page_id_);
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool B_EPSILON_TREE_TYPE::Check() {
+  latch_.RLock();
+  bool ok = IsEmpty() || CheckNode(root_page_id_, nullptr, nullptr);
+  latch_.RUnlock();
+  return ok;
+}
+
+/*
+ * Every key of the page is in [low, high), a missing bound is unbounded
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool B_EPSILON_TREE_TYPE::CheckNode(page_id_t page_id, const KeyType *low,
+                                    const KeyType *high) {
+  BEpsilonPage *node = FetchNode(page_id);
+  auto in_range = [&](const KeyType &key) {
+    return (low == nullptr || comparator_(key, *low) >= 0) &&
+           (high == nullptr || comparator_(key, *high) < 0);
+  };
+  bool ok = node->GetSize() <= node->GetMaxSize();
+  if (node->IsLeafPage()) {
+    LeafPage *leaf = reinterpret_cast<LeafPage *>(node);
+    for (int i = 0; ok && i < leaf->GetSize(); i++)
+      ok = in_range(leaf->KeyAt(i)) &&
+           (i == 0 || comparator_(leaf->KeyAt(i - 1), leaf->KeyAt(i)) < 0);
+  } else {
+    InternalPage *inner = reinterpret_cast<InternalPage *>(node);
+    for (int i = 0; ok && i < inner->GetBufferSize(); i++)
+      ok = in_range(inner->MessageAt(i).key) &&
+           (i == 0 || comparator_(inner->MessageAt(i - 1).key,
+                                  inner->MessageAt(i).key) < 0);
+    for (int i = 1; ok && i < inner->GetSize(); i++)
+      ok = in_range(inner->KeyAt(i)) &&
+           (i == 1 || comparator_(inner->KeyAt(i - 1), inner->KeyAt(i)) < 0);
+    for (int i = 0; ok && i < inner->GetSize(); i++) {
+      KeyType child_low = inner->KeyAt(i), child_high;
+      if (i + 1 < inner->GetSize())
+        child_high = inner->KeyAt(i + 1);
+      ok = CheckNode(inner->ValueAt(i), i == 0 ? low : &child_low,
+                     i + 1 < inner->GetSize() ? &child_high : high);
+    }
+  }
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return ok;
+}
+
+template class BEpsilonTree<GenericKey<4>, RID, GenericComparator<4>>;
+template class BEpsilonTree<GenericKey<8>, RID, GenericComparator<8>>;
+template class BEpsilonTree<GenericKey<16>, RID, GenericComparator<16>>;
+template class BEpsilonTree<GenericKey<32>, RID, GenericComparator<32>>;
+template class BEpsilonTree<GenericKey<64>, RID, GenericComparator<64>>;
+
+} // namespace cmudb
@@ -0,0 +1,334 @@
+/**
+ * b_link_tree.cpp
+ */
+
+#include "common/exception.h"
+#include "common/metrics.h"
+#include "common/rid.h"
+#include "index/b_link_tree.h"
+#include "page/header_page.h"
+
+namespace cmudb {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+B_LINK_TREE_TYPE::BLinkTree(const std::string &name,
+                            BufferPoolManager *buffer_pool_manager,
+                            const KeyComparator &comparator,
+                            page_id_t root_page_id)
+    : index_name_(name), root_page_id_(root_page_id),
+      buffer_pool_manager_(buffer_pool_manager), comparator_(comparator) {}
+
+/*****************************************************************************
+ * SEARCH
+ *****************************************************************************/
+/*
+ * Return the only value that associated with input key
+ * This method is used for point query
+ * @return : true means key exists
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool B_LINK_TREE_TYPE::GetValue(const KeyType &key,
+                                std::vector<ValueType> &result,
+                                Transaction *) {
+  if (IsEmpty())
+    return false;
+  Page *page = FindPage(key, 0, false, nullptr);
+  ValueType value;
+  bool found = reinterpret_cast<LeafPage *>(page->GetData())
+                   ->Lookup(key, value, comparator_);
+  if (found)
+    result.push_back(value);
+  Release(page, false, false);
+  return found;
+}
+
+/*****************************************************************************
+ * INSERTION
+ *****************************************************************************/
+/*
+ * Insert constant key & value pair into the tree, the first insert creates a
+ * leaf as the root.
+ * @return: since we only support unique key, if user try to insert duplicate
+ * keys return false, otherwise return true.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool B_LINK_TREE_TYPE::Insert(const KeyType &key, const ValueType &value,
+                              Transaction *) {
+  if (IsEmpty()) {
+    std::lock_guard<std::mutex> guard(root_mutex_);
+    if (IsEmpty()) {
+      page_id_t root_page_id;
+      Page *page = buffer_pool_manager_->NewPage(root_page_id);
+      if (page == nullptr)
+        throw Exception(EXCEPTION_TYPE_INDEX, "out of memory");
+      LeafPage *root = reinterpret_cast<LeafPage *>(page->GetData());
+      root->Init(root_page_id, 0, buffer_pool_manager_->GetPageSize());
+      root->Insert(key, value, comparator_);
+      buffer_pool_manager_->UnpinPage(root_page_id, true);
+      root_page_id_ = root_page_id;
+      UpdateRootPageId(true);
+      return true;
+    }
+  }
+
+  // 1. latch the leaf, remembering the way down for the split
+  std::vector<page_id_t> path;
+  Page *page = FindPage(key, 0, true, &path);
+  LeafPage *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  ValueType existing;
+  if (leaf->Lookup(key, existing, comparator_)) {
+    Release(page, true, false);
+    return false;
+  }
+  // 2. insert, split if the leaf overflows
+  leaf->Insert(key, value, comparator_);
+  if (leaf->GetSize() <= leaf->GetMaxSize()) {
+    Release(page, true, true);
+    return true;
+  }
+  Split(page, path);
+  return true;
+}
+
+/*
+ * Move the upper half of the latched page into a new right sibling, then
+ * latch the parent, release the page and insert the separator. The new
+ * sibling is reachable through the right link before the parent knows it.
+ * Repeats while parents overflow, a split of the root grows a new root.
+ * @param   path      internal pages passed on the way down, root first. The
+ *                    last one is where the search left the parent level.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_LINK_TREE_TYPE::Split(Page *page, std::vector<page_id_t> &path) {
+  while (true) {
+    // 1. split into a new right sibling
+    page_id_t new_page_id;
+    Page *new_page = buffer_pool_manager_->NewPage(new_page_id);
+    if (new_page == nullptr)
+      throw Exception(EXCEPTION_TYPE_INDEX, "out of memory");
+    Metrics::Add(MetricCounter::BTREE_SPLIT);
+    InternalPage *node = reinterpret_cast<InternalPage *>(page->GetData());
+    int level = node->GetLevel();
+    KeyType separator;
+    if (node->IsLeafPage()) {
+      LeafPage *recipient = reinterpret_cast<LeafPage *>(new_page->GetData());
+      recipient->Init(new_page_id, 0, buffer_pool_manager_->GetPageSize());
+      reinterpret_cast<LeafPage *>(node)->MoveHalfTo(recipient);
+      separator = recipient->KeyAt(0);
+    } else {
+      InternalPage *recipient =
+          reinterpret_cast<InternalPage *>(new_page->GetData());
+      recipient->Init(new_page_id, level, buffer_pool_manager_->GetPageSize());
+      node->MoveHalfTo(recipient);
+      separator = recipient->KeyAt(0);
+    }
+    buffer_pool_manager_->UnpinPage(new_page_id, true);
+
+    // 2. latch the parent
+    Page *parent_page;
+    if (path.empty()) {
+      std::unique_lock<std::mutex> guard(root_mutex_);
+      if (page->GetPageId() == root_page_id_) {
+        page_id_t root_page_id;
+        Page *root_page = buffer_pool_manager_->NewPage(root_page_id);
+        if (root_page == nullptr)
+          throw Exception(EXCEPTION_TYPE_INDEX, "out of memory");
+        InternalPage *root =
+            reinterpret_cast<InternalPage *>(root_page->GetData());
+        root->Init(root_page_id, level + 1, buffer_pool_manager_->GetPageSize());
+        root->PopulateNewRoot(page->GetPageId(), separator, new_page_id);
+        buffer_pool_manager_->UnpinPage(root_page_id, true);
+        root_page_id_ = root_page_id;
+        UpdateRootPageId(false);
+        Release(page, true, true);
+        return;
+      }
+      guard.unlock();
+      // the root grew since the descent, search the parent level again
+      parent_page = FindPage(separator, level + 1, true, nullptr);
+    } else {
+      parent_page = FetchPage(path.back());
+      path.pop_back();
+      parent_page->WLatch();
+      parent_page = MoveRight(parent_page, separator, true);
+    }
+    Release(page, true, true);
+
+    // 3. post the separator, split the parent if it overflows
+    InternalPage *parent =
+        reinterpret_cast<InternalPage *>(parent_page->GetData());
+    parent->Insert(separator, new_page_id, comparator_);
+    if (parent->GetSize() <= parent->GetMaxSize()) {
+      Release(parent_page, true, true);
+      return;
+    }
+    page = parent_page;
+  }
+}
+
+/*****************************************************************************
+ * REMOVE
+ *****************************************************************************/
+/*
+ * Delete key & value pair associated with input key. Pages are not merged or
+ * redistributed, so only the leaf is latched.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool B_LINK_TREE_TYPE::Remove(const KeyType &key, Transaction *) {
+  if (IsEmpty())
+    return false;
+  Page *page = FindPage(key, 0, true, nullptr);
+  LeafPage *leaf = reinterpret_cast<LeafPage *>(page->GetData());
+  int index = leaf->KeyIndex(key, comparator_);
+  bool found =
+      index < leaf->GetSize() && comparator_(leaf->KeyAt(index), key) == 0;
+  if (found)
+    leaf->RemoveAt(index);
+  Release(page, true, found);
+  return found;
+}
+
+/*****************************************************************************
+ * UTILITIES AND DEBUG
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *B_LINK_TREE_TYPE::FetchPage(page_id_t page_id) {
+  Page *page = buffer_pool_manager_->FetchPage(page_id);
+  if (page == nullptr)
+    throw Exception(EXCEPTION_TYPE_INDEX, "all pages are pinned");
+  return page;
+}
+
+/*
+ * Descend from the root with shared latches, releasing every page before
+ * latching the next one. Only the page returned is latched, exclusively if
+ * asked.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *B_LINK_TREE_TYPE::FindPage(const KeyType &key, int level,
+                                 bool exclusive,
+                                 std::vector<page_id_t> *path) {
+  page_id_t page_id = root_page_id_;
+  Page *page = FetchPage(page_id);
+  page->RLatch();
+  InternalPage *node = reinterpret_cast<InternalPage *>(page->GetData());
+  if (node->GetLevel() < level) {
+    Release(page, false, false);
+    throw Exception(EXCEPTION_TYPE_INDEX, "b-link tree level out of range");
+  }
+  bool is_exclusive = exclusive && node->GetLevel() == level;
+  if (is_exclusive) {
+    page->RUnlatch();
+    page->WLatch();
+  }
+  while (node->GetLevel() > level) {
+    page_id_t next_id;
+    int next_level = node->GetLevel();
+    if (node->IsBeyondHighKey(key, comparator_)) {
+      Metrics::Add(MetricCounter::BLINK_MOVE_RIGHT);
+      next_id = node->GetRightPageId();
+    } else {
+      next_id = node->LookupChild(key, comparator_);
+      next_level--;
+      if (path != nullptr)
+        path->push_back(page_id);
+    }
+    Release(page, false, false);
+    page_id = next_id;
+    page = FetchPage(page_id);
+    is_exclusive = exclusive && next_level == level;
+    if (is_exclusive)
+      page->WLatch();
+    else
+      page->RLatch();
+    node = reinterpret_cast<InternalPage *>(page->GetData());
+  }
+  return MoveRight(page, key, exclusive);
+}
+
+/*
+ * A writer latches the right sibling before releasing the page, a reader
+ * does not need to since pages are never freed.
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+Page *B_LINK_TREE_TYPE::MoveRight(Page *page, const KeyType &key,
+                                  bool exclusive) {
+  InternalPage *node = reinterpret_cast<InternalPage *>(page->GetData());
+  while (node->IsBeyondHighKey(key, comparator_)) {
+    Metrics::Add(MetricCounter::BLINK_MOVE_RIGHT);
+    Page *right_page = FetchPage(node->GetRightPageId());
+    if (exclusive) {
+      right_page->WLatch();
+      Release(page, true, false);
+    } else {
+      Release(page, false, false);
+      right_page->RLatch();
+    }
+    page = right_page;
+    node = reinterpret_cast<InternalPage *>(page->GetData());
+  }
+  return page;
+}
+
+/*
+ * Update/Insert root page id in header page, the record is named after the
+ * index
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_LINK_TREE_TYPE::UpdateRootPageId(bool insert_record) {
+  HeaderPage *header_page = static_cast<HeaderPage *>(
+      buffer_pool_manager_->FetchPage(HEADER_PAGE_ID));
+  if (!insert_record || !header_page->InsertRecord(index_name_, root_page_id_))
+    header_page->UpdateRecord(index_name_, root_page_id_);
+  buffer_pool_manager_->UnpinPage(HEADER_PAGE_ID, true);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool B_LINK_TREE_TYPE::Check() {
+  if (IsEmpty())
+    return true;
+  page_id_t level_head = root_page_id_;
+  while (level_head != INVALID_PAGE_ID) {
+    page_id_t page_id = level_head;
+    level_head = INVALID_PAGE_ID;
+    bool has_low_key = false;
+    KeyType low_key;
+    while (page_id != INVALID_PAGE_ID) {
+      Page *page = FetchPage(page_id);
+      page->RLatch();
+      InternalPage *node = reinterpret_cast<InternalPage *>(page->GetData());
+      if (level_head == INVALID_PAGE_ID && !node->IsLeafPage())
+        level_head = node->ValueAt(0);
+      bool ok = true;
+      // leaf keys are read through the leaf layout
+      int first = node->IsLeafPage() ? 0 : 1;
+      for (int i = first; ok && i < node->GetSize(); i++) {
+        KeyType key = node->IsLeafPage()
+                          ? reinterpret_cast<LeafPage *>(node)->KeyAt(i)
+                          : node->KeyAt(i);
+        ok = !(has_low_key && comparator_(key, low_key) < 0) &&
+             !node->IsBeyondHighKey(key, comparator_);
+        has_low_key = true;
+        low_key = key;
+      }
+      if (ok && node->HasHighKey()) {
+        has_low_key = true;
+        low_key = node->GetHighKey();
+      }
+      page_id_t right_page_id = node->GetRightPageId();
+      Release(page, false, false);
+      if (!ok)
+        return false;
+      page_id = right_page_id;
+    }
+  }
+  return true;
+}
+
+template class BLinkTree<GenericKey<4>, RID, GenericComparator<4>>;
+template class BLinkTree<GenericKey<8>, RID, GenericComparator<8>>;
+template class BLinkTree<GenericKey<16>, RID, GenericComparator<16>>;
+template class BLinkTree<GenericKey<32>, RID, GenericComparator<32>>;
+template class BLinkTree<GenericKey<64>, RID, GenericComparator<64>>;
+
+} // namespace cmudb
@@ -0,0 +1,56 @@
+/**
+ * b_link_tree_index.cpp
+ */
+
+#include "index/b_link_tree_index.h"
+
+namespace cmudb {
+/*
+ * Constructor
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+B_LINK_TREE_INDEX_TYPE::BLinkTreeIndex(
+    IndexMetadata *metadata, BufferPoolManager *buffer_pool_manager,
+    page_id_t root_page_id)
+    : Index(metadata), comparator_(metadata->GetKeySchema()),
+      container_(metadata->GetName(), buffer_pool_manager, comparator_,
+                 root_page_id) {}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_LINK_TREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid,
+                                        Transaction *transaction) {
+  // construct insert index key
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container_.Insert(index_key, rid, transaction);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_LINK_TREE_INDEX_TYPE::DeleteEntry(const Tuple &key,
+                                        Transaction *transaction) {
+  // construct delete index key
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container_.Remove(index_key, transaction);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_LINK_TREE_INDEX_TYPE::ScanKey(const Tuple &key,
+                                    std::vector<RID> &result,
+                                    Transaction *transaction) {
+  // construct scan index key
+  KeyType index_key;
+  index_key.SetFromKey(key);
+
+  container_.GetValue(index_key, result, transaction);
+}
+
+template class BLinkTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
+template class BLinkTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
+template class BLinkTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
+template class BLinkTreeIndex<GenericKey<32>, RID, GenericComparator<32>>;
+template class BLinkTreeIndex<GenericKey<64>, RID, GenericComparator<64>>;
+
+} // namespace cmudb
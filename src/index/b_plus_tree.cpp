@@ -3,9 +3,12 @@
  */
 #include <iostream>
 #include <string>
+#include <thread>
 
 #include "common/exception.h"
 #include "common/logger.h"
+#include "common/metrics.h"
+#include "common/trace.h"
 #include "common/rid.h"
 #include "index/b_plus_tree.h"
 #include "page/header_page.h"
@@ -42,17 +45,182 @@ INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::GetValue(const KeyType &key,
                               std::vector<ValueType> &result,
                               Transaction *transaction) {
+  // 0. go straight to the leaf if the key is hot
+  if (AdaptiveHashLookup(key, result))
+    return true;
   // 1. find the page
   B_PLUS_TREE_LEAF_PAGE_TYPE *res_page = FindLeafPage(key, false, OpType::READ, transaction);
   if (!res_page) return false;
-  // 2. find the record
-  result.resize(1);
-  bool ret = res_page->Lookup(key, result[0], comparator_);
+  // 2. find the record, the epoch is read while the leaf is latched
+  int slot = res_page->KeyIndex(key, comparator_);
+  bool ret = slot < res_page->GetSize() &&
+             comparator_(res_page->KeyAt(slot), key) == 0;
+  if (ret) {
+    result.push_back(res_page->GetItem(slot).second);
+    adaptive_hash_.Record(
+        key, {res_page->GetPageId(), slot, adaptive_hash_.GetEpoch()});
+  }
   // 3. Unpin the page
   RemovePagesInTransaction(LockType::SHARED, transaction, res_page->GetPageId());
   return ret;
 }
 
+/*
+ * Probes share leaves instead of each descending from the root: keys are
+ * looked up in the leaf of the previous key while they fall in it, or in its
+ * right neighbour, like a merge of the keys with the leaf chain. The hint is
+ * trusted, like adaptive hash entries, only if no page was freed since it
+ * was recorded.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::GetValues(const std::vector<KeyType> &keys,
+                               std::vector<ValueType> &result,
+                               LeafHint *hint) {
+  B_PLUS_TREE_LEAF_PAGE_TYPE *leaf = nullptr;
+  if (hint != nullptr && hint->page_id != INVALID_PAGE_ID)
+    leaf = LatchHintedLeaf(*hint);
+  for (auto &key : keys) {
+    leaf = ProbeLeaf(leaf, key);
+    if (leaf == nullptr)
+      break;
+    int slot = leaf->KeyIndex(key, comparator_);
+    if (slot < leaf->GetSize() && comparator_(leaf->KeyAt(slot), key) == 0)
+      result.push_back(leaf->GetItem(slot).second);
+  }
+  if (hint != nullptr) {
+    // the epoch is read while the leaf is latched
+    hint->page_id = leaf != nullptr ? leaf->GetPageId() : INVALID_PAGE_ID;
+    hint->epoch = adaptive_hash_.GetEpoch();
+  }
+  if (leaf != nullptr) {
+    UnlockPage(LockType::SHARED, leaf->GetPageId());
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+  }
+}
+
+/*
+ * A key within the first and last key of the leaf is there or nowhere. A key
+ * past the last one is tried in the next leaf. This leaf is released first:
+ * Remove latches a left sibling while it holds the right one, so holding
+ * this leaf while waiting for the next could deadlock with it. The next leaf
+ * is trusted if no page was freed meanwhile and the key falls within its
+ * keys. Anything else descends from the root.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+B_PLUS_TREE_LEAF_PAGE_TYPE *
+BPLUSTREE_TYPE::ProbeLeaf(B_PLUS_TREE_LEAF_PAGE_TYPE *leaf,
+                          const KeyType &key) {
+  if (leaf != nullptr && leaf->GetSize() > 0 &&
+      comparator_(key, leaf->KeyAt(0)) >= 0) {
+    if (comparator_(key, leaf->KeyAt(leaf->GetSize() - 1)) <= 0) {
+      Metrics::Add(MetricCounter::BTREE_LEAF_REUSE);
+      return leaf;
+    }
+    page_id_t next_id = leaf->GetNextPageId();
+    // past the last key of the tree
+    if (next_id == INVALID_PAGE_ID)
+      return leaf;
+    uint64_t epoch = adaptive_hash_.GetEpoch();
+    UnlockPage(LockType::SHARED, leaf->GetPageId());
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+    leaf = nullptr;
+    Page *next_page = buffer_pool_manager_->FetchPage(next_id);
+    if (next_page != nullptr) {
+      LockPage(LockType::SHARED, next_page);
+      leaf = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(next_page->GetData());
+      if (epoch == adaptive_hash_.GetEpoch() && leaf->IsLeafPage() &&
+          leaf->GetSize() > 0 && comparator_(key, leaf->KeyAt(0)) >= 0 &&
+          comparator_(key, leaf->KeyAt(leaf->GetSize() - 1)) <= 0) {
+        Metrics::Add(MetricCounter::BTREE_LEAF_REUSE);
+        return leaf;
+      }
+    }
+  }
+  if (leaf != nullptr) {
+    UnlockPage(LockType::SHARED, leaf->GetPageId());
+    buffer_pool_manager_->UnpinPage(leaf->GetPageId(), false);
+  }
+  leaf = FindLeafPage(key);
+  UnlockRootPage(LockType::SHARED);
+  return leaf;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+B_PLUS_TREE_LEAF_PAGE_TYPE *
+BPLUSTREE_TYPE::LatchHintedLeaf(const LeafHint &hint) {
+  Page *page = buffer_pool_manager_->FetchPage(hint.page_id);
+  if (page == nullptr)
+    return nullptr;
+  LockPage(LockType::SHARED, page);
+  auto *leaf = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page->GetData());
+  if (hint.epoch == adaptive_hash_.GetEpoch() && leaf->IsLeafPage())
+    return leaf;
+  UnlockPage(LockType::SHARED, page);
+  buffer_pool_manager_->UnpinPage(hint.page_id, false);
+  return nullptr;
+}
+
+/*
+ * Look the key up in the leaf cached by the adaptive hash index. The entry is
+ * trusted only if no page was freed since it was cached, then the leaf is
+ * searched again when an insert shifted the slot. Keys are unique, so a leaf
+ * holding the key is the leaf the tree would reach.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::AdaptiveHashLookup(const KeyType &key,
+                                        std::vector<ValueType> &result) {
+  if (!adaptive_hash_.IsEnabled())
+    return false;
+  typename AdaptiveHashIndex<KeyType>::Entry entry;
+  if (!adaptive_hash_.Lookup(key, entry)) {
+    Metrics::Add(MetricCounter::BTREE_HASH_MISS);
+    return false;
+  }
+  Page *page = buffer_pool_manager_->FetchPage(entry.page_id);
+  if (page == nullptr) {
+    Metrics::Add(MetricCounter::BTREE_HASH_MISS);
+    return false;
+  }
+  LockPage(LockType::SHARED, page);
+  B_PLUS_TREE_LEAF_PAGE_TYPE *leaf_page =
+      reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page->GetData());
+  bool hit = false;
+  int slot = entry.slot;
+  if (entry.epoch == adaptive_hash_.GetEpoch() && leaf_page->IsLeafPage()) {
+    if (slot >= leaf_page->GetSize() ||
+        comparator_(leaf_page->KeyAt(slot), key) != 0)
+      slot = leaf_page->KeyIndex(key, comparator_);
+    hit = slot < leaf_page->GetSize() &&
+          comparator_(leaf_page->KeyAt(slot), key) == 0;
+  }
+  if (hit) {
+    result.push_back(leaf_page->GetItem(slot).second);
+    if (slot != entry.slot) {
+      entry.slot = slot;
+      adaptive_hash_.Record(key, entry);
+    }
+  }
+  UnlockPage(LockType::SHARED, page);
+  buffer_pool_manager_->UnpinPage(entry.page_id, false);
+  if (!hit)
+    adaptive_hash_.Invalidate(key);
+  Metrics::Add(hit ? MetricCounter::BTREE_HASH_HIT
+                   : MetricCounter::BTREE_HASH_MISS);
+  return hit;
+}
+
+/*
+ * Keys of a leaf leave it on split, merge and redistribute. Internal pages
+ * are never cached.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+template <typename N> void BPLUSTREE_TYPE::InvalidateAdaptiveHash(N *node) {
+  if (!node->IsLeafPage() || adaptive_hash_.Size() == 0)
+    return;
+  for (int i = 0; i < node->GetSize(); i++)
+    adaptive_hash_.Invalidate(node->KeyAt(i));
+}
+
 /*****************************************************************************
  * INSERTION
  *****************************************************************************/
@@ -89,7 +257,7 @@ void BPLUSTREE_TYPE::StartNewTree(const KeyType &key, const ValueType &value) {
   if (!root_page)  throw "out of memory";
 
   B_PLUS_TREE_LEAF_PAGE_TYPE *root_tree_page = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(root_page->GetData());
-  root_tree_page->Init(new_page_id, INVALID_PAGE_ID);
+  root_tree_page->Init(new_page_id, true, buffer_pool_manager_->GetPageSize());
   root_page_id_ = new_page_id;
   UpdateRootPageId(true);
   // 2. insert record in root
@@ -109,11 +277,23 @@ INDEX_TEMPLATE_ARGUMENTS
 bool BPLUSTREE_TYPE::InsertIntoLeaf(const KeyType &key, const ValueType &value,
                                     Transaction *transaction) {
   // 1. find the key
-  B_PLUS_TREE_LEAF_PAGE_TYPE *insert_page = FindLeafPage(key, false, OpType::INSERT, transaction);
-  ValueType tmp_val;
-  if (insert_page->Lookup(key, tmp_val, comparator_)) {
+  B_PLUS_TREE_LEAF_PAGE_TYPE *insert_page;
+  while (true) {
+    insert_page = FindLeafPage(key, false, OpType::INSERT, transaction);
+    // emptied meanwhile
+    if (insert_page == nullptr)
+      return Insert(key, value, transaction);
+    ValueType tmp_val;
+    if (insert_page->Lookup(key, tmp_val, comparator_)) {
+      RemovePagesInTransaction(LockType::EXCLUSIVE, transaction);
+      return false;
+    }
+    // a split relinks the next leaf, start over when it is taken
+    if (insert_page->GetSize() < insert_page->GetMaxSize() ||
+        LatchNextLeaf(insert_page, transaction))
+      break;
     RemovePagesInTransaction(LockType::EXCLUSIVE, transaction);
-    return false;
+    std::this_thread::yield();
   }
   // 2. insert new record
   insert_page->Insert(key, value, comparator_);
@@ -140,12 +320,18 @@ template <typename N> N *BPLUSTREE_TYPE::Split(N *node, Transaction *transaction
   page_id_t new_page_id;
   auto new_page = buffer_pool_manager_->NewPage(new_page_id);
   if (!new_page) throw "out of memory";
+  Metrics::Add(MetricCounter::BTREE_SPLIT);
+  TRACE_SCOPE("btree", "Split", new_page_id);
   // 2. move half of records from input page to new page
   new_page->WLatch();
   transaction->AddIntoPageSet(new_page);
   N *new_tree_page = reinterpret_cast<N *>(new_page->GetData());
-  new_tree_page->Init(new_page_id, node->GetParentPageId());
-  node->MoveHalfTo(new_tree_page, buffer_pool_manager_);
+  new_tree_page->Init(new_page_id, false, buffer_pool_manager_->GetPageSize());
+  node->MoveHalfTo(new_tree_page);
+  if (node->IsLeafPage())
+    RelinkNextLeaf(reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(new_tree_page),
+                   transaction);
+  InvalidateAdaptiveHash(new_tree_page);
   return new_tree_page;
 }
 
@@ -168,29 +354,23 @@ void BPLUSTREE_TYPE::InsertIntoParent(BPlusTreePage *old_node,
     // 1.1 create new root page
     auto new_page = buffer_pool_manager_->NewPage(root_page_id_);
     B_PLUS_TREE_INTERNAL_PAGE *new_root_page = reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE *>(new_page->GetData());
-    new_root_page->Init(root_page_id_);
+    new_root_page->Init(root_page_id_, true, buffer_pool_manager_->GetPageSize());
     // 1.2 set two records of new root page
     new_root_page->PopulateNewRoot(old_node->GetPageId(), key, new_node->GetPageId());
-    old_node->SetParentPageId(root_page_id_);
-    new_node->SetParentPageId(root_page_id_);
+    old_node->SetRootPage(false);
     UpdateRootPageId();
     // buffer_pool_manager_->UnpinPage(new_node->GetPageId(), true);
     buffer_pool_manager_->UnpinPage(new_root_page->GetPageId(), true);
     return;
   }
-  // 2. handle split of internal page
-  page_id_t parent_id = old_node->GetParentPageId();
-  auto parent_page = buffer_pool_manager_->FetchPage(parent_id);
-  B_PLUS_TREE_INTERNAL_PAGE *parent_tree_page = reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE *>(parent_page->GetData());
-  new_node->SetParentPageId(parent_id);
-  // buffer_pool_manager_->UnpinPage(new_node->GetPageId(), true);
+  // 2. handle split of internal page, the parent is still latched
+  B_PLUS_TREE_INTERNAL_PAGE *parent_tree_page = GetParentPage(old_node, transaction);
   parent_tree_page->InsertNodeAfter(old_node->GetPageId(), key, new_node->GetPageId());
   // 3.split recursively
   if (parent_tree_page->GetSize() > parent_tree_page->GetMaxSize()) {
     B_PLUS_TREE_INTERNAL_PAGE *split_page = Split(parent_tree_page, transaction);
     InsertIntoParent(parent_tree_page, split_page->KeyAt(0), split_page, transaction);
   }
-  buffer_pool_manager_->UnpinPage(parent_id, true);
 }
 
 /*****************************************************************************
@@ -207,14 +387,47 @@ INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_TYPE::Remove(const KeyType &key, Transaction *transaction) {
   if (IsEmpty())
     return;
-  // 1. get the page
-  B_PLUS_TREE_LEAF_PAGE_TYPE *delete_page = FindLeafPage(key, false, OpType::DELETE, transaction);
-  // 2. delete the record
-  int after_sz = delete_page->RemoveAndDeleteRecord(key, comparator_);
-  // 3. merge or redistribute if size < min size
-  if (after_sz < delete_page->GetMinSize())
-    CoalesceOrRedistribute(delete_page, transaction);
-  RemovePagesInTransaction(LockType::EXCLUSIVE, transaction);
+  bool underflow = true;
+  while (underflow) {
+    // 1. get the page
+    B_PLUS_TREE_LEAF_PAGE_TYPE *delete_page = FindLeafPage(key, false, OpType::DELETE, transaction);
+    if (delete_page == nullptr)
+      return;
+    // 2. delete the record
+    adaptive_hash_.Invalidate(key);
+    int after_sz = delete_page->RemoveAndDeleteRecord(key, comparator_);
+    // 3. merge or redistribute if size < low water
+    if (after_sz < LowWater(delete_page))
+      CoalesceOrRedistribute(delete_page, transaction);
+    // a merge put off by a taken next leaf is tried again from the root
+    underflow = !delete_page->IsRootPage() &&
+                delete_page->GetSize() < LowWater(delete_page) &&
+                transaction->GetDeletedPageSet()->count(
+                    delete_page->GetPageId()) == 0;
+    RemovePagesInTransaction(LockType::EXCLUSIVE, transaction);
+    if (underflow)
+      std::this_thread::yield();
+  }
+}
+
+/*
+ * Leaves below half full are left alone until they reach the merge
+ * threshold, so delete and insert churn around the same keys does not merge
+ * and split the same leaves back and forth. Internal pages keep the usual
+ * half full minimum, they only lose entries when leaves merge.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+int BPLUSTREE_TYPE::LowWater(BPlusTreePage *page) const {
+  if (merge_threshold_ >= 50 || !page->IsLeafPage() || page->IsRootPage())
+    return page->GetMinSize();
+  return std::max(1, page->GetMaxSize() * merge_threshold_ / 100);
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::IsSafe(BPlusTreePage *page, OpType op) const {
+  if (op == OpType::DELETE && page->IsLeafPage())
+    return page->GetSize() > LowWater(page);
+  return page->IsSafe(op);
 }
 
 /*
@@ -230,30 +443,31 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
   // 1. handle root page
   if (node->IsRootPage()) {
     bool delete_root = AdjustRoot(node);
-    if (delete_root)
+    if (delete_root) {
+      adaptive_hash_.BumpEpoch();
       transaction->AddIntoDeletedPageSet(node->GetPageId());
+    }
     return delete_root;
   }
-  // 2. get sibling of node
+  // 2. get sibling of node, the parent is still latched
+  B_PLUS_TREE_INTERNAL_PAGE *parent_tree_page = GetParentPage(node, transaction);
   N *sibling;
-  bool node_left = FindSibling(node, sibling, transaction);
-#ifdef DBG
-    // LOG_DEBUG("node - %d\tsibling - %d\n", node->GetPageId(), sibling->GetPageId());
-#endif
-  auto parent_page = buffer_pool_manager_->FetchPage(node->GetParentPageId());
-  B_PLUS_TREE_INTERNAL_PAGE *parent_tree_page = reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE *>(parent_page->GetData());
+  bool node_left = FindSibling(node, parent_tree_page, sibling, transaction);
   // 3. redistribute condition
   if (node->GetSize() + sibling->GetSize() > node->GetMaxSize()) {
     int node_idx = parent_tree_page->ValueIndex(node->GetPageId());
-    Redistribute(sibling, node, node_idx);
-    buffer_pool_manager_->UnpinPage(parent_tree_page->GetPageId(), false);
+    Redistribute(sibling, node, parent_tree_page, node_idx);
     return false;
   }
   // 4. merge condition
   if (node_left)  std::swap(node, sibling);  // let node is after sibling
+  // leaves stay apart while the leaf after them is taken, see Remove
+  if (node->IsLeafPage() &&
+      !LatchNextLeaf(reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(node),
+                     transaction))
+    return false;
   int remove_idx = parent_tree_page->ValueIndex(node->GetPageId());
   Coalesce(sibling, node, parent_tree_page, remove_idx, transaction);
-  buffer_pool_manager_->UnpinPage(parent_tree_page->GetPageId(), true);
   return true;
 }
 
@@ -264,11 +478,10 @@ bool BPLUSTREE_TYPE::CoalesceOrRedistribute(N *node, Transaction *transaction) {
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
-bool BPLUSTREE_TYPE::FindSibling(N *node, N * &sibling, Transaction *transaction) {
-  // 1. get parent page
-  auto parent_page = buffer_pool_manager_->FetchPage(node->GetParentPageId());
-  B_PLUS_TREE_INTERNAL_PAGE *parent_tree_page = reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE *>(parent_page->GetData());
-  // 2. get sibling page (left or right)
+bool BPLUSTREE_TYPE::FindSibling(N *node,
+                                 B_PLUS_TREE_INTERNAL_PAGE *parent_tree_page,
+                                 N * &sibling, Transaction *transaction) {
+  // get sibling page (left or right)
   int idx = parent_tree_page->ValueIndex(node->GetPageId());
   int sibling_idx = (idx > 0) ? (idx - 1) : (idx + 1);
   page_id_t sibling_page_id = parent_tree_page->ValueAt(sibling_idx);
@@ -282,10 +495,6 @@ bool BPLUSTREE_TYPE::FindSibling(N *node, N * &sibling, Transaction *transaction
 #endif
   BPlusTreePage *sibling_page = ConcurrentFetchPage(sibling_page_id, OpType::DELETE, INVALID_PAGE_ID, transaction);
   sibling = reinterpret_cast<N *>(sibling_page);
-  buffer_pool_manager_->UnpinPage(parent_tree_page->GetPageId(), false);
-#ifdef DBG
-    // LOG_DEBUG("node - %d\tsibling - %d\n", node->GetPageId(), sibling->GetPageId());
-#endif
   return idx == 0;
 }
 
@@ -307,9 +516,15 @@ bool BPLUSTREE_TYPE::Coalesce(
     N *&neighbor_node, N *&node,
     BPlusTreeInternalPage<KeyType, page_id_t, KeyComparator> *&parent,
     int index, Transaction *transaction) {
+  Metrics::Add(MetricCounter::BTREE_MERGE);
   // 1. move all record from node to neighbor_node
-  node->MoveAllTo(neighbor_node, index, buffer_pool_manager_);
+  InvalidateAdaptiveHash(node);
+  node->MoveAllTo(neighbor_node, parent->KeyAt(index));
+  if (neighbor_node->IsLeafPage())
+    RelinkNextLeaf(reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(neighbor_node),
+                   transaction);
   // 2. delete node page
+  adaptive_hash_.BumpEpoch();
   transaction->AddIntoDeletedPageSet(node->GetPageId());
   // 3. parent delete the record of node recursively
   parent->Remove(index);
@@ -318,6 +533,46 @@ bool BPLUSTREE_TYPE::Coalesce(
   return false;
 }
 
+/*
+ * The leaf after a split or merged page is latched to fix its previous link.
+ * It may sit under another parent, whose writer can hold it while waiting
+ * for a page this writer holds (FindSibling latches leftwards), so the latch
+ * is only tried. It is kept in the transaction's page set until the split or
+ * merge is done.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+bool BPLUSTREE_TYPE::LatchNextLeaf(B_PLUS_TREE_LEAF_PAGE_TYPE *leaf,
+                                   Transaction *transaction) {
+  page_id_t next_id = leaf->GetNextPageId();
+  if (next_id == INVALID_PAGE_ID)
+    return true;
+  Page *next_page = buffer_pool_manager_->FetchPage(next_id);
+  if (!next_page) throw "out of memory";
+  if (!next_page->TryWLatch()) {
+    Metrics::Add(MetricCounter::BTREE_LATCH_WAIT);
+    buffer_pool_manager_->UnpinPage(next_id, false);
+    return false;
+  }
+  transaction->AddIntoPageSet(next_page);
+  return true;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_TYPE::RelinkNextLeaf(B_PLUS_TREE_LEAF_PAGE_TYPE *leaf,
+                                    Transaction *transaction) {
+  page_id_t next_id = leaf->GetNextPageId();
+  if (next_id == INVALID_PAGE_ID)
+    return;
+  for (Page *page : *transaction->GetPageSet()) {
+    if (page->GetPageId() != next_id)
+      continue;
+    reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(page->GetData())
+        ->SetPrevPageId(leaf->GetPageId());
+    return;
+  }
+  throw Exception(EXCEPTION_TYPE_INDEX, "next leaf is not latched");
+}
+
 /*
  * Redistribute key & value pairs from one page to its sibling page. If index ==
  * 0, move sibling page's first key & value pair into end of input "node",
@@ -326,16 +581,29 @@ bool BPLUSTREE_TYPE::Coalesce(
  * Using template N to represent either internal page or leaf page.
  * @param   neighbor_node      sibling page of input "node"
  * @param   node               input from method coalesceOrRedistribute()
+ * @param   parent             parent page of both, its separator is updated
  */
 INDEX_TEMPLATE_ARGUMENTS
 template <typename N>
-void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node, int index) {
+void BPLUSTREE_TYPE::Redistribute(N *neighbor_node, N *node,
+                                  B_PLUS_TREE_INTERNAL_PAGE *parent,
+                                  int index) {
+  Metrics::Add(MetricCounter::BTREE_REDISTRIBUTE);
   // 1. node is the left most, neighbor_node is after node
-  if (index == 0)
-    neighbor_node->MoveFirstToEndOf(node, buffer_pool_manager_);
+  if (index == 0) {
+    if (neighbor_node->IsLeafPage())
+      adaptive_hash_.Invalidate(neighbor_node->KeyAt(0));
+    neighbor_node->MoveFirstToEndOf(node, parent->KeyAt(1));
+    parent->SetKeyAt(1, neighbor_node->KeyAt(0));
+  }
   // 2. neighbor_node is before node
-  else 
-    neighbor_node->MoveLastToFrontOf(node, index, buffer_pool_manager_);
+  else {
+    if (neighbor_node->IsLeafPage())
+      adaptive_hash_.Invalidate(
+          neighbor_node->KeyAt(neighbor_node->GetSize() - 1));
+    neighbor_node->MoveLastToFrontOf(node, parent->KeyAt(index));
+    parent->SetKeyAt(index, node->KeyAt(0));
+  }
 }
 
 /*
@@ -365,7 +633,7 @@ bool BPLUSTREE_TYPE::AdjustRoot(BPlusTreePage *old_root_node) {
     UpdateRootPageId();
     auto *new_root_page = buffer_pool_manager_->FetchPage(root_page_id_);
     B_PLUS_TREE_INTERNAL_PAGE *new_root_tree_page = reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE *>(new_root_page->GetData());
-    new_root_tree_page->SetParentPageId(INVALID_PAGE_ID);
+    new_root_tree_page->SetRootPage(true);
     buffer_pool_manager_->UnpinPage(root_page_id_, true);
     return true;
   }
@@ -387,7 +655,7 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin() {
   // find the left most leaf page
   B_PLUS_TREE_LEAF_PAGE_TYPE *start_leaf = FindLeafPage(tmp_key, true);
   UnlockRootPage(LockType::SHARED);
-  return INDEXITERATOR_TYPE(0, start_leaf, buffer_pool_manager_);
+  return INDEXITERATOR_TYPE(0, start_leaf, buffer_pool_manager_, this);
 }
 
 /*
@@ -400,8 +668,42 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
   B_PLUS_TREE_LEAF_PAGE_TYPE *start_leaf = FindLeafPage(key, false);
   UnlockRootPage(LockType::SHARED);
   if (!start_leaf)
-    return INDEXITERATOR_TYPE(0, start_leaf, buffer_pool_manager_);
-  return INDEXITERATOR_TYPE(start_leaf->KeyIndex(key, comparator_), start_leaf, buffer_pool_manager_);
+    return INDEXITERATOR_TYPE(0, start_leaf, buffer_pool_manager_, this);
+  return INDEXITERATOR_TYPE(start_leaf->KeyIndex(key, comparator_), start_leaf, buffer_pool_manager_, this);
+}
+
+/*
+ * Input parameter is void, find the right most leaf page first, then
+ * construct index iterator on its last key
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin() {
+  KeyType tmp_key;
+  B_PLUS_TREE_LEAF_PAGE_TYPE *start_leaf = FindLeafPage(tmp_key, false, OpType::READ, nullptr, true);
+  UnlockRootPage(LockType::SHARED);
+  if (!start_leaf)
+    return INDEXITERATOR_TYPE(0, start_leaf, buffer_pool_manager_, this);
+  return INDEXITERATOR_TYPE(start_leaf->GetSize() - 1, start_leaf, buffer_pool_manager_, this);
+}
+
+/*
+ * Input parameter is high key, find the leaf page that contains the input
+ * key first, then construct index iterator on the last key not greater than
+ * it
+ * @return : index iterator
+ */
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_TYPE::RBegin(const KeyType &key) {
+  B_PLUS_TREE_LEAF_PAGE_TYPE *start_leaf = FindLeafPage(key, false);
+  UnlockRootPage(LockType::SHARED);
+  if (!start_leaf)
+    return INDEXITERATOR_TYPE(0, start_leaf, buffer_pool_manager_, this);
+  int index = start_leaf->KeyIndex(key, comparator_);
+  if (index >= start_leaf->GetSize() ||
+      comparator_(start_leaf->KeyAt(index), key) != 0)
+    index--;
+  return INDEXITERATOR_TYPE(index, start_leaf, buffer_pool_manager_, this);
 }
 
 /*****************************************************************************
@@ -409,11 +711,12 @@ INDEXITERATOR_TYPE BPLUSTREE_TYPE::Begin(const KeyType &key) {
  *****************************************************************************/
 /*
  * Find leaf page containing particular key, if leftMost flag == true, find
- * the left most leaf page
+ * the left most leaf page, if rightMost flag == true the right most one
  */
 INDEX_TEMPLATE_ARGUMENTS
 B_PLUS_TREE_LEAF_PAGE_TYPE *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, bool leftMost, 
-                                                          OpType op, Transaction *transaction) {
+                                                          OpType op, Transaction *transaction,
+                                                          bool rightMost) {
   LockType lock_type = (op == OpType::READ) ? LockType::SHARED : LockType::EXCLUSIVE;
   LockRootPage(lock_type);
   if (IsEmpty()) {
@@ -427,6 +730,8 @@ B_PLUS_TREE_LEAF_PAGE_TYPE *BPLUSTREE_TYPE::FindLeafPage(const KeyType &key, boo
     B_PLUS_TREE_INTERNAL_PAGE *internal_tree_page = static_cast<B_PLUS_TREE_INTERNAL_PAGE *>(tree_page);
     if (leftMost) 
       next_id = internal_tree_page->ValueAt(0);
+    else if (rightMost)
+      next_id = internal_tree_page->ValueAt(internal_tree_page->GetSize() - 1);
     else          
       next_id = internal_tree_page->Lookup(key, comparator_);
 
@@ -483,6 +788,28 @@ void BPLUSTREE_TYPE::RemovePagesInTransaction(LockType lock_type, Transaction *t
   transaction->GetPageSet()->clear();
 }
 
+/*
+ * Writers keep the latched path in the transaction's page set, root first.
+ * Split and sibling pages are appended behind it, so the parent of a page on
+ * the path is the page latched right before it. Only unsafe pages keep their
+ * parent latched, which are exactly the ones a split or merge climbs from.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+B_PLUS_TREE_INTERNAL_PAGE *
+BPLUSTREE_TYPE::GetParentPage(BPlusTreePage *node, Transaction *transaction) {
+  if (transaction != nullptr) {
+    auto page_set = transaction->GetPageSet();
+    for (auto it = page_set->rbegin(); it != page_set->rend(); ++it) {
+      if ((*it)->GetPageId() != node->GetPageId())
+        continue;
+      if (++it == page_set->rend())
+        break;
+      return reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE *>((*it)->GetData());
+    }
+  }
+  throw Exception(EXCEPTION_TYPE_INDEX, "parent page is not latched");
+}
+
 /*
  * Fetch page in concurrent environment
  */ 
@@ -493,7 +820,7 @@ BPlusTreePage *BPLUSTREE_TYPE::ConcurrentFetchPage(page_id_t page_id, OpType op,
   LockPage(lock_type, page);
   BPlusTreePage *tree_page = reinterpret_cast<BPlusTreePage  *>(page->GetData());
   // if the op is read or the page is safe, release the latch of previous page
-  if (previous_id > 0 && (op == OpType::READ || tree_page->IsSafe(op)))
+  if (previous_id > 0 && (op == OpType::READ || IsSafe(tree_page, op)))
     RemovePagesInTransaction(lock_type, transaction, previous_id);
   if (transaction != nullptr)  
     transaction->AddIntoPageSet(page);  // add pages which are locked in set
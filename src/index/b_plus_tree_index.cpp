@@ -2,9 +2,25 @@
  * b_plus_tree_index.cpp
  */
 
+#include <algorithm>
+#include <cstring>
+
+#include "common/metrics.h"
+#include "hash/city.h"
 #include "index/b_plus_tree_index.h"
 
 namespace cmudb {
+
+namespace {
+// keys are zero padded by SetFromKey, so equal keys hash the same
+template <typename KeyType> inline uint64_t HashKey(const KeyType &key) {
+  return CityHash64(key.data, sizeof(key.data));
+}
+
+// smallest number of keys a filter is sized for
+const size_t MIN_FILTER_CAPACITY = 1024;
+} // namespace
+
 /*
  * Constructor
  */
@@ -14,7 +30,13 @@ BPLUSTREE_INDEX_TYPE::BPlusTreeIndex(IndexMetadata *metadata,
                                      page_id_t root_page_id)
     : Index(metadata), comparator_(metadata->GetKeySchema()),
       container_(metadata->GetName(), buffer_pool_manager, comparator_,
-                 root_page_id) {}
+                 root_page_id),
+      filter_(new BlockedBloomFilter(MIN_FILTER_CAPACITY)),
+      filter_capacity_(MIN_FILTER_CAPACITY) {
+  // the filter is not persisted, an existing tree fills it again
+  if (root_page_id != INVALID_PAGE_ID)
+    RebuildFilter();
+}
 
 INDEX_TEMPLATE_ARGUMENTS
 void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid,
@@ -22,8 +44,26 @@ void BPLUSTREE_INDEX_TYPE::InsertEntry(const Tuple &key, RID rid,
   // construct insert index key
   KeyType index_key;
   index_key.SetFromKey(key);
+  uint64_t hash = HashKey(index_key);
 
-  container_.Insert(index_key, rid, transaction);
+  filter_latch_.RLock();
+  // the leaf checks for a duplicate, the filter can't tell which of two
+  // concurrent inserts of a key came first. Only a key the tree took is
+  // counted, a rejected duplicate must not bring the rebuild forward
+  bool inserted = container_.Insert(index_key, rid, transaction);
+  bool full = false;
+  if (inserted) {
+    filter_->Insert(hash);
+    full = ++filter_count_ > filter_capacity_;
+  }
+  filter_latch_.RUnlock();
+  if (full) {
+    filter_latch_.WLock();
+    // another insert may have rebuilt it meanwhile
+    if (filter_count_ > filter_capacity_)
+      RebuildFilter();
+    filter_latch_.WUnlock();
+  }
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -43,8 +83,114 @@ void BPLUSTREE_INDEX_TYPE::ScanKey(const Tuple &key, std::vector<RID> &result,
   KeyType index_key;
   index_key.SetFromKey(key);
 
+  filter_latch_.RLock();
+  bool maybe_present = filter_->MayContain(HashKey(index_key));
+  filter_latch_.RUnlock();
+  if (!maybe_present) {
+    Metrics::Add(MetricCounter::BLOOM_FILTER_SKIP);
+    return;
+  }
+  size_t found = result.size();
   container_.GetValue(index_key, result, transaction);
+  if (result.size() == found)
+    Metrics::Add(MetricCounter::BLOOM_FILTER_FALSE_POSITIVE);
 }
+
+/*
+ * Keys the filter rules out are dropped, the others are sorted and probed in
+ * one pass over the leaves.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanKeys(const std::vector<Tuple> &keys,
+                                    std::vector<RID> &result,
+                                    std::string &position) {
+  std::vector<KeyType> index_keys;
+  index_keys.reserve(keys.size());
+  filter_latch_.RLock();
+  for (auto &key : keys) {
+    KeyType index_key;
+    index_key.SetFromKey(key);
+    if (filter_->MayContain(HashKey(index_key)))
+      index_keys.push_back(index_key);
+    else
+      Metrics::Add(MetricCounter::BLOOM_FILTER_SKIP);
+  }
+  filter_latch_.RUnlock();
+  std::sort(index_keys.begin(), index_keys.end(),
+            [this](const KeyType &lhs, const KeyType &rhs) {
+              return comparator_(lhs, rhs) < 0;
+            });
+
+  LeafHint hint;
+  if (position.size() == sizeof(hint))
+    memcpy(&hint, position.data(), sizeof(hint));
+  size_t found = result.size();
+  container_.GetValues(index_keys, result, &hint);
+  position.assign(reinterpret_cast<const char *>(&hint), sizeof(hint));
+  Metrics::Add(MetricCounter::BLOOM_FILTER_FALSE_POSITIVE,
+               index_keys.size() - (result.size() - found));
+}
+
+/*
+ * Keys are unique, the scan goes on from the position key and skips it. Keys
+ * inserted or removed between batches may or may not be seen, like in a
+ * table heap scan.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::ScanBatch(std::string &position, bool reverse,
+                                     size_t batch_size,
+                                     std::vector<RID> &result,
+                                     std::vector<Tuple> *keys) {
+  Schema *key_schema = GetKeySchema();
+  KeyType last_key;
+  bool started = !position.empty();
+  if (started)
+    memcpy(last_key.data, position.data(), sizeof(last_key.data));
+  auto it = !started ? (reverse ? container_.RBegin() : container_.Begin())
+                     : (reverse ? container_.RBegin(last_key)
+                                : container_.Begin(last_key));
+  for (; !it.isEnd() && result.size() < batch_size; reverse ? --it : ++it) {
+    if (started && comparator_((*it).first, last_key) == 0)
+      continue;
+    result.push_back((*it).second);
+    Metrics::Add(MetricCounter::INDEX_SCAN_ROW);
+    if (keys != nullptr) {
+      std::vector<Value> values;
+      for (int i = 0; i < key_schema->GetColumnCount(); i++)
+        values.push_back((*it).first.ToValue(key_schema, i));
+      keys->emplace_back(values, key_schema);
+    }
+    position.assign((*it).first.data, sizeof(last_key.data));
+  }
+}
+
+/*
+ * The caller latches the filter exclusively, inserts wait while the tree is
+ * scanned so no key is missed. Deletes go on, their keys may stay in the new
+ * filter.
+ */
+INDEX_TEMPLATE_ARGUMENTS
+void BPLUSTREE_INDEX_TYPE::RebuildFilter() {
+  std::vector<uint64_t> hashes;
+  for (auto it = container_.Begin(); !it.isEnd(); ++it)
+    hashes.push_back(HashKey((*it).first));
+  filter_capacity_ = std::max(MIN_FILTER_CAPACITY, 2 * hashes.size());
+  filter_.reset(new BlockedBloomFilter(filter_capacity_));
+  for (uint64_t hash : hashes)
+    filter_->Insert(hash);
+  filter_count_ = hashes.size();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator() {
+  return container_.Begin();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE BPLUSTREE_INDEX_TYPE::GetBeginIterator(const KeyType &key) {
+  return container_.Begin(key);
+}
+
 template class BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>;
 template class BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>;
 template class BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>;
@@ -0,0 +1,49 @@
+/**
+ * bloom_filter.cpp
+ */
+
+#include <cstdlib>
+#include <new>
+
+#include "index/bloom_filter.h"
+
+namespace cmudb {
+
+BlockedBloomFilter::BlockedBloomFilter(size_t expected_keys) {
+  size_t bits = expected_keys * BITS_PER_KEY;
+  num_blocks_ = (bits + WORDS_PER_BLOCK * 64 - 1) / (WORDS_PER_BLOCK * 64);
+  if (num_blocks_ == 0)
+    num_blocks_ = 1;
+  size_t num_words = num_blocks_ * WORDS_PER_BLOCK;
+  void *memory = aligned_alloc(64, num_words * sizeof(uint64_t));
+  if (memory == nullptr)
+    throw std::bad_alloc();
+  words_ = static_cast<std::atomic<uint64_t> *>(memory);
+  for (size_t i = 0; i < num_words; i++)
+    new (&words_[i]) std::atomic<uint64_t>(0);
+}
+
+BlockedBloomFilter::~BlockedBloomFilter() { free(words_); }
+
+void BlockedBloomFilter::Insert(uint64_t hash) {
+  uint64_t mask[WORDS_PER_BLOCK];
+  MakeMask(static_cast<uint32_t>(hash), mask);
+  std::atomic<uint64_t> *block = words_ + BlockOf(hash) * WORDS_PER_BLOCK;
+  for (int i = 0; i < WORDS_PER_BLOCK; i++) {
+    // skip the atomic read-modify-write when the bit is already set
+    if ((block[i].load(std::memory_order_relaxed) & mask[i]) != mask[i])
+      block[i].fetch_or(mask[i], std::memory_order_release);
+  }
+}
+
+bool BlockedBloomFilter::MayContain(uint64_t hash) const {
+  uint64_t mask[WORDS_PER_BLOCK];
+  MakeMask(static_cast<uint32_t>(hash), mask);
+  const std::atomic<uint64_t> *block = words_ + BlockOf(hash) * WORDS_PER_BLOCK;
+  uint64_t missing = 0;
+  for (int i = 0; i < WORDS_PER_BLOCK; i++)
+    missing |= mask[i] & ~block[i].load(std::memory_order_acquire);
+  return missing == 0;
+}
+
+} // namespace cmudb
@@ -2,14 +2,34 @@
  * index_iterator.cpp
  */
 #include <cassert>
+#include <thread>
 
+#include "index/b_plus_tree.h"
 #include "index/index_iterator.h"
 
 namespace cmudb {
 
 INDEX_TEMPLATE_ARGUMENTS
-INDEXITERATOR_TYPE::IndexIterator(int index, B_PLUS_TREE_LEAF_PAGE_TYPE *leaf, BufferPoolManager *buffer_pool_manager) 
-                        : index_(index), leaf_(leaf), buffer_pool_manager_(buffer_pool_manager) {};
+INDEXITERATOR_TYPE::IndexIterator(int index, B_PLUS_TREE_LEAF_PAGE_TYPE *leaf,
+                                  BufferPoolManager *buffer_pool_manager,
+                                  BPlusTree<KeyType, ValueType, KeyComparator> *tree)
+    : index_(index), leaf_(leaf), buffer_pool_manager_(buffer_pool_manager),
+      tree_(tree) {
+  // the start key may be larger than every key in its leaf, or smaller
+  // when walking back
+  if (leaf_ != nullptr && index_ >= leaf_->GetSize())
+    ++(*this);
+  else if (leaf_ != nullptr && index_ < 0)
+    SkipBackward();
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE::IndexIterator(IndexIterator &&other)
+    : index_(other.index_), leaf_(other.leaf_),
+      buffer_pool_manager_(other.buffer_pool_manager_), tree_(other.tree_) {
+  // the latch and pin move along
+  other.leaf_ = nullptr;
+}
 
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -44,7 +64,45 @@ INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator++() {
     }
   }
   return *this;
-} 
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+INDEXITERATOR_TYPE &INDEXITERATOR_TYPE::operator--() {
+  --index_;
+  SkipBackward();
+  return *this;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void INDEXITERATOR_TYPE::SkipBackward() {
+  while (leaf_ != nullptr && index_ < 0) {
+    page_id_t prev_id = leaf_->GetPrevPageId();
+    if (prev_id == INVALID_PAGE_ID) {
+      UnlockAndUnPin();
+      leaf_ = nullptr;
+      break;
+    }
+    // while this leaf is latched the previous one can neither split nor
+    // merge, a writer holding it backs off when it can't take ours. Its
+    // latch is only tried all the same, readers never wait leftwards
+    auto *prev_page = buffer_pool_manager_->FetchPage(prev_id);
+    if (prev_page->TryRLatch()) {
+      UnlockAndUnPin();
+      leaf_ = reinterpret_cast<B_PLUS_TREE_LEAF_PAGE_TYPE *>(prev_page->GetData());
+      index_ = leaf_->GetSize() - 1;
+      continue;
+    }
+    buffer_pool_manager_->UnpinPage(prev_id, false);
+    // give way, then find the last key before this leaf from the root
+    KeyType bound = leaf_->KeyAt(0);
+    UnlockAndUnPin();
+    std::this_thread::yield();
+    leaf_ = tree_->FindLeafPage(bound);
+    tree_->UnlockRootPage(LockType::SHARED);
+    if (leaf_ != nullptr)
+      index_ = leaf_->KeyIndex(bound, tree_->comparator_) - 1;
+  }
+}
 
 template class IndexIterator<GenericKey<4>, RID, GenericComparator<4>>;
 template class IndexIterator<GenericKey<8>, RID, GenericComparator<8>>;
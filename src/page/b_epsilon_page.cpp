@@ -0,0 +1,237 @@
+/**
+ * b_epsilon_page.cpp
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#include "common/rid.h"
+#include "page/b_epsilon_page.h"
+
+namespace cmudb {
+
+/*****************************************************************************
+ * LEAF
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_EPSILON_LEAF_PAGE_TYPE::Init(page_id_t page_id, size_t page_size) {
+  level_ = 0;
+  size_ = 0;
+  // one spare slot for the item that overflows the page before the split
+  max_size_ = (page_size - sizeof(BEpsilonLeafPage)) / sizeof(ItemType) - 1;
+  page_id_ = page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+int B_EPSILON_LEAF_PAGE_TYPE::KeyIndex(const KeyType &key,
+                                       const KeyComparator &comparator) const {
+  int le = 0, ri = size_ - 1;
+  while (le <= ri) {
+    int mid = (ri - le) / 2 + le;
+    if (comparator(array_[mid].first, key) < 0)
+      le = mid + 1;
+    else
+      ri = mid - 1;
+  }
+  return le;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool B_EPSILON_LEAF_PAGE_TYPE::Lookup(const KeyType &key, ValueType &value,
+                                      const KeyComparator &comparator) const {
+  int index = KeyIndex(key, comparator);
+  if (index < size_ && comparator(array_[index].first, key) == 0) {
+    value = array_[index].second;
+    return true;
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_EPSILON_LEAF_PAGE_TYPE::Apply(const MessageType &message,
+                                     const KeyComparator &comparator) {
+  int index = KeyIndex(message.key, comparator);
+  bool found =
+      index < size_ && comparator(array_[index].first, message.key) == 0;
+  if (message.erase) {
+    if (found) {
+      memmove(static_cast<void *>(array_ + index), array_ + index + 1,
+              (size_ - index - 1) * sizeof(ItemType));
+      size_--;
+    }
+  } else if (found) {
+    array_[index].second = message.value;
+  } else {
+    memmove(static_cast<void *>(array_ + index + 1), array_ + index,
+            (size_ - index) * sizeof(ItemType));
+    array_[index] = ItemType(message.key, message.value);
+    size_++;
+  }
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_EPSILON_LEAF_PAGE_TYPE::MoveHalfTo(BEpsilonLeafPage *recipient) {
+  int copy_index = size_ / 2;
+  memcpy(static_cast<void *>(recipient->array_), array_ + copy_index,
+         (size_ - copy_index) * sizeof(ItemType));
+  recipient->size_ = size_ - copy_index;
+  size_ = copy_index;
+}
+
+/*****************************************************************************
+ * INTERNAL
+ *****************************************************************************/
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_EPSILON_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, int level,
+                                        size_t page_size) {
+  level_ = level;
+  size_ = 0;
+  page_id_ = page_id;
+  buffer_size_ = 0;
+  // about the square root of the slots are pivots, at least three. One
+  // spare pivot slot holds the pivot that overflows the page before the split
+  size_t space = page_size - sizeof(BEpsilonInternalPage);
+  max_size_ = std::max(3, (int)std::sqrt(space / sizeof(MessageType)));
+  buffer_max_size_ =
+      (space - (max_size_ + 1) * sizeof(PivotType)) / sizeof(MessageType);
+}
+
+/*
+ * Last index from 1 whose key is not greater than key, else 0
+ */
+template <typename KeyType, typename ValueType, typename KeyComparator>
+int B_EPSILON_INTERNAL_PAGE_TYPE::ChildIndex(
+    const KeyType &key, const KeyComparator &comparator) const {
+  int le = 1, ri = size_ - 1;
+  while (le <= ri) {
+    int mid = (ri - le) / 2 + le;
+    if (comparator(pivots_[mid].first, key) <= 0)
+      le = mid + 1;
+    else
+      ri = mid - 1;
+  }
+  return le - 1;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_EPSILON_INTERNAL_PAGE_TYPE::PopulateNewRoot(page_id_t old_page_id) {
+  pivots_[0].second = old_page_id;
+  size_ = 1;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_EPSILON_INTERNAL_PAGE_TYPE::InsertPivotAfter(int index,
+                                                    const KeyType &key,
+                                                    page_id_t page_id) {
+  // the buffer starts after the spare slot, moving pivots never touches it
+  memmove(static_cast<void *>(pivots_ + index + 2), pivots_ + index + 1,
+          (size_ - index - 1) * sizeof(PivotType));
+  pivots_[index + 1] = PivotType(key, page_id);
+  size_++;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+int B_EPSILON_INTERNAL_PAGE_TYPE::MessageIndex(
+    const KeyType &key, const KeyComparator &comparator) const {
+  const MessageType *messages = Messages();
+  int le = 0, ri = buffer_size_ - 1;
+  while (le <= ri) {
+    int mid = (ri - le) / 2 + le;
+    if (comparator(messages[mid].key, key) < 0)
+      le = mid + 1;
+    else
+      ri = mid - 1;
+  }
+  return le;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+const typename B_EPSILON_INTERNAL_PAGE_TYPE::MessageType *
+B_EPSILON_INTERNAL_PAGE_TYPE::FindMessage(
+    const KeyType &key, const KeyComparator &comparator) const {
+  int index = MessageIndex(key, comparator);
+  if (index < buffer_size_ &&
+      comparator(Messages()[index].key, key) == 0)
+    return Messages() + index;
+  return nullptr;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_EPSILON_INTERNAL_PAGE_TYPE::PutMessage(
+    const MessageType &message, const KeyComparator &comparator) {
+  MessageType *messages = Messages();
+  int index = MessageIndex(message.key, comparator);
+  if (index < buffer_size_ &&
+      comparator(messages[index].key, message.key) == 0) {
+    messages[index] = message;
+    return;
+  }
+  memmove(static_cast<void *>(messages + index + 1), messages + index,
+          (buffer_size_ - index) * sizeof(MessageType));
+  messages[index] = message;
+  buffer_size_++;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_EPSILON_INTERNAL_PAGE_TYPE::ChildMessages(
+    int index, const KeyComparator &comparator, int &begin, int &end) const {
+  begin = index == 0 ? 0 : MessageIndex(pivots_[index].first, comparator);
+  end = index + 1 == size_
+            ? buffer_size_
+            : MessageIndex(pivots_[index + 1].first, comparator);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_EPSILON_INTERNAL_PAGE_TYPE::RemoveMessages(int begin, int end) {
+  MessageType *messages = Messages();
+  memmove(static_cast<void *>(messages + begin), messages + end,
+          (buffer_size_ - end) * sizeof(MessageType));
+  buffer_size_ -= end - begin;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+KeyType
+B_EPSILON_INTERNAL_PAGE_TYPE::MoveHalfTo(BEpsilonInternalPage *recipient,
+                                         const KeyComparator &comparator) {
+  int copy_index = size_ / 2;
+  KeyType separator = pivots_[copy_index].first;
+  memcpy(static_cast<void *>(recipient->pivots_), pivots_ + copy_index,
+         (size_ - copy_index) * sizeof(PivotType));
+  recipient->size_ = size_ - copy_index;
+  size_ = copy_index;
+
+  int message_index = MessageIndex(separator, comparator);
+  memcpy(static_cast<void *>(recipient->Messages()), Messages() + message_index,
+         (buffer_size_ - message_index) * sizeof(MessageType));
+  recipient->buffer_size_ = buffer_size_ - message_index;
+  buffer_size_ = message_index;
+  return separator;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::string B_EPSILON_INTERNAL_PAGE_TYPE::ToString() const {
+  std::ostringstream os;
+  os << "[pageId: " << page_id_ << " level: " << level_ << "]<" << size_
+     << "> ";
+  for (int i = 1; i < size_; i++)
+    os << pivots_[i].first << " ";
+  os << "| <" << buffer_size_ << "> ";
+  for (int i = 0; i < buffer_size_; i++)
+    os << (Messages()[i].erase ? "-" : "+") << Messages()[i].key << " ";
+  return os.str();
+}
+
+template class BEpsilonLeafPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class BEpsilonLeafPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class BEpsilonLeafPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class BEpsilonLeafPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class BEpsilonLeafPage<GenericKey<64>, RID, GenericComparator<64>>;
+template class BEpsilonInternalPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class BEpsilonInternalPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class BEpsilonInternalPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class BEpsilonInternalPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class BEpsilonInternalPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+} // namespace cmudb
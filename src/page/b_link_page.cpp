@@ -0,0 +1,139 @@
+/**
+ * b_link_page.cpp
+ */
+
+#include <cstring>
+#include <sstream>
+
+#include "common/rid.h"
+#include "page/b_link_page.h"
+
+namespace cmudb {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_LINK_PAGE_TYPE::Init(page_id_t page_id, int level, size_t page_size) {
+  level_ = level;
+  size_ = 0;
+  // one spare slot for the item that overflows the page before the split
+  max_size_ = (page_size - sizeof(BLinkPage)) / sizeof(ItemType) - 1;
+  page_id_ = page_id;
+  right_page_id_ = INVALID_PAGE_ID;
+  has_high_key_ = 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool B_LINK_PAGE_TYPE::IsBeyondHighKey(const KeyType &key,
+                                       const KeyComparator &comparator) const {
+  return has_high_key_ && comparator(key, high_key_) >= 0;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+int B_LINK_PAGE_TYPE::KeyIndex(const KeyType &key,
+                               const KeyComparator &comparator) const {
+  int le = 0, ri = size_ - 1;
+  while (le <= ri) {
+    int mid = (ri - le) / 2 + le;
+    if (comparator(array_[mid].first, key) < 0)
+      le = mid + 1;
+    else
+      ri = mid - 1;
+  }
+  return le;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool B_LINK_PAGE_TYPE::Lookup(const KeyType &key, ValueType &value,
+                              const KeyComparator &comparator) const {
+  int index = KeyIndex(key, comparator);
+  if (index < size_ && comparator(array_[index].first, key) == 0) {
+    value = array_[index].second;
+    return true;
+  }
+  return false;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+ValueType
+B_LINK_PAGE_TYPE::LookupChild(const KeyType &key,
+                              const KeyComparator &comparator) const {
+  // last index from 1 whose key is not greater than key, else 0
+  int le = 1, ri = size_ - 1;
+  while (le <= ri) {
+    int mid = (ri - le) / 2 + le;
+    if (comparator(array_[mid].first, key) <= 0)
+      le = mid + 1;
+    else
+      ri = mid - 1;
+  }
+  return array_[le - 1].second;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_LINK_PAGE_TYPE::Insert(const KeyType &key, const ValueType &value,
+                              const KeyComparator &comparator) {
+  // the invalid first key of an internal page stays in front
+  int index = IsLeafPage() ? 0 : 1;
+  while (index < size_ && comparator(array_[index].first, key) < 0)
+    index++;
+  memmove(static_cast<void *>(array_ + index + 1), array_ + index,
+          (size_ - index) * sizeof(ItemType));
+  array_[index] = ItemType(key, value);
+  size_++;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_LINK_PAGE_TYPE::RemoveAt(int index) {
+  memmove(static_cast<void *>(array_ + index), array_ + index + 1,
+          (size_ - index - 1) * sizeof(ItemType));
+  size_--;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_LINK_PAGE_TYPE::PopulateNewRoot(const ValueType &old_value,
+                                       const KeyType &new_key,
+                                       const ValueType &new_value) {
+  array_[0].second = old_value;
+  array_[1] = ItemType(new_key, new_value);
+  size_ = 2;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void B_LINK_PAGE_TYPE::MoveHalfTo(BLinkPage *recipient) {
+  int copy_index = size_ / 2;
+  memcpy(static_cast<void *>(recipient->array_), array_ + copy_index,
+         (size_ - copy_index) * sizeof(ItemType));
+  recipient->size_ = size_ - copy_index;
+  size_ = copy_index;
+  // the recipient takes over the upper range and the right link
+  recipient->right_page_id_ = right_page_id_;
+  recipient->has_high_key_ = has_high_key_;
+  recipient->high_key_ = high_key_;
+  right_page_id_ = recipient->page_id_;
+  has_high_key_ = 1;
+  high_key_ = recipient->array_[0].first;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::string B_LINK_PAGE_TYPE::ToString() const {
+  std::ostringstream os;
+  os << "[pageId: " << page_id_ << " level: " << level_
+     << " right: " << right_page_id_ << "]<" << size_ << "> ";
+  for (int i = IsLeafPage() ? 0 : 1; i < size_; i++)
+    os << array_[i].first << " ";
+  if (has_high_key_)
+    os << "| " << high_key_;
+  return os.str();
+}
+
+template class BLinkPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class BLinkPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class BLinkPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class BLinkPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class BLinkPage<GenericKey<64>, RID, GenericComparator<64>>;
+template class BLinkPage<GenericKey<4>, page_id_t, GenericComparator<4>>;
+template class BLinkPage<GenericKey<8>, page_id_t, GenericComparator<8>>;
+template class BLinkPage<GenericKey<16>, page_id_t, GenericComparator<16>>;
+template class BLinkPage<GenericKey<32>, page_id_t, GenericComparator<32>>;
+template class BLinkPage<GenericKey<64>, page_id_t, GenericComparator<64>>;
+
+} // namespace cmudb
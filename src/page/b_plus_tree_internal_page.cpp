@@ -13,17 +13,17 @@ namespace cmudb {
  *****************************************************************************/
 /*
  * Init method after creating a new internal page
- * Including set page type, set current size, set page id, set parent id and set
+ * Including set page type, set current size, set page id, set root flag and set
  * max page size
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id,
-                                          page_id_t parent_id) {
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::Init(page_id_t page_id, bool is_root,
+                                         size_t page_size) {
   SetPageType(IndexPageType::INTERNAL_PAGE);
   SetSize(0);
   SetPageId(page_id);
-  SetParentPageId(parent_id);
-  SetMaxSize((PAGE_SIZE - sizeof(BPlusTreeInternalPage)) / sizeof(MappingType) - 1);
+  SetRootPage(is_root);
+  SetMaxSize((page_size - sizeof(BPlusTreeInternalPage)) / sizeof(MappingType) - 1);
 }
 /*
  * Helper method to get/set the key associated with input "index"(a.k.a
@@ -124,29 +124,23 @@ int B_PLUS_TREE_INTERNAL_PAGE_TYPE::InsertNodeAfter(
  * SPLIT
  *****************************************************************************/
 /*
- * Remove half of key & value pairs from this page to "recipient" page
+ * Remove half of key & value pairs from this page to "recipient" page, the
+ * moved children are not touched
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveHalfTo(
-    BPlusTreeInternalPage *recipient,
-    BufferPoolManager *buffer_pool_manager) {
+    BPlusTreeInternalPage *recipient) {
   int total = GetMaxSize() + 1;   
   int copy_idx = total / 2;
-  recipient->CopyHalfFrom(&array[copy_idx], total - copy_idx, buffer_pool_manager);
+  recipient->CopyHalfFrom(&array[copy_idx], total - copy_idx);
   SetSize(copy_idx);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyHalfFrom(
-  MappingType *items, int size, BufferPoolManager *buffer_pool_manager) {
-  for (int i = 0; i < size; ++ i) {
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyHalfFrom(MappingType *items,
+                                                  int size) {
+  for (int i = 0; i < size; ++ i)
     array[i] = items[i];
-
-    auto child_page = buffer_pool_manager->FetchPage(items[i].second);
-    BPlusTreePage *child_tree_page = reinterpret_cast<BPlusTreePage* >(child_page->GetData());
-    child_tree_page->SetParentPageId(GetPageId());
-    buffer_pool_manager->UnpinPage(items[i].second, true);
-  }
   SetSize(size);
 }
 
@@ -178,35 +172,24 @@ ValueType B_PLUS_TREE_INTERNAL_PAGE_TYPE::RemoveAndReturnOnlyChild() {
  * MERGE
  *****************************************************************************/
 /*
- * Remove all of key & value pairs from this page to "recipient" page, then
- * update relavent key & value pair in its parent page.
+ * Remove all of key & value pairs from this page to "recipient" page.
+ * middle_key is the key of this page in the parent, it becomes the key of the
+ * first moved child.
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveAllTo(
-    BPlusTreeInternalPage *recipient, int index_in_parent,
-    BufferPoolManager *buffer_pool_manager) {
-  auto parent_page = buffer_pool_manager->FetchPage(GetParentPageId());
-  BPlusTreeInternalPage *parent_tree_page = reinterpret_cast<BPlusTreeInternalPage *>(parent_page->GetData());
-  // set the first key of parent to index 0 for routing
-  SetKeyAt(0, parent_tree_page->KeyAt(index_in_parent));
-  buffer_pool_manager->UnpinPage(parent_tree_page->GetPageId(), false);
-
-  recipient->CopyAllFrom(array, GetSize(), buffer_pool_manager);
+    BPlusTreeInternalPage *recipient, const KeyType &middle_key) {
+  SetKeyAt(0, middle_key);
+  recipient->CopyAllFrom(array, GetSize());
   SetSize(0);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyAllFrom(
-    MappingType *items, int size, BufferPoolManager *buffer_pool_manager) {
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyAllFrom(MappingType *items,
+                                                 int size) {
   int cur_sz = GetSize();
-  for (int i = 0; i < size; ++ i) {
+  for (int i = 0; i < size; ++ i)
     array[cur_sz + i] = items[i];
-
-    auto child_page = buffer_pool_manager->FetchPage(items[i].second);
-    BPlusTreePage *child_tree_page = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
-    child_tree_page->SetParentPageId(GetPageId());
-    buffer_pool_manager->UnpinPage(items[i].second, true);
-  }
   IncreaseSize(size);
 }
 
@@ -215,67 +198,45 @@ void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyAllFrom(
  *****************************************************************************/
 /*
  * Remove the first key & value pair from this page to tail of "recipient"
- * page, then update relavent key & value pair in its parent page.
+ * page. middle_key is the key of this page in the parent, the caller replaces
+ * it with KeyAt(0) afterwards.
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveFirstToEndOf(
-    BPlusTreeInternalPage *recipient,
-    BufferPoolManager *buffer_pool_manager) {
-  MappingType first_pair{KeyAt(0), ValueAt(0)};
+    BPlusTreeInternalPage *recipient, const KeyType &middle_key) {
+  MappingType first_pair{middle_key, ValueAt(0)};
   IncreaseSize(-1);
-  memmove(array, array + 1, GetSize() * sizeof(MappingType));
-  recipient->CopyLastFrom(first_pair, buffer_pool_manager);
-
-  page_id_t child_page_id = first_pair.second;
-  auto child_page = buffer_pool_manager->FetchPage(child_page_id);
-  BPlusTreePage *child_tree_page = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
-  child_tree_page->SetParentPageId(recipient->GetPageId());
-  buffer_pool_manager->UnpinPage(child_tree_page->GetPageId(), true);
-
-  auto parent_page = buffer_pool_manager->FetchPage(GetParentPageId());
-  B_PLUS_TREE_INTERNAL_PAGE *parent_tree_page = reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE *>(parent_page->GetData());
-  parent_tree_page->SetKeyAt(parent_tree_page->ValueIndex(GetPageId()), array[0].first);
-  buffer_pool_manager->UnpinPage(GetParentPageId(), true);
+  memmove(static_cast<void *>(array), array + 1, GetSize() * sizeof(MappingType));
+  recipient->CopyLastFrom(first_pair);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyLastFrom(
-    const MappingType &pair, BufferPoolManager *buffer_pool_manager) {
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyLastFrom(const MappingType &pair) {
   array[GetSize()] = pair;
   IncreaseSize(1);
 }
 
 /*
  * Remove the last key & value pair from this page to head of "recipient"
- * page, then update relavent key & value pair in its parent page.
+ * page. middle_key is the key of "recipient" in the parent, the caller
+ * replaces it with recipient->KeyAt(0) afterwards.
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_INTERNAL_PAGE_TYPE::MoveLastToFrontOf(
-    BPlusTreeInternalPage *recipient, int parent_index,
-    BufferPoolManager *buffer_pool_manager) {
+    BPlusTreeInternalPage *recipient, const KeyType &middle_key) {
   MappingType last_pair{KeyAt(GetSize() - 1), ValueAt(GetSize() - 1)};
   IncreaseSize(-1);
-  recipient->CopyFirstFrom(last_pair, parent_index, buffer_pool_manager);
+  recipient->CopyFirstFrom(last_pair, middle_key);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyFirstFrom(
-    const MappingType &pair, int parent_index,
-    BufferPoolManager *buffer_pool_manager) {
-  memmove(array + 1, array, GetSize() * sizeof(MappingType));
+void B_PLUS_TREE_INTERNAL_PAGE_TYPE::CopyFirstFrom(const MappingType &pair,
+                                                   const KeyType &middle_key) {
+  // the old first child is now keyed by the separator it was reached through
+  SetKeyAt(0, middle_key);
+  memmove(static_cast<void *>(array + 1), array, GetSize() * sizeof(MappingType));
   IncreaseSize(1);
   array[0] = pair;
-
-  page_id_t child_page_id = pair.second;
-  auto *child_page = buffer_pool_manager->FetchPage(child_page_id);
-  BPlusTreePage *child_tree_page = reinterpret_cast<BPlusTreePage *>(child_page->GetData());
-  child_tree_page->SetParentPageId(GetPageId());
-  buffer_pool_manager->UnpinPage(child_tree_page->GetPageId(), true);
-
-  auto parent_page = buffer_pool_manager->FetchPage(GetParentPageId());
-  B_PLUS_TREE_INTERNAL_PAGE *parent_tree_page = reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE *>(parent_page->GetData());
-  parent_tree_page->SetKeyAt(parent_index, array[0].first);
-  buffer_pool_manager->UnpinPage(GetParentPageId(), true);
 }
 
 /*****************************************************************************
@@ -303,7 +264,7 @@ std::string B_PLUS_TREE_INTERNAL_PAGE_TYPE::ToString(bool verbose) const {
   }
   std::ostringstream os;
   if (verbose) {
-    os << "[pageId: " << GetPageId() << " parentId: " << GetParentPageId()
+    os << "[pageId: " << GetPageId() << " root: " << IsRootPage()
        << "]<" << GetSize() << "> ";
   }
 
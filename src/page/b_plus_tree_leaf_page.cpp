@@ -7,7 +7,6 @@
 #include "common/exception.h"
 #include "common/rid.h"
 #include "page/b_plus_tree_leaf_page.h"
-#include "page/b_plus_tree_internal_page.h"
 
 namespace cmudb {
 
@@ -17,21 +16,23 @@ namespace cmudb {
 
 /**
  * Init method after creating a new leaf page
- * Including set page type, set current size to zero, set page id/parent id, set
+ * Including set page type, set current size to zero, set page id/root flag, set
  * next page id and set max size
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, page_id_t parent_id) {
+void B_PLUS_TREE_LEAF_PAGE_TYPE::Init(page_id_t page_id, bool is_root,
+                                     size_t page_size) {
   SetPageType(IndexPageType::LEAF_PAGE);
   SetSize(0);
   SetPageId(page_id);
-  SetParentPageId(parent_id);
+  SetRootPage(is_root);
   SetNextPageId(INVALID_PAGE_ID);
-  SetMaxSize((PAGE_SIZE - sizeof(BPlusTreeLeafPage)) / sizeof(MappingType) - 1); 
+  SetPrevPageId(INVALID_PAGE_ID);
+  SetMaxSize((page_size - sizeof(BPlusTreeLeafPage)) / sizeof(MappingType) - 1); 
 }
 
 /**
- * Helper methods to set/get next page id
+ * Helper methods to set/get next and previous page id
  */
 INDEX_TEMPLATE_ARGUMENTS
 page_id_t B_PLUS_TREE_LEAF_PAGE_TYPE::GetNextPageId() const {
@@ -43,6 +44,16 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
   next_page_id_ = next_page_id;
 }
 
+INDEX_TEMPLATE_ARGUMENTS
+page_id_t B_PLUS_TREE_LEAF_PAGE_TYPE::GetPrevPageId() const {
+  return prev_page_id_;
+}
+
+INDEX_TEMPLATE_ARGUMENTS
+void B_PLUS_TREE_LEAF_PAGE_TYPE::SetPrevPageId(page_id_t prev_page_id) {
+  prev_page_id_ = prev_page_id;
+}
+
 /**
  * Helper method to find the first index i so that array[i].first >= key
  * NOTE: This method is only used when generating index iterator
@@ -106,13 +117,12 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::Insert(const KeyType &key,
  * Remove half of key & value pairs from this page to "recipient" page
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(
-    BPlusTreeLeafPage *recipient,
-    __attribute__((unused)) BufferPoolManager *buffer_pool_manager) {
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveHalfTo(BPlusTreeLeafPage *recipient) {
   int total = GetMaxSize() + 1;
   int copy_idx = total / 2;
   recipient->CopyHalfFrom(&array[copy_idx], total - copy_idx);
   recipient->SetNextPageId(GetNextPageId());
+  recipient->SetPrevPageId(GetPageId());
   SetNextPageId(recipient->GetPageId());
   SetSize(copy_idx);
 }
@@ -160,7 +170,7 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(
   if (idx_gt_key >= GetSize() || comparator(key, KeyAt(idx_gt_key)) != 0) 
     return GetSize();
 
-  memmove(array + idx_gt_key, array + idx_gt_key + 1, (GetSize() - idx_gt_key - 1) * sizeof(MappingType));
+  memmove(static_cast<void *>(array + idx_gt_key), array + idx_gt_key + 1, (GetSize() - idx_gt_key - 1) * sizeof(MappingType));
   IncreaseSize(-1);
   return GetSize();
 }
@@ -174,7 +184,7 @@ int B_PLUS_TREE_LEAF_PAGE_TYPE::RemoveAndDeleteRecord(
  */
 INDEX_TEMPLATE_ARGUMENTS
 void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveAllTo(BPlusTreeLeafPage *recipient,
-                                           int, BufferPoolManager *) {
+                                           const KeyType &) {
   recipient->CopyAllFrom(array, GetSize());
   recipient->SetNextPageId(GetNextPageId());
   SetSize(0);
@@ -192,22 +202,16 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyAllFrom(MappingType *items, int size) {
  * REDISTRIBUTE
  *****************************************************************************/
 /*
- * Remove the first key & value pair from this page to "recipient" page, then
- * update relavent key & value pair in its parent page.
+ * Remove the first key & value pair from this page to "recipient" page, the
+ * caller updates the key of this page in the parent.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(
-    BPlusTreeLeafPage *recipient,
-    BufferPoolManager *buffer_pool_manager) {
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveFirstToEndOf(BPlusTreeLeafPage *recipient,
+                                                  const KeyType &) {
   MappingType first_pair = GetItem(0);
   IncreaseSize(-1);
-  memmove(array, array + 1, GetSize() * sizeof(MappingType));
+  memmove(static_cast<void *>(array), array + 1, GetSize() * sizeof(MappingType));
   recipient->CopyLastFrom(first_pair);
-
-  auto parent_page = buffer_pool_manager->FetchPage(GetParentPageId());
-  B_PLUS_TREE_INTERNAL_PAGE *parent_tree_page = reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE *>(parent_page->GetData());
-  parent_tree_page->SetKeyAt(parent_tree_page->ValueIndex(GetPageId()), array[0].first);
-  buffer_pool_manager->UnpinPage(GetParentPageId(), true);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
@@ -216,30 +220,22 @@ void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyLastFrom(const MappingType &item) {
   IncreaseSize(1);
 }
 /*
- * Remove the last key & value pair from this page to "recipient" page, then
- * update relavent key & value pair in its parent page.
+ * Remove the last key & value pair from this page to "recipient" page, the
+ * caller updates the key of "recipient" in the parent.
  */
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(
-    BPlusTreeLeafPage *recipient, int parent_index,
-    BufferPoolManager *buffer_pool_manager) {
+void B_PLUS_TREE_LEAF_PAGE_TYPE::MoveLastToFrontOf(BPlusTreeLeafPage *recipient,
+                                                   const KeyType &) {
   MappingType last_pair = GetItem(GetSize() - 1);
   IncreaseSize(-1);
-  recipient->CopyFirstFrom(last_pair, parent_index, buffer_pool_manager);
+  recipient->CopyFirstFrom(last_pair);
 }
 
 INDEX_TEMPLATE_ARGUMENTS
-void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyFirstFrom(
-    const MappingType &item, int parent_index,
-    BufferPoolManager *buffer_pool_manager) {
-  memmove(array + 1, array, GetSize() * sizeof(MappingType));
+void B_PLUS_TREE_LEAF_PAGE_TYPE::CopyFirstFrom(const MappingType &item) {
+  memmove(static_cast<void *>(array + 1), array, GetSize() * sizeof(MappingType));
   IncreaseSize(1);
   array[0] = item;
-
-  auto *parent_page = buffer_pool_manager->FetchPage(GetParentPageId());
-  B_PLUS_TREE_INTERNAL_PAGE *parent_tree_page = reinterpret_cast<B_PLUS_TREE_INTERNAL_PAGE *>(parent_page->GetData());
-  parent_tree_page->SetKeyAt(parent_index, array[0].first);
-  buffer_pool_manager->UnpinPage(GetParentPageId(), true);
 }
 
 /*****************************************************************************
@@ -252,7 +248,7 @@ std::string B_PLUS_TREE_LEAF_PAGE_TYPE::ToString(bool verbose) const {
   }
   std::ostringstream stream;
   if (verbose) {
-    stream << "[pageId: " << GetPageId() << " parentId: " << GetParentPageId()
+    stream << "[pageId: " << GetPageId() << " root: " << IsRootPage()
            << "]<" << GetSize() << "> ";
   }
   int entry = 0;
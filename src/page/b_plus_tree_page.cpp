@@ -13,7 +13,7 @@ bool BPlusTreePage::IsLeafPage() const {
   return page_type_ == IndexPageType::LEAF_PAGE;
 }
 bool BPlusTreePage::IsRootPage() const { 
-  return parent_page_id_== INVALID_PAGE_ID;
+  return is_root_ != 0;
 }
 void BPlusTreePage::SetPageType(IndexPageType page_type) {
   page_type_ = page_type;
@@ -55,13 +55,11 @@ int BPlusTreePage::GetMinSize() const {
 }
 
 /*
- * Helper methods to get/set parent page id
+ * Helper method to set whether the page is the root, only the tree knows when
+ * the root changes
  */
-page_id_t BPlusTreePage::GetParentPageId() const {
-  return parent_page_id_;
-}
-void BPlusTreePage::SetParentPageId(page_id_t parent_page_id) {
-  parent_page_id_ = parent_page_id;
+void BPlusTreePage::SetRootPage(bool is_root) {
+  is_root_ = is_root;
 }
 
 /*
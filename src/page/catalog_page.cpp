@@ -0,0 +1,165 @@
+/**
+ * catalog_page.cpp
+ */
+#include <cstring>
+
+#include "page/catalog_page.h"
+
+namespace cmudb {
+
+namespace {
+const int CATALOG_PAGE_HEADER_SIZE = 12;
+const int RECORD_HEADER_SIZE = 8;
+} // namespace
+
+/*****************************************************************************
+ * DIRECTORY
+ *****************************************************************************/
+void CatalogDirectoryPage::Init() {
+  int bucket_count = (GetPageSize() - 4) / sizeof(page_id_t);
+  memcpy(GetData(), &bucket_count, 4);
+  for (int i = 0; i < bucket_count; i++)
+    SetBucketPageId(i, INVALID_PAGE_ID);
+}
+
+int CatalogDirectoryPage::GetBucketCount() {
+  return *reinterpret_cast<int *>(GetData());
+}
+
+page_id_t CatalogDirectoryPage::GetBucketPageId(int bucket) {
+  return *reinterpret_cast<page_id_t *>(GetData() + 4 +
+                                        bucket * sizeof(page_id_t));
+}
+
+void CatalogDirectoryPage::SetBucketPageId(int bucket, page_id_t page_id) {
+  memcpy(GetData() + 4 + bucket * sizeof(page_id_t), &page_id,
+         sizeof(page_id_t));
+}
+
+/*****************************************************************************
+ * BUCKET PAGE
+ *****************************************************************************/
+void CatalogPage::Init() {
+  SetNextPageId(INVALID_PAGE_ID);
+  SetRecordCount(0);
+  SetUsedBytes(CATALOG_PAGE_HEADER_SIZE);
+}
+
+page_id_t CatalogPage::GetNextPageId() {
+  return *reinterpret_cast<page_id_t *>(GetData());
+}
+
+void CatalogPage::SetNextPageId(page_id_t next_page_id) {
+  memcpy(GetData(), &next_page_id, 4);
+}
+
+int CatalogPage::GetRecordCount() {
+  return *reinterpret_cast<int *>(GetData() + 4);
+}
+
+bool CatalogPage::InsertRecord(const std::string &name,
+                               const std::string &payload) {
+  int used_bytes = GetUsedBytes();
+  int record_size = RECORD_HEADER_SIZE + name.size() + payload.size();
+  if (used_bytes + record_size > (int)GetPageSize())
+    return false;
+  int name_length = name.size(), payload_length = payload.size();
+  char *record = GetData() + used_bytes;
+  memcpy(record, &name_length, 4);
+  memcpy(record + 4, &payload_length, 4);
+  memcpy(record + RECORD_HEADER_SIZE, name.data(), name_length);
+  memcpy(record + RECORD_HEADER_SIZE + name_length, payload.data(),
+         payload_length);
+  SetRecordCount(GetRecordCount() + 1);
+  SetUsedBytes(used_bytes + record_size);
+  return true;
+}
+
+bool CatalogPage::DeleteRecord(const std::string &name) {
+  int offset = FindRecord(name);
+  if (offset == -1)
+    return false;
+  char *record = GetData() + offset;
+  int record_size = RECORD_HEADER_SIZE + *reinterpret_cast<int *>(record) +
+                    *reinterpret_cast<int *>(record + 4);
+  int used_bytes = GetUsedBytes();
+  memmove(record, record + record_size, used_bytes - offset - record_size);
+  SetRecordCount(GetRecordCount() - 1);
+  SetUsedBytes(used_bytes - record_size);
+  return true;
+}
+
+bool CatalogPage::ReplaceRecord(const std::string &name,
+                                const std::string &payload) {
+  int offset = FindRecord(name);
+  if (offset == -1)
+    return false;
+  char *record = GetData() + offset;
+  int old_payload_length = *reinterpret_cast<int *>(record + 4);
+  if (GetUsedBytes() - old_payload_length + (int)payload.size() >
+      (int)GetPageSize())
+    return false;
+  DeleteRecord(name);
+  return InsertRecord(name, payload);
+}
+
+bool CatalogPage::GetRecord(const std::string &name, std::string &payload) {
+  int offset = FindRecord(name);
+  if (offset == -1)
+    return false;
+  char *record = GetData() + offset;
+  int name_length = *reinterpret_cast<int *>(record);
+  int payload_length = *reinterpret_cast<int *>(record + 4);
+  payload.assign(record + RECORD_HEADER_SIZE + name_length, payload_length);
+  return true;
+}
+
+void CatalogPage::GetRecords(
+    std::vector<std::pair<std::string, std::string>> &records) {
+  int offset = CATALOG_PAGE_HEADER_SIZE;
+  for (int i = 0; i < GetRecordCount(); i++) {
+    char *record = GetData() + offset;
+    int name_length = *reinterpret_cast<int *>(record);
+    int payload_length = *reinterpret_cast<int *>(record + 4);
+    records.emplace_back(
+        std::string(record + RECORD_HEADER_SIZE, name_length),
+        std::string(record + RECORD_HEADER_SIZE + name_length,
+                    payload_length));
+    offset += RECORD_HEADER_SIZE + name_length + payload_length;
+  }
+}
+
+size_t CatalogPage::MaxRecordSize(size_t page_size) {
+  return page_size - CATALOG_PAGE_HEADER_SIZE - RECORD_HEADER_SIZE;
+}
+
+/**
+ * helper functions
+ */
+int CatalogPage::FindRecord(const std::string &name) {
+  int offset = CATALOG_PAGE_HEADER_SIZE;
+  for (int i = 0; i < GetRecordCount(); i++) {
+    char *record = GetData() + offset;
+    int name_length = *reinterpret_cast<int *>(record);
+    int payload_length = *reinterpret_cast<int *>(record + 4);
+    if (name_length == (int)name.size() &&
+        memcmp(record + RECORD_HEADER_SIZE, name.data(), name_length) == 0)
+      return offset;
+    offset += RECORD_HEADER_SIZE + name_length + payload_length;
+  }
+  return -1;
+}
+
+int CatalogPage::GetUsedBytes() {
+  return *reinterpret_cast<int *>(GetData() + 8);
+}
+
+void CatalogPage::SetRecordCount(int record_count) {
+  memcpy(GetData() + 4, &record_count, 4);
+}
+
+void CatalogPage::SetUsedBytes(int used_bytes) {
+  memcpy(GetData() + 8, &used_bytes, 4);
+}
+
+} // namespace cmudb
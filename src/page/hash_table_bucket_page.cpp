@@ -0,0 +1,115 @@
+/**
+ * hash_table_bucket_page.cpp
+ */
+
+#include <cassert>
+#include <sstream>
+
+#include "common/rid.h"
+#include "page/hash_table_bucket_page.h"
+
+namespace cmudb {
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BUCKET_PAGE_TYPE::Init(page_id_t page_id, size_t page_size) {
+  page_id_ = page_id;
+  lsn_ = INVALID_LSN;
+  size_ = 0;
+  max_size_ = (page_size - sizeof(HashTableBucketPage)) / sizeof(ItemType);
+  next_page_id_ = INVALID_PAGE_ID;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t HASH_TABLE_BUCKET_PAGE_TYPE::GetPageId() const {
+  return page_id_;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+int HASH_TABLE_BUCKET_PAGE_TYPE::GetSize() const {
+  return size_;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+int HASH_TABLE_BUCKET_PAGE_TYPE::GetMaxSize() const {
+  return max_size_;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_BUCKET_PAGE_TYPE::IsFull() const {
+  return size_ >= GetMaxSize();
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+page_id_t HASH_TABLE_BUCKET_PAGE_TYPE::GetNextPageId() const {
+  return next_page_id_;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BUCKET_PAGE_TYPE::SetNextPageId(page_id_t next_page_id) {
+  next_page_id_ = next_page_id;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+KeyType HASH_TABLE_BUCKET_PAGE_TYPE::KeyAt(int index) const {
+  assert(index >= 0 && index < size_);
+  return array_[index].first;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+const typename HASH_TABLE_BUCKET_PAGE_TYPE::ItemType &
+HASH_TABLE_BUCKET_PAGE_TYPE::GetItem(int index) const {
+  assert(index >= 0 && index < size_);
+  return array_[index];
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+int HASH_TABLE_BUCKET_PAGE_TYPE::KeyIndex(
+    const KeyType &key, const KeyComparator &comparator) const {
+  for (int i = 0; i < size_; i++) {
+    if (comparator(array_[i].first, key) == 0)
+      return i;
+  }
+  return -1;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+bool HASH_TABLE_BUCKET_PAGE_TYPE::Lookup(
+    const KeyType &key, ValueType &value,
+    const KeyComparator &comparator) const {
+  int index = KeyIndex(key, comparator);
+  if (index == -1)
+    return false;
+  value = array_[index].second;
+  return true;
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BUCKET_PAGE_TYPE::Insert(const KeyType &key,
+                                         const ValueType &value) {
+  assert(!IsFull());
+  array_[size_++] = ItemType(key, value);
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+void HASH_TABLE_BUCKET_PAGE_TYPE::RemoveAt(int index) {
+  assert(index >= 0 && index < size_);
+  array_[index] = array_[--size_];
+}
+
+template <typename KeyType, typename ValueType, typename KeyComparator>
+std::string HASH_TABLE_BUCKET_PAGE_TYPE::ToString() const {
+  std::stringstream os;
+  os << "[pageId: " << page_id_ << " size: " << size_
+     << " next: " << next_page_id_ << "]";
+  for (int i = 0; i < size_; i++)
+    os << " " << array_[i].first;
+  return os.str();
+}
+
+template class HashTableBucketPage<GenericKey<4>, RID, GenericComparator<4>>;
+template class HashTableBucketPage<GenericKey<8>, RID, GenericComparator<8>>;
+template class HashTableBucketPage<GenericKey<16>, RID, GenericComparator<16>>;
+template class HashTableBucketPage<GenericKey<32>, RID, GenericComparator<32>>;
+template class HashTableBucketPage<GenericKey<64>, RID, GenericComparator<64>>;
+
+} // namespace cmudb
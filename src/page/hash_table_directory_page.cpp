@@ -0,0 +1,87 @@
+/**
+ * hash_table_directory_page.cpp
+ */
+
+#include <cassert>
+#include <cstring>
+#include <sstream>
+
+#include "page/hash_table_directory_page.h"
+
+namespace cmudb {
+
+/**
+ * Init method after creating a new directory page, a single slot pointing at
+ * the first bucket. The page has as many slots as page_size bytes hold
+ */
+void HashTableDirectoryPage::Init(page_id_t page_id, page_id_t bucket_page_id,
+                                  size_t page_size) {
+  page_id_ = page_id;
+  lsn_ = INVALID_LSN;
+  global_depth_ = 0;
+  max_depth_ = MaxDepthOf(page_size);
+  memset(LocalDepths(), 0, 1U << max_depth_);
+  BucketPageIds()[0] = bucket_page_id;
+}
+
+page_id_t HashTableDirectoryPage::GetPageId() const { return page_id_; }
+
+uint32_t HashTableDirectoryPage::GetGlobalDepth() const {
+  return global_depth_;
+}
+
+uint32_t HashTableDirectoryPage::Size() const { return 1U << global_depth_; }
+
+uint32_t HashTableDirectoryPage::GetMaxDepth() const { return max_depth_; }
+
+uint32_t HashTableDirectoryPage::MaxDepthOf(size_t page_size) {
+  uint32_t depth = 0;
+  while ((2U << depth) <= DirectorySlots(page_size))
+    depth++;
+  return depth;
+}
+
+uint32_t HashTableDirectoryPage::SlotOf(uint32_t hash) const {
+  return hash & (Size() - 1);
+}
+
+page_id_t HashTableDirectoryPage::GetBucketPageId(uint32_t slot) const {
+  assert(slot < Size());
+  return BucketPageIds()[slot];
+}
+
+void HashTableDirectoryPage::SetBucketPageId(uint32_t slot,
+                                             page_id_t bucket_page_id) {
+  assert(slot < Size());
+  BucketPageIds()[slot] = bucket_page_id;
+}
+
+uint32_t HashTableDirectoryPage::GetLocalDepth(uint32_t slot) const {
+  assert(slot < Size());
+  return LocalDepths()[slot];
+}
+
+void HashTableDirectoryPage::SetLocalDepth(uint32_t slot,
+                                           uint32_t local_depth) {
+  assert(slot < Size() && local_depth <= global_depth_);
+  LocalDepths()[slot] = static_cast<uint8_t>(local_depth);
+}
+
+void HashTableDirectoryPage::Grow() {
+  assert(global_depth_ < GetMaxDepth());
+  uint32_t size = Size();
+  memcpy(LocalDepths() + size, LocalDepths(), size * sizeof(uint8_t));
+  memcpy(BucketPageIds() + size, BucketPageIds(), size * sizeof(page_id_t));
+  global_depth_++;
+}
+
+std::string HashTableDirectoryPage::ToString() const {
+  std::stringstream os;
+  os << "[global depth " << global_depth_ << "]";
+  for (uint32_t i = 0; i < Size(); i++)
+    os << " " << i << ":" << BucketPageIds()[i] << "/"
+       << static_cast<int>(LocalDepths()[i]);
+  return os.str();
+}
+
+} // namespace cmudb
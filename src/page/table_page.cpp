@@ -2,6 +2,7 @@
  * header_page.cpp
  */
 
+#include <algorithm>
 #include <cassert>
 
 #include "page/table_page.h"
@@ -27,6 +28,10 @@ page_id_t TablePage::GetPageId() {
   return *reinterpret_cast<page_id_t *>(GetData());
 }
 
+void TablePage::SetPageId(page_id_t page_id) {
+  memcpy(GetData(), &page_id, 4);
+}
+
 page_id_t TablePage::GetPrevPageId() {
   return *reinterpret_cast<page_id_t *>(GetData() + 8);
 }
@@ -340,6 +345,21 @@ bool TablePage::GetNextTupleRid(const RID &cur_rid, RID &next_rid) {
   return false; // End of last tuple
 }
 
+// the vector grows geometrically, a reused vector stops reallocating
+void TablePage::GetTuples(std::vector<Tuple> &tuples, Transaction *txn,
+                          LockManager *lock_manager) {
+  size_t needed = tuples.size() + GetTupleCount();
+  if (tuples.capacity() < needed)
+    tuples.reserve(std::max(needed, 2 * tuples.capacity()));
+  for (int i = 0; i < GetTupleCount(); ++i) {
+    if (GetTupleSize(i) <= 0) // deleted tuple
+      continue;
+    tuples.emplace_back(RID(GetPageId(), i));
+    if (!GetTuple(tuples.back().rid_, tuples.back(), txn, lock_manager))
+      tuples.pop_back();
+  }
+}
+
 /**
  * helper functions
  */
@@ -0,0 +1,306 @@
+/**
+ * bulk_loader.cpp
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <deque>
+#include <fstream>
+#include <future>
+#include <numeric>
+
+#include "common/exception.h"
+#include "table/bulk_loader.h"
+#include "type/limits.h"
+#include "type/type_traits.h"
+
+namespace cmudb {
+
+// the file is read this much at a time, a chunk goes to a worker once cut
+// at its last record boundary
+static const size_t CHUNK_SIZE = 1 << 20;
+
+namespace {
+// end of the last complete record of text, 0 when there is none. A newline
+// in double quotes is part of a field
+size_t RecordBoundary(const std::string &text) {
+  size_t boundary = 0;
+  bool in_quotes = false;
+  for (size_t i = 0; i < text.size(); i++) {
+    if (text[i] == '"')
+      in_quotes = !in_quotes;
+    else if (text[i] == '\n' && !in_quotes)
+      boundary = i + 1;
+  }
+  return boundary;
+}
+} // namespace
+
+size_t BulkLoader::Load(const std::string &file_name, int worker_count) {
+  std::ifstream file(file_name, std::ios::binary);
+  if (!file)
+    throw Exception(EXCEPTION_TYPE_INVALID, "can't open " + file_name);
+  bytes_ = 0;
+  keys_.clear();
+  first_page_id_ = last_page_id_ = INVALID_PAGE_ID;
+  worker_count = std::max(worker_count, 1);
+
+  // the last page of the heap, the pages loaded go after it
+  page_id_t tail_page_id = table_heap_->GetFirstPageId();
+  while (true) {
+    auto page = static_cast<TablePage *>(
+        buffer_pool_manager_->FetchPage(tail_page_id));
+    if (page == nullptr)
+      throw Exception(EXCEPTION_TYPE_INVALID, "out of memory");
+    page_id_t next_page_id = page->GetNextPageId();
+    buffer_pool_manager_->UnpinPage(tail_page_id, false);
+    if (next_page_id == INVALID_PAGE_ID)
+      break;
+    tail_page_id = next_page_id;
+  }
+  last_page_id_ = tail_page_id;
+
+  // chunks are parsed in parallel and written in file order, at most
+  // worker_count of them are in memory
+  std::deque<std::future<Chunk>> chunks;
+  size_t row_count = 0;
+  auto write_oldest = [&]() {
+    Chunk chunk = chunks.front().get();
+    chunks.pop_front();
+    row_count += chunk.row_count;
+    WriteChunk(chunk);
+  };
+  std::string text;
+  std::vector<char> buffer(CHUNK_SIZE);
+  while (file) {
+    file.read(buffer.data(), buffer.size());
+    size_t read = file.gcount();
+    bytes_ += read;
+    text.append(buffer.data(), read);
+    // a record longer than a chunk is read on until it ends
+    size_t boundary = file ? RecordBoundary(text) : text.size();
+    if (boundary == 0)
+      continue;
+    std::string rest = text.substr(boundary);
+    text.resize(boundary);
+    if (static_cast<int>(chunks.size()) == worker_count)
+      write_oldest();
+    chunks.push_back(std::async(std::launch::async, &BulkLoader::ParseChunk,
+                                this, std::move(text)));
+    text = std::move(rest);
+  }
+  while (!chunks.empty())
+    write_oldest();
+
+  // the pages are all on disk, linking the first one makes the rows part of
+  // the table
+  if (first_page_id_ != INVALID_PAGE_ID) {
+    auto page = static_cast<TablePage *>(
+        buffer_pool_manager_->FetchPage(tail_page_id));
+    if (page == nullptr)
+      throw Exception(EXCEPTION_TYPE_INVALID, "out of memory");
+    page->WLatch();
+    page->SetNextPageId(first_page_id_);
+    page->WUnlatch();
+    buffer_pool_manager_->UnpinPage(tail_page_id, true);
+    buffer_pool_manager_->FlushPage(tail_page_id);
+  }
+
+  // an ordered index takes the keys one leaf after the other
+  if (key_schema_ != nullptr) {
+    std::vector<size_t> order(keys_.size());
+    std::iota(order.begin(), order.end(), 0);
+    int column_count = key_schema_->GetColumnCount();
+    std::stable_sort(order.begin(), order.end(), [&](size_t lhs, size_t rhs) {
+      for (int i = 0; i < column_count; i++) {
+        int cmp = CompareRaw(key_schema_->GetType(i),
+                             keys_[lhs].first.GetDataPtr(key_schema_, i),
+                             keys_[rhs].first.GetDataPtr(key_schema_, i));
+        if (cmp != 0)
+          return cmp < 0;
+      }
+      return false;
+    });
+    std::vector<std::pair<Tuple, RID>> sorted;
+    sorted.reserve(keys_.size());
+    for (size_t i : order)
+      sorted.push_back(keys_[i]);
+    keys_.swap(sorted);
+  }
+  return row_count;
+}
+
+/**
+ * helper functions
+ */
+BulkLoader::Chunk BulkLoader::ParseChunk(const std::string &text) {
+  Chunk chunk;
+  int column_count = schema_->GetColumnCount();
+  std::vector<Value> values;
+  std::string field;
+  size_t pos = 0;
+  while (pos < text.size()) {
+    // blank lines hold no record
+    if (text[pos] == '\n' || text.compare(pos, 2, "\r\n") == 0) {
+      pos += text[pos] == '\n' ? 1 : 2;
+      continue;
+    }
+    values.clear();
+    bool end_of_record = false;
+    while (!end_of_record) {
+      field.clear();
+      bool quoted = pos < text.size() && text[pos] == '"';
+      if (quoted) {
+        for (pos++; pos < text.size(); pos++) {
+          if (text[pos] == '"') {
+            if (pos + 1 == text.size() || text[pos + 1] != '"')
+              break;
+            pos++;
+          }
+          field += text[pos];
+        }
+        pos++;
+      }
+      for (; pos < text.size() && text[pos] != ',' && text[pos] != '\n';
+           pos++) {
+        if (text[pos] != '\r')
+          field += text[pos];
+      }
+      end_of_record = pos >= text.size() || text[pos] == '\n';
+      pos++;
+      if (static_cast<int>(values.size()) == column_count)
+        throw Exception(EXCEPTION_TYPE_CONVERSION,
+                        "record has more than " +
+                            std::to_string(column_count) + " fields");
+      values.push_back(ParseField(values.size(), field, quoted));
+    }
+    if (static_cast<int>(values.size()) != column_count)
+      throw Exception(EXCEPTION_TYPE_CONVERSION,
+                      "record has " + std::to_string(values.size()) +
+                          " fields, not " + std::to_string(column_count));
+
+    Tuple tuple(values, schema_);
+    if (tuple.GetLength() + 32 > PAGE_SIZE)
+      throw Exception(EXCEPTION_TYPE_OBJECT_SIZE,
+                      "record does not fit in a table page");
+    // into the last page image, or a new one when it is full
+    RID rid;
+    bool inserted = false;
+    if (chunk.page_count > 0) {
+      Page image(&chunk.pages[(chunk.page_count - 1) * PAGE_SIZE], PAGE_SIZE);
+      inserted = static_cast<TablePage *>(&image)->InsertTuple(
+          tuple, rid, nullptr, nullptr, nullptr);
+    }
+    if (!inserted) {
+      chunk.pages.resize((chunk.page_count + 1) * PAGE_SIZE);
+      Page image(&chunk.pages[chunk.page_count * PAGE_SIZE], PAGE_SIZE);
+      auto page = static_cast<TablePage *>(&image);
+      page->Init(chunk.page_count, PAGE_SIZE, INVALID_PAGE_ID, nullptr,
+                 nullptr);
+      page->InsertTuple(tuple, rid, nullptr, nullptr, nullptr);
+      chunk.page_count++;
+    }
+    chunk.row_count++;
+
+    if (key_schema_ != nullptr) {
+      std::vector<Value> key_values;
+      for (int i : key_attrs_)
+        key_values.push_back(values[i]);
+      chunk.keys.emplace_back(Tuple(key_values, key_schema_), rid);
+    }
+  }
+  return chunk;
+}
+
+Value BulkLoader::ParseField(int column, const std::string &field,
+                             bool quoted) {
+  TypeId type = schema_->GetType(column);
+  const std::string &name = schema_->GetColumnName(column);
+  if (field.empty() && !quoted)
+    return Type::GetNullValue(type);
+  if (schema_->IsDictionary(column))
+    return Value(type, dictionary_->Encode(name, field));
+
+  const char *begin = field.c_str();
+  char *end;
+  errno = 0;
+  switch (type) {
+  case TypeId::VARCHAR:
+    return Value(type, field);
+  case TypeId::DECIMAL: {
+    double d = strtod(begin, &end);
+    if (end == begin || *end != '\0')
+      break;
+    return Value(type, d);
+  }
+  default: {
+    if (type == TypeId::BOOLEAN && (field == "true" || field == "false"))
+      return Value(type, (int32_t)(field == "true"));
+    long long i = strtoll(begin, &end, 10);
+    if (end == begin || *end != '\0')
+      break;
+    int64_t min = PELOTON_INT64_MIN, max = PELOTON_INT64_MAX;
+    switch (type) {
+    case TypeId::BOOLEAN:
+      min = PELOTON_BOOLEAN_MIN, max = PELOTON_BOOLEAN_MAX;
+      break;
+    case TypeId::TINYINT:
+      min = PELOTON_INT8_MIN, max = PELOTON_INT8_MAX;
+      break;
+    case TypeId::SMALLINT:
+      min = PELOTON_INT16_MIN, max = PELOTON_INT16_MAX;
+      break;
+    case TypeId::INTEGER:
+      min = PELOTON_INT32_MIN, max = PELOTON_INT32_MAX;
+      break;
+    default:
+      break;
+    }
+    // the minimum of each type is its NULL
+    if (errno == ERANGE || i < min || i > max)
+      throw Exception(EXCEPTION_TYPE_OUT_OF_RANGE,
+                      field + " is out of range for column " + name);
+    if (type == TypeId::BIGINT)
+      return Value(type, (int64_t)i);
+    return Value(type, (int32_t)i);
+  }
+  }
+  throw Exception(EXCEPTION_TYPE_CONVERSION,
+                  "can't convert " + field + " for column " + name);
+}
+
+void BulkLoader::WriteChunk(Chunk &chunk) {
+  if (chunk.page_count == 0)
+    return;
+  page_id_t first_page_id = disk_manager_->AllocatePages(chunk.page_count);
+  for (int i = 0; i < chunk.page_count; i++) {
+    Page image(&chunk.pages[i * PAGE_SIZE], PAGE_SIZE);
+    auto page = static_cast<TablePage *>(&image);
+    page->SetPageId(first_page_id + i);
+    page->SetPrevPageId(i == 0 ? last_page_id_ : first_page_id + i - 1);
+    page->SetNextPageId(i + 1 < chunk.page_count ? first_page_id + i + 1
+                                                 : INVALID_PAGE_ID);
+  }
+  // the last page of the chunk before now leads to this one, the table
+  // itself is linked once every page is written
+  if (first_page_id_ == INVALID_PAGE_ID) {
+    first_page_id_ = first_page_id;
+  } else {
+    Page image(last_page_.data(), PAGE_SIZE);
+    static_cast<TablePage *>(&image)->SetNextPageId(first_page_id);
+    disk_manager_->WritePage(last_page_id_, last_page_.data());
+  }
+  disk_manager_->WritePages(first_page_id, chunk.pages.data(),
+                            chunk.page_count);
+  last_page_id_ = first_page_id + chunk.page_count - 1;
+  last_page_.assign(chunk.pages.end() - PAGE_SIZE, chunk.pages.end());
+
+  for (auto &key : chunk.keys) {
+    key.second.Set(first_page_id + key.second.GetPageId(),
+                   key.second.GetSlotNum());
+    keys_.push_back(std::move(key));
+  }
+}
+
+} // namespace cmudb
@@ -154,21 +154,44 @@ bool TableHeap::GetTuple(const RID &rid, Tuple &tuple, Transaction *txn) {
   return res;
 }
 
+page_id_t TableHeap::GetPageTuples(page_id_t page_id,
+                                   std::vector<Tuple> &tuples,
+                                   Transaction *txn) {
+  auto page =
+      static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+  if (page == nullptr) {
+    txn->SetState(TransactionState::ABORTED);
+    return INVALID_PAGE_ID;
+  }
+  page->RLatch();
+  page->GetTuples(tuples, txn, lock_manager_);
+  page_id_t next_page_id = page->GetNextPageId();
+  page->RUnlatch();
+  buffer_pool_manager_->UnpinPage(page_id, false);
+  return next_page_id;
+}
+
 bool TableHeap::DeleteTableHeap() {
   // todo: real delete
   return true;
 }
 
 TableIterator TableHeap::begin(Transaction *txn) {
-  auto page =
-      static_cast<TablePage *>(buffer_pool_manager_->FetchPage(first_page_id_));
-  page->RLatch();
   RID rid;
   // if failed (no tuple), rid will be the result of default
-  // constructor, which means eof
-  page->GetFirstTupleRid(rid);
-  page->RUnlatch();
-  buffer_pool_manager_->UnpinPage(first_page_id_, false);
+  // constructor, which means eof. Pages without a tuple are skipped, e.g.
+  // the first page of a table that was empty before a bulk load
+  page_id_t page_id = first_page_id_;
+  while (page_id != INVALID_PAGE_ID) {
+    auto page =
+        static_cast<TablePage *>(buffer_pool_manager_->FetchPage(page_id));
+    page->RLatch();
+    bool found = page->GetFirstTupleRid(rid);
+    page_id_t next_page_id = page->GetNextPageId();
+    page->RUnlatch();
+    buffer_pool_manager_->UnpinPage(page_id, false);
+    page_id = found ? INVALID_PAGE_ID : next_page_id;
+  }
   return TableIterator(this, rid, txn);
 }
 
@@ -11,13 +11,68 @@
 
 namespace cmudb {
 
+namespace {
+// the value of an integer column, as int64_t
+inline int64_t IntegerOf(const Value &value) {
+  switch (value.GetTypeId()) {
+  case TypeId::BOOLEAN:
+  case TypeId::TINYINT:
+    return value.GetAs<int8_t>();
+  case TypeId::SMALLINT:
+    return value.GetAs<int16_t>();
+  case TypeId::INTEGER:
+    return value.GetAs<int32_t>();
+  default:
+    return value.GetAs<int64_t>();
+  }
+}
+
+// zigzag maps values of small magnitude, of either sign, to small unsigned
+// ones: 0, -1, 1, -2, ... to 0, 1, 2, 3, ...
+inline uint64_t ZigZag(int64_t value) {
+  return (static_cast<uint64_t>(value) << 1) ^
+         static_cast<uint64_t>(value >> 63);
+}
+
+inline int64_t UnZigZag(uint64_t value) {
+  return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+inline int32_t VarintLength(uint64_t value) {
+  int32_t length = 1;
+  for (; value >= 0x80; value >>= 7)
+    length++;
+  return length;
+}
+
+// write value at storage, return its length
+inline int32_t EncodeVarint(uint64_t value, char *storage) {
+  int32_t length = 0;
+  for (; value >= 0x80; value >>= 7)
+    storage[length++] = static_cast<char>(value | 0x80);
+  storage[length++] = static_cast<char>(value);
+  return length;
+}
+} // namespace
+
 Tuple::Tuple(std::vector<Value> values, Schema *schema) : allocated_(true) {
   assert((int)values.size() == schema->GetColumnCount());
+  bool null_bitmap = schema->HasNullBitmap();
 
   // step1: calculate size of the tuple
   int32_t tuple_size = schema->GetLength();
+  // a NULL varint is stored as 0, the null bitmap tells it apart
+  std::vector<uint64_t> varints;
+  for (auto &i : schema->GetVarintColumns()) {
+    varints.push_back(null_bitmap && values[i].IsNull()
+                          ? 0
+                          : ZigZag(IntegerOf(values[i])));
+    tuple_size += VarintLength(varints.back());
+  }
+  // a NULL VARCHAR is its length alone
   for (auto &i : schema->GetUnlinedColumns())
-    tuple_size += (values[i].GetLength() + sizeof(uint32_t));
+    tuple_size += (values[i].IsNull() ? 0 : values[i].GetLength()) +
+                  sizeof(uint32_t);
   // allocate memory using new, allocated_ flag set as true
   size_ = tuple_size;
   data_ = new char[size_];
@@ -25,13 +80,22 @@ Tuple::Tuple(std::vector<Value> values, Schema *schema) : allocated_(true) {
   // step2: Serialize each column(attribute) based on input value
   int column_count = schema->GetColumnCount();
   int32_t offset = schema->GetLength();
+  for (auto varint : varints)
+    offset += EncodeVarint(varint, data_ + offset);
+  if (null_bitmap)
+    memset(data_ + schema->GetNullBitmapOffset(), 0, (column_count + 7) / 8);
   for (int i = 0; i < column_count; i++) {
-    if (!schema->IsInlined(i)) {
+    if (null_bitmap && values[i].IsNull())
+      data_[schema->GetNullBitmapOffset() + i / 8] |= 1 << (i % 8);
+    if (schema->IsVarint(i)) {
+      continue;
+    } else if (!schema->IsInlined(i)) {
       // Serialize relative offset, where the actual varchar data is stored
       *reinterpret_cast<int32_t *>(data_ + schema->GetOffset(i)) = offset;
       // Serialize varchar value, in place(size+data)
       values[i].SerializeTo(data_ + offset);
-      offset += (values[i].GetLength() + sizeof(uint32_t));
+      offset += (values[i].IsNull() ? 0 : values[i].GetLength()) +
+                sizeof(uint32_t);
     } else {
       values[i].SerializeTo(data_ + schema->GetOffset(i));
     }
@@ -74,25 +138,66 @@ Value Tuple::GetValue(Schema *schema, const int column_id) const {
   assert(schema);
   assert(data_);
   const TypeId column_type = schema->GetType(column_id);
+  if (schema->IsVarint(column_id)) {
+    bool is_null = schema->HasNullBitmap() && IsNull(schema, column_id);
+    switch (column_type) {
+    case TypeId::SMALLINT:
+      return Value(column_type, is_null ? PELOTON_INT16_NULL
+                                        : Get<int16_t>(schema, column_id));
+    case TypeId::INTEGER:
+      return Value(column_type, is_null ? PELOTON_INT32_NULL
+                                        : Get<int32_t>(schema, column_id));
+    default:
+      return Value(column_type, is_null ? PELOTON_INT64_NULL
+                                        : Get<int64_t>(schema, column_id));
+    }
+  }
   const char *data_ptr = GetDataPtr(schema, column_id);
   // the third parameter "is_inlined" is unused
   return Value::DeserializeFrom(data_ptr, column_type);
 }
 
-const char *Tuple::GetDataPtr(Schema *schema, const int column_id) const {
-  assert(schema);
-  assert(data_);
-  bool is_inlined = schema->IsInlined(column_id);
-  // for inline type, data are stored where they are
-  if (is_inlined)
-    return (data_ + schema->GetOffset(column_id));
-  else {
-    // step1: read relative offset from tuple data
-    int32_t offset =
-        *reinterpret_cast<int32_t *>(data_ + schema->GetOffset(column_id));
-    // step 2: return beginning address of the real data for VARCHAR type
-    return (data_ + offset);
+bool Tuple::IsNullSentinel(Schema *schema, const int column_id) const {
+  switch (schema->GetType(column_id)) {
+  case TypeId::BOOLEAN:
+    return Get<int8_t>(schema, column_id) == PELOTON_BOOLEAN_NULL;
+  case TypeId::TINYINT:
+    return Get<int8_t>(schema, column_id) == PELOTON_INT8_NULL;
+  case TypeId::SMALLINT:
+    return Get<int16_t>(schema, column_id) == PELOTON_INT16_NULL;
+  case TypeId::INTEGER:
+    return Get<int32_t>(schema, column_id) == PELOTON_INT32_NULL;
+  case TypeId::BIGINT:
+    return Get<int64_t>(schema, column_id) == PELOTON_INT64_NULL;
+  case TypeId::DECIMAL:
+    return Get<double>(schema, column_id) == PELOTON_DECIMAL_NULL;
+  case TypeId::TIMESTAMP:
+    return Get<uint64_t>(schema, column_id) == PELOTON_TIMESTAMP_NULL;
+  case TypeId::VARCHAR: {
+    uint32_t length;
+    memcpy(&length, GetDataPtr(schema, column_id), sizeof(uint32_t));
+    return length == PELOTON_VALUE_NULL;
+  }
+  default:
+    return true;
+  }
+}
+
+int64_t Tuple::GetVarint(Schema *schema, const int column_id) const {
+  const uint8_t *data_ptr =
+      reinterpret_cast<const uint8_t *>(data_ + schema->GetLength());
+  // skip the varint columns stored before this one
+  for (int i = schema->GetVarintOrdinal(column_id); i > 0; i--) {
+    while (*data_ptr++ & 0x80) {
+    }
   }
+  uint64_t value = 0;
+  int shift = 0;
+  do {
+    value |= static_cast<uint64_t>(*data_ptr & 0x7f) << shift;
+    shift += 7;
+  } while (*data_ptr++ & 0x80);
+  return UnZigZag(value);
 }
 
 std::string Tuple::ToString(Schema *schema) const {
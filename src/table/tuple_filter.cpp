@@ -0,0 +1,190 @@
+/**
+ * tuple_filter.cpp
+ */
+
+#include <cstring>
+
+#include "table/tuple_filter.h"
+
+namespace cmudb {
+
+namespace {
+inline bool IsIntegral(TypeId type) {
+  return type == TypeId::BOOLEAN || type == TypeId::TINYINT ||
+         type == TypeId::SMALLINT || type == TypeId::INTEGER ||
+         type == TypeId::BIGINT;
+}
+
+// the column of every tuple read as T, the type it is stored as, widened to
+// U. One loop per stored type
+template <typename T, typename U>
+void Gather(const std::vector<Tuple> &tuples, Schema *schema, int column,
+            std::vector<U> &values) {
+  values.resize(tuples.size());
+  for (size_t i = 0; i < tuples.size(); i++)
+    values[i] = tuples[i].Get<T>(schema, column);
+}
+
+template <typename U>
+void GatherNumeric(const std::vector<Tuple> &tuples, Schema *schema,
+                   int column, std::vector<U> &values) {
+  switch (schema->GetType(column)) {
+  case TypeId::BOOLEAN:
+  case TypeId::TINYINT:
+    Gather<int8_t>(tuples, schema, column, values);
+    break;
+  case TypeId::SMALLINT:
+    Gather<int16_t>(tuples, schema, column, values);
+    break;
+  case TypeId::INTEGER:
+    Gather<int32_t>(tuples, schema, column, values);
+    break;
+  case TypeId::BIGINT:
+    Gather<int64_t>(tuples, schema, column, values);
+    break;
+  default:
+    Gather<double>(tuples, schema, column, values);
+  }
+}
+
+inline int64_t BigintOf(const Value &value) {
+  switch (value.GetTypeId()) {
+  case TypeId::BOOLEAN:
+  case TypeId::TINYINT:
+    return value.GetAs<int8_t>();
+  case TypeId::SMALLINT:
+    return value.GetAs<int16_t>();
+  case TypeId::INTEGER:
+    return value.GetAs<int32_t>();
+  default:
+    return value.GetAs<int64_t>();
+  }
+}
+
+// narrow match by values[i] op constant. One loop per op without branches
+// in the body, the compiler turns each into vector compares
+template <typename T>
+void Match(FilterOp op, const T *values, T constant, size_t n,
+           uint8_t *match) {
+  switch (op) {
+  case FilterOp::EQ:
+    for (size_t i = 0; i < n; i++)
+      match[i] &= values[i] == constant;
+    break;
+  case FilterOp::LT:
+    for (size_t i = 0; i < n; i++)
+      match[i] &= values[i] < constant;
+    break;
+  case FilterOp::LE:
+    for (size_t i = 0; i < n; i++)
+      match[i] &= values[i] <= constant;
+    break;
+  case FilterOp::GT:
+    for (size_t i = 0; i < n; i++)
+      match[i] &= values[i] > constant;
+    break;
+  case FilterOp::GE:
+    for (size_t i = 0; i < n; i++)
+      match[i] &= values[i] >= constant;
+    break;
+  }
+}
+} // namespace
+
+bool TupleFilter::AddPredicate(int column, FilterOp op,
+                               const Value &constant) {
+  TypeId column_type = schema_->GetType(column);
+  TypeId constant_type = constant.GetTypeId();
+  Predicate predicate;
+  predicate.column = column;
+  predicate.op = op;
+  if (IsIntegral(column_type) && IsIntegral(constant_type)) {
+    predicate.compare_type = TypeId::BIGINT;
+    predicate.bigint_constant = BigintOf(constant);
+  } else if ((IsIntegral(column_type) || column_type == TypeId::DECIMAL) &&
+             (IsIntegral(constant_type) || constant_type == TypeId::DECIMAL)) {
+    predicate.compare_type = TypeId::DECIMAL;
+    predicate.decimal_constant = constant_type == TypeId::DECIMAL
+                                     ? constant.GetAs<double>()
+                                     : (double)BigintOf(constant);
+  } else if (column_type == TypeId::VARCHAR &&
+             constant_type == TypeId::VARCHAR) {
+    predicate.compare_type = TypeId::VARCHAR;
+    predicate.varchar_constant = constant.GetData();
+  } else {
+    return false;
+  }
+  predicates_.push_back(predicate);
+  return true;
+}
+
+void TupleFilter::Select(const std::vector<Tuple> &tuples,
+                         std::vector<int> &selection) {
+  selection.clear();
+  if (empty_)
+    return;
+  size_t n = tuples.size();
+  match_.assign(n, 1);
+  for (auto &predicate : predicates_) {
+    MatchNotNull(tuples, predicate.column);
+    switch (predicate.compare_type) {
+    case TypeId::BIGINT:
+      GatherNumeric(tuples, schema_, predicate.column, bigints_);
+      Match(predicate.op, bigints_.data(), predicate.bigint_constant, n,
+            match_.data());
+      break;
+    case TypeId::DECIMAL:
+      GatherNumeric(tuples, schema_, predicate.column, decimals_);
+      Match(predicate.op, decimals_.data(), predicate.decimal_constant, n,
+            match_.data());
+      break;
+    default:
+      MatchVarchar(tuples, predicate);
+    }
+  }
+  for (size_t i = 0; i < n; i++) {
+    if (match_[i])
+      selection.push_back(i);
+  }
+}
+
+/**
+ * helper functions
+ */
+// a comparison with NULL holds for no row
+void TupleFilter::MatchNotNull(const std::vector<Tuple> &tuples, int column) {
+  for (size_t i = 0; i < tuples.size(); i++)
+    match_[i] &= !tuples[i].IsNull(schema_, column);
+}
+
+// the characters are null terminated and NULLs are already out, strcmp
+// orders them as memcmp does
+void TupleFilter::MatchVarchar(const std::vector<Tuple> &tuples,
+                               const Predicate &predicate) {
+  const char *constant = predicate.varchar_constant.c_str();
+  for (size_t i = 0; i < tuples.size(); i++) {
+    if (!match_[i])
+      continue;
+    const char *value = tuples[i].Get<const char *>(schema_, predicate.column);
+    int cmp = strcmp(value, constant);
+    switch (predicate.op) {
+    case FilterOp::EQ:
+      match_[i] = cmp == 0;
+      break;
+    case FilterOp::LT:
+      match_[i] = cmp < 0;
+      break;
+    case FilterOp::LE:
+      match_[i] = cmp <= 0;
+      break;
+    case FilterOp::GT:
+      match_[i] = cmp > 0;
+      break;
+    case FilterOp::GE:
+      match_[i] = cmp >= 0;
+      break;
+    }
+  }
+}
+
+} // namespace cmudb
@@ -164,6 +164,30 @@ Value Type::GetMaxValue(TypeId type_id) {
   throw Exception(EXCEPTION_TYPE_MISMATCH_TYPE, "Cannot get max value.");
 }
 
+Value Type::GetNullValue(TypeId type_id) {
+  switch (type_id) {
+  case BOOLEAN:
+    return Value(type_id, PELOTON_BOOLEAN_NULL);
+  case TINYINT:
+    return Value(type_id, PELOTON_INT8_NULL);
+  case SMALLINT:
+    return Value(type_id, PELOTON_INT16_NULL);
+  case INTEGER:
+    return Value(type_id, PELOTON_INT32_NULL);
+  case BIGINT:
+    return Value(type_id, PELOTON_INT64_NULL);
+  case DECIMAL:
+    return Value(type_id, PELOTON_DECIMAL_NULL);
+  case TIMESTAMP:
+    return Value(type_id, PELOTON_TIMESTAMP_NULL);
+  case VARCHAR:
+    return Value(type_id, nullptr, PELOTON_VALUE_NULL, false);
+  default:
+    break;
+  }
+  throw Exception(EXCEPTION_TYPE_MISMATCH_TYPE, "Cannot get null value.");
+}
+
 CmpBool Type::CompareEquals(const Value &left __attribute__((unused)),
                             const Value &right __attribute__((unused))) const {
   throw NotImplementedException("CompareEquals not implemented");
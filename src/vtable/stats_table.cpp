@@ -0,0 +1,205 @@
+/**
+ * stats_table.cpp
+ */
+#include <cstring>
+#include <new>
+
+#include "common/latch_profiler.h"
+#include "common/metrics.h"
+#include "common/trace.h"
+#include "vtable/stats_table.h"
+
+namespace cmudb {
+
+// sqlite3_api is defined by virtual_table.cpp
+SQLITE_EXTENSION_INIT3
+
+namespace {
+
+enum StatsColumn { NAME = 0, VALUE, SUM, P50, P99, P999 };
+
+struct StatsCursor {
+  sqlite3_vtab_cursor base;
+  // metrics are merged once, when the scan starts
+  MetricsSnapshot snapshot;
+  int row = 0;
+};
+
+const int kStatsRows = NUM_COUNTERS + NUM_HISTOGRAMS;
+
+int StatsConnect(sqlite3 *db, void *pAux, int argc, const char *const *argv,
+                 sqlite3_vtab **ppVtab, char **pzErr) {
+  int rc = sqlite3_declare_vtab(db, "CREATE TABLE X(name TEXT, value INTEGER, "
+                                    "sum INTEGER, p50 INTEGER, p99 INTEGER, "
+                                    "p999 INTEGER)");
+  if (rc != SQLITE_OK)
+    return rc;
+  *ppVtab = static_cast<sqlite3_vtab *>(sqlite3_malloc(sizeof(sqlite3_vtab)));
+  if (*ppVtab == nullptr)
+    return SQLITE_NOMEM;
+  memset(*ppVtab, 0, sizeof(sqlite3_vtab));
+  return SQLITE_OK;
+}
+
+int StatsDisconnect(sqlite3_vtab *pVtab) {
+  sqlite3_free(pVtab);
+  return SQLITE_OK;
+}
+
+int StatsBestIndex(sqlite3_vtab *tab, sqlite3_index_info *pIdxInfo) {
+  pIdxInfo->estimatedCost = kStatsRows;
+  return SQLITE_OK;
+}
+
+int StatsOpen(sqlite3_vtab *pVtab, sqlite3_vtab_cursor **ppCursor) {
+  StatsCursor *cursor = new (std::nothrow) StatsCursor;
+  if (cursor == nullptr)
+    return SQLITE_NOMEM;
+  *ppCursor = &cursor->base;
+  return SQLITE_OK;
+}
+
+int StatsClose(sqlite3_vtab_cursor *cur) {
+  delete reinterpret_cast<StatsCursor *>(cur);
+  return SQLITE_OK;
+}
+
+int StatsFilter(sqlite3_vtab_cursor *cur, int idxNum, const char *idxStr,
+                int argc, sqlite3_value **argv) {
+  StatsCursor *cursor = reinterpret_cast<StatsCursor *>(cur);
+  cursor->snapshot = Metrics::Snapshot();
+  cursor->row = 0;
+  return SQLITE_OK;
+}
+
+int StatsNext(sqlite3_vtab_cursor *cur) {
+  reinterpret_cast<StatsCursor *>(cur)->row++;
+  return SQLITE_OK;
+}
+
+int StatsEof(sqlite3_vtab_cursor *cur) {
+  return reinterpret_cast<StatsCursor *>(cur)->row >= kStatsRows;
+}
+
+int StatsColumn(sqlite3_vtab_cursor *cur, sqlite3_context *ctx, int i) {
+  StatsCursor *cursor = reinterpret_cast<StatsCursor *>(cur);
+  // counters first, then histograms
+  if (cursor->row < NUM_COUNTERS) {
+    MetricCounter id = static_cast<MetricCounter>(cursor->row);
+    if (i == NAME)
+      sqlite3_result_text(ctx, Metrics::Name(id), -1, SQLITE_STATIC);
+    else if (i == VALUE)
+      sqlite3_result_int64(ctx, cursor->snapshot.Get(id));
+    else
+      sqlite3_result_null(ctx);
+    return SQLITE_OK;
+  }
+  MetricHistogram id = static_cast<MetricHistogram>(cursor->row - NUM_COUNTERS);
+  const HistogramSnapshot &histogram = cursor->snapshot.Get(id);
+  switch (i) {
+  case NAME:
+    sqlite3_result_text(ctx, Metrics::Name(id), -1, SQLITE_STATIC);
+    break;
+  case VALUE:
+    sqlite3_result_int64(ctx, histogram.count);
+    break;
+  case SUM:
+    sqlite3_result_int64(ctx, histogram.sum);
+    break;
+  case P50:
+    sqlite3_result_int64(ctx, histogram.Percentile(50));
+    break;
+  case P99:
+    sqlite3_result_int64(ctx, histogram.Percentile(99));
+    break;
+  case P999:
+    sqlite3_result_int64(ctx, histogram.Percentile(99.9));
+    break;
+  default:
+    return SQLITE_ERROR;
+  }
+  return SQLITE_OK;
+}
+
+int StatsRowid(sqlite3_vtab_cursor *cur, sqlite3_int64 *pRowid) {
+  *pRowid = reinterpret_cast<StatsCursor *>(cur)->row;
+  return SQLITE_OK;
+}
+
+sqlite3_module StatsModule = {
+    0,               /* iVersion */
+    0,               /* xCreate - eponymous only */
+    StatsConnect,    /* xConnect */
+    StatsBestIndex,  /* xBestIndex */
+    StatsDisconnect, /* xDisconnect */
+    0,               /* xDestroy */
+    StatsOpen,       /* xOpen - open a cursor */
+    StatsClose,      /* xClose - close a cursor */
+    StatsFilter,     /* xFilter - configure scan constraints */
+    StatsNext,       /* xNext - advance a cursor */
+    StatsEof,        /* xEof - check for end of scan */
+    StatsColumn,     /* xColumn - read data */
+    StatsRowid,      /* xRowid - read data */
+    0,               /* xUpdate - read only */
+    0,               /* xBegin */
+    0,               /* xSync */
+    0,               /* xCommit */
+    0,               /* xRollback */
+    0,               /* xFindMethod */
+    0,               /* xRename */
+    0,               /* xSavepoint */
+    0,               /* xRelease */
+    0,               /* xRollbackTo */
+};
+
+// SELECT vtable_latch_profile(); one line per latch class
+void LatchProfileFunc(sqlite3_context *context, int argc,
+                      sqlite3_value **argv) {
+  std::string dump = LatchProfiler::Dump();
+  sqlite3_result_text(context, dump.c_str(), dump.size(), SQLITE_TRANSIENT);
+}
+
+/*
+ * SELECT vtable_trace('start'), vtable_trace('stop'),
+ * vtable_trace('dump', 'trace.json') returns the number of events written
+ */
+void TraceFunc(sqlite3_context *context, int argc, sqlite3_value **argv) {
+  const char *command =
+      reinterpret_cast<const char *>(sqlite3_value_text(argv[0]));
+  if (command != nullptr && strcmp(command, "start") == 0 && argc == 1) {
+    Trace::Start();
+    sqlite3_result_int(context, 1);
+  } else if (command != nullptr && strcmp(command, "stop") == 0 &&
+             argc == 1) {
+    Trace::Stop();
+    sqlite3_result_int(context, 0);
+  } else if (command != nullptr && strcmp(command, "dump") == 0 &&
+             argc == 2) {
+    const char *path =
+        reinterpret_cast<const char *>(sqlite3_value_text(argv[1]));
+    int64_t events = path == nullptr ? -1 : Trace::WriteChromeJson(path);
+    if (events < 0)
+      sqlite3_result_error(context, "vtable_trace: can't write the trace", -1);
+    else
+      sqlite3_result_int64(context, events);
+  } else {
+    sqlite3_result_error(context,
+                         "usage: vtable_trace('start' | 'stop' | 'dump', path)",
+                         -1);
+  }
+}
+
+} // namespace
+
+int RegisterStatsModule(sqlite3 *db) {
+  int rc = sqlite3_create_module(db, "vtable_stats", &StatsModule, nullptr);
+  if (rc == SQLITE_OK)
+    rc = sqlite3_create_function(db, "vtable_latch_profile", 0, SQLITE_UTF8,
+                                 nullptr, LatchProfileFunc, nullptr, nullptr);
+  if (rc == SQLITE_OK)
+    rc = sqlite3_create_function(db, "vtable_trace", -1, SQLITE_UTF8, nullptr,
+                                 TraceFunc, nullptr, nullptr);
+  return rc;
+}
+
+} // namespace cmudb
@@ -4,13 +4,16 @@
 #include <algorithm>
 #include <cstring>
 #include <iostream>
+#include <sstream>
 #include <sys/stat.h>
+#include <thread>
 #include <vector>
 
 #include "common/exception.h"
 #include "common/logger.h"
 #include "common/string_utility.h"
 #include "page/header_page.h"
+#include "vtable/stats_table.h"
 #include "vtable/virtual_table.h"
 
 namespace cmudb {
@@ -25,15 +28,14 @@ int VtabCreate(sqlite3 *db, void *pAux, int argc, const char *const *argv,
   LockManager *lock_manager = storage_engine_->lock_manager_;
   LogManager *log_manager = storage_engine_->log_manager_;
 
-  // fetch header page from buffer pool
-  HeaderPage *header_page =
-      static_cast<HeaderPage *>(buffer_pool_manager->FetchPage(HEADER_PAGE_ID));
-
   // the first three parameter:(1) module name (2) database name (3)table name
   assert(argc >= 4);
+  CatalogEntry entry;
+  entry.name = argv[2];
   // parse arg[3](string that defines table schema)
   std::string schema_string(argv[3]);
   schema_string = schema_string.substr(1, (schema_string.size() - 2));
+  entry.schema = schema_string;
   Schema *schema = ParseCreateStatement(schema_string);
 
   // parse arg[4](string that defines table index)
@@ -41,23 +43,32 @@ int VtabCreate(sqlite3 *db, void *pAux, int argc, const char *const *argv,
   if (argc > 4) {
     std::string index_string(argv[4]);
     index_string = index_string.substr(1, (index_string.size() - 2));
+    entry.index = index_string;
     // create index object, allocate memory space
     IndexMetadata *index_metadata =
         ParseIndexStatement(index_string, std::string(argv[2]), schema);
-    index = ConstructIndex(index_metadata, buffer_pool_manager);
+    index = ConstructIndex(index_metadata,
+                           storage_engine_->index_buffer_pool_manager_);
   }
   // create table object, allocate memory space
   VirtualTable *table = new VirtualTable(schema, buffer_pool_manager,
                                          lock_manager, log_manager, index);
+  // a snapshot left by an older table of the same name
+  if (table->IsIndexInMemory())
+    remove(table->GetIndexSnapshotName().c_str());
 
-  // insert table root page info into header page
-  header_page->InsertRecord(std::string(argv[2]), table->GetFirstPageId());
-  buffer_pool_manager->UnpinPage(HEADER_PAGE_ID, true);
+  // record the table in the catalog, over a stale entry of the same name
+  entry.first_page_id = table->GetFirstPageId();
+  table->GetCatalogEntry() = entry;
+  table->OpenDictionary();
+  if (!storage_engine_->catalog_->CreateEntry(table->GetCatalogEntry()))
+    storage_engine_->catalog_->UpdateEntry(table->GetCatalogEntry());
 
   // register virtual table within sqlite system
   schema_string = "CREATE TABLE X(" + schema_string + ");";
   assert(sqlite3_declare_vtab(db, schema_string.c_str()) == SQLITE_OK);
 
+  storage_engine_->tables_[argv[2]] = table;
   *ppVtab = reinterpret_cast<sqlite3_vtab *>(table);
   return SQLITE_OK;
 }
@@ -76,11 +87,32 @@ int VtabConnect(sqlite3 *db, void *pAux, int argc, const char *const *argv,
   LockManager *lock_manager = storage_engine_->lock_manager_;
   LogManager *log_manager = storage_engine_->log_manager_;
 
-  // Retrieve table root page info from header page
-  HeaderPage *header_page =
-      static_cast<HeaderPage *>(buffer_pool_manager->FetchPage(HEADER_PAGE_ID));
-  page_id_t table_root_id;
-  header_page->GetRootId(std::string(argv[2]), table_root_id);
+  // Retrieve table root page info from the catalog, tables created before
+  // the catalog are only recorded in the header page, with the old layout
+  CatalogEntry entry;
+  if (!storage_engine_->catalog_->GetEntry(argv[2], entry)) {
+    HeaderPage *header_page = static_cast<HeaderPage *>(
+        buffer_pool_manager->FetchPage(HEADER_PAGE_ID));
+    entry.name = argv[2];
+    entry.schema = schema_string;
+    if (argc > 4) {
+      entry.index = argv[4];
+      entry.index = entry.index.substr(1, entry.index.size() - 2);
+    }
+    if (header_page->GetRootId(entry.name, entry.first_page_id))
+      entry.layout_version = 0;
+    buffer_pool_manager->UnpinPage(HEADER_PAGE_ID, false);
+    storage_engine_->catalog_->CreateEntry(entry);
+  }
+  // rows of another layout would be misread, the table has to be recreated
+  if (entry.layout_version != TUPLE_LAYOUT_VERSION) {
+    delete schema;
+    *pzErr = sqlite3_mprintf("table %s was written with tuple layout %d, "
+                             "this build reads layout %d, recreate it",
+                             argv[2], entry.layout_version,
+                             TUPLE_LAYOUT_VERSION);
+    return SQLITE_ERROR;
+  }
   // parse arg[4](string that defines table index)
   Index *index = nullptr;
   if (argc > 4) {
@@ -89,39 +121,83 @@ int VtabConnect(sqlite3 *db, void *pAux, int argc, const char *const *argv,
     // create index object, allocate memory space
     IndexMetadata *index_metadata =
         ParseIndexStatement(index_string, std::string(argv[2]), schema);
-    // Retrieve index root page info from header page
-    page_id_t index_root_id;
-    header_page->GetRootId(index_metadata->GetName(), index_root_id);
-    index = ConstructIndex(index_metadata, buffer_pool_manager, index_root_id);
+    // Retrieve index root page info from the header page of the index
+    // segment, an empty B+ tree has no record yet
+    BufferPoolManager *index_buffer_pool_manager =
+        storage_engine_->index_buffer_pool_manager_;
+    HeaderPage *index_header_page = static_cast<HeaderPage *>(
+        index_buffer_pool_manager->FetchPage(HEADER_PAGE_ID));
+    page_id_t index_root_id = INVALID_PAGE_ID;
+    index_header_page->GetRootId(index_metadata->GetName(), index_root_id);
+    index_buffer_pool_manager->UnpinPage(HEADER_PAGE_ID, false);
+    index = ConstructIndex(index_metadata, index_buffer_pool_manager,
+                           index_root_id);
   }
   VirtualTable *table =
       new VirtualTable(schema, buffer_pool_manager, lock_manager, log_manager,
-                       index, table_root_id);
+                       index, entry.first_page_id);
+  table->GetCatalogEntry() = entry;
+  table->OpenDictionary();
+  table->LoadIndex();
 
   // register virtual table within sqlite system
   schema_string = "CREATE TABLE X(" + schema_string + ");";
   assert(sqlite3_declare_vtab(db, schema_string.c_str()) == SQLITE_OK);
 
+  storage_engine_->tables_[argv[2]] = table;
   *ppVtab = reinterpret_cast<sqlite3_vtab *>(table);
-  buffer_pool_manager->UnpinPage(HEADER_PAGE_ID, false);
   return SQLITE_OK;
 }
 
+// idxNum flag, set next to the scan kind when only key columns are read
+static const int INDEX_ONLY_SCAN = 4;
+// idxNum of a sequential scan that evaluates the constraints itself
+static const int FILTER_SCAN = 8;
+
 /*
  * we only support
  * (1) equlity check. e.g select * from foo where a = 1
  * (2) indexed column == predicated column
+ * (3) ORDER BY the indexed columns, on a B+ tree
+ * either can be index-only when no other column is read
  */
-int VtabBestIndex(sqlite3_vtab *tab, sqlite3_index_info *pIdxInfo) {
-  // LOG_DEBUG("VtabBestIndex");
-  VirtualTable *table = reinterpret_cast<VirtualTable *>(tab);
+static void PlanIndexScan(VirtualTable *table, sqlite3_index_info *pIdxInfo) {
   if (table->GetIndex() == nullptr)
-    return SQLITE_OK;
+    return;
   const std::vector<int> key_attrs = table->GetIndex()->GetKeyAttrs();
+  // the statement reads only key columns, index scans can skip the table
+  // heap. Bit 63 stands for every column from the 63rd on, a key never
+  // covers all of them
+  sqlite3_uint64 key_columns = 0;
+  for (int attr : key_attrs) {
+    if (attr < 63)
+      key_columns |= (sqlite3_uint64)1 << attr;
+  }
+  bool covered = (pIdxInfo->colUsed & ~key_columns) == 0;
+  // ORDER BY the index key, in either direction, walks a tree index instead
+  // of sorting a full scan
+  if (table->GetIndex()->GetIndexType() == IndexType::BPLUS_TREE &&
+      pIdxInfo->nOrderBy == (int)(key_attrs.size())) {
+    bool ordered = true;
+    // codes of an encoded column are not in the order of their values
+    for (int i = 0; i < pIdxInfo->nOrderBy; i++) {
+      if (pIdxInfo->aOrderBy[i].iColumn != key_attrs[i] ||
+          pIdxInfo->aOrderBy[i].desc != pIdxInfo->aOrderBy[0].desc ||
+          table->GetSchema()->IsDictionary(key_attrs[i]))
+        ordered = false;
+    }
+    if (ordered) {
+      pIdxInfo->idxNum = (pIdxInfo->aOrderBy[0].desc ? 3 : 2) |
+                         (covered ? INDEX_ONLY_SCAN : 0);
+      pIdxInfo->orderByConsumed = 1;
+      // a little over a full scan when the table heap is read in key order
+      pIdxInfo->estimatedCost = covered ? 5e5 : 1.5e6;
+    }
+  }
   // make sure indexed column == predicate column
   // e.g select * from foo where a = 1 and b =2; indexed column must be {a,b}
   if (pIdxInfo->nConstraint != (int)(key_attrs.size()))
-    return SQLITE_OK;
+    return;
 
   int counter = 0;
   bool is_index_scan = true;
@@ -143,16 +219,108 @@ int VtabBestIndex(sqlite3_vtab *tab, sqlite3_index_info *pIdxInfo) {
   }
 
   if (counter == (int)key_attrs.size() && is_index_scan) {
-    pIdxInfo->idxNum = 1;
+    pIdxInfo->idxNum = 1 | (covered ? INDEX_ONLY_SCAN : 0);
+    // unique key, a hash probe reads two pages, a tree probe one per level
+    // and an art probe none
+    switch (table->GetIndex()->GetIndexType()) {
+    case IndexType::ART:
+      pIdxInfo->estimatedCost = 1.0;
+      break;
+    case IndexType::HASH:
+      pIdxInfo->estimatedCost = 2.0;
+      break;
+    default:
+      pIdxInfo->estimatedCost = 4.0;
+    }
+    pIdxInfo->estimatedRows = 1;
+    pIdxInfo->idxFlags = SQLITE_INDEX_SCAN_UNIQUE;
+  }
+}
+
+/*
+ * a sequential scan takes every usable =, <, <=, >, >= constraint on any
+ * column (BETWEEN arrives as >= and <=). idxStr lists "column:op" of each
+ * argv, sqlite still checks the rows handed out, since a constant that does
+ * not compare in place is left to it (see TupleFilter::AddPredicate)
+ */
+static void PlanFilterScan(sqlite3_index_info *pIdxInfo) {
+  std::string plan;
+  int argc = 0;
+  for (int i = 0; i < pIdxInfo->nConstraint; i++) {
+    pIdxInfo->aConstraintUsage[i].argvIndex = 0;
+    auto &constraint = pIdxInfo->aConstraint[i];
+    if (constraint.usable == 0 || constraint.iColumn < 0)
+      continue;
+    switch (constraint.op) {
+    case SQLITE_INDEX_CONSTRAINT_EQ:
+    case SQLITE_INDEX_CONSTRAINT_LT:
+    case SQLITE_INDEX_CONSTRAINT_LE:
+    case SQLITE_INDEX_CONSTRAINT_GT:
+    case SQLITE_INDEX_CONSTRAINT_GE:
+      pIdxInfo->aConstraintUsage[i].argvIndex = ++argc;
+      plan += std::to_string(constraint.iColumn) + ":" +
+              std::to_string(constraint.op) + " ";
+      break;
+    default:
+      break;
+    }
   }
+  if (argc == 0)
+    return;
+  pIdxInfo->idxNum = FILTER_SCAN;
+  pIdxInfo->idxStr = sqlite3_mprintf("%s", plan.c_str());
+  pIdxInfo->needToFreeIdxStr = 1;
+  // every row is still read, on the scale of the ordered scan cost. A plain
+  // full scan keeps the far higher default of sqlite
+  pIdxInfo->estimatedCost = 1e6;
+  pIdxInfo->estimatedRows =
+      std::max<int64_t>(pIdxInfo->estimatedRows / (2 * argc), 1);
+}
+
+int VtabBestIndex(sqlite3_vtab *tab, sqlite3_index_info *pIdxInfo) {
+  // LOG_DEBUG("VtabBestIndex");
+  VirtualTable *table = reinterpret_cast<VirtualTable *>(tab);
+  // a full scan reads every row of the last count
+  pIdxInfo->estimatedRows =
+      std::max<int64_t>(table->GetCatalogEntry().row_count, 1);
+  PlanIndexScan(table, pIdxInfo);
+  if (pIdxInfo->idxNum == 0)
+    PlanFilterScan(pIdxInfo);
   return SQLITE_OK;
 }
 
 int VtabDisconnect(sqlite3_vtab *pVtab) {
   VirtualTable *virtual_table = reinterpret_cast<VirtualTable *>(pVtab);
+  virtual_table->SaveIndex();
+  virtual_table->SaveStats();
+  storage_engine_->tables_.erase(virtual_table->GetCatalogEntry().name);
+  delete virtual_table;
+  return SQLITE_OK;
+}
+
+// DROP TABLE, nothing of the table is kept
+int VtabDestroy(sqlite3_vtab *pVtab) {
+  VirtualTable *virtual_table = reinterpret_cast<VirtualTable *>(pVtab);
+  if (virtual_table->IsIndexInMemory())
+    remove(virtual_table->GetIndexSnapshotName().c_str());
+  // the root of the index is recorded in the header page of the index
+  // segment, a table created again under the name must not find it
+  Index *index = virtual_table->GetIndex();
+  if (index != nullptr) {
+    BufferPoolManager *index_buffer_pool_manager =
+        storage_engine_->index_buffer_pool_manager_;
+    HeaderPage *index_header_page = static_cast<HeaderPage *>(
+        index_buffer_pool_manager->FetchPage(HEADER_PAGE_ID));
+    // an index kept in memory or a tree never inserted into has none
+    page_id_t root_id;
+    bool recorded = index_header_page->GetRootId(index->GetName(), root_id);
+    if (recorded)
+      index_header_page->DeleteRecord(index->GetName());
+    index_buffer_pool_manager->UnpinPage(HEADER_PAGE_ID, recorded);
+  }
+  storage_engine_->catalog_->DropEntry(virtual_table->GetCatalogEntry().name);
+  storage_engine_->tables_.erase(virtual_table->GetCatalogEntry().name);
   delete virtual_table;
-  // delete all the global managers
-  delete storage_engine_;
   return SQLITE_OK;
 }
 
@@ -178,6 +346,67 @@ int VtabClose(sqlite3_vtab_cursor *cur) {
   return SQLITE_OK;
 }
 
+// add column op argv to filter. Comparisons with NULL hold for no row. An
+// encoded column compares its code for equality with a text, sqlite is left
+// every other comparison of it
+static void AddFilterPredicate(VirtualTable *table, TupleFilter *filter,
+                               int column, int op, sqlite3_value *value) {
+  Schema *schema = table->GetSchema();
+  if (schema->IsDictionary(column) &&
+      sqlite3_value_type(value) != SQLITE_NULL) {
+    int32_t code;
+    if (op != SQLITE_INDEX_CONSTRAINT_EQ ||
+        sqlite3_value_type(value) != SQLITE_TEXT)
+      return;
+    std::string text(reinterpret_cast<const char *>(sqlite3_value_text(value)));
+    if (table->GetDictionary()->Lookup(schema->GetColumnName(column), text,
+                                       code))
+      filter->AddPredicate(column, FilterOp::EQ, Value(TypeId::INTEGER, code));
+    else
+      filter->SetEmpty();
+    return;
+  }
+  FilterOp filter_op;
+  switch (op) {
+  case SQLITE_INDEX_CONSTRAINT_EQ:
+    filter_op = FilterOp::EQ;
+    break;
+  case SQLITE_INDEX_CONSTRAINT_LT:
+    filter_op = FilterOp::LT;
+    break;
+  case SQLITE_INDEX_CONSTRAINT_LE:
+    filter_op = FilterOp::LE;
+    break;
+  case SQLITE_INDEX_CONSTRAINT_GT:
+    filter_op = FilterOp::GT;
+    break;
+  default:
+    filter_op = FilterOp::GE;
+  }
+  switch (sqlite3_value_type(value)) {
+  case SQLITE_INTEGER:
+    filter->AddPredicate(column, filter_op,
+                         Value(TypeId::BIGINT,
+                               (int64_t)sqlite3_value_int64(value)));
+    break;
+  case SQLITE_FLOAT:
+    filter->AddPredicate(column, filter_op,
+                         Value(TypeId::DECIMAL, sqlite3_value_double(value)));
+    break;
+  case SQLITE_TEXT:
+    filter->AddPredicate(
+        column, filter_op,
+        Value(TypeId::VARCHAR, std::string(reinterpret_cast<const char *>(
+                                   sqlite3_value_text(value)))));
+    break;
+  case SQLITE_NULL:
+    filter->SetEmpty();
+    break;
+  default:
+    break;
+  }
+}
+
 /*
 ** This method is called to "rewind" the cursor object back
 ** to the first row of output. This method is always called at least
@@ -189,13 +418,31 @@ int VtabFilter(sqlite3_vtab_cursor *pVtabCursor, int idxNum, const char *idxStr,
   // LOG_DEBUG("VtabFilter");
   Cursor *cursor = reinterpret_cast<Cursor *>(pVtabCursor);
   Schema *key_schema;
+  cursor->SetIndexOnly((idxNum & INDEX_ONLY_SCAN) != 0);
+  idxNum &= ~INDEX_ONLY_SCAN;
   // if indexed scan
   if (idxNum == 1) {
     cursor->SetScanFlag(true);
     // Construct the tuple for point query
     key_schema = cursor->GetKeySchema();
-    Tuple scan_tuple = ConstructTuple(key_schema, argv);
+    Tuple scan_tuple =
+        ConstructTuple(key_schema, argv,
+                       cursor->GetVirtualTable()->GetDictionary(), false);
     cursor->ScanKey(scan_tuple);
+  } else if (idxNum == 2 || idxNum == 3) {
+    // ordered scan, ascending or descending
+    cursor->SetScanFlag(true);
+    cursor->ScanOrdered(idxNum == 3);
+  } else if (idxNum == FILTER_SCAN) {
+    Schema *schema = cursor->GetVirtualTable()->GetSchema();
+    TupleFilter *filter = new TupleFilter(schema);
+    std::istringstream plan(idxStr);
+    int column, op;
+    char colon;
+    for (int i = 0; i < argc && plan >> column >> colon >> op; i++)
+      AddFilterPredicate(cursor->GetVirtualTable(), filter, column, op,
+                         argv[i]);
+    cursor->ScanFiltered(filter);
   }
   return SQLITE_OK;
 }
@@ -216,29 +463,40 @@ int VtabEof(sqlite3_vtab_cursor *cur) {
 int VtabColumn(sqlite3_vtab_cursor *cur, sqlite3_context *ctx, int i) {
   Cursor *cursor = reinterpret_cast<Cursor *>(cur);
   Schema *schema = cursor->GetVirtualTable()->GetSchema();
-  // get column type and value
-  TypeId type = schema->GetType(i);
-  Value v = cursor->GetCurrentValue(schema, i);
-
-  switch (type) {
+  // the column is read in place by its type, no Value is built
+  const Tuple &tuple = cursor->GetCurrentTuple(schema, i);
+  if (tuple.IsNull(schema, i)) {
+    sqlite3_result_null(ctx);
+    return SQLITE_OK;
+  }
+  switch (schema->GetType(i)) {
   case TypeId::TINYINT:
   case TypeId::BOOLEAN:
-    sqlite3_result_int(ctx, (int)v.GetAs<int8_t>());
+    sqlite3_result_int(ctx, tuple.Get<int8_t>(schema, i));
     break;
   case TypeId::SMALLINT:
-    sqlite3_result_int(ctx, (int)v.GetAs<int16_t>());
+    sqlite3_result_int(ctx, tuple.Get<int16_t>(schema, i));
     break;
   case TypeId::INTEGER:
-    sqlite3_result_int(ctx, (int)v.GetAs<int32_t>());
+    if (schema->IsDictionary(i)) {
+      // the only place a code is decoded
+      const std::string &value =
+          cursor->GetVirtualTable()->GetDictionary()->Decode(
+              schema->GetColumnName(i), tuple.Get<int32_t>(schema, i));
+      sqlite3_result_text(ctx, value.data(), value.size(), SQLITE_TRANSIENT);
+      break;
+    }
+    sqlite3_result_int(ctx, tuple.Get<int32_t>(schema, i));
     break;
   case TypeId::BIGINT:
-    sqlite3_result_int64(ctx, (sqlite3_int64)v.GetAs<int64_t>());
+    sqlite3_result_int64(ctx, (sqlite3_int64)tuple.Get<int64_t>(schema, i));
     break;
   case TypeId::DECIMAL:
-    sqlite3_result_double(ctx, v.GetAs<double>());
+    sqlite3_result_double(ctx, tuple.Get<double>(schema, i));
     break;
   case TypeId::VARCHAR:
-    sqlite3_result_text(ctx, v.GetData(), -1, SQLITE_TRANSIENT);
+    sqlite3_result_text(ctx, tuple.Get<const char *>(schema, i), -1,
+                        SQLITE_TRANSIENT);
     break;
   default:
     return SQLITE_ERROR;
@@ -271,7 +529,7 @@ int VtabUpdate(sqlite3_vtab *pVTab, int argc, sqlite3_value **argv,
   // automatically.
   else if (argc > 1 && sqlite3_value_type(argv[0]) == SQLITE_NULL) {
     Schema *schema = table->GetSchema();
-    Tuple tuple = ConstructTuple(schema, (argv + 2));
+    Tuple tuple = ConstructTuple(schema, (argv + 2), table->GetDictionary());
     // insert into table heap
     RID rid;
     table->InsertTuple(tuple, rid);
@@ -282,7 +540,7 @@ int VtabUpdate(sqlite3_vtab *pVTab, int argc, sqlite3_value **argv,
   // following parameters.
   else if (argc > 1 && sqlite3_value_type(argv[0]) != SQLITE_NULL) {
     Schema *schema = table->GetSchema();
-    Tuple tuple = ConstructTuple(schema, (argv + 2));
+    Tuple tuple = ConstructTuple(schema, (argv + 2), table->GetDictionary());
     RID rid(sqlite3_value_int64(argv[0]));
     // for update, index always delete and insert
     // because you have no clue key has been updated or not
@@ -328,7 +586,7 @@ sqlite3_module VtableModule = {
     VtabConnect,    /* xConnect */
     VtabBestIndex,  /* xBestIndex */
     VtabDisconnect, /* xDisconnect */
-    VtabDisconnect, /* xDestroy */
+    VtabDestroy,    /* xDestroy */
     VtabOpen,       /* xOpen - open a cursor */
     VtabClose,      /* xClose - close a cursor */
     VtabFilter,     /* xFilter - configure scan constraints */
@@ -348,6 +606,61 @@ sqlite3_module VtableModule = {
     0,              /* xRollbackTo */
 };
 
+/*
+ * vtable_import(table, file[, workers]) appends the rows of a CSV file to a
+ * table and returns their number. The pages are written directly, outside
+ * any transaction of sqlite (see VirtualTable::Import)
+ */
+static void ImportFunction(sqlite3_context *ctx, int argc,
+                           sqlite3_value **argv) {
+  if (argc < 2 || argc > 3) {
+    sqlite3_result_error(ctx, "vtable_import(table, file[, workers])", -1);
+    return;
+  }
+  const unsigned char *table_name = sqlite3_value_text(argv[0]);
+  const unsigned char *file_name = sqlite3_value_text(argv[1]);
+  if (table_name == nullptr || file_name == nullptr) {
+    sqlite3_result_error(ctx, "table and file can't be NULL", -1);
+    return;
+  }
+  std::string name(reinterpret_cast<const char *>(table_name));
+  int worker_count = argc == 3 ? sqlite3_value_int(argv[2])
+                               : std::thread::hardware_concurrency();
+
+  // sqlite connects a table the first time a statement reads it, %w doubles
+  // the quotes within the name
+  char *sql = sqlite3_mprintf("SELECT rowid FROM \"%w\" LIMIT 0", table_name);
+  sqlite3_stmt *stmt;
+  int rc = sqlite3_prepare_v2(sqlite3_context_db_handle(ctx), sql, -1, &stmt,
+                              nullptr);
+  sqlite3_free(sql);
+  if (rc != SQLITE_OK) {
+    sqlite3_result_error(ctx, ("no such table: " + name).c_str(), -1);
+    return;
+  }
+  sqlite3_finalize(stmt);
+  auto it = storage_engine_->tables_.find(name);
+  if (it == storage_engine_->tables_.end()) {
+    sqlite3_result_error(ctx, ("not a vtable table: " + name).c_str(), -1);
+    return;
+  }
+  try {
+    uint64_t bytes;
+    size_t row_count = it->second->Import(
+        reinterpret_cast<const char *>(file_name), worker_count, bytes);
+    sqlite3_result_int64(ctx, row_count);
+  } catch (const std::exception &e) {
+    sqlite3_result_error(ctx, e.what(), -1);
+  }
+}
+
+// module destructor, runs when the connection closes after every table is
+// disconnected
+static void DestroyStorageEngine(void *) {
+  delete storage_engine_;
+  storage_engine_ = nullptr;
+}
+
 #ifdef _WIN32
 __declspec(dllexport)
 #endif
@@ -358,20 +671,39 @@ __declspec(dllexport)
   struct stat buffer;
   bool is_file_exist = (stat(db_file_name.c_str(), &buffer) == 0);
 
+  // an index segment without its database file is stale
+  if (!is_file_exist)
+    remove(StorageEngine::IndexFileName(db_file_name).c_str());
+
   // init storage engine
   storage_engine_ = new StorageEngine(db_file_name);
   // start the logging
   storage_engine_->log_manager_->RunFlushThread();
-  // create header page from BufferPoolManager if necessary
+  // create header pages from BufferPoolManager if necessary
   if (!is_file_exist) {
-    page_id_t header_page_id;
-    storage_engine_->buffer_pool_manager_->NewPage(header_page_id);
-
-    assert(header_page_id == HEADER_PAGE_ID);
-    storage_engine_->buffer_pool_manager_->UnpinPage(header_page_id, true);
+    for (BufferPoolManager *buffer_pool_manager :
+         {storage_engine_->buffer_pool_manager_,
+          storage_engine_->index_buffer_pool_manager_}) {
+      page_id_t header_page_id;
+      buffer_pool_manager->NewPage(header_page_id);
+
+      assert(header_page_id == HEADER_PAGE_ID);
+      buffer_pool_manager->UnpinPage(header_page_id, true);
+    }
   }
 
-  int rc = sqlite3_create_module(db, "vtable", &VtableModule, nullptr);
+  storage_engine_->catalog_ =
+      new Catalog(storage_engine_->buffer_pool_manager_);
+
+  // the storage engine is shared by every table of the connection and goes
+  // away with it
+  int rc = sqlite3_create_module_v2(db, "vtable", &VtableModule, nullptr,
+                                    DestroyStorageEngine);
+  if (rc == SQLITE_OK)
+    rc = RegisterStatsModule(db);
+  if (rc == SQLITE_OK)
+    rc = sqlite3_create_function(db, "vtable_import", -1, SQLITE_UTF8, nullptr,
+                                 ImportFunction, nullptr, nullptr);
   return rc;
 }
 
@@ -396,6 +728,14 @@ Schema *ParseCreateStatement(const std::string &sql_base) {
     n = t.find_first_of(' ');
     column_name = t.substr(0, n);
     column_type = t.substr(n + 1);
+    // "dictionary varchar(size)" stores the code of the value instead
+    bool dictionary = column_type.compare(0, 11, "dictionary ") == 0;
+    if (dictionary)
+      column_type = column_type.substr(11);
+    // "varint bigint" stores the integer in as few bytes as it needs
+    bool varint = column_type.compare(0, 7, "varint ") == 0;
+    if (varint)
+      column_type = column_type.substr(7);
     // deal with varchar(size) situation
     n = column_type.find_first_of('(');
     if (n != std::string::npos) {
@@ -422,15 +762,28 @@ Schema *ParseCreateStatement(const std::string &sql_base) {
     if (type == INVALID) {
       throw Exception(EXCEPTION_TYPE_UNKNOWN_TYPE,
                       "unknown type for create table");
+    } else if (dictionary && type != VARCHAR) {
+      throw Exception(EXCEPTION_TYPE_UNKNOWN_TYPE,
+                      "only varchar columns are dictionary encoded");
+    } else if (varint && type != SMALLINT && type != INTEGER &&
+               type != BIGINT) {
+      throw Exception(EXCEPTION_TYPE_UNKNOWN_TYPE,
+                      "only integer columns are varint encoded");
+    } else if (dictionary) {
+      Column col(INTEGER, Type::GetTypeSize(INTEGER), column_name);
+      col.SetDictionary(true);
+      v.emplace_back(col);
     } else if (type == VARCHAR) {
       Column col(type, column_length, column_name);
       v.emplace_back(col);
     } else {
       Column col(type, Type::GetTypeSize(type), column_name);
+      col.SetVarint(varint);
       v.emplace_back(col);
     }
   }
-  Schema *schema = new Schema(v);
+  // the rows of a table tell their NULLs apart in a null bitmap
+  Schema *schema = new Schema(v, true);
   // LOG_DEBUG("%s", schema->ToString().c_str());
 
   return schema;
@@ -450,6 +803,26 @@ IndexMetadata *ParseIndexStatement(std::string &sql,
   assert(n != std::string::npos);
   index_name = sql.substr(0, n);
   sql = sql.substr(n + 1);
+  // optional trailing "using btree", "using blink", "using betree",
+  // "using hash" or "using art" picks the structure
+  IndexType index_type = IndexType::BPLUS_TREE;
+  n = sql.find(" using ");
+  if (n != std::string::npos) {
+    std::string type_name = sql.substr(n + 7);
+    StringUtility::Trim(type_name);
+    if (type_name == "hash")
+      index_type = IndexType::HASH;
+    else if (type_name == "art")
+      index_type = IndexType::ART;
+    else if (type_name == "blink")
+      index_type = IndexType::BLINK_TREE;
+    else if (type_name == "betree")
+      index_type = IndexType::BEPSILON_TREE;
+    else if (type_name != "btree")
+      throw Exception(EXCEPTION_TYPE_INDEX,
+                      "can't create index, unknown type " + type_name);
+    sql = sql.substr(0, n);
+  }
 
   std::vector<std::string> tok = StringUtility::Split(sql, ',');
   // iterate through returned result
@@ -462,20 +835,36 @@ IndexMetadata *ParseIndexStatement(std::string &sql,
   if ((int)key_attrs.size() > schema->GetColumnCount())
     throw Exception(EXCEPTION_TYPE_INDEX, "can't create index, format error");
 
-  IndexMetadata *metadata =
-      new IndexMetadata(index_name, table_name, schema, key_attrs);
+  IndexMetadata *metadata = new IndexMetadata(index_name, table_name, schema,
+                                              key_attrs, index_type);
 
   // LOG_DEBUG("%s", metadata->ToString().c_str());
   return metadata;
 }
 
-Tuple ConstructTuple(Schema *schema, sqlite3_value **argv) {
+Tuple ConstructTuple(Schema *schema, sqlite3_value **argv,
+                     Dictionary *dictionary, bool add_values) {
   int column_count = schema->GetColumnCount();
   Value v(TypeId::INVALID);
   std::vector<Value> values;
   // iterate through schema, generate column value to insert
   for (int i = 0; i < column_count; i++) {
     TypeId type = schema->GetType(i);
+    if (sqlite3_value_type(argv[i]) == SQLITE_NULL) {
+      values.emplace_back(Type::GetNullValue(type));
+      continue;
+    }
+    if (schema->IsDictionary(i)) {
+      const unsigned char *chars = sqlite3_value_text(argv[i]);
+      std::string text(chars ? reinterpret_cast<const char *>(chars) : "");
+      int32_t code = -1;
+      if (add_values)
+        code = dictionary->Encode(schema->GetColumnName(i), text);
+      else
+        dictionary->Lookup(schema->GetColumnName(i), text, code);
+      values.emplace_back(type, code);
+      continue;
+    }
 
     switch (type) {
     case TypeId::BOOLEAN:
@@ -504,34 +893,58 @@ Tuple ConstructTuple(Schema *schema, sqlite3_value **argv) {
   return tuple;
 }
 
-// serve the functionality of index factory
-Index *ConstructIndex(IndexMetadata *metadata,
-                      BufferPoolManager *buffer_pool_manager,
-                      page_id_t root_id) {
-  // The size of the key in bytes
-  Schema *key_schema = metadata->GetKeySchema();
-  int key_size = key_schema->GetLength();
-  // for each varchar attribute, we assume the largest size is 16 bytes
-  key_size += 16 * key_schema->GetUnlinedColumnCount();
-
+// instantiate IndexClass with the smallest key that fits
+template <template <typename, typename, typename> class IndexClass>
+Index *ConstructIndexOfKeySize(int key_size, IndexMetadata *metadata,
+                               BufferPoolManager *buffer_pool_manager,
+                               page_id_t root_id) {
   if (key_size <= 4) {
-    return new BPlusTreeIndex<GenericKey<4>, RID, GenericComparator<4>>(
+    return new IndexClass<GenericKey<4>, RID, GenericComparator<4>>(
         metadata, buffer_pool_manager, root_id);
   } else if (key_size <= 8) {
-    return new BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>>(
+    return new IndexClass<GenericKey<8>, RID, GenericComparator<8>>(
         metadata, buffer_pool_manager, root_id);
   } else if (key_size <= 16) {
-    return new BPlusTreeIndex<GenericKey<16>, RID, GenericComparator<16>>(
+    return new IndexClass<GenericKey<16>, RID, GenericComparator<16>>(
         metadata, buffer_pool_manager, root_id);
   } else if (key_size <= 32) {
-    return new BPlusTreeIndex<GenericKey<32>, RID, GenericComparator<32>>(
+    return new IndexClass<GenericKey<32>, RID, GenericComparator<32>>(
         metadata, buffer_pool_manager, root_id);
   } else {
-    return new BPlusTreeIndex<GenericKey<64>, RID, GenericComparator<64>>(
+    return new IndexClass<GenericKey<64>, RID, GenericComparator<64>>(
         metadata, buffer_pool_manager, root_id);
   }
 }
 
+// serve the functionality of index factory
+Index *ConstructIndex(IndexMetadata *metadata,
+                      BufferPoolManager *buffer_pool_manager,
+                      page_id_t root_id) {
+  // The size of the key in bytes
+  Schema *key_schema = metadata->GetKeySchema();
+  int key_size = key_schema->GetLength();
+  // for each varchar attribute, we assume the largest size is 16 bytes
+  key_size += 16 * key_schema->GetUnlinedColumnCount();
+
+  switch (metadata->GetIndexType()) {
+  case IndexType::ART:
+    return new ArtIndex(metadata);
+  case IndexType::HASH:
+    return ConstructIndexOfKeySize<ExtendibleHashIndex>(
+        key_size, metadata, buffer_pool_manager, root_id);
+  case IndexType::BLINK_TREE:
+    return ConstructIndexOfKeySize<BLinkTreeIndex>(
+        key_size, metadata, buffer_pool_manager, root_id);
+  case IndexType::BEPSILON_TREE:
+    return ConstructIndexOfKeySize<BEpsilonTreeIndex>(
+        key_size, metadata, buffer_pool_manager, root_id);
+  case IndexType::BPLUS_TREE:
+  default:
+    return ConstructIndexOfKeySize<BPlusTreeIndex>(
+        key_size, metadata, buffer_pool_manager, root_id);
+  }
+}
+
 Transaction *GetTransaction() { return global_transaction_; }
 
 } // namespace cmudb
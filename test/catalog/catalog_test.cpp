@@ -0,0 +1,88 @@
+/**
+ * catalog_test.cpp
+ */
+
+#include <cstdio>
+#include <string>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/catalog.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+
+namespace cmudb {
+
+CatalogEntry MakeEntry(int i) {
+  CatalogEntry entry;
+  entry.name = "table_with_a_name_longer_than_32_bytes_" + std::to_string(i);
+  entry.first_page_id = i;
+  entry.schema = "a int, b varchar(" + std::to_string(i) + ")";
+  entry.index = i % 2 == 0 ? "pk a" : "";
+  entry.row_count = i * 10;
+  entry.dictionary_page_id = i % 3 == 0 ? i + 1000 : INVALID_PAGE_ID;
+  entry.layout_version = i % 5 == 0 ? 0 : TUPLE_LAYOUT_VERSION;
+  return entry;
+}
+
+TEST(CatalogTest, UnitTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(20, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+
+  // far more entries than fit in the header page, over many pages
+  const int entry_count = 500;
+  Catalog *catalog = new Catalog(bpm);
+  for (int i = 0; i < entry_count; i++)
+    EXPECT_TRUE(catalog->CreateEntry(MakeEntry(i)));
+  EXPECT_FALSE(catalog->CreateEntry(MakeEntry(0)));
+  EXPECT_EQ(entry_count, catalog->GetEntryCount());
+
+  // updates may move a grown record to another page, drops free its space
+  for (int i = 0; i < entry_count; i += 3) {
+    CatalogEntry entry = MakeEntry(i);
+    entry.schema += ", c bigint, d decimal, e varchar(100)";
+    entry.row_count = -1;
+    EXPECT_TRUE(catalog->UpdateEntry(entry));
+  }
+  for (int i = 1; i < entry_count; i += 3)
+    EXPECT_TRUE(catalog->DropEntry(MakeEntry(i).name));
+  EXPECT_FALSE(catalog->DropEntry(MakeEntry(1).name));
+  CatalogEntry too_large = MakeEntry(entry_count);
+  too_large.schema = std::string(PAGE_SIZE, 'a');
+  EXPECT_THROW(catalog->CreateEntry(too_large), Exception);
+  // a failed update keeps the old record
+  too_large.name = MakeEntry(2).name;
+  EXPECT_THROW(catalog->UpdateEntry(too_large), Exception);
+  delete catalog;
+
+  // a catalog opened again reads every entry back
+  catalog = new Catalog(bpm);
+  EXPECT_EQ(entry_count - (entry_count + 1) / 3, catalog->GetEntryCount());
+  for (int i = 0; i < entry_count; i++) {
+    CatalogEntry expected = MakeEntry(i), entry;
+    if (i % 3 == 1) {
+      EXPECT_FALSE(catalog->GetEntry(expected.name, entry));
+      continue;
+    }
+    if (i % 3 == 0) {
+      expected.schema += ", c bigint, d decimal, e varchar(100)";
+      expected.row_count = -1;
+    }
+    EXPECT_TRUE(catalog->GetEntry(expected.name, entry));
+    EXPECT_EQ(expected.first_page_id, entry.first_page_id);
+    EXPECT_EQ(expected.schema, entry.schema);
+    EXPECT_EQ(expected.index, entry.index);
+    EXPECT_EQ(expected.row_count, entry.row_count);
+    EXPECT_EQ(expected.dictionary_page_id, entry.dictionary_page_id);
+    EXPECT_EQ(expected.layout_version, entry.layout_version);
+  }
+
+  delete catalog;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+}
+
+} // namespace cmudb
@@ -0,0 +1,57 @@
+/**
+ * dictionary_test.cpp
+ */
+
+#include <cstdio>
+#include <string>
+
+#include "buffer/buffer_pool_manager.h"
+#include "catalog/dictionary.h"
+#include "common/exception.h"
+#include "gtest/gtest.h"
+
+namespace cmudb {
+
+TEST(DictionaryTest, UnitTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(20, disk_manager);
+
+  // far more values than a page holds, codes count from 0 per column
+  const int value_count = 300;
+  Dictionary *dictionary = new Dictionary(bpm);
+  page_id_t first_page_id = dictionary->GetFirstPageId();
+  for (int i = 0; i < value_count; i++) {
+    std::string value = "status_" + std::to_string(i);
+    EXPECT_EQ(i, dictionary->Encode("status", value));
+    EXPECT_EQ(i, dictionary->Encode("status", value));
+    EXPECT_EQ(i / 2, dictionary->Encode("region", std::to_string(i / 2)));
+  }
+  int32_t code = -1;
+  EXPECT_FALSE(dictionary->Lookup("status", "unknown", code));
+  EXPECT_FALSE(dictionary->Lookup("category", "status_1", code));
+  EXPECT_EQ(-1, code);
+  EXPECT_THROW(dictionary->Encode("status", std::string(PAGE_SIZE, 'a')),
+               Exception);
+  EXPECT_THROW(dictionary->Decode("status", value_count), Exception);
+  delete dictionary;
+
+  // a dictionary opened again has every code, and goes on from the last one
+  dictionary = new Dictionary(bpm, first_page_id);
+  EXPECT_EQ((size_t)value_count, dictionary->GetSize("status"));
+  EXPECT_EQ((size_t)value_count / 2, dictionary->GetSize("region"));
+  for (int i = 0; i < value_count; i++) {
+    std::string value = "status_" + std::to_string(i);
+    EXPECT_TRUE(dictionary->Lookup("status", value, code));
+    EXPECT_EQ(i, code);
+    EXPECT_EQ(value, dictionary->Decode("status", i));
+  }
+  EXPECT_EQ(value_count, dictionary->Encode("status", "new"));
+  EXPECT_EQ(value_count / 2, dictionary->Encode("region", "new"));
+
+  delete dictionary;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+}
+
+} // namespace cmudb
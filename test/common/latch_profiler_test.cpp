@@ -0,0 +1,73 @@
+/**
+ * latch_profiler_test.cpp
+ */
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common/latch_profiler.h"
+#include "common/rwmutex.h"
+#include "gtest/gtest.h"
+
+namespace cmudb {
+
+TEST(LatchProfilerTest, LayoutTest) {
+  EXPECT_EQ(MetricCounter::BPM_LATCH_ACQUIRE,
+            LatchProfiler::Counter(LatchClass::BPM_LATCH, 0));
+  EXPECT_EQ(MetricCounter::LOG_LATCH_CONTENDED,
+            LatchProfiler::Counter(LatchClass::LOG_LATCH, 1));
+  EXPECT_EQ(MetricHistogram::PAGE_LATCH_HOLD,
+            LatchProfiler::Histogram(LatchClass::PAGE_LATCH, 1));
+  EXPECT_EQ(MetricHistogram::LOG_LATCH_HOLD,
+            LatchProfiler::Histogram(LatchClass::LOG_LATCH, 1));
+  EXPECT_STREQ("lock_table_mutex",
+               LatchProfiler::Name(LatchClass::LOCK_TABLE_MUTEX));
+}
+
+TEST(LatchProfilerTest, CountTest) {
+  Metrics::Reset();
+  ProfiledMutex mutex(LatchClass::BPM_LATCH);
+  RWMutex rwlatch(LatchClass::PAGE_LATCH);
+  RWMutex unprofiled;
+  int sum = 0;
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([&] {
+      for (int j = 0; j < 1000; j++) {
+        std::lock_guard<ProfiledMutex> guard(mutex);
+        sum++;
+      }
+      for (int j = 0; j < 1000; j++) {
+        rwlatch.WLock();
+        rwlatch.WUnlock();
+        rwlatch.RLock();
+        rwlatch.RUnlock();
+        unprofiled.WLock();
+        unprofiled.WUnlock();
+      }
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+  EXPECT_EQ(4000, sum);
+
+  MetricsSnapshot snapshot = Metrics::Snapshot();
+  uint64_t expected = LatchProfiler::Enabled() ? 4000 : 0;
+  EXPECT_EQ(expected, snapshot.Get(MetricCounter::BPM_LATCH_ACQUIRE));
+  EXPECT_EQ(expected, snapshot.Get(MetricHistogram::BPM_LATCH_HOLD).count);
+  EXPECT_EQ(2 * expected, snapshot.Get(MetricCounter::PAGE_LATCH_ACQUIRE));
+  // only exclusive holds are timed
+  EXPECT_EQ(expected, snapshot.Get(MetricHistogram::PAGE_LATCH_HOLD).count);
+  EXPECT_GE(snapshot.Get(MetricCounter::BPM_LATCH_ACQUIRE),
+            snapshot.Get(MetricCounter::BPM_LATCH_CONTENDED));
+  EXPECT_EQ(snapshot.Get(MetricCounter::BPM_LATCH_CONTENDED),
+            snapshot.Get(MetricHistogram::BPM_LATCH_WAIT).count);
+  EXPECT_EQ(0, snapshot.Get(MetricCounter::ROOT_LATCH_ACQUIRE));
+
+  std::string dump = LatchProfiler::Dump();
+  EXPECT_NE(std::string::npos, dump.find("bpm_latch"));
+  EXPECT_NE(std::string::npos, dump.find("log_latch"));
+}
+
+} // namespace cmudb
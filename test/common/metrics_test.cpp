@@ -0,0 +1,60 @@
+/**
+ * metrics_test.cpp
+ */
+
+#include <thread>
+#include <vector>
+
+#include "common/metrics.h"
+#include "gtest/gtest.h"
+
+namespace cmudb {
+
+TEST(MetricsTest, MergeThreadsTest) {
+  Metrics::Reset();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([] {
+      for (int j = 0; j < 1000; j++)
+        Metrics::Add(MetricCounter::BUFFER_HIT);
+      Metrics::Add(MetricCounter::LOG_BYTES, 10);
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+  // exited threads are folded into the retired slot
+  Metrics::Add(MetricCounter::BUFFER_HIT);
+  MetricsSnapshot snapshot = Metrics::Snapshot();
+  EXPECT_EQ(4001, snapshot.Get(MetricCounter::BUFFER_HIT));
+  EXPECT_EQ(40, snapshot.Get(MetricCounter::LOG_BYTES));
+  EXPECT_EQ(0, snapshot.Get(MetricCounter::BUFFER_MISS));
+
+  Metrics::Reset();
+  EXPECT_EQ(0, Metrics::Snapshot().Get(MetricCounter::BUFFER_HIT));
+}
+
+TEST(MetricsTest, HistogramTest) {
+  Metrics::Reset();
+  EXPECT_EQ(0, Metrics::BucketOf(0));
+  EXPECT_EQ(1, Metrics::BucketOf(1));
+  EXPECT_EQ(2, Metrics::BucketOf(3));
+  EXPECT_EQ(11, Metrics::BucketOf(1024));
+  EXPECT_EQ(63, Metrics::BucketOf(1ULL << 62));
+  EXPECT_EQ(HISTOGRAM_BUCKETS - 1, Metrics::BucketOf(1ULL << 63));
+  EXPECT_EQ(HISTOGRAM_BUCKETS - 1, Metrics::BucketOf(UINT64_MAX));
+
+  for (int i = 0; i < 98; i++)
+    Metrics::Record(MetricHistogram::DISK_READ_LATENCY, 100);
+  Metrics::Record(MetricHistogram::DISK_READ_LATENCY, 5000);
+  Metrics::Record(MetricHistogram::DISK_READ_LATENCY, 100000);
+  const HistogramSnapshot histogram =
+      Metrics::Snapshot().Get(MetricHistogram::DISK_READ_LATENCY);
+  EXPECT_EQ(100, histogram.count);
+  EXPECT_EQ(98 * 100 + 5000 + 100000, histogram.sum);
+  // percentiles are bucket upper bounds
+  EXPECT_EQ(127, histogram.Percentile(50));
+  EXPECT_EQ(8191, histogram.Percentile(98.5));
+  EXPECT_EQ(131071, histogram.Percentile(100));
+}
+
+} // namespace cmudb
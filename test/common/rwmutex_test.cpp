@@ -2,6 +2,7 @@
  * rwmutex_test.cpp
  */
 
+#include <atomic>
 #include <thread>
 
 #include "common/rwmutex.h"
@@ -9,7 +10,7 @@
 
 namespace cmudb {
 
-class Counter {
+template <typename Latch> class Counter {
 public:
   Counter() : count_(0), mutex{} {}
   void Add(int num) {
@@ -26,12 +27,12 @@ public:
   }
 private:
   int count_;
-  RWMutex mutex;
+  Latch mutex;
 };
 
 TEST(RWMutexTest, BasicTest) {
   int num_threads = 100;
-  Counter counter{};
+  Counter<RWMutex> counter{};
   counter.Add(5);
   std::vector<std::thread> threads;
   for (int tid = 0; tid < num_threads; tid++) {
@@ -50,4 +51,72 @@ TEST(RWMutexTest, BasicTest) {
   }
   EXPECT_EQ(counter.Read(), 55);
 }
+
+TEST(RWMutexTest, TryLockTest) {
+  RWMutex mutex;
+  EXPECT_TRUE(mutex.TryRLock());
+  EXPECT_TRUE(mutex.TryRLock());
+  EXPECT_FALSE(mutex.TryWLock());
+  mutex.RUnlock();
+  mutex.RUnlock();
+  EXPECT_TRUE(mutex.TryWLock());
+  EXPECT_FALSE(mutex.TryRLock());
+  EXPECT_FALSE(mutex.TryWLock());
+  mutex.WUnlock();
+  EXPECT_TRUE(mutex.TryRLock());
+  mutex.RUnlock();
+}
+
+// once a writer waits, new readers queue up behind it
+TEST(RWMutexTest, WriterPreferenceTest) {
+  RWMutex mutex;
+  mutex.RLock();
+  std::atomic<bool> written(false);
+  std::thread writer([&] {
+    mutex.WLock();
+    written = true;
+    mutex.WUnlock();
+  });
+  while (mutex.TryRLock()) {
+    mutex.RUnlock();
+    std::this_thread::yield();
+  }
+  EXPECT_FALSE(written);
+  std::thread reader([&] {
+    mutex.RLock();
+    EXPECT_TRUE(written);
+    mutex.RUnlock();
+  });
+  mutex.RUnlock();
+  writer.join();
+  reader.join();
+}
+
+TEST(RWMutexTest, ShardedTest) {
+  ShardedRWMutex mutex;
+  EXPECT_TRUE(mutex.TryRLock());
+  EXPECT_FALSE(mutex.TryWLock());
+  mutex.RUnlock();
+  EXPECT_TRUE(mutex.TryWLock());
+  EXPECT_FALSE(mutex.TryRLock());
+  mutex.WUnlock();
+
+  int num_threads = 100;
+  Counter<ShardedRWMutex> counter{};
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.push_back(std::thread([tid, &counter]() {
+      for (int i = 0; i < 100; i++) {
+        if (tid % 2 == 0)
+          counter.Read();
+        else
+          counter.Add(1);
+      }
+    }));
+  }
+  for (int i = 0; i < num_threads; i++) {
+    threads[i].join();
+  }
+  EXPECT_EQ(counter.Read(), 5000);
+}
 }
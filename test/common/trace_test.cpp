@@ -0,0 +1,72 @@
+/**
+ * trace_test.cpp
+ */
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "common/trace.h"
+#include "gtest/gtest.h"
+
+namespace cmudb {
+
+static int CountOf(const std::string &json, const std::string &needle) {
+  int count = 0;
+  for (size_t pos = json.find(needle); pos != std::string::npos;
+       pos = json.find(needle, pos + 1))
+    count++;
+  return count;
+}
+
+TEST(TraceTest, ChromeJsonTest) {
+  Trace::Stop();
+  { TraceScope scope("test", "disabled"); }
+
+  Trace::Start();
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; i++) {
+    threads.emplace_back([i] {
+      TraceScope scope("test", "worker", i);
+      Trace::Instant("test", "tick");
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+  Trace::Stop();
+  { TraceScope scope("test", "stopped"); }
+
+  int64_t events = 0;
+  std::string json = Trace::ToChromeJson(&events);
+  EXPECT_EQ(8, events);
+  EXPECT_EQ(0u, json.find("{\"displayTimeUnit\":\"ns\",\"traceEvents\":["));
+  EXPECT_EQ(4, CountOf(json, "\"name\":\"worker\",\"ph\":\"X\""));
+  EXPECT_EQ(4, CountOf(json, "\"name\":\"tick\",\"ph\":\"i\""));
+  EXPECT_EQ(1, CountOf(json, "\"args\":{\"arg\":3}"));
+  EXPECT_EQ(0, CountOf(json, "disabled"));
+  EXPECT_EQ(0, CountOf(json, "stopped"));
+
+  EXPECT_EQ(8, Trace::WriteChromeJson("trace_test.json"));
+  remove("trace_test.json");
+
+  // the rings of the exited threads are dropped
+  Trace::Start();
+  Trace::Stop();
+  Trace::ToChromeJson(&events);
+  EXPECT_EQ(0, events);
+}
+
+TEST(TraceTest, RingTest) {
+  Trace::Start();
+  for (size_t i = 0; i < Trace::RING_CAPACITY + 10; i++)
+    Trace::Instant("test", "tick", i);
+  Trace::Stop();
+  int64_t events = 0;
+  std::string json = Trace::ToChromeJson(&events);
+  // only the newest events survive
+  EXPECT_EQ(static_cast<int64_t>(Trace::RING_CAPACITY), events);
+  EXPECT_EQ(0, CountOf(json, "\"arg\":9}"));
+  EXPECT_EQ(1, CountOf(json, "\"arg\":10}"));
+}
+
+} // namespace cmudb
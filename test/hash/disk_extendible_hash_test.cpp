@@ -0,0 +1,172 @@
+/**
+ * disk_extendible_hash_test.cpp
+ */
+
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "hash/disk_extendible_hash.h"
+#include "page/header_page.h"
+#include "vtable/virtual_table.h"
+#include "gtest/gtest.h"
+
+namespace cmudb {
+
+typedef DiskExtendibleHash<GenericKey<8>, RID, GenericComparator<8>>
+    HashIndex8;
+
+TEST(DiskExtendibleHashTest, InsertRemoveTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+
+  HashIndex8 hash("foo_pk", bpm, comparator);
+  GenericKey<8> index_key;
+  RID rid;
+  // enough keys to split up to the maximum depth and chain overflow pages
+  const int64_t num_keys = 8000;
+  for (int64_t key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    rid.Set(static_cast<int32_t>(key), static_cast<int32_t>(key));
+    EXPECT_TRUE(hash.Insert(index_key, rid));
+  }
+  EXPECT_EQ(HashTableDirectoryPage::MaxDepthOf(PAGE_SIZE),
+            hash.GetGlobalDepth());
+  // unique keys only
+  index_key.SetFromInteger(42);
+  EXPECT_FALSE(hash.Insert(index_key, rid));
+
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < num_keys; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(hash.GetValue(index_key, rids));
+    ASSERT_EQ(1, rids.size());
+    EXPECT_EQ(key, rids[0].GetSlotNum());
+  }
+  index_key.SetFromInteger(num_keys);
+  EXPECT_FALSE(hash.GetValue(index_key, rids));
+
+  for (int64_t key = 0; key < num_keys; key += 2) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(hash.Remove(index_key));
+  }
+  index_key.SetFromInteger(0);
+  EXPECT_FALSE(hash.Remove(index_key));
+  for (int64_t key = 0; key < num_keys; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ(key % 2 == 1, hash.GetValue(index_key, rids));
+  }
+
+  // reopen from the directory page recorded in the header page
+  HeaderPage *header_page =
+      static_cast<HeaderPage *>(bpm->FetchPage(HEADER_PAGE_ID));
+  page_id_t directory_page_id;
+  EXPECT_TRUE(header_page->GetRootId("foo_pk", directory_page_id));
+  bpm->UnpinPage(HEADER_PAGE_ID, false);
+  EXPECT_EQ(hash.GetDirectoryPageId(), directory_page_id);
+  HashIndex8 reopened("foo_pk", bpm, comparator, directory_page_id);
+  rids.clear();
+  index_key.SetFromInteger(7);
+  EXPECT_TRUE(reopened.GetValue(index_key, rids));
+
+  delete key_schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(DiskExtendibleHashTest, IndexPageSizeTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  DiskManager *disk_manager = new DiskManager("test.db", INDEX_PAGE_SIZE);
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+
+  // the directory and buckets fill the larger pages, far more keys than
+  // small pages hold without overflow pages stay a few splits deep
+  HashIndex8 hash("foo_pk", bpm, comparator);
+  EXPECT_LT(HashTableDirectoryPage::MaxDepthOf(PAGE_SIZE),
+            HashTableDirectoryPage::MaxDepthOf(INDEX_PAGE_SIZE));
+  GenericKey<8> index_key;
+  const int64_t num_keys = 20000;
+  for (int64_t key = 0; key < num_keys; key++) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(hash.Insert(index_key, RID(0, key)));
+  }
+  EXPECT_LT(hash.GetGlobalDepth(),
+            HashTableDirectoryPage::MaxDepthOf(PAGE_SIZE));
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < num_keys; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(hash.GetValue(index_key, rids));
+  }
+
+  delete key_schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(DiskExtendibleHashTest, ConcurrentTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+
+  HashIndex8 hash("foo_pk", bpm, comparator);
+  const int num_threads = 4;
+  const int64_t keys_per_thread = 1000;
+  std::vector<std::thread> threads;
+  for (int tid = 0; tid < num_threads; tid++) {
+    threads.emplace_back([&, tid] {
+      GenericKey<8> index_key;
+      std::vector<RID> rids;
+      for (int64_t i = 0; i < keys_per_thread; i++) {
+        int64_t key = i * num_threads + tid;
+        index_key.SetFromInteger(key);
+        EXPECT_TRUE(hash.Insert(index_key, RID(0, key)));
+        rids.clear();
+        EXPECT_TRUE(hash.GetValue(index_key, rids));
+      }
+      // remove every other key again
+      for (int64_t i = 0; i < keys_per_thread; i += 2) {
+        index_key.SetFromInteger(i * num_threads + tid);
+        EXPECT_TRUE(hash.Remove(index_key));
+      }
+    });
+  }
+  for (auto &t : threads)
+    t.join();
+
+  GenericKey<8> index_key;
+  std::vector<RID> rids;
+  for (int64_t key = 0; key < num_threads * keys_per_thread; key++) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_EQ((key / num_threads) % 2 == 1, hash.GetValue(index_key, rids));
+  }
+
+  delete key_schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+} // namespace cmudb
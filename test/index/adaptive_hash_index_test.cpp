@@ -0,0 +1,134 @@
+/**
+ * adaptive_hash_index_test.cpp
+ */
+
+#include <cstdio>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/metrics.h"
+#include "index/adaptive_hash_index.h"
+#include "index/b_plus_tree.h"
+#include "vtable/virtual_table.h"
+#include "gtest/gtest.h"
+
+namespace cmudb {
+
+TEST(AdaptiveHashIndexTest, PromoteTest) {
+  AdaptiveHashIndex<GenericKey<8>> overlay;
+  AdaptiveHashIndex<GenericKey<8>>::Entry entry{7, 3, overlay.GetEpoch()};
+  GenericKey<8> key;
+  key.SetFromInteger(42);
+
+  // cached after PROMOTE_THRESHOLD lookups
+  for (int i = 0; i < AdaptiveHashIndex<GenericKey<8>>::PROMOTE_THRESHOLD;
+       i++) {
+    EXPECT_FALSE(overlay.Lookup(key, entry));
+    overlay.Record(key, entry);
+  }
+  AdaptiveHashIndex<GenericKey<8>>::Entry cached;
+  EXPECT_TRUE(overlay.Lookup(key, cached));
+  EXPECT_EQ(7, cached.page_id);
+  EXPECT_EQ(3, cached.slot);
+  EXPECT_EQ(1, overlay.Size());
+
+  // a cached key is refreshed in place
+  entry.slot = 5;
+  overlay.Record(key, entry);
+  EXPECT_TRUE(overlay.Lookup(key, cached));
+  EXPECT_EQ(5, cached.slot);
+
+  overlay.Invalidate(key);
+  EXPECT_FALSE(overlay.Lookup(key, cached));
+  EXPECT_EQ(0, overlay.Size());
+
+  overlay.SetEnabled(false);
+  for (int i = 0; i < AdaptiveHashIndex<GenericKey<8>>::PROMOTE_THRESHOLD;
+       i++)
+    overlay.Record(key, entry);
+  EXPECT_FALSE(overlay.Lookup(key, cached));
+}
+
+TEST(AdaptiveHashIndexTest, TreeLookupTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm,
+                                                           comparator);
+  GenericKey<8> index_key;
+  RID rid;
+  Transaction *transaction = new Transaction(0);
+  page_id_t page_id;
+  bpm->NewPage(page_id);
+
+  auto lookup = [&](int64_t key) {
+    std::vector<RID> rids;
+    index_key.SetFromInteger(key);
+    tree.GetValue(index_key, rids);
+    return rids;
+  };
+
+  for (int64_t key = 1; key <= 200; key++) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+
+  // the second round makes the keys hot, the third one hits
+  Metrics::Reset();
+  for (int round = 0; round < 3; round++) {
+    for (int64_t key = 1; key <= 100; key++) {
+      auto rids = lookup(key);
+      ASSERT_EQ(1, rids.size());
+      EXPECT_EQ(key, rids[0].GetSlotNum());
+    }
+  }
+  EXPECT_EQ(100, Metrics::Snapshot().Get(MetricCounter::BTREE_HASH_HIT));
+  EXPECT_EQ(100, tree.GetAdaptiveHash().Size());
+
+  // splits shift and move the cached keys
+  for (int64_t key = -200; key <= 0; key++) {
+    rid.Set(0, key);
+    index_key.SetFromInteger(key);
+    tree.Insert(index_key, rid, transaction);
+  }
+  for (int64_t key = 1; key <= 100; key++) {
+    auto rids = lookup(key);
+    ASSERT_EQ(1, rids.size());
+    EXPECT_EQ(key, rids[0].GetSlotNum());
+  }
+
+  // deletes and merges, removed keys must not be found through the cache
+  for (int64_t key = -200; key <= 50; key++) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  for (int round = 0; round < 3; round++) {
+    for (int64_t key = 1; key <= 100; key++) {
+      auto rids = lookup(key);
+      if (key <= 50) {
+        EXPECT_EQ(0, rids.size());
+      } else {
+        ASSERT_EQ(1, rids.size());
+        EXPECT_EQ(key, rids[0].GetSlotNum());
+      }
+    }
+  }
+  EXPECT_EQ(50, tree.GetAdaptiveHash().Size());
+
+  tree.GetAdaptiveHash().SetEnabled(false);
+  Metrics::Reset();
+  EXPECT_EQ(1, lookup(60).size());
+  EXPECT_EQ(0, Metrics::Snapshot().Get(MetricCounter::BTREE_HASH_HIT));
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+} // namespace cmudb
@@ -0,0 +1,176 @@
+/**
+ * art_test.cpp
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "index/art.h"
+#include "index/art_index.h"
+#include "vtable/virtual_table.h"
+#include "gtest/gtest.h"
+
+namespace cmudb {
+
+// keys sharing long prefixes exercise the prefixes not stored in nodes
+std::string MakeKey(int i) {
+  return "shared-long-prefix/" + std::to_string(i % 7) + "/" +
+         std::to_string(i) + std::string(1, '\0');
+}
+
+TEST(ArtTest, InsertRemoveTest) {
+  AdaptiveRadixTree tree;
+  std::map<std::string, RID> expected;
+  std::mt19937 random(42);
+  for (int i = 0; i < 5000; i++) {
+    std::string key = MakeKey(random() % 3000);
+    RID rid(i, i);
+    bool inserted = expected.emplace(key, rid).second;
+    EXPECT_EQ(inserted, tree.Insert(key, rid));
+  }
+  EXPECT_EQ(expected.size(), tree.Size());
+
+  // remove about half, every node type shrinks back and collapses
+  for (int i = 0; i < 3000; i += 2) {
+    std::string key = MakeKey(i);
+    EXPECT_EQ(expected.erase(key) == 1, tree.Remove(key));
+  }
+  EXPECT_EQ(expected.size(), tree.Size());
+  for (int i = 0; i < 3000; i++) {
+    std::string key = MakeKey(i);
+    RID rid;
+    auto it = expected.find(key);
+    EXPECT_EQ(it != expected.end(), tree.GetValue(key, rid));
+    if (it != expected.end()) {
+      EXPECT_EQ(it->second, rid);
+    }
+  }
+
+  // visited in key order
+  std::vector<std::string> keys;
+  tree.ForEach([&keys](const std::string &key, const RID &) {
+    keys.push_back(key);
+  });
+  EXPECT_EQ(expected.size(), keys.size());
+  EXPECT_TRUE(std::is_sorted(keys.begin(), keys.end()));
+}
+
+TEST(ArtTest, ConcurrentTest) {
+  AdaptiveRadixTree tree;
+  const int num_threads = 4;
+  const int keys_per_thread = 2000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&tree, t]() {
+      for (int i = t; i < num_threads * keys_per_thread; i += num_threads)
+        EXPECT_TRUE(tree.Insert(MakeKey(i), RID(i, i)));
+      // remove a quarter of the own keys while the others still insert
+      for (int i = t; i < num_threads * keys_per_thread; i += 4 * num_threads)
+        EXPECT_TRUE(tree.Remove(MakeKey(i)));
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  for (int i = 0; i < num_threads * keys_per_thread; i++) {
+    RID rid;
+    bool removed = (i % num_threads) == (i % (4 * num_threads));
+    EXPECT_EQ(!removed, tree.GetValue(MakeKey(i), rid));
+  }
+}
+
+TEST(ArtTest, NormalizeKeyTest) {
+  Schema *schema = ParseCreateStatement("a int, b double, c varchar(8)");
+  std::vector<std::string> normalized;
+  int ints[] = {-5, 3};
+  double doubles[] = {-1.5, 0.25};
+  const char *strings[] = {"", "ab", "b"};
+  for (int a : ints) {
+    for (double b : doubles) {
+      for (const char *c : strings) {
+        Tuple key({Value(TypeId::INTEGER, a), Value(TypeId::DECIMAL, b),
+                   Value(TypeId::VARCHAR, std::string(c))},
+                  schema);
+        normalized.push_back(ArtIndex::NormalizeKey(key, schema));
+      }
+    }
+  }
+  // built in key order, so the bytes compare in the same order
+  EXPECT_TRUE(std::is_sorted(normalized.begin(), normalized.end()));
+  EXPECT_TRUE(std::adjacent_find(normalized.begin(), normalized.end()) ==
+              normalized.end());
+  delete schema;
+
+  // a NULL string is not '', and neither key is a prefix of the other
+  schema = ParseCreateStatement("c varchar(8)");
+  std::string null_key = ArtIndex::NormalizeKey(
+      Tuple({Value(TypeId::VARCHAR, nullptr, 0, false)}, schema), schema);
+  std::string empty_key = ArtIndex::NormalizeKey(
+      Tuple({Value(TypeId::VARCHAR, std::string(""))}, schema), schema);
+  EXPECT_LT(null_key, empty_key);
+  EXPECT_NE(0, empty_key.compare(0, null_key.size(), null_key));
+  delete schema;
+}
+
+TEST(ArtTest, ReclaimTest) {
+  AdaptiveRadixTree tree;
+  std::atomic<bool> done(false);
+  // optimistic reads race with the nodes being freed
+  std::thread reader([&tree, &done]() {
+    RID rid;
+    for (int i = 0; !done.load(); i = (i + 1) % 500)
+      tree.GetValue(MakeKey(i), rid);
+  });
+  // the same keys come and go, every round retires its leaves and nodes
+  for (int round = 0; round < 50; round++) {
+    for (int i = 0; i < 500; i++)
+      EXPECT_TRUE(tree.Insert(MakeKey(i), RID(round, i)));
+    for (int i = 0; i < 500; i++)
+      EXPECT_TRUE(tree.Remove(MakeKey(i)));
+  }
+  done.store(true);
+  reader.join();
+  EXPECT_EQ(0, tree.Size());
+
+  // with no reader left behind, only the latest retirements wait
+  for (int i = 0; i < 500; i++)
+    EXPECT_TRUE(tree.Insert(MakeKey(i), RID(0, i)));
+  for (int i = 0; i < 500; i++)
+    EXPECT_TRUE(tree.Remove(MakeKey(i)));
+  EXPECT_LT(tree.RetiredCount(), 200);
+}
+
+TEST(ArtTest, SnapshotTest) {
+  Schema *schema = ParseCreateStatement("a bigint, b varchar(16)");
+  ArtIndex index(new IndexMetadata("foo_pk", "foo", schema, {0}));
+  Schema *key_schema = index.GetKeySchema();
+  for (int64_t i = 0; i < 1000; i++)
+    index.InsertEntry(Tuple({Value(TypeId::BIGINT, i * 7)}, key_schema),
+                      RID(i, i));
+  index.Checkpoint("art_snapshot");
+
+  ArtIndex loaded(new IndexMetadata("foo_pk", "foo", schema, {0}));
+  EXPECT_TRUE(loaded.LoadSnapshot("art_snapshot"));
+  EXPECT_EQ(1000, loaded.Size());
+  std::vector<RID> result;
+  loaded.ScanKey(Tuple({Value(TypeId::BIGINT, int64_t(700))}, key_schema),
+                 result);
+  ASSERT_EQ(1, result.size());
+  EXPECT_EQ(RID(100, 100), result[0]);
+
+  // the snapshot of an index on other columns is refused
+  ArtIndex other(new IndexMetadata("foo_b", "foo", schema, {1}));
+  EXPECT_FALSE(other.LoadSnapshot("art_snapshot"));
+  EXPECT_FALSE(other.LoadSnapshot("no_such_snapshot"));
+  EXPECT_EQ(0, other.Size());
+
+  remove("art_snapshot");
+  delete schema;
+}
+
+} // namespace cmudb
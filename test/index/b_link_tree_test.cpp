@@ -0,0 +1,118 @@
+/**
+ * b_link_tree_test.cpp
+ */
+
+#include <algorithm>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "index/b_link_tree.h"
+#include "page/header_page.h"
+#include "vtable/virtual_table.h"
+#include "gtest/gtest.h"
+
+namespace cmudb {
+
+typedef BLinkTree<GenericKey<64>, RID, GenericComparator<64>> Tree64;
+
+GenericKey<64> MakeKey(int64_t key) {
+  GenericKey<64> index_key;
+  index_key.SetFromInteger(key);
+  return index_key;
+}
+
+TEST(BLinkTreeTest, InsertRemoveTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<64> comparator(key_schema);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(page_id);
+  bpm->UnpinPage(page_id, true);
+  Tree64 tree("foo_pk", bpm, comparator);
+
+  // wide keys give a three level tree
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 20000; key++)
+    keys.push_back(key);
+  std::random_shuffle(keys.begin(), keys.end());
+  for (auto key : keys)
+    EXPECT_TRUE(tree.Insert(MakeKey(key), RID(key)));
+  EXPECT_FALSE(tree.Insert(MakeKey(keys[0]), RID(0)));
+  EXPECT_TRUE(tree.Check());
+
+  for (size_t i = 0; i < keys.size(); i += 2)
+    EXPECT_TRUE(tree.Remove(MakeKey(keys[i])));
+  EXPECT_FALSE(tree.Remove(MakeKey(keys[0])));
+  EXPECT_TRUE(tree.Check());
+  std::vector<RID> result;
+  for (size_t i = 0; i < keys.size(); i++) {
+    result.clear();
+    EXPECT_EQ(i % 2 == 1, tree.GetValue(MakeKey(keys[i]), result));
+    if (i % 2 == 1) {
+      EXPECT_EQ(RID(keys[i]), result[0]);
+    }
+  }
+
+  // the root is found again through the header page
+  HeaderPage *header_page =
+      static_cast<HeaderPage *>(bpm->FetchPage(HEADER_PAGE_ID));
+  page_id_t root_page_id;
+  EXPECT_TRUE(header_page->GetRootId("foo_pk", root_page_id));
+  EXPECT_EQ(tree.GetRootPageId(), root_page_id);
+  bpm->UnpinPage(HEADER_PAGE_ID, false);
+  Tree64 reopened("foo_pk", bpm, comparator, root_page_id);
+  result.clear();
+  EXPECT_TRUE(reopened.GetValue(MakeKey(keys[1]), result));
+
+  delete key_schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BLinkTreeTest, ConcurrentTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<64> comparator(key_schema);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t page_id;
+  bpm->NewPage(page_id);
+  bpm->UnpinPage(page_id, true);
+  Tree64 tree("foo_pk", bpm, comparator);
+
+  const int num_threads = 4;
+  const int64_t keys_per_thread = 5000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&tree, t]() {
+      for (int64_t i = 0; i < keys_per_thread; i++) {
+        int64_t key = i * num_threads + t;
+        EXPECT_TRUE(tree.Insert(MakeKey(key), RID(key)));
+        // own keys stay visible while the others split pages
+        std::vector<RID> result;
+        int64_t earlier = (i / 2) * num_threads + t;
+        EXPECT_TRUE(tree.GetValue(MakeKey(earlier), result));
+      }
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  EXPECT_TRUE(tree.Check());
+  std::vector<RID> result;
+  for (int64_t key = 0; key < num_threads * keys_per_thread; key++)
+    EXPECT_TRUE(tree.GetValue(MakeKey(key), result));
+  EXPECT_EQ(num_threads * keys_per_thread, result.size());
+
+  delete key_schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+} // namespace cmudb
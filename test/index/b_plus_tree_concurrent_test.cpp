@@ -348,4 +348,198 @@ TEST(BPlusTreeConcurrentTest, MixTest) {
   remove("test.log");
 }
 
+TEST(BPlusTreeConcurrentTest, ReverseScanTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm,
+                                                           comparator);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(page_id);
+  (void)header_page;
+
+  // keys 1..1000 stay, 1001..5000 are deleted while 5001..10000 come in
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 5000; key++)
+    keys.push_back(key);
+  InsertHelper(tree, keys);
+  std::vector<int64_t> remove_keys(keys.begin() + 1000, keys.end());
+  std::vector<int64_t> insert_keys;
+  for (int64_t key = 5001; key <= 10000; key++)
+    insert_keys.push_back(key);
+
+  // readers walk back while leaves split and merge next to them
+  auto reader = [&tree](uint64_t) {
+    for (int round = 0; round < 20; round++) {
+      int64_t previous = INT64_MAX;
+      int64_t stable = 0;
+      for (auto iterator = tree.RBegin(); !iterator.isEnd(); --iterator) {
+        int64_t key = (*iterator).second.GetSlotNum();
+        EXPECT_LT(key, previous);
+        previous = key;
+        if (key <= 1000)
+          stable++;
+      }
+      EXPECT_EQ(1000, stable);
+    }
+  };
+  std::thread writer([&]() {
+    LaunchParallelTest(1, InsertHelper, std::ref(tree), insert_keys);
+  });
+  std::thread deleter([&]() {
+    LaunchParallelTest(1, DeleteHelper, std::ref(tree), remove_keys);
+  });
+  LaunchParallelTest(2, reader);
+  writer.join();
+  deleter.join();
+
+  int64_t expected = 10000;
+  for (auto iterator = tree.RBegin(); !iterator.isEnd(); --iterator) {
+    EXPECT_EQ(expected, (*iterator).second.GetSlotNum());
+    expected = expected == 5001 ? 1000 : expected - 1;
+  }
+  EXPECT_EQ(0, expected);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeConcurrentTest, SplitMergeTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm,
+                                                           comparator);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(page_id);
+  (void)header_page;
+
+  // blocks of keys are deleted while the blocks between them fill up, so
+  // leaves split right before leaves that merge, and parents merge too
+  const int64_t block = 1000;
+  std::vector<int64_t> keys[4];
+  for (int64_t key = 0; key < 40 * block; key++)
+    keys[key / block % 4].push_back(key);
+  InsertHelper(tree, keys[0]);
+  InsertHelper(tree, keys[2]);
+  // even blocks go first, then the blocks swap roles every round
+  const int rounds = 6;
+  for (int round = 0; round < rounds; round++) {
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++) {
+      if (i % 2 == round % 2)
+        threads.emplace_back(DeleteHelper, std::ref(tree), std::cref(keys[i]),
+                             i);
+      else
+        threads.emplace_back(InsertHelper, std::ref(tree), std::cref(keys[i]),
+                             i);
+    }
+    for (auto &thread : threads)
+      thread.join();
+  }
+
+  // even blocks are left, the previous links match the next links
+  std::vector<int64_t> expected;
+  for (int64_t key = 0; key < 40 * block; key++) {
+    if (key / block % 2 == 0)
+      expected.push_back(key);
+  }
+  std::vector<int64_t> forward;
+  for (auto iterator = tree.Begin(); !iterator.isEnd(); ++iterator)
+    forward.push_back((*iterator).second.GetSlotNum());
+  EXPECT_EQ(expected, forward);
+  std::vector<int64_t> backward;
+  for (auto iterator = tree.RBegin(); !iterator.isEnd(); --iterator)
+    backward.push_back((*iterator).second.GetSlotNum());
+  std::reverse(backward.begin(), backward.end());
+  EXPECT_EQ(expected, backward);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeConcurrentTest, ProbeDeleteTest) {
+  // create KeyComparator and index schema
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  // create b+ tree
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm,
+                                                           comparator);
+  // create and fetch header_page
+  page_id_t page_id;
+  auto header_page = bpm->NewPage(page_id);
+  (void)header_page;
+
+  // even keys stay, odd keys are deleted and leaves merge under the probes
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 10000; key++)
+    keys.push_back(key);
+  InsertHelper(tree, keys);
+  std::vector<int64_t> remove_keys;
+  for (int64_t key = 1; key <= 10000; key += 2)
+    remove_keys.push_back(key);
+
+  // IN-list probes walk right while Remove latches leaves leftwards
+  auto prober = [&tree, &keys](uint64_t) {
+    std::vector<GenericKey<8>> probe_keys(keys.size());
+    for (size_t i = 0; i < keys.size(); i++)
+      probe_keys[i].SetFromInteger(keys[i]);
+    for (int round = 0; round < 20; round++) {
+      std::vector<RID> result;
+      tree.GetValues(probe_keys, result);
+      int64_t previous = 0;
+      int64_t stable = 0;
+      for (auto &rid : result) {
+        EXPECT_LT(previous, rid.GetSlotNum());
+        previous = rid.GetSlotNum();
+        if (previous % 2 == 0)
+          stable++;
+      }
+      EXPECT_EQ(5000, stable);
+    }
+  };
+  std::thread deleter([&]() {
+    LaunchParallelTest(2, DeleteHelperSplit, std::ref(tree), remove_keys, 2);
+  });
+  LaunchParallelTest(2, prober);
+  deleter.join();
+
+  int64_t expected = 2;
+  GenericKey<8> index_key;
+  index_key.SetFromInteger(0);
+  for (auto iterator = tree.Begin(index_key); !iterator.isEnd(); ++iterator) {
+    EXPECT_EQ(expected, (*iterator).second.GetSlotNum());
+    expected += 2;
+  }
+  EXPECT_EQ(10002, expected);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete key_schema;
+  delete disk_manager;
+  delete bpm;
+  remove("test.db");
+  remove("test.log");
+}
+
 } // namespace cmudb
@@ -10,6 +10,7 @@
 #include "buffer/buffer_pool_manager.h"
 #include "common/logger.h"
 #include "index/b_plus_tree.h"
+#include "page/header_page.h"
 #include "vtable/virtual_table.h"
 #include "gtest/gtest.h"
 
@@ -390,4 +391,331 @@ TEST(BPlusTreeTests, ScaleTest) {
   remove("test.db");
   remove("test.log");
 }
+
+// wide keys give a three level tree, so internal pages split, borrow and merge
+TEST(BPlusTreeTests, InternalRebalanceTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<64> comparator(key_schema);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(100, disk_manager);
+  BPlusTree<GenericKey<64>, RID, GenericComparator<64>> tree("foo_pk", bpm,
+                                                             comparator);
+  GenericKey<64> index_key;
+  Transaction *transaction = new Transaction(0);
+  page_id_t page_id;
+  bpm->NewPage(page_id);
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 20000; key++)
+    keys.push_back(key);
+  std::random_shuffle(keys.begin(), keys.end());
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(key), transaction));
+  }
+
+  // remove in rounds, checking the remaining keys in between
+  std::vector<int64_t> remaining(keys);
+  std::sort(remaining.begin(), remaining.end());
+  while (remaining.size() > 100) {
+    std::vector<int64_t> kept;
+    for (size_t i = 0; i < remaining.size(); i++) {
+      index_key.SetFromInteger(remaining[i]);
+      if (i % 3 == 0) {
+        tree.Remove(index_key, transaction);
+      } else {
+        kept.push_back(remaining[i]);
+      }
+    }
+    remaining.swap(kept);
+    std::vector<RID> rids;
+    for (auto key : remaining) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(tree.GetValue(index_key, rids));
+    }
+    size_t size = 0;
+    for (auto iterator = tree.Begin(); !iterator.isEnd(); ++iterator) {
+      ASSERT_LT(size, remaining.size());
+      EXPECT_EQ(remaining[size], (*iterator).second.Get());
+      size++;
+    }
+    EXPECT_EQ(remaining.size(), size);
+  }
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+  delete disk_manager;
+  delete key_schema;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, ReverseIteratorTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<64> comparator(key_schema);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(100, disk_manager);
+  BPlusTree<GenericKey<64>, RID, GenericComparator<64>> tree("foo_pk", bpm,
+                                                             comparator);
+  GenericKey<64> index_key;
+  Transaction *transaction = new Transaction(0);
+  page_id_t page_id;
+  bpm->NewPage(page_id);
+
+  // even keys only, so every odd key falls between two of them
+  std::vector<int64_t> keys;
+  for (int64_t key = 2; key <= 20000; key += 2)
+    keys.push_back(key);
+  std::random_shuffle(keys.begin(), keys.end());
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(key), transaction));
+  }
+  // merges relink the previous leaf pointers too
+  std::vector<int64_t> remaining;
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    if (key % 3 == 0) {
+      tree.Remove(index_key, transaction);
+    } else {
+      remaining.push_back(key);
+    }
+  }
+  std::sort(remaining.begin(), remaining.end());
+
+  int64_t expected = remaining.size() - 1;
+  for (auto iterator = tree.RBegin(); !iterator.isEnd(); --iterator) {
+    ASSERT_GE(expected, 0);
+    EXPECT_EQ(remaining[expected], (*iterator).second.Get());
+    expected--;
+  }
+  EXPECT_EQ(-1, expected);
+
+  // start at the last key not greater than the bound, then change direction
+  for (int64_t bound : {5001, 5002, 19999}) {
+    index_key.SetFromInteger(bound);
+    auto iterator = tree.RBegin(index_key);
+    auto pos = std::upper_bound(remaining.begin(), remaining.end(), bound) - 1;
+    for (int i = 0; i < 300; i++, pos--) {
+      ASSERT_FALSE(iterator.isEnd());
+      EXPECT_EQ(*pos, (*iterator).second.Get());
+      --iterator;
+    }
+    ++iterator;
+    EXPECT_EQ(*(pos + 1), (*iterator).second.Get());
+  }
+  index_key.SetFromInteger(1);
+  EXPECT_TRUE(tree.RBegin(index_key).isEnd());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+  delete disk_manager;
+  delete key_schema;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, BatchProbeTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<64> comparator(key_schema);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(100, disk_manager);
+  BPlusTree<GenericKey<64>, RID, GenericComparator<64>> tree("foo_pk", bpm,
+                                                             comparator);
+  GenericKey<64> index_key;
+  Transaction *transaction = new Transaction(0);
+  page_id_t page_id;
+  bpm->NewPage(page_id);
+
+  // even keys only, odd probes miss
+  for (int64_t key = 2; key <= 10000; key += 2) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(key), transaction));
+  }
+
+  std::vector<GenericKey<64>> keys;
+  auto probe = [&](int64_t from, int64_t to, int64_t step) {
+    keys.clear();
+    for (int64_t key = from; key <= to; key += step) {
+      index_key.SetFromInteger(key);
+      keys.push_back(index_key);
+    }
+  };
+  // dense probes stay in a leaf, sparse ones skip leaves
+  std::vector<RID> result;
+  for (int64_t step : {1, 3, 701}) {
+    probe(1, 10001, step);
+    result.clear();
+    tree.GetValues(keys, result);
+    size_t expected = 0;
+    for (int64_t key = 1; key <= 10001; key += step) {
+      if (key % 2 == 0) {
+        ASSERT_LT(expected, result.size());
+        EXPECT_EQ(key, result[expected].Get());
+        expected++;
+      }
+    }
+    EXPECT_EQ(expected, result.size());
+  }
+
+  // the hint carries over calls and is dropped once pages are freed
+  LeafHint hint;
+  result.clear();
+  probe(100, 100, 1);
+  tree.GetValues(keys, result, &hint);
+  EXPECT_NE(INVALID_PAGE_ID, hint.page_id);
+  probe(102, 102, 1);
+  tree.GetValues(keys, result, &hint);
+  for (int64_t key = 2; key <= 8000; key += 2) {
+    index_key.SetFromInteger(key);
+    tree.Remove(index_key, transaction);
+  }
+  probe(100, 9000, 100);
+  tree.GetValues(keys, result, &hint);
+  ASSERT_EQ(12, result.size());
+  EXPECT_EQ(100, result[0].Get());
+  EXPECT_EQ(102, result[1].Get());
+  EXPECT_EQ(8100, result[2].Get());
+  EXPECT_EQ(9000, result[11].Get());
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+  delete disk_manager;
+  delete key_schema;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, LazyDeleteTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(100, disk_manager);
+  GenericKey<8> index_key;
+  Transaction *transaction = new Transaction(0);
+  page_id_t page_id;
+  bpm->NewPage(page_id);
+
+  // ascending inserts leave half full leaves, where removing and inserting
+  // the same keys merges and splits them again with the eager threshold
+  uint64_t merges[2];
+  for (int round = 0; round < 2; round++) {
+    BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree(
+        "foo_pk" + std::to_string(round), bpm, comparator);
+    tree.SetMergeThreshold(round == 0 ? 50 : 25);
+    for (int64_t key = 1; key <= 10000; key++) {
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(tree.Insert(index_key, RID(key), transaction));
+    }
+    uint64_t before = Metrics::Snapshot().Get(MetricCounter::BTREE_MERGE);
+    for (int64_t key = 1; key <= 10000; key += 7) {
+      index_key.SetFromInteger(key);
+      tree.Remove(index_key, transaction);
+      EXPECT_TRUE(tree.Insert(index_key, RID(key), transaction));
+    }
+    merges[round] =
+        Metrics::Snapshot().Get(MetricCounter::BTREE_MERGE) - before;
+
+    // leaves far below half full still find and order their keys
+    std::vector<int64_t> remaining;
+    for (int64_t key = 1; key <= 10000; key++) {
+      index_key.SetFromInteger(key);
+      if (key % 5 != 0) {
+        tree.Remove(index_key, transaction);
+      } else {
+        remaining.push_back(key);
+      }
+    }
+    std::vector<RID> rids;
+    for (auto key : remaining) {
+      rids.clear();
+      index_key.SetFromInteger(key);
+      EXPECT_TRUE(tree.GetValue(index_key, rids));
+    }
+    size_t size = 0;
+    for (auto iterator = tree.Begin(); !iterator.isEnd(); ++iterator) {
+      ASSERT_LT(size, remaining.size());
+      EXPECT_EQ(remaining[size], (*iterator).second.Get());
+      size++;
+    }
+    EXPECT_EQ(remaining.size(), size);
+  }
+  EXPECT_GT(merges[0], 0);
+  EXPECT_EQ(0, merges[1]);
+
+  bpm->UnpinPage(HEADER_PAGE_ID, true);
+  delete transaction;
+  delete bpm;
+  delete disk_manager;
+  delete key_schema;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BPlusTreeTests, LargeNodeTest) {
+  Schema *key_schema = ParseCreateStatement("a bigint");
+  GenericComparator<8> comparator(key_schema);
+  // nodes sized by the disk manager, not by PAGE_SIZE
+  DiskManager *disk_manager = new DiskManager("test.db", INDEX_PAGE_SIZE);
+  BufferPoolManager *bpm = new BufferPoolManager(20, disk_manager);
+  BPlusTree<GenericKey<8>, RID, GenericComparator<8>> tree("foo_pk", bpm,
+                                                           comparator);
+  GenericKey<8> index_key;
+  Transaction *transaction = new Transaction(0);
+  page_id_t page_id;
+  bpm->NewPage(page_id);
+  bpm->UnpinPage(page_id, true);
+
+  std::vector<int64_t> keys;
+  for (int64_t key = 1; key <= 100000; key++)
+    keys.push_back(key);
+  std::random_shuffle(keys.begin(), keys.end());
+  for (auto key : keys) {
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.Insert(index_key, RID(key), transaction));
+  }
+
+  // a root over leaves holds 100000 keys
+  HeaderPage *header_page =
+      static_cast<HeaderPage *>(bpm->FetchPage(HEADER_PAGE_ID));
+  page_id_t root_page_id;
+  EXPECT_TRUE(header_page->GetRootId("foo_pk", root_page_id));
+  bpm->UnpinPage(HEADER_PAGE_ID, false);
+  auto *root = reinterpret_cast<BPlusTreeInternalPage<
+      GenericKey<8>, page_id_t, GenericComparator<8>> *>(
+      bpm->FetchPage(root_page_id)->GetData());
+  EXPECT_FALSE(root->IsLeafPage());
+  page_id_t child_id = root->ValueAt(0);
+  auto *child = reinterpret_cast<BPlusTreePage *>(
+      bpm->FetchPage(child_id)->GetData());
+  EXPECT_TRUE(child->IsLeafPage());
+  EXPECT_EQ(
+      (INDEX_PAGE_SIZE -
+       sizeof(BPlusTreeLeafPage<GenericKey<8>, RID, GenericComparator<8>>)) /
+              sizeof(std::pair<GenericKey<8>, RID>) -
+          1,
+      child->GetMaxSize());
+  bpm->UnpinPage(child_id, false);
+  bpm->UnpinPage(root_page_id, false);
+
+  std::vector<RID> rids;
+  for (int64_t key = 1; key <= 100000; key += 97) {
+    rids.clear();
+    index_key.SetFromInteger(key);
+    EXPECT_TRUE(tree.GetValue(index_key, rids));
+    EXPECT_EQ(key, rids[0].Get());
+  }
+
+  delete transaction;
+  delete bpm;
+  delete disk_manager;
+  delete key_schema;
+  remove("test.db");
+  remove("test.log");
+}
+
 } // namespace cmudb
@@ -0,0 +1,156 @@
+/**
+ * bloom_filter_test.cpp
+ */
+
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/metrics.h"
+#include "index/b_plus_tree_index.h"
+#include "index/bloom_filter.h"
+#include "page/header_page.h"
+#include "vtable/virtual_table.h"
+#include "gtest/gtest.h"
+
+namespace cmudb {
+
+TEST(BloomFilterTest, FalsePositiveTest) {
+  const size_t num_keys = 10000;
+  BlockedBloomFilter filter(num_keys);
+  EXPECT_EQ(num_keys * BlockedBloomFilter::BITS_PER_KEY / 512 + 1,
+            filter.GetNumBlocks());
+  std::mt19937_64 random(7);
+  std::vector<uint64_t> hashes;
+  for (size_t i = 0; i < num_keys; i++) {
+    hashes.push_back(random());
+    filter.Insert(hashes.back());
+  }
+  // no false negative
+  for (uint64_t hash : hashes)
+    EXPECT_TRUE(filter.MayContain(hash));
+  int false_positives = 0;
+  for (size_t i = 0; i < 100000; i++)
+    false_positives += filter.MayContain(random());
+  EXPECT_LT(false_positives, 1000);
+}
+
+TEST(BloomFilterTest, IndexTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  Schema *schema = ParseCreateStatement("a bigint");
+  typedef BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> Index8;
+  Index8 *index =
+      new Index8(new IndexMetadata("foo_pk", "foo", schema, {0}), bpm);
+  Transaction transaction(0);
+  auto make_key = [&](int64_t key) {
+    return Tuple({Value(TypeId::BIGINT, key)}, schema);
+  };
+
+  // even keys, enough to rebuild the filter larger a few times
+  const int64_t num_keys = 5000;
+  for (int64_t key = 0; key < 2 * num_keys; key += 2)
+    index->InsertEntry(make_key(key), RID(0, key), &transaction);
+  EXPECT_GE(index->GetFilterCapacity(), num_keys);
+
+  Metrics::Reset();
+  std::vector<RID> result;
+  for (int64_t key = 0; key < 2 * num_keys; key++) {
+    result.clear();
+    index->ScanKey(make_key(key), result);
+    EXPECT_EQ(key % 2 == 0 ? 1 : 0, result.size());
+  }
+  // most odd keys never reach the tree
+  MetricsSnapshot snapshot = Metrics::Snapshot();
+  EXPECT_EQ(num_keys, snapshot.Get(MetricCounter::BLOOM_FILTER_SKIP) +
+                          snapshot.Get(
+                              MetricCounter::BLOOM_FILTER_FALSE_POSITIVE));
+  EXPECT_GT(snapshot.Get(MetricCounter::BLOOM_FILTER_SKIP), num_keys * 9 / 10);
+
+  // still unique, the leaf finds the duplicate. Rejected duplicates leave
+  // the filter as it was
+  size_t filter_capacity = index->GetFilterCapacity();
+  for (int64_t key = 0; key < 2 * num_keys; key += 2)
+    index->InsertEntry(make_key(key), RID(1, 1), &transaction);
+  EXPECT_EQ(filter_capacity, index->GetFilterCapacity());
+  result.clear();
+  index->ScanKey(make_key(2), result);
+  ASSERT_EQ(1, result.size());
+  EXPECT_EQ(RID(0, 2), result[0]);
+
+  // an index opened on an existing tree fills its filter again
+  HeaderPage *header_page =
+      static_cast<HeaderPage *>(bpm->FetchPage(HEADER_PAGE_ID));
+  page_id_t root_page_id;
+  EXPECT_TRUE(header_page->GetRootId("foo_pk", root_page_id));
+  bpm->UnpinPage(HEADER_PAGE_ID, false);
+  delete index;
+  index = new Index8(new IndexMetadata("foo_pk", "foo", schema, {0}), bpm,
+                     root_page_id);
+  for (int64_t key = 0; key < 2 * num_keys; key += 2) {
+    result.clear();
+    index->ScanKey(make_key(key), result);
+    EXPECT_EQ(1, result.size());
+  }
+
+  delete index;
+  delete schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+TEST(BloomFilterTest, ConcurrentUniqueTest) {
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *bpm = new BufferPoolManager(50, disk_manager);
+  page_id_t header_page_id;
+  bpm->NewPage(header_page_id);
+  bpm->UnpinPage(header_page_id, true);
+  Schema *schema = ParseCreateStatement("a bigint");
+  typedef BPlusTreeIndex<GenericKey<8>, RID, GenericComparator<8>> Index8;
+  Index8 *index =
+      new Index8(new IndexMetadata("foo_pk", "foo", schema, {0}), bpm);
+  auto make_key = [&](int64_t key) {
+    return Tuple({Value(TypeId::BIGINT, key)}, schema);
+  };
+
+  // every thread inserts the same absent keys, only one insert may win
+  const int num_threads = 4;
+  const int64_t num_keys = 2000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < num_threads; t++) {
+    threads.emplace_back([&, t]() {
+      Transaction transaction(t);
+      for (int64_t key = 0; key < num_keys; key++)
+        index->InsertEntry(make_key(key), RID(t, key), &transaction);
+    });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  std::vector<RID> result;
+  for (int64_t key = 0; key < num_keys; key++) {
+    result.clear();
+    index->ScanKey(make_key(key), result);
+    EXPECT_EQ(1, result.size());
+  }
+  int64_t entries = 0;
+  for (auto it = index->GetBeginIterator(); !it.isEnd(); ++it)
+    entries++;
+  EXPECT_EQ(num_keys, entries);
+
+  delete index;
+  delete schema;
+  delete bpm;
+  delete disk_manager;
+  remove("test.db");
+  remove("test.log");
+}
+
+} // namespace cmudb
@@ -0,0 +1,133 @@
+/**
+ * bulk_loader_test.cpp
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "buffer/buffer_pool_manager.h"
+#include "common/exception.h"
+#include "table/bulk_loader.h"
+#include "vtable/virtual_table.h"
+#include "gtest/gtest.h"
+
+namespace cmudb {
+
+TEST(BulkLoaderTest, LoadTest) {
+  Schema *schema = ParseCreateStatement("a int, b varchar(16), c double");
+  Transaction *transaction = new Transaction(0);
+  DiskManager *disk_manager = new DiskManager("test.db");
+  BufferPoolManager *buffer_pool_manager =
+      new BufferPoolManager(10, disk_manager);
+  LockManager *lock_manager = new LockManager(true);
+  LogManager *log_manager = new LogManager(disk_manager);
+  TableHeap *table = new TableHeap(buffer_pool_manager, lock_manager,
+                                   log_manager, transaction);
+  RID rid;
+  for (int i = 0; i < 100; i++) {
+    Tuple tuple({Value(TypeId::INTEGER, -i - 1), Value(TypeId::VARCHAR, "x"),
+                 Value(TypeId::DECIMAL, 0.0)},
+                schema);
+    EXPECT_TRUE(table->InsertTuple(tuple, rid, transaction));
+  }
+
+  // more than one chunk, keys in descending order. Every 10th row has a
+  // quoted comma in b, every 7th a NULL c
+  const int rows = 80000;
+  {
+    std::ofstream file("test.csv", std::ios::binary);
+    for (int i = rows - 1; i >= 0; i--) {
+      file << i << "," << (i % 10 ? "v" + std::to_string(i % 13) : "\"u,\"\"\"")
+           << "," << (i % 7 ? std::to_string(i / 2.0) : "") << "\r\n";
+      if (i == rows / 2)
+        file << "\n";
+    }
+  }
+  std::vector<int> key_attrs{0};
+  Schema *key_schema = Schema::CopySchema(schema, key_attrs);
+  BulkLoader loader(schema, table, buffer_pool_manager, disk_manager);
+  loader.SetKeyAttrs(key_attrs, key_schema);
+  EXPECT_EQ((size_t)rows, loader.Load("test.csv", 4));
+  EXPECT_LT((uint64_t)rows * 10, loader.GetBytes());
+
+  // the rows follow those inserted, in file order
+  int i = 0;
+  for (auto it = table->begin(transaction); it != table->end(); ++it, ++i) {
+    if (i < 100) {
+      EXPECT_EQ(-i - 1, it->Get<int32_t>(schema, 0));
+      continue;
+    }
+    int a = rows - 1 - (i - 100);
+    ASSERT_EQ(a, it->Get<int32_t>(schema, 0));
+    EXPECT_EQ(a % 10 ? "v" + std::to_string(a % 13) : "u,\"",
+              it->Get<const char *>(schema, 1));
+    if (a % 7 == 0) {
+      EXPECT_TRUE(it->IsNull(schema, 2));
+    } else {
+      EXPECT_EQ(a / 2.0, it->Get<double>(schema, 2));
+    }
+  }
+  EXPECT_EQ(100 + rows, i);
+
+  // the keys come sorted, each rid holds its row
+  auto &keys = loader.GetKeys();
+  ASSERT_EQ((size_t)rows, keys.size());
+  for (int k = 0; k < rows; k += 997) {
+    EXPECT_EQ(k, keys[k].first.Get<int32_t>(key_schema, 0));
+    Tuple tuple;
+    EXPECT_TRUE(table->GetTuple(keys[k].second, tuple, transaction));
+    EXPECT_EQ(k, tuple.Get<int32_t>(schema, 0));
+  }
+
+  // a record that does not fit the schema appends nothing
+  {
+    std::ofstream file("test.csv", std::ios::binary);
+    file << "1,a,1.5\n2,b,x\n";
+  }
+  EXPECT_THROW(loader.Load("test.csv", 2), Exception);
+  {
+    std::ofstream file("test.csv", std::ios::binary);
+    file << "1,a\n";
+  }
+  EXPECT_THROW(loader.Load("test.csv", 2), Exception);
+  {
+    std::ofstream file("test.csv", std::ios::binary);
+    file << "2147483648,a,1\n";
+  }
+  EXPECT_THROW(loader.Load("test.csv", 2), Exception);
+  i = 0;
+  for (auto it = table->begin(transaction); it != table->end(); ++it)
+    i++;
+  EXPECT_EQ(100 + rows, i);
+
+  // rows loaded into an empty table follow its empty first page
+  TableHeap empty_table(buffer_pool_manager, lock_manager, log_manager,
+                        transaction);
+  {
+    std::ofstream file("test.csv", std::ios::binary);
+    file << "1,a,1.5\n2,b,2.5\n";
+  }
+  BulkLoader empty_loader(schema, &empty_table, buffer_pool_manager,
+                          disk_manager);
+  EXPECT_EQ(2u, empty_loader.Load("test.csv", 1));
+  i = 0;
+  for (auto it = empty_table.begin(transaction); it != empty_table.end(); ++it)
+    EXPECT_EQ(++i, it->Get<int32_t>(schema, 0));
+  EXPECT_EQ(2, i);
+
+  remove("test.db");
+  remove("test.log");
+  remove("test.csv");
+  delete key_schema;
+  delete schema;
+  delete table;
+  delete buffer_pool_manager;
+  delete log_manager;
+  delete lock_manager;
+  delete disk_manager;
+  delete transaction;
+}
+
+} // namespace cmudb
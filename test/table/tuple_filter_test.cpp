@@ -0,0 +1,70 @@
+/**
+ * tuple_filter_test.cpp
+ */
+
+#include <string>
+#include <vector>
+
+#include "table/tuple_filter.h"
+#include "gtest/gtest.h"
+
+namespace cmudb {
+
+TEST(TupleFilterTest, SelectTest) {
+  Schema schema({Column(TypeId::SMALLINT, 2, "a"), Column(TypeId::BIGINT, 8, "b"),
+                 Column(TypeId::DECIMAL, 8, "c"),
+                 Column(TypeId::VARCHAR, 16, "d")});
+  std::vector<Tuple> tuples;
+  for (int i = 0; i < 100; i++) {
+    std::vector<Value> values{
+        Value(TypeId::SMALLINT, (int16_t)(i - 50)),
+        Value(TypeId::BIGINT, (int64_t)i * 1000000000),
+        Value(TypeId::DECIMAL, i / 4.0),
+        Value(TypeId::VARCHAR, "k" + std::to_string(i % 10))};
+    tuples.emplace_back(values, &schema);
+  }
+  auto select = [&](TupleFilter &filter) {
+    std::vector<int> selection;
+    filter.Select(tuples, selection);
+    return selection;
+  };
+
+  // no predicate selects every row
+  TupleFilter all(&schema);
+  EXPECT_EQ(100u, select(all).size());
+
+  // a BETWEEN on a negative smallint and an int64 range
+  TupleFilter between(&schema);
+  EXPECT_TRUE(between.AddPredicate(0, FilterOp::GE,
+                                   Value(TypeId::INTEGER, (int32_t)-3)));
+  EXPECT_TRUE(between.AddPredicate(0, FilterOp::LE,
+                                   Value(TypeId::BIGINT, (int64_t)3)));
+  EXPECT_TRUE(between.AddPredicate(
+      1, FilterOp::GT, Value(TypeId::BIGINT, (int64_t)48000000000)));
+  EXPECT_EQ(std::vector<int>({49, 50, 51, 52, 53}), select(between));
+
+  // decimal against decimal, integer against decimal
+  TupleFilter decimal(&schema);
+  EXPECT_TRUE(decimal.AddPredicate(2, FilterOp::LT, Value(TypeId::DECIMAL, 1.0)));
+  EXPECT_TRUE(decimal.AddPredicate(0, FilterOp::GT, Value(TypeId::DECIMAL, -48.5)));
+  EXPECT_EQ(std::vector<int>({2, 3}), select(decimal));
+
+  TupleFilter varchar(&schema);
+  EXPECT_TRUE(varchar.AddPredicate(3, FilterOp::EQ,
+                                   Value(TypeId::VARCHAR, std::string("k7"))));
+  EXPECT_TRUE(varchar.AddPredicate(0, FilterOp::LT,
+                                   Value(TypeId::INTEGER, (int32_t)0)));
+  EXPECT_EQ(std::vector<int>({7, 17, 27, 37, 47}), select(varchar));
+
+  // varchar does not compare with a number in place
+  TupleFilter mismatch(&schema);
+  EXPECT_FALSE(mismatch.AddPredicate(3, FilterOp::EQ,
+                                     Value(TypeId::INTEGER, (int32_t)7)));
+  EXPECT_FALSE(mismatch.AddPredicate(
+      1, FilterOp::EQ, Value(TypeId::VARCHAR, std::string("7"))));
+  EXPECT_EQ(0u, mismatch.GetPredicateCount());
+  mismatch.SetEmpty();
+  EXPECT_TRUE(select(mismatch).empty());
+}
+
+} // namespace cmudb
@@ -61,4 +61,60 @@ TEST(TupleTest, TableHeapTest) {
   delete disk_manager;
 }
 
+TEST(TupleTest, LayoutTest) {
+  Schema *schema = ParseCreateStatement(
+      "a bool, b bigint, c varchar(8), d varint int, e smallint, "
+      "f varint bigint, g double");
+  // fixed length columns by decreasing length, then the null bitmap
+  EXPECT_EQ(0, schema->GetOffset(1));
+  EXPECT_EQ(8, schema->GetOffset(6));
+  EXPECT_EQ(16, schema->GetOffset(2));
+  EXPECT_EQ(20, schema->GetOffset(4));
+  EXPECT_EQ(22, schema->GetOffset(0));
+  EXPECT_TRUE(schema->HasNullBitmap());
+  EXPECT_EQ(23, schema->GetNullBitmapOffset());
+  EXPECT_EQ(24, schema->GetLength());
+  EXPECT_EQ(0, schema->GetVarintOrdinal(3));
+  EXPECT_EQ(1, schema->GetVarintOrdinal(5));
+
+  std::vector<Value> values{Value(TypeId::BOOLEAN, (int8_t)1),
+                            Value(TypeId::BIGINT, (int64_t)-7),
+                            Value(TypeId::VARCHAR, "abc"),
+                            Value(TypeId::INTEGER, (int32_t)-64),
+                            Value(TypeId::SMALLINT, (int16_t)300),
+                            Value(TypeId::BIGINT, (int64_t)1 << 40),
+                            Value(TypeId::DECIMAL, 0.5)};
+  Tuple tuple(values, schema);
+  // -64 in 1 byte, 2^40 in 6, "abc" and its length in 8
+  EXPECT_EQ(24 + 1 + 6 + 8, tuple.GetLength());
+  for (int i = 0; i < schema->GetColumnCount(); i++) {
+    EXPECT_FALSE(tuple.IsNull(schema, i));
+    EXPECT_EQ(CMP_TRUE, tuple.GetValue(schema, i).CompareEquals(values[i]));
+  }
+  EXPECT_EQ(-64, tuple.Get<int32_t>(schema, 3));
+  EXPECT_EQ((int64_t)1 << 40, tuple.Get<int64_t>(schema, 5));
+  EXPECT_STREQ("abc", tuple.Get<const char *>(schema, 2));
+
+  // NULLs are in the bitmap, a NULL VARCHAR is its length alone
+  values[2] = Value(TypeId::VARCHAR, nullptr, PELOTON_VALUE_NULL, false);
+  values[3] = Value(TypeId::INTEGER, PELOTON_INT32_NULL);
+  values[6] = Value(TypeId::DECIMAL, PELOTON_DECIMAL_NULL);
+  Tuple nulls(values, schema);
+  EXPECT_EQ(24 + 1 + 6 + 4, nulls.GetLength());
+  for (int i = 0; i < schema->GetColumnCount(); i++) {
+    bool is_null = i == 2 || i == 3 || i == 6;
+    EXPECT_EQ(is_null, nulls.IsNull(schema, i));
+    EXPECT_EQ(is_null, nulls.GetValue(schema, i).IsNull());
+  }
+  EXPECT_EQ((int64_t)1 << 40, nulls.Get<int64_t>(schema, 5));
+
+  // keys have neither a null bitmap nor varints
+  Schema *key_schema = Schema::CopySchema(schema, {5, 2});
+  EXPECT_FALSE(key_schema->HasNullBitmap());
+  EXPECT_FALSE(key_schema->IsVarint(0));
+  EXPECT_EQ(12, key_schema->GetLength());
+  delete key_schema;
+  delete schema;
+}
+
 } // namespace cmudb
@@ -1,6 +1,11 @@
 /**
  * virtual_table_test.cpp
  */
+#include <algorithm>
+#include <fstream>
+#include <sys/stat.h>
+
+#include "catalog/catalog.h"
 #include "vtable/testing_vtable_util.h"
 
 namespace cmudb {
@@ -44,4 +49,923 @@ TEST(VtableTest, CreateTest) {
   remove("vtable.db");
   return;
 }
+
+TEST(VtableTest, StatsTest) {
+  std::string db_file = "sqlite.db";
+  remove(db_file.c_str());
+  remove("vtable.db");
+  sqlite3 *db;
+  EXPECT_EQ(SQLITE_OK, sqlite3_open(db_file.c_str(), &db));
+  EXPECT_EQ(SQLITE_OK, sqlite3_enable_load_extension(db, 1));
+  EXPECT_EQ(SQLITE_OK, sqlite3_load_extension(db, "libvtable", 0, 0));
+
+  EXPECT_TRUE(ExecSQL(db, "CREATE VIRTUAL TABLE foo2 USING vtable ('a int, "
+                          "b varchar(10)', 'foo2_pk a')"));
+  EXPECT_TRUE(ExecSQL(db, "INSERT INTO foo2 VALUES(1, 'hello')"));
+  EXPECT_TRUE(ExecSQL(db, "SELECT * FROM foo2 WHERE a = 1"));
+  EXPECT_TRUE(ExecSQL(db, "SELECT * FROM vtable_stats"));
+
+  // the buffer pool served the queries above
+  sqlite3_stmt *stmt;
+  EXPECT_EQ(SQLITE_OK,
+            sqlite3_prepare_v2(db, "SELECT value FROM vtable_stats WHERE "
+                                   "name = 'buffer_hit'",
+                               -1, &stmt, nullptr));
+  EXPECT_EQ(SQLITE_ROW, sqlite3_step(stmt));
+  EXPECT_GT(sqlite3_column_int64(stmt, 0), 0);
+  EXPECT_EQ(SQLITE_DONE, sqlite3_step(stmt));
+  sqlite3_finalize(stmt);
+  // read only
+  EXPECT_FALSE(ExecSQL(db, "DELETE FROM vtable_stats"));
+
+  EXPECT_TRUE(ExecSQL(db, "SELECT vtable_trace('start')"));
+  EXPECT_TRUE(ExecSQL(db, "SELECT * FROM foo2 WHERE a = 1"));
+  EXPECT_TRUE(ExecSQL(db, "SELECT vtable_trace('stop')"));
+  EXPECT_TRUE(ExecSQL(db, "SELECT vtable_trace('dump', 'trace.json')"));
+  EXPECT_FALSE(ExecSQL(db, "SELECT vtable_trace('bogus')"));
+  remove("trace.json");
+
+  EXPECT_TRUE(ExecSQL(db, "DROP TABLE foo2"));
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+  remove(db_file.c_str());
+  remove("vtable.db");
+}
+TEST(VtableTest, HashIndexTest) {
+  std::string db_file = "sqlite.db";
+  remove(db_file.c_str());
+  remove("vtable.db");
+  sqlite3 *db;
+  EXPECT_EQ(SQLITE_OK, sqlite3_open(db_file.c_str(), &db));
+  EXPECT_EQ(SQLITE_OK, sqlite3_enable_load_extension(db, 1));
+  EXPECT_EQ(SQLITE_OK, sqlite3_load_extension(db, "libvtable", 0, 0));
+
+  EXPECT_TRUE(ExecSQL(db, "CREATE VIRTUAL TABLE foo3 USING vtable ('a int, "
+                          "b varchar(10)', 'foo3_pk a using hash')"));
+  for (int i = 0; i < 200; i++) {
+    std::string sql = "INSERT INTO foo3 VALUES(" + std::to_string(i) +
+                      ", 'v" + std::to_string(i) + "')";
+    EXPECT_TRUE(ExecSQL(db, sql.c_str()));
+  }
+  EXPECT_TRUE(ExecSQL(db, "DELETE FROM foo3 WHERE a = 7"));
+  EXPECT_TRUE(ExecSQL(db, "UPDATE foo3 SET b = 'new' WHERE a = 8"));
+
+  // the equality lookups go through the hash index
+  sqlite3_stmt *stmt;
+  EXPECT_EQ(SQLITE_OK,
+            sqlite3_prepare_v2(db, "EXPLAIN QUERY PLAN SELECT b FROM foo3 "
+                                   "WHERE a = 150",
+                               -1, &stmt, nullptr));
+  EXPECT_EQ(SQLITE_ROW, sqlite3_step(stmt));
+  std::string plan(reinterpret_cast<const char *>(
+      sqlite3_column_text(stmt, sqlite3_column_count(stmt) - 1)));
+  EXPECT_NE(std::string::npos, plan.find("VIRTUAL TABLE INDEX 1"));
+  sqlite3_finalize(stmt);
+
+  int values[] = {150, 7, 8};
+  const char *expected[] = {"v150", nullptr, "new"};
+  for (int i = 0; i < 3; i++) {
+    std::string sql = "SELECT b FROM foo3 WHERE a = " +
+                      std::to_string(values[i]);
+    EXPECT_EQ(SQLITE_OK,
+              sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr));
+    if (expected[i] == nullptr) {
+      EXPECT_EQ(SQLITE_DONE, sqlite3_step(stmt));
+    } else {
+      EXPECT_EQ(SQLITE_ROW, sqlite3_step(stmt));
+      EXPECT_STREQ(expected[i], reinterpret_cast<const char *>(
+                                    sqlite3_column_text(stmt, 0)));
+      EXPECT_EQ(SQLITE_DONE, sqlite3_step(stmt));
+    }
+    sqlite3_finalize(stmt);
+  }
+
+  EXPECT_TRUE(ExecSQL(db, "DROP TABLE foo3"));
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+  remove(db_file.c_str());
+  remove("vtable.db");
+}
+
+TEST(VtableTest, ArtIndexTest) {
+  std::string db_file = "sqlite.db";
+  std::string snapshot = "vtable.db.foo4_pk.art";
+  remove(db_file.c_str());
+  remove("vtable.db");
+  sqlite3 *db;
+  auto open = [&]() {
+    EXPECT_EQ(SQLITE_OK, sqlite3_open(db_file.c_str(), &db));
+    EXPECT_EQ(SQLITE_OK, sqlite3_enable_load_extension(db, 1));
+    EXPECT_EQ(SQLITE_OK, sqlite3_load_extension(db, "libvtable", 0, 0));
+  };
+  // b of the row where a = key, empty if there is none
+  auto lookup = [&](int key) {
+    sqlite3_stmt *stmt;
+    std::string sql = "SELECT b FROM foo4 WHERE a = " + std::to_string(key);
+    EXPECT_EQ(SQLITE_OK,
+              sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr));
+    std::string b;
+    if (sqlite3_step(stmt) == SQLITE_ROW)
+      b = reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
+    sqlite3_finalize(stmt);
+    return b;
+  };
+
+  open();
+  EXPECT_TRUE(ExecSQL(db, "CREATE VIRTUAL TABLE foo4 USING vtable ('a int, "
+                          "b varchar(10)', 'foo4_pk a using art')"));
+  for (int i = 0; i < 200; i++) {
+    std::string sql = "INSERT INTO foo4 VALUES(" + std::to_string(i) +
+                      ", 'v" + std::to_string(i) + "')";
+    EXPECT_TRUE(ExecSQL(db, sql.c_str()));
+  }
+  EXPECT_TRUE(ExecSQL(db, "DELETE FROM foo4 WHERE a = 7"));
+  EXPECT_TRUE(ExecSQL(db, "UPDATE foo4 SET b = 'new' WHERE a = 8"));
+  EXPECT_EQ("v150", lookup(150));
+  EXPECT_EQ("", lookup(7));
+  EXPECT_EQ("new", lookup(8));
+
+  // a clean close leaves a snapshot, the next connect consumes it
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+  struct stat buffer;
+  EXPECT_EQ(0, stat(snapshot.c_str(), &buffer));
+  open();
+  EXPECT_EQ("v150", lookup(150));
+  EXPECT_NE(0, stat(snapshot.c_str(), &buffer));
+  EXPECT_EQ("", lookup(7));
+  EXPECT_EQ("new", lookup(8));
+
+  // without a snapshot the index is rebuilt from the table heap
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+  remove(snapshot.c_str());
+  open();
+  EXPECT_EQ("v199", lookup(199));
+  EXPECT_EQ("", lookup(7));
+  EXPECT_EQ("new", lookup(8));
+
+  EXPECT_TRUE(ExecSQL(db, "DROP TABLE foo4"));
+  EXPECT_NE(0, stat(snapshot.c_str(), &buffer));
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+  remove(db_file.c_str());
+  remove("vtable.db");
+}
+
+TEST(VtableTest, BLinkIndexTest) {
+  std::string db_file = "sqlite.db";
+  remove(db_file.c_str());
+  remove("vtable.db");
+  sqlite3 *db;
+  EXPECT_EQ(SQLITE_OK, sqlite3_open(db_file.c_str(), &db));
+  EXPECT_EQ(SQLITE_OK, sqlite3_enable_load_extension(db, 1));
+  EXPECT_EQ(SQLITE_OK, sqlite3_load_extension(db, "libvtable", 0, 0));
+
+  EXPECT_TRUE(ExecSQL(db, "CREATE VIRTUAL TABLE foo5 USING vtable ('a int, "
+                          "b varchar(10)', 'foo5_pk a using blink')"));
+  for (int i = 0; i < 500; i++) {
+    std::string sql = "INSERT INTO foo5 VALUES(" + std::to_string(i) +
+                      ", 'v" + std::to_string(i) + "')";
+    EXPECT_TRUE(ExecSQL(db, sql.c_str()));
+  }
+  EXPECT_TRUE(ExecSQL(db, "DELETE FROM foo5 WHERE a = 7"));
+
+  sqlite3_stmt *stmt;
+  int values[] = {450, 7};
+  const char *expected[] = {"v450", nullptr};
+  for (int i = 0; i < 2; i++) {
+    std::string sql = "SELECT b FROM foo5 WHERE a = " +
+                      std::to_string(values[i]);
+    EXPECT_EQ(SQLITE_OK,
+              sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr));
+    if (expected[i] == nullptr) {
+      EXPECT_EQ(SQLITE_DONE, sqlite3_step(stmt));
+    } else {
+      EXPECT_EQ(SQLITE_ROW, sqlite3_step(stmt));
+      EXPECT_STREQ(expected[i], reinterpret_cast<const char *>(
+                                    sqlite3_column_text(stmt, 0)));
+    }
+    sqlite3_finalize(stmt);
+  }
+
+  EXPECT_TRUE(ExecSQL(db, "DROP TABLE foo5"));
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+  remove(db_file.c_str());
+  remove("vtable.db");
+}
+
+TEST(VtableTest, BEpsilonIndexTest) {
+  std::string db_file = "sqlite.db";
+  remove(db_file.c_str());
+  remove("vtable.db");
+  sqlite3 *db;
+  EXPECT_EQ(SQLITE_OK, sqlite3_open(db_file.c_str(), &db));
+  EXPECT_EQ(SQLITE_OK, sqlite3_enable_load_extension(db, 1));
+  EXPECT_EQ(SQLITE_OK, sqlite3_load_extension(db, "libvtable", 0, 0));
+
+  EXPECT_TRUE(ExecSQL(db, "CREATE VIRTUAL TABLE foo6 USING vtable ('a int, "
+                          "b varchar(10)', 'foo6_pk a using betree')"));
+  EXPECT_TRUE(ExecSQL(db, "BEGIN"));
+  for (int i = 0; i < 2000; i++) {
+    std::string sql = "INSERT INTO foo6 VALUES(" + std::to_string(i) +
+                      ", 'v" + std::to_string(i) + "')";
+    EXPECT_TRUE(ExecSQL(db, sql.c_str()));
+  }
+  EXPECT_TRUE(ExecSQL(db, "COMMIT"));
+  EXPECT_TRUE(ExecSQL(db, "DELETE FROM foo6 WHERE a = 7"));
+  EXPECT_TRUE(ExecSQL(db, "UPDATE foo6 SET a = 5000 WHERE a = 8"));
+
+  // erases and puts still buffered above the leaves decide the lookups
+  sqlite3_stmt *stmt;
+  int values[] = {1450, 7, 8, 5000};
+  const char *expected[] = {"v1450", nullptr, nullptr, "v8"};
+  for (int i = 0; i < 4; i++) {
+    std::string sql = "SELECT b FROM foo6 WHERE a = " +
+                      std::to_string(values[i]);
+    EXPECT_EQ(SQLITE_OK,
+              sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr));
+    if (expected[i] == nullptr) {
+      EXPECT_EQ(SQLITE_DONE, sqlite3_step(stmt));
+    } else {
+      EXPECT_EQ(SQLITE_ROW, sqlite3_step(stmt));
+      EXPECT_STREQ(expected[i], reinterpret_cast<const char *>(
+                                    sqlite3_column_text(stmt, 0)));
+    }
+    sqlite3_finalize(stmt);
+  }
+
+  EXPECT_TRUE(ExecSQL(db, "DROP TABLE foo6"));
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+  remove(db_file.c_str());
+  remove("vtable.db");
+}
+
+TEST(VtableTest, CatalogTest) {
+  std::string db_file = "sqlite.db";
+  remove(db_file.c_str());
+  remove("vtable.db");
+  sqlite3 *db;
+  auto open = [&]() {
+    EXPECT_EQ(SQLITE_OK, sqlite3_open(db_file.c_str(), &db));
+    EXPECT_EQ(SQLITE_OK, sqlite3_enable_load_extension(db, 1));
+    EXPECT_EQ(SQLITE_OK, sqlite3_load_extension(db, "libvtable", 0, 0));
+  };
+
+  // far more tables than the header page holds, in one connection
+  const int table_count = 100;
+  open();
+  for (int i = 0; i < table_count; i++) {
+    std::string table = "catalog_table_" + std::to_string(i);
+    std::string sql = "CREATE VIRTUAL TABLE " + table +
+                      " USING vtable ('a int, b varchar(10)', '" + table +
+                      "_pk a')";
+    EXPECT_TRUE(ExecSQL(db, sql.c_str()));
+    sql = "INSERT INTO " + table + " VALUES(" + std::to_string(i) + ", 'v" +
+          std::to_string(i) + "')";
+    EXPECT_TRUE(ExecSQL(db, sql.c_str()));
+  }
+  EXPECT_TRUE(ExecSQL(db, "DROP TABLE catalog_table_0"));
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+
+  // every table is found again through the catalog
+  open();
+  for (int i = 1; i < table_count; i++) {
+    sqlite3_stmt *stmt;
+    std::string sql =
+        "SELECT b FROM catalog_table_" + std::to_string(i) + " WHERE a = " +
+        std::to_string(i);
+    EXPECT_EQ(SQLITE_OK,
+              sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr));
+    EXPECT_EQ(SQLITE_ROW, sqlite3_step(stmt));
+    EXPECT_EQ("v" + std::to_string(i),
+              std::string(reinterpret_cast<const char *>(
+                  sqlite3_column_text(stmt, 0))));
+    sqlite3_finalize(stmt);
+  }
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+  remove(db_file.c_str());
+  remove("vtable.db");
+}
+
+TEST(VtableTest, DropTest) {
+  std::string db_file = "sqlite.db";
+  remove(db_file.c_str());
+  remove("vtable.db");
+  sqlite3 *db;
+  auto open = [&]() {
+    EXPECT_EQ(SQLITE_OK, sqlite3_open(db_file.c_str(), &db));
+    EXPECT_EQ(SQLITE_OK, sqlite3_enable_load_extension(db, 1));
+    EXPECT_EQ(SQLITE_OK, sqlite3_load_extension(db, "libvtable", 0, 0));
+  };
+  auto count = [&](const std::string &where) {
+    sqlite3_stmt *stmt;
+    std::string sql = "SELECT count(*) FROM foo14 WHERE " + where;
+    EXPECT_EQ(SQLITE_OK,
+              sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr));
+    EXPECT_EQ(SQLITE_ROW, sqlite3_step(stmt));
+    int rows = sqlite3_column_int(stmt, 0);
+    sqlite3_finalize(stmt);
+    return rows;
+  };
+
+  open();
+  EXPECT_TRUE(ExecSQL(db, "CREATE VIRTUAL TABLE foo14 USING vtable ('a int, "
+                          "b varchar(10)', 'foo14_pk a')"));
+  for (int i = 0; i < 10; i++) {
+    std::string sql =
+        "INSERT INTO foo14 VALUES(" + std::to_string(i) + ", 'old')";
+    EXPECT_TRUE(ExecSQL(db, sql.c_str()));
+  }
+  EXPECT_TRUE(ExecSQL(db, "DROP TABLE foo14"));
+  // the same table again, its index must not find the old root
+  EXPECT_TRUE(ExecSQL(db, "CREATE VIRTUAL TABLE foo14 USING vtable ('a int, "
+                          "b varchar(10)', 'foo14_pk a')"));
+  EXPECT_TRUE(ExecSQL(db, "INSERT INTO foo14 VALUES(100, 'new')"));
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+
+  open();
+  EXPECT_EQ(0, count("a = 5"));
+  EXPECT_EQ(1, count("a = 100"));
+  EXPECT_TRUE(ExecSQL(db, "DROP TABLE foo14"));
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+  remove(db_file.c_str());
+  remove("vtable.db");
+}
+
+TEST(VtableTest, OrderedScanTest) {
+  std::string db_file = "sqlite.db";
+  remove(db_file.c_str());
+  remove("vtable.db");
+  sqlite3 *db;
+  EXPECT_EQ(SQLITE_OK, sqlite3_open(db_file.c_str(), &db));
+  EXPECT_EQ(SQLITE_OK, sqlite3_enable_load_extension(db, 1));
+  EXPECT_EQ(SQLITE_OK, sqlite3_load_extension(db, "libvtable", 0, 0));
+
+  EXPECT_TRUE(ExecSQL(db, "CREATE VIRTUAL TABLE foo6 USING vtable ('a int, "
+                          "b varchar(10)', 'foo6_pk a')"));
+  // more rows than one scan batch, inserted out of order
+  for (int i = 0; i < 500; i++) {
+    int a = (i * 7) % 500;
+    std::string sql = "INSERT INTO foo6 VALUES(" + std::to_string(a) +
+                      ", 'v" + std::to_string(a) + "')";
+    EXPECT_TRUE(ExecSQL(db, sql.c_str()));
+  }
+
+  // the index gives the order, sqlite does not sort
+  sqlite3_stmt *stmt;
+  EXPECT_EQ(SQLITE_OK,
+            sqlite3_prepare_v2(db, "EXPLAIN QUERY PLAN SELECT a FROM foo6 "
+                                   "ORDER BY a DESC",
+                               -1, &stmt, nullptr));
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    std::string detail =
+        reinterpret_cast<const char *>(sqlite3_column_text(stmt, 3));
+    EXPECT_EQ(std::string::npos, detail.find("TEMP B-TREE"));
+  }
+  sqlite3_finalize(stmt);
+
+  const char *queries[] = {"SELECT a FROM foo6 ORDER BY a DESC",
+                           "SELECT a FROM foo6 ORDER BY a"};
+  for (int q = 0; q < 2; q++) {
+    EXPECT_EQ(SQLITE_OK,
+              sqlite3_prepare_v2(db, queries[q], -1, &stmt, nullptr));
+    int count = 0;
+    while (sqlite3_step(stmt) == SQLITE_ROW) {
+      int expected = q == 0 ? 499 - count : count;
+      EXPECT_EQ(expected, sqlite3_column_int(stmt, 0));
+      count++;
+    }
+    EXPECT_EQ(500, count);
+    sqlite3_finalize(stmt);
+  }
+
+  auto scan_rows = [db]() {
+    sqlite3_stmt *stmt;
+    sqlite3_prepare_v2(db, "SELECT value FROM vtable_stats WHERE "
+                           "name = 'index_scan_row'",
+                       -1, &stmt, nullptr);
+    sqlite3_step(stmt);
+    int64_t rows = sqlite3_column_int64(stmt, 0);
+    sqlite3_finalize(stmt);
+    return rows;
+  };
+  // a small limit reads little ahead of it
+  int64_t before = scan_rows();
+  EXPECT_EQ(SQLITE_OK,
+            sqlite3_prepare_v2(db, "SELECT b FROM foo6 ORDER BY a DESC LIMIT 5",
+                               -1, &stmt, nullptr));
+  for (int i = 0; i < 5; i++) {
+    EXPECT_EQ(SQLITE_ROW, sqlite3_step(stmt));
+    std::string expected = "v" + std::to_string(499 - i);
+    EXPECT_STREQ(expected.c_str(), reinterpret_cast<const char *>(
+                                       sqlite3_column_text(stmt, 0)));
+  }
+  EXPECT_EQ(SQLITE_DONE, sqlite3_step(stmt));
+  sqlite3_finalize(stmt);
+  EXPECT_GE(8, scan_rows() - before);
+
+  before = scan_rows();
+  EXPECT_EQ(SQLITE_OK,
+            sqlite3_prepare_v2(db, "SELECT a FROM foo6 ORDER BY a LIMIT 3 "
+                                   "OFFSET 100",
+                               -1, &stmt, nullptr));
+  for (int i = 0; i < 3; i++) {
+    EXPECT_EQ(SQLITE_ROW, sqlite3_step(stmt));
+    EXPECT_EQ(100 + i, sqlite3_column_int(stmt, 0));
+  }
+  EXPECT_EQ(SQLITE_DONE, sqlite3_step(stmt));
+  sqlite3_finalize(stmt);
+  EXPECT_GE(120, scan_rows() - before);
+
+  EXPECT_TRUE(ExecSQL(db, "DROP TABLE foo6"));
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+  remove(db_file.c_str());
+  remove("vtable.db");
+}
+
+TEST(VtableTest, IndexOnlyScanTest) {
+  std::string db_file = "sqlite.db";
+  remove(db_file.c_str());
+  remove("vtable.db");
+  sqlite3 *db;
+  EXPECT_EQ(SQLITE_OK, sqlite3_open(db_file.c_str(), &db));
+  EXPECT_EQ(SQLITE_OK, sqlite3_enable_load_extension(db, 1));
+  EXPECT_EQ(SQLITE_OK, sqlite3_load_extension(db, "libvtable", 0, 0));
+
+  EXPECT_TRUE(ExecSQL(db, "CREATE VIRTUAL TABLE foo7 USING vtable ('a int, "
+                          "b varchar(10), c bigint', 'foo7_pk a, c')"));
+  for (int i = 0; i < 300; i++) {
+    std::string sql = "INSERT INTO foo7 VALUES(" + std::to_string(i % 100) +
+                      ", 'v" + std::to_string(i) + "', " + std::to_string(i) +
+                      ")";
+    EXPECT_TRUE(ExecSQL(db, sql.c_str()));
+  }
+
+  auto index_only_rows = [db]() {
+    sqlite3_stmt *stmt;
+    sqlite3_prepare_v2(db, "SELECT value FROM vtable_stats WHERE "
+                           "name = 'index_only_row'",
+                       -1, &stmt, nullptr);
+    sqlite3_step(stmt);
+    int64_t rows = sqlite3_column_int64(stmt, 0);
+    sqlite3_finalize(stmt);
+    return rows;
+  };
+
+  // key columns only, decoded from the index
+  sqlite3_stmt *stmt;
+  int64_t before = index_only_rows();
+  EXPECT_EQ(SQLITE_OK,
+            sqlite3_prepare_v2(db, "SELECT c, a FROM foo7 ORDER BY a DESC, "
+                                   "c DESC",
+                               -1, &stmt, nullptr));
+  int count = 0;
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    int64_t c = 299 - count / 3 - 100 * (count % 3);
+    EXPECT_EQ(c, sqlite3_column_int64(stmt, 0));
+    EXPECT_EQ(c % 100, sqlite3_column_int(stmt, 1));
+    count++;
+  }
+  EXPECT_EQ(300, count);
+  sqlite3_finalize(stmt);
+  EXPECT_EQ(before + 300, index_only_rows());
+
+  before = index_only_rows();
+  EXPECT_EQ(SQLITE_OK,
+            sqlite3_prepare_v2(db, "SELECT a FROM foo7 WHERE a = 42 AND "
+                                   "c = 142",
+                               -1, &stmt, nullptr));
+  EXPECT_EQ(SQLITE_ROW, sqlite3_step(stmt));
+  EXPECT_EQ(42, sqlite3_column_int(stmt, 0));
+  EXPECT_EQ(SQLITE_DONE, sqlite3_step(stmt));
+  sqlite3_finalize(stmt);
+  EXPECT_EQ(before + 1, index_only_rows());
+
+  // b is not in the key, the tuple is read
+  before = index_only_rows();
+  EXPECT_EQ(SQLITE_OK,
+            sqlite3_prepare_v2(db, "SELECT b FROM foo7 WHERE a = 42 AND "
+                                   "c = 142",
+                               -1, &stmt, nullptr));
+  EXPECT_EQ(SQLITE_ROW, sqlite3_step(stmt));
+  EXPECT_STREQ("v142",
+               reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0)));
+  EXPECT_EQ(SQLITE_DONE, sqlite3_step(stmt));
+  sqlite3_finalize(stmt);
+  EXPECT_EQ(before, index_only_rows());
+
+  EXPECT_TRUE(ExecSQL(db, "DROP TABLE foo7"));
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+  remove(db_file.c_str());
+  remove("vtable.db");
+}
+
+TEST(VtableTest, InListTest) {
+  std::string db_file = "sqlite.db";
+  remove(db_file.c_str());
+  remove("vtable.db");
+  sqlite3 *db;
+  EXPECT_EQ(SQLITE_OK, sqlite3_open(db_file.c_str(), &db));
+  EXPECT_EQ(SQLITE_OK, sqlite3_enable_load_extension(db, 1));
+  EXPECT_EQ(SQLITE_OK, sqlite3_load_extension(db, "libvtable", 0, 0));
+
+  EXPECT_TRUE(ExecSQL(db, "CREATE VIRTUAL TABLE foo8 USING vtable ('a int, "
+                          "b varchar(10)', 'foo8_pk a')"));
+  for (int i = 0; i < 1000; i++) {
+    std::string sql = "INSERT INTO foo8 VALUES(" + std::to_string(i) +
+                      ", 'v" + std::to_string(i) + "')";
+    EXPECT_TRUE(ExecSQL(db, sql.c_str()));
+  }
+
+  auto leaf_reuse = [db]() {
+    sqlite3_stmt *stmt;
+    sqlite3_prepare_v2(db, "SELECT value FROM vtable_stats WHERE "
+                           "name = 'btree_leaf_reuse'",
+                       -1, &stmt, nullptr);
+    sqlite3_step(stmt);
+    int64_t reuse = sqlite3_column_int64(stmt, 0);
+    sqlite3_finalize(stmt);
+    return reuse;
+  };
+
+  // listed out of order, with misses and a duplicate
+  std::string sql = "SELECT a, b FROM foo8 WHERE a IN (2000, 5";
+  for (int i = 400; i > 0; i -= 2)
+    sql += ", " + std::to_string(i);
+  sql += ", -1, 5)";
+  int64_t before = leaf_reuse();
+  sqlite3_stmt *stmt;
+  EXPECT_EQ(SQLITE_OK, sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr));
+  std::vector<int> found;
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    int a = sqlite3_column_int(stmt, 0);
+    std::string b = "v" + std::to_string(a);
+    EXPECT_STREQ(b.c_str(),
+                 reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1)));
+    found.push_back(a);
+  }
+  sqlite3_finalize(stmt);
+  std::sort(found.begin(), found.end());
+  std::vector<int> expected = {5};
+  for (int i = 2; i <= 400; i += 2)
+    expected.push_back(i);
+  std::sort(expected.begin(), expected.end());
+  EXPECT_EQ(expected, found);
+  // most probes did not descend from the root
+  EXPECT_GT(leaf_reuse() - before, 150);
+
+  EXPECT_TRUE(ExecSQL(db, "DROP TABLE foo8"));
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+  remove(db_file.c_str());
+  remove("vtable.db");
+}
+
+TEST(VtableTest, FilterScanTest) {
+  std::string db_file = "sqlite.db";
+  remove(db_file.c_str());
+  remove("vtable.db");
+  sqlite3 *db;
+  EXPECT_EQ(SQLITE_OK, sqlite3_open(db_file.c_str(), &db));
+  EXPECT_EQ(SQLITE_OK, sqlite3_enable_load_extension(db, 1));
+  EXPECT_EQ(SQLITE_OK, sqlite3_load_extension(db, "libvtable", 0, 0));
+
+  EXPECT_TRUE(ExecSQL(db, "CREATE VIRTUAL TABLE foo9 USING vtable ('a int, "
+                          "b varchar(10), c bigint, d double', 'foo9_pk a')"));
+  for (int i = 0; i < 1000; i++) {
+    std::string sql = "INSERT INTO foo9 VALUES(" + std::to_string(i) +
+                      ", 'v" + std::to_string(i % 10) + "', " +
+                      std::to_string(i % 100) + ", " + std::to_string(i) +
+                      ".5)";
+    EXPECT_TRUE(ExecSQL(db, sql.c_str()));
+  }
+  // a row deleted from a page is not handed out
+  EXPECT_TRUE(ExecSQL(db, "DELETE FROM foo9 WHERE a = 17"));
+
+  auto skipped_rows = [db]() {
+    sqlite3_stmt *stmt;
+    sqlite3_prepare_v2(db, "SELECT value FROM vtable_stats WHERE "
+                           "name = 'filter_skip_row'",
+                       -1, &stmt, nullptr);
+    sqlite3_step(stmt);
+    int64_t rows = sqlite3_column_int64(stmt, 0);
+    sqlite3_finalize(stmt);
+    return rows;
+  };
+  auto count = [db](const std::string &where) {
+    sqlite3_stmt *stmt;
+    std::string sql = "SELECT count(*) FROM foo9 WHERE " + where;
+    EXPECT_EQ(SQLITE_OK,
+              sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr));
+    EXPECT_EQ(SQLITE_ROW, sqlite3_step(stmt));
+    int rows = sqlite3_column_int(stmt, 0);
+    sqlite3_finalize(stmt);
+    return rows;
+  };
+
+  // the rows that do not match never reach sqlite
+  int64_t before = skipped_rows();
+  EXPECT_EQ(9, count("c = 17"));
+  EXPECT_EQ(999 - 9, skipped_rows() - before);
+
+  EXPECT_EQ(90, count("c < 10 AND a >= 10"));
+  EXPECT_EQ(300, count("c BETWEEN 20 AND 49"));
+  EXPECT_EQ(10, count("a > 100 AND a <= 110"));
+  EXPECT_EQ(100, count("b = 'v3'"));
+  EXPECT_EQ(699, count("b >= 'v3'"));
+  EXPECT_EQ(10, count("d < 10"));
+  EXPECT_EQ(10, count("c < 10.5 AND c > 9.5"));
+  EXPECT_EQ(0, count("c = NULL"));
+  // text against a number column is left to sqlite
+  EXPECT_EQ(0, count("c = 'v3'"));
+  EXPECT_EQ(0, count("c > 1000"));
+
+  // the filter goes with the columns it does not read
+  sqlite3_stmt *stmt;
+  EXPECT_EQ(SQLITE_OK,
+            sqlite3_prepare_v2(db, "SELECT a, b, d FROM foo9 WHERE c = 42 "
+                                   "AND b = 'v2' ORDER BY a",
+                               -1, &stmt, nullptr));
+  std::vector<int> found;
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    int a = sqlite3_column_int(stmt, 0);
+    EXPECT_STREQ("v2",
+                 reinterpret_cast<const char *>(sqlite3_column_text(stmt, 1)));
+    EXPECT_EQ(a + 0.5, sqlite3_column_double(stmt, 2));
+    found.push_back(a);
+  }
+  sqlite3_finalize(stmt);
+  std::vector<int> expected;
+  for (int i = 42; i < 1000; i += 100)
+    expected.push_back(i);
+  EXPECT_EQ(expected, found);
+
+  EXPECT_TRUE(ExecSQL(db, "DROP TABLE foo9"));
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+  remove(db_file.c_str());
+  remove("vtable.db");
+}
+
+TEST(VtableTest, DictionaryTest) {
+  std::string db_file = "sqlite.db";
+  remove(db_file.c_str());
+  remove("vtable.db");
+  sqlite3 *db;
+  auto open = [&]() {
+    EXPECT_EQ(SQLITE_OK, sqlite3_open(db_file.c_str(), &db));
+    EXPECT_EQ(SQLITE_OK, sqlite3_enable_load_extension(db, 1));
+    EXPECT_EQ(SQLITE_OK, sqlite3_load_extension(db, "libvtable", 0, 0));
+  };
+  auto count = [&](const std::string &where) {
+    sqlite3_stmt *stmt;
+    std::string sql = "SELECT count(*) FROM foo10 WHERE " + where;
+    EXPECT_EQ(SQLITE_OK,
+              sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr));
+    EXPECT_EQ(SQLITE_ROW, sqlite3_step(stmt));
+    int rows = sqlite3_column_int(stmt, 0);
+    sqlite3_finalize(stmt);
+    return rows;
+  };
+  const char *statuses[] = {"open", "closed", "pending", "rejected"};
+
+  open();
+  EXPECT_TRUE(ExecSQL(db, "CREATE VIRTUAL TABLE foo10 USING vtable ('a int, "
+                          "status dictionary varchar(16), b varchar(16)', "
+                          "'foo10_pk status, a')"));
+  for (int i = 0; i < 400; i++) {
+    std::string sql = "INSERT INTO foo10 VALUES(" + std::to_string(i) + ", '" +
+                      statuses[i % 4] + "', 'v" + std::to_string(i) + "')";
+    EXPECT_TRUE(ExecSQL(db, sql.c_str()));
+  }
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+
+  // the codes are decoded after a reopen, new values go on from the last code
+  open();
+  EXPECT_TRUE(ExecSQL(db, "INSERT INTO foo10 VALUES(400, 'archived', 'v400')"));
+  EXPECT_TRUE(ExecSQL(db, "UPDATE foo10 SET status = 'archived' WHERE a < 3"));
+  sqlite3_stmt *stmt;
+  EXPECT_EQ(SQLITE_OK,
+            sqlite3_prepare_v2(db, "SELECT a, status, b FROM foo10", -1,
+                               &stmt, nullptr));
+  int rows = 0;
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    int a = sqlite3_column_int(stmt, 0);
+    std::string status = a < 3 || a == 400 ? "archived" : statuses[a % 4];
+    EXPECT_EQ(status, reinterpret_cast<const char *>(
+                          sqlite3_column_text(stmt, 1)));
+    EXPECT_EQ("v" + std::to_string(a),
+              reinterpret_cast<const char *>(sqlite3_column_text(stmt, 2)));
+    rows++;
+  }
+  sqlite3_finalize(stmt);
+  EXPECT_EQ(401, rows);
+
+  // equality compares codes, in the filter and in the index key
+  EXPECT_EQ(99, count("status = 'closed'"));
+  EXPECT_EQ(4, count("status = 'archived'"));
+  EXPECT_EQ(0, count("status = 'unknown'"));
+  EXPECT_EQ(1, count("status = 'pending' AND a = 6"));
+  EXPECT_EQ(0, count("status = 'pending' AND a = 7"));
+  // other comparisons are left to sqlite, on the decoded values
+  EXPECT_EQ(99, count("status < 'open' AND status > 'archived'"));
+  EXPECT_EQ(4 + 99, count("status IN ('archived', 'closed')"));
+
+  // ORDER BY the encoded key is sorted by sqlite
+  EXPECT_EQ(SQLITE_OK,
+            sqlite3_prepare_v2(db, "SELECT status FROM foo10 ORDER BY "
+                                   "status, a",
+                               -1, &stmt, nullptr));
+  std::string last;
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    std::string status =
+        reinterpret_cast<const char *>(sqlite3_column_text(stmt, 0));
+    EXPECT_LE(last, status);
+    last = status;
+  }
+  sqlite3_finalize(stmt);
+  EXPECT_EQ("rejected", last);
+
+  EXPECT_TRUE(ExecSQL(db, "DROP TABLE foo10"));
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+  remove(db_file.c_str());
+  remove("vtable.db");
+}
+
+TEST(VtableTest, NullTest) {
+  std::string db_file = "sqlite.db";
+  remove(db_file.c_str());
+  remove("vtable.db");
+  sqlite3 *db;
+  EXPECT_EQ(SQLITE_OK, sqlite3_open(db_file.c_str(), &db));
+  EXPECT_EQ(SQLITE_OK, sqlite3_enable_load_extension(db, 1));
+  EXPECT_EQ(SQLITE_OK, sqlite3_load_extension(db, "libvtable", 0, 0));
+  auto count = [&](const std::string &where) {
+    sqlite3_stmt *stmt;
+    std::string sql = "SELECT count(*) FROM foo11 WHERE " + where;
+    EXPECT_EQ(SQLITE_OK,
+              sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr));
+    EXPECT_EQ(SQLITE_ROW, sqlite3_step(stmt));
+    int rows = sqlite3_column_int(stmt, 0);
+    sqlite3_finalize(stmt);
+    return rows;
+  };
+
+  EXPECT_TRUE(ExecSQL(db, "CREATE VIRTUAL TABLE foo11 USING vtable ('a int, "
+                          "b varint bigint, c varchar(16), d tinyint', "
+                          "'foo11_pk a')"));
+  // every third row has NULL b and c
+  for (int i = 0; i < 300; i++) {
+    std::string sql = "INSERT INTO foo11 VALUES(" + std::to_string(i) + ", " +
+                      (i % 3 ? std::to_string(i * 1000 - 150000) : "NULL") +
+                      ", " +
+                      (i % 3 ? "'c" + std::to_string(i) + "'" : "NULL") +
+                      ", " + std::to_string(i % 2) + ")";
+    EXPECT_TRUE(ExecSQL(db, sql.c_str()));
+  }
+
+  sqlite3_stmt *stmt;
+  EXPECT_EQ(SQLITE_OK, sqlite3_prepare_v2(db, "SELECT a, b, c FROM foo11", -1,
+                                          &stmt, nullptr));
+  int rows = 0;
+  while (sqlite3_step(stmt) == SQLITE_ROW) {
+    int a = sqlite3_column_int(stmt, 0);
+    if (a % 3 == 0) {
+      EXPECT_EQ(SQLITE_NULL, sqlite3_column_type(stmt, 1));
+      EXPECT_EQ(SQLITE_NULL, sqlite3_column_type(stmt, 2));
+    } else {
+      EXPECT_EQ(a * 1000 - 150000, sqlite3_column_int64(stmt, 1));
+      EXPECT_EQ("c" + std::to_string(a),
+                reinterpret_cast<const char *>(sqlite3_column_text(stmt, 2)));
+    }
+    rows++;
+  }
+  sqlite3_finalize(stmt);
+  EXPECT_EQ(300, rows);
+
+  EXPECT_EQ(100, count("b IS NULL"));
+  EXPECT_EQ(100, count("c IS NULL"));
+  // a comparison with NULL holds for no row, in the filter scan too
+  EXPECT_EQ(100, count("b < 0"));
+  EXPECT_EQ(100, count("b >= 0"));
+  EXPECT_EQ(200, count("c > 'a'"));
+  EXPECT_EQ(0, count("b = NULL"));
+  EXPECT_TRUE(ExecSQL(db, "UPDATE foo11 SET c = 'set' WHERE c IS NULL"));
+  EXPECT_EQ(0, count("c IS NULL"));
+  EXPECT_EQ(100, count("c = 'set'"));
+
+  EXPECT_TRUE(ExecSQL(db, "DROP TABLE foo11"));
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+  remove(db_file.c_str());
+  remove("vtable.db");
+}
+
+TEST(VtableTest, LayoutTest) {
+  std::string db_file = "sqlite.db";
+  remove(db_file.c_str());
+  remove("vtable.db");
+  sqlite3 *db;
+  auto open = [&]() {
+    EXPECT_EQ(SQLITE_OK, sqlite3_open(db_file.c_str(), &db));
+    EXPECT_EQ(SQLITE_OK, sqlite3_enable_load_extension(db, 1));
+    EXPECT_EQ(SQLITE_OK, sqlite3_load_extension(db, "libvtable", 0, 0));
+  };
+
+  open();
+  EXPECT_TRUE(ExecSQL(db, "CREATE VIRTUAL TABLE foo13 USING vtable ('a int, "
+                          "b varchar(10)', 'foo13_pk a')"));
+  EXPECT_TRUE(ExecSQL(db, "INSERT INTO foo13 VALUES(1, 'one')"));
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+
+  // record the table as written with the layout before the null bitmap
+  {
+    DiskManager disk_manager("vtable.db");
+    BufferPoolManager bpm(10, &disk_manager);
+    Catalog catalog(&bpm);
+    CatalogEntry entry;
+    EXPECT_TRUE(catalog.GetEntry("foo13", entry));
+    EXPECT_EQ(TUPLE_LAYOUT_VERSION, entry.layout_version);
+    entry.layout_version = 0;
+    EXPECT_TRUE(catalog.UpdateEntry(entry));
+    bpm.FlushAllPages();
+  }
+
+  // the table is rejected rather than misread
+  open();
+  sqlite3_stmt *stmt;
+  EXPECT_EQ(SQLITE_ERROR, sqlite3_prepare_v2(db, "SELECT b FROM foo13", -1,
+                                             &stmt, nullptr));
+  EXPECT_NE(std::string::npos,
+            std::string(sqlite3_errmsg(db)).find("tuple layout 0"));
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+  remove(db_file.c_str());
+  remove("vtable.db");
+}
+
+TEST(VtableTest, ImportTest) {
+  std::string db_file = "sqlite.db";
+  remove(db_file.c_str());
+  remove("vtable.db");
+  sqlite3 *db;
+  auto open = [&]() {
+    EXPECT_EQ(SQLITE_OK, sqlite3_open(db_file.c_str(), &db));
+    EXPECT_EQ(SQLITE_OK, sqlite3_enable_load_extension(db, 1));
+    EXPECT_EQ(SQLITE_OK, sqlite3_load_extension(db, "libvtable", 0, 0));
+  };
+  // first column of the first row of sql, empty if there is none
+  auto query = [&](const std::string &sql) {
+    sqlite3_stmt *stmt;
+    EXPECT_EQ(SQLITE_OK,
+              sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr));
+    std::string result;
+    if (sqlite3_step(stmt) == SQLITE_ROW) {
+      const unsigned char *text = sqlite3_column_text(stmt, 0);
+      result = text ? reinterpret_cast<const char *>(text) : "NULL";
+    } else {
+      result = sqlite3_errmsg(db);
+    }
+    sqlite3_finalize(stmt);
+    return result;
+  };
+
+  // a quoted comma in b, NULL d on every fifth row, c dictionary encoded
+  {
+    std::ofstream file("import.csv", std::ios::binary);
+    for (int i = 0; i < 3000; i++)
+      file << (i * 7919) % 3000 << ",\"b," << i << "\",c" << i % 4 << ","
+           << (i % 5 ? std::to_string(i * 100000 - 1) : "") << "\n";
+  }
+  open();
+  EXPECT_TRUE(ExecSQL(db, "CREATE VIRTUAL TABLE foo12 USING vtable ('a int, "
+                          "b varchar(16), c dictionary varchar(8), d varint "
+                          "bigint', 'foo12_pk a')"));
+  EXPECT_TRUE(ExecSQL(db, "INSERT INTO foo12 VALUES(-1, 'x', 'c1', 1)"));
+  EXPECT_EQ("3000", query("SELECT vtable_import('foo12', 'import.csv', 3)"));
+  EXPECT_EQ("3001", query("SELECT count(*) FROM foo12"));
+  EXPECT_EQ("750", query("SELECT count(*) FROM foo12 WHERE c = 'c2'"));
+  EXPECT_EQ("600", query("SELECT count(*) FROM foo12 WHERE d IS NULL"));
+  // row i has a = i * 7919 % 3000
+  EXPECT_EQ("b,2", query("SELECT b FROM foo12 WHERE a = 838"));
+  EXPECT_EQ("199999", query("SELECT d FROM foo12 WHERE a = 838"));
+  EXPECT_EQ("x", query("SELECT b FROM foo12 WHERE a = -1"));
+  EXPECT_NE("3000", query("SELECT vtable_import('foo12', 'missing.csv')"));
+  EXPECT_NE("3000", query("SELECT vtable_import('nothere', 'import.csv')"));
+  // the name is quoted within the statement that connects the table
+  EXPECT_TRUE(ExecSQL(db, "CREATE VIRTUAL TABLE \"foo\"\"13\" USING vtable "
+                          "('a int, b varchar(16), c varchar(8), d bigint')"));
+  EXPECT_EQ("3000", query("SELECT vtable_import('foo\"13', 'import.csv')"));
+  EXPECT_EQ("3000", query("SELECT count(*) FROM \"foo\"\"13\""));
+  EXPECT_NE("3000",
+            query("SELECT vtable_import('foo12\" LIMIT 0; --', 'import.csv')"));
+  EXPECT_TRUE(ExecSQL(db, "DROP TABLE \"foo\"\"13\""));
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+
+  // the rows and their index entries outlive the connection
+  open();
+  EXPECT_EQ("3001", query("SELECT count(*) FROM foo12"));
+  EXPECT_EQ("b,2999", query("SELECT b FROM foo12 WHERE a = 1081"));
+  EXPECT_EQ("c1", query("SELECT c FROM foo12 WHERE a = 1919"));
+  EXPECT_TRUE(ExecSQL(db, "INSERT INTO foo12 VALUES(5000, 'y', 'c0', 2)"));
+  EXPECT_EQ("y", query("SELECT b FROM foo12 WHERE a = 5000"));
+
+  EXPECT_TRUE(ExecSQL(db, "DROP TABLE foo12"));
+  EXPECT_EQ(SQLITE_OK, sqlite3_close(db));
+  remove(db_file.c_str());
+  remove("vtable.db");
+  remove("import.csv");
+}
 } // namespace cmudb
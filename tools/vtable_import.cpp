@@ -0,0 +1,90 @@
+/**
+ * vtable_import.cpp
+ *
+ * Bulk import of a CSV file into a vtable table, through the vtable_import
+ * function of the extension (see table/bulk_loader.h for the format). The
+ * table must exist, the extension opens vtable.db in the working directory.
+ *
+ * usage: vtable_import [--db=sqlite.db] [--workers=N]
+ *                      [--vtable_lib=libvtable] <table> <file.csv>
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+#include "sqlite/sqlite3.h"
+
+int main(int argc, char **argv) {
+  std::string db_file = "sqlite.db";
+  std::string vtable_lib = "libvtable";
+  int workers = 0;
+  std::vector<std::string> args;
+  for (int i = 1; i < argc; i++) {
+    std::string arg(argv[i]);
+    if (arg.compare(0, 5, "--db=") == 0)
+      db_file = arg.substr(5);
+    else if (arg.compare(0, 10, "--workers=") == 0)
+      workers = std::stoi(arg.substr(10));
+    else if (arg.compare(0, 13, "--vtable_lib=") == 0)
+      vtable_lib = arg.substr(13);
+    else
+      args.push_back(arg);
+  }
+  if (args.size() != 2) {
+    std::printf("usage: %s [--db=sqlite.db] [--workers=N] "
+                "[--vtable_lib=libvtable] <table> <file.csv>\n",
+                argv[0]);
+    return args.empty() ? 0 : 1;
+  }
+  struct stat buffer;
+  if (stat(args[1].c_str(), &buffer) != 0) {
+    std::fprintf(stderr, "can't open %s\n", args[1].c_str());
+    return 1;
+  }
+
+  sqlite3 *db;
+  char *err = nullptr;
+  if (sqlite3_open(db_file.c_str(), &db) != SQLITE_OK ||
+      sqlite3_enable_load_extension(db, 1) != SQLITE_OK ||
+      sqlite3_load_extension(db, vtable_lib.c_str(), nullptr, &err) !=
+          SQLITE_OK) {
+    std::fprintf(stderr, "load extension: %s\n",
+                 err ? err : sqlite3_errmsg(db));
+    sqlite3_free(err);
+    sqlite3_close(db);
+    return 1;
+  }
+
+  // workers 0 leaves the count to the extension, one per core
+  sqlite3_stmt *stmt;
+  std::string sql = workers > 0 ? "SELECT vtable_import(?, ?, ?)"
+                                : "SELECT vtable_import(?, ?)";
+  sqlite3_prepare_v2(db, sql.c_str(), -1, &stmt, nullptr);
+  sqlite3_bind_text(stmt, 1, args[0].c_str(), -1, SQLITE_STATIC);
+  sqlite3_bind_text(stmt, 2, args[1].c_str(), -1, SQLITE_STATIC);
+  if (workers > 0)
+    sqlite3_bind_int(stmt, 3, workers);
+  auto start = std::chrono::steady_clock::now();
+  int rc = sqlite3_step(stmt);
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - start)
+                       .count();
+  if (rc != SQLITE_ROW) {
+    std::fprintf(stderr, "import: %s\n", sqlite3_errmsg(db));
+    sqlite3_finalize(stmt);
+    sqlite3_close(db);
+    return 1;
+  }
+  long long rows = sqlite3_column_int64(stmt, 0);
+  sqlite3_finalize(stmt);
+  sqlite3_close(db);
+
+  double gigabytes = buffer.st_size / 1e9;
+  std::printf("%lld rows, %.1f MB in %.3f s, %.2f GB/min\n", rows,
+              buffer.st_size / 1e6, seconds,
+              seconds > 0 ? gigabytes / seconds * 60 : 0.0);
+  return 0;
+}